@@ -0,0 +1,278 @@
+/*
+ * @file bench.c
+ *
+ * Benchmark harness and driver for the dsp-lib modules.
+ *
+ * Usage:
+ *   dsp_bench [--csv | --json] [--reps N] [--warmup N] [--min-rep-us N]
+ *             [--filter NAME]
+ *
+ * Every case is warmed up, then timed for a number of repetitions. Short
+ * calls are batched so a single repetition lasts at least --min-rep-us,
+ * and the per-call time is the repetition time divided by the batch size.
+ * The report gives median and 99th percentile per call, ns per sample,
+ * samples per second and allocations per call.
+ *
+ * Allocations are counted by linking with
+ *   -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+ * which routes every library allocation through the counters below.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define BENCH_MAX_REPS 10000
+
+int bench_failed = 0;
+
+BenchConfig bench_config = {
+    .warmup = 3,
+    .repetitions = 31,
+    .min_rep_ns = 200000.0,
+    .filter = NULL,
+    .format = BENCH_FORMAT_TEXT
+};
+
+static atomic_ulong alloc_calls;   /* bumped by pool workers too */
+static int rows_emitted;
+
+/******************************************************************************/
+/* allocation counters (linker --wrap) */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_realloc(ptr, size);
+}
+
+unsigned long bench_alloc_count(void) {
+    return atomic_load_explicit(&alloc_calls, memory_order_relaxed);
+}
+
+/******************************************************************************/
+/* harness */
+
+double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int bench_selected(const char *name) {
+    return !bench_config.filter || strstr(name, bench_config.filter) != NULL;
+}
+
+/******************************************************************************
+ * bench_parse_args
+ *
+ * @param[in] argc number of command-line arguments
+ * @param[in] argv command-line arguments
+ *
+ * @returns 0 on success, -1 on an unknown option (usage is printed)
+ */
+int bench_parse_args(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *next = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--csv") == 0) {
+            bench_config.format = BENCH_FORMAT_CSV;
+        } else if (strcmp(arg, "--json") == 0) {
+            bench_config.format = BENCH_FORMAT_JSON;
+        } else if (strcmp(arg, "--reps") == 0 && next) {
+            bench_config.repetitions = atoi(next);
+            i++;
+        } else if (strcmp(arg, "--warmup") == 0 && next) {
+            bench_config.warmup = atoi(next);
+            i++;
+        } else if (strcmp(arg, "--min-rep-us") == 0 && next) {
+            bench_config.min_rep_ns = atof(next) * 1000.0;
+            i++;
+        } else if (strcmp(arg, "--filter") == 0 && next) {
+            bench_config.filter = next;
+            i++;
+        } else {
+            fprintf(stderr,
+                    "Usage: %s [--csv | --json] [--reps N] [--warmup N] "
+                    "[--min-rep-us N] [--filter NAME]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    if (bench_config.repetitions < 1) bench_config.repetitions = 1;
+    if (bench_config.repetitions > BENCH_MAX_REPS) bench_config.repetitions = BENCH_MAX_REPS;
+    if (bench_config.warmup < 0) bench_config.warmup = 0;
+    return 0;
+}
+/* End of bench_parse_args() */
+/******************************************************************************/
+
+void bench_report_begin(void) {
+    rows_emitted = 0;
+    switch (bench_config.format) {
+        case BENCH_FORMAT_CSV:
+            printf("name,variant,param,median_ns,p99_ns,ns_per_sample,"
+                   "samples_per_sec,allocs_per_call,calls_per_rep\n");
+            break;
+        case BENCH_FORMAT_JSON:
+            printf("[\n");
+            break;
+        default:
+            printf("%-22s %-12s %8s %14s %14s %10s %14s %8s\n",
+                   "name", "variant", "param", "median_ns", "p99_ns",
+                   "ns/sample", "samples/sec", "allocs");
+            break;
+    }
+}
+
+void bench_report_end(void) {
+    if (bench_config.format == BENCH_FORMAT_JSON) {
+        printf("\n]\n");
+    }
+}
+
+static void bench_report_row(const char *name, const char *variant, long param,
+                             const BenchResult *r) {
+    switch (bench_config.format) {
+        case BENCH_FORMAT_CSV:
+            printf("%s,%s,%ld,%.1f,%.1f,%.4f,%.1f,%.3f,%zu\n",
+                   name, variant, param, r->median_ns, r->p99_ns, r->ns_per_sample,
+                   r->samples_per_sec, r->allocs_per_call, r->calls_per_rep);
+            break;
+        case BENCH_FORMAT_JSON:
+            printf("%s  {\"name\": \"%s\", \"variant\": \"%s\", \"param\": %ld, "
+                   "\"median_ns\": %.1f, \"p99_ns\": %.1f, \"ns_per_sample\": %.4f, "
+                   "\"samples_per_sec\": %.1f, \"allocs_per_call\": %.3f, "
+                   "\"calls_per_rep\": %zu}",
+                   rows_emitted ? ",\n" : "", name, variant, param, r->median_ns,
+                   r->p99_ns, r->ns_per_sample, r->samples_per_sec,
+                   r->allocs_per_call, r->calls_per_rep);
+            break;
+        default:
+            printf("%-22s %-12s %8ld %14.1f %14.1f %10.3f %14.4g %8.2f\n",
+                   name, variant, param, r->median_ns, r->p99_ns,
+                   r->ns_per_sample, r->samples_per_sec, r->allocs_per_call);
+            break;
+    }
+    rows_emitted++;
+    fflush(stdout);
+}
+
+/******************************************************************************
+ * bench_run
+ *
+ * @param[in] name             case name (module/function)
+ * @param[in] variant          variant label (e.g. "sample", "block")
+ * @param[in] param            size/order label reported with the result
+ * @param[in] samples_per_call samples processed by one fn(ctx) call
+ * @param[in] fn               function under test
+ * @param[in] ctx              state passed to fn
+ *
+ * @returns None
+ *
+ * @note
+ * - Skipped silently when the name does not match --filter.
+ * - fn must be safe to call repeatedly (state may carry over).
+ */
+void bench_run(const char *name, const char *variant, long param,
+               size_t samples_per_call, BenchFn fn, void *ctx) {
+    if (!bench_selected(name)) return;
+
+    static double samples[BENCH_MAX_REPS];
+    int reps = bench_config.repetitions;
+
+    for (int i = 0; i < bench_config.warmup; i++) {
+        fn(ctx);
+    }
+
+    // Calibrate the batch size from a single timed call
+    double t0 = bench_now_ns();
+    fn(ctx);
+    double single = bench_now_ns() - t0;
+    size_t calls = 1;
+    if (single < bench_config.min_rep_ns) {
+        calls = (size_t)(bench_config.min_rep_ns / (single > 1.0 ? single : 1.0)) + 1;
+    }
+
+    unsigned long allocs_before = bench_alloc_count();
+    for (int r = 0; r < reps; r++) {
+        t0 = bench_now_ns();
+        for (size_t c = 0; c < calls; c++) {
+            fn(ctx);
+        }
+        samples[r] = (bench_now_ns() - t0) / calls;
+    }
+    unsigned long allocs = bench_alloc_count() - allocs_before;
+
+    qsort(samples, reps, sizeof(double), compare_double);
+
+    BenchResult result;
+    result.median_ns = samples[reps / 2];
+    result.p99_ns = samples[(int)((reps - 1) * 0.99 + 0.5)];
+    result.ns_per_sample = samples_per_call ? result.median_ns / samples_per_call : 0.0;
+    result.samples_per_sec = result.median_ns > 0 ? samples_per_call * 1e9 / result.median_ns : 0.0;
+    result.allocs_per_call = (double)allocs / ((double)reps * calls);
+    result.calls_per_rep = calls;
+
+    bench_report_row(name, variant, param, &result);
+}
+/* End of bench_run() */
+/******************************************************************************/
+
+/******************************************************************************
+ * main
+ *
+ * @param[in] argc number of command-line arguments
+ * @param[in] argv command-line arguments (see file header)
+ *
+ * @returns 0 if successful, 1 on bad arguments, 2 if a case's self-check failed
+ */
+int main(int argc, char *argv[]) {
+    if (bench_parse_args(argc, argv) != 0) return 1;
+
+    bench_report_begin();
+    bench_fft();
+    bench_filters();
+    bench_adaptive();
+    bench_cic();
+    bench_spectrogram();
+    bench_wav();
+    bench_resampler();
+    bench_goertzel();
+    bench_xcorr();
+    bench_ring_buffer();
+    bench_dispatch();
+    bench_report_end();
+
+    return bench_failed ? 2 : 0;
+}
+/* End of main() */
+/******************************************************************************/
@@ -0,0 +1,85 @@
+/*
+ * @file bench.h
+ *
+ * Header file for bench.c
+ *
+ * Minimal benchmark harness: warmup, repeated timed runs, median/p99
+ * statistics, allocation counting and text/CSV/JSON reporting.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stddef.h>
+
+/* Output format of the report */
+typedef enum {
+    BENCH_FORMAT_TEXT, /* aligned human-readable table */
+    BENCH_FORMAT_CSV,  /* one header line plus one line per case */
+    BENCH_FORMAT_JSON  /* JSON array of case objects */
+} BenchFormat;
+
+/* Harness settings, filled from the command line */
+typedef struct {
+    int warmup;          /* untimed calls before measuring */
+    int repetitions;     /* timed repetitions per case */
+    double min_rep_ns;   /* each repetition batches calls until it lasts this long */
+    const char *filter;  /* run only cases whose name contains this substring */
+    BenchFormat format;  /* report format */
+} BenchConfig;
+
+/* Statistics for one benchmark case */
+typedef struct {
+    double median_ns;        /* median time per call */
+    double p99_ns;           /* 99th percentile time per call */
+    double ns_per_sample;    /* median time divided by samples per call */
+    double samples_per_sec;  /* throughput derived from the median */
+    double allocs_per_call;  /* malloc/calloc/realloc calls per call */
+    size_t calls_per_rep;    /* calls batched in one timed repetition */
+} BenchResult;
+
+/* Function under test; ctx is the case's private state */
+typedef void (*BenchFn)(void *ctx);
+
+extern BenchConfig bench_config;
+
+/* Set by cases whose correctness self-check fails; main() then exits with 2 */
+extern int bench_failed;
+
+// Parse command-line options into bench_config; returns 0 on success
+int bench_parse_args(int argc, char *argv[]);
+
+// Nonzero when the case name passes the --filter option
+int bench_selected(const char *name);
+
+// Time fn(ctx) and report one result row; param is a free-form size/order label
+void bench_run(const char *name, const char *variant, long param,
+               size_t samples_per_call, BenchFn fn, void *ctx);
+
+// Emit any report header/footer (call once before and once after all cases)
+void bench_report_begin(void);
+void bench_report_end(void);
+
+// Monotonic clock in nanoseconds
+double bench_now_ns(void);
+
+// Allocation calls seen so far (counted via the linker's --wrap option)
+unsigned long bench_alloc_count(void);
+
+// Register a bench case group; implemented in the bench_*.c files
+void bench_fft(void);
+void bench_filters(void);
+void bench_spectrogram(void);
+void bench_wav(void);
+void bench_resampler(void);
+void bench_goertzel(void);
+void bench_xcorr(void);
+void bench_ring_buffer(void);
+void bench_dispatch(void);
+void bench_adaptive(void);
+void bench_cic(void);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,185 @@
+/*
+ * @file bench_adaptive.c
+ *
+ * Benchmark cases comparing the adaptive filters at the same order: LMS,
+ * RLS, fast transversal RLS and affine projection (projection 4). Each one
+ * identifies an unknown FIR plant driven by colored (first-order
+ * autoregressive) noise, the case where LMS converges slowly.
+ *
+ *   adaptive        steady-state cost on a 4096-sample block, param = order
+ *   adaptive_conv   time from reset until the error power stays 30 dB below
+ *                   the desired power, param = samples needed (-1: never
+ *                   within the test signal); one row per filter and order
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdio.h>
+#include "bench.h"
+#include "lms_filter.h"
+#include "rls_filter.h"
+#include "ap_filter.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define BLOCK_LEN 4096
+#define SIGNAL_LEN 65536
+#define AR_POLE 0.8
+#define CONV_WINDOW 256
+#define CONV_DB -30.0
+#define AP_PROJECTION 4
+
+static double input[SIGNAL_LEN];
+static double desired[SIGNAL_LEN];
+static double output[SIGNAL_LEN];
+
+typedef enum { ADAPT_LMS, ADAPT_RLS, ADAPT_FTRLS, ADAPT_AP, ADAPT_COUNT } AdaptKind;
+
+static const char *const adapt_names[ADAPT_COUNT] = { "lms", "rls", "ftrls", "ap4" };
+
+typedef struct {
+    AdaptKind kind;
+    LMSFilter lms;
+    RLSFilter rls;
+    FTRLSFilter ftrls;
+    APFilter ap;
+    size_t len;  /* samples per call of run_converge() */
+} AdaptCase;
+
+static void adapt_reset(AdaptCase *c) {
+    switch (c->kind) {
+    case ADAPT_LMS:   lms_filter_reset(&c->lms); break;
+    case ADAPT_RLS:   rls_filter_reset(&c->rls); break;
+    case ADAPT_FTRLS: ftrls_filter_reset(&c->ftrls); break;
+    default:          ap_filter_reset(&c->ap); break;
+    }
+}
+
+static void adapt_block(AdaptCase *c, size_t len) {
+    switch (c->kind) {
+    case ADAPT_LMS:   lms_filter_process_block(&c->lms, input, desired, output, len); break;
+    case ADAPT_RLS:   rls_filter_process_block(&c->rls, input, desired, output, len); break;
+    case ADAPT_FTRLS: ftrls_filter_process_block(&c->ftrls, input, desired, output, len); break;
+    default:          ap_filter_process_block(&c->ap, input, desired, output, len); break;
+    }
+}
+
+static void run_block(void *ctx) {
+    adapt_block(ctx, BLOCK_LEN);
+}
+
+static void run_converge(void *ctx) {
+    AdaptCase *c = ctx;
+    adapt_reset(c);
+    adapt_block(c, c->len);
+}
+
+/* Internal helper: first sample after which the moving error power stays
+ * below the threshold, or -1 */
+static long converge_point(AdaptCase *c, double threshold) {
+    adapt_reset(c);
+    adapt_block(c, SIGNAL_LEN);
+
+    double power = 0.0;
+    long last_above = 0;
+    for (long i = 0; i < SIGNAL_LEN; i++) {
+        double e = desired[i] - output[i];
+        power += e * e;
+        if (i >= CONV_WINDOW) {
+            double old = desired[i - CONV_WINDOW] - output[i - CONV_WINDOW];
+            power -= old * old;
+        }
+        if (i < CONV_WINDOW || power > threshold * CONV_WINDOW) last_above = i + 1;
+    }
+    return last_above < SIGNAL_LEN - CONV_WINDOW ? last_above : -1;
+}
+
+static int adapt_init(AdaptCase *c, AdaptKind kind, int order, double input_power) {
+    c->kind = kind;
+    switch (kind) {
+    case ADAPT_LMS:
+        // mu well inside the stability bound 1 / (order * input power)
+        return lms_filter_init(&c->lms, order, 0.05 / (order * input_power));
+    case ADAPT_RLS:
+        return rls_filter_init(&c->rls, order, 0.999, input_power);
+    case ADAPT_FTRLS:
+        return ftrls_filter_init(&c->ftrls, order, 0.999, input_power);
+    default:
+        return ap_filter_init(&c->ap, order, AP_PROJECTION, 0.5, 1e-3 * order * input_power);
+    }
+}
+
+static void adapt_free(AdaptCase *c) {
+    switch (c->kind) {
+    case ADAPT_LMS:   lms_filter_free(&c->lms); break;
+    case ADAPT_RLS:   rls_filter_free(&c->rls); break;
+    case ADAPT_FTRLS: ftrls_filter_free(&c->ftrls); break;
+    default:          ap_filter_free(&c->ap); break;
+    }
+}
+
+/******************************************************************************
+ * bench_adaptive
+ *
+ * @note Orders 16 and 64. The plant is an exponentially decaying random FIR
+ *       of the filter's order applied to past inputs, plus noise 60 dB down.
+ */
+void bench_adaptive(void) {
+    if (!bench_selected("adaptive")) return;
+
+    static const int orders[] = { 16, 64 };
+    for (size_t o = 0; o < sizeof(orders) / sizeof(orders[0]); o++) {
+        int order = orders[o];
+
+        // Fixed-seed uniform noise, colored by one real pole
+        unsigned int seed = 12345u;
+        double plant[64];
+        for (int k = 0; k < order; k++) {
+            seed = seed * 1664525u + 1013904223u;
+            plant[k] = ((double)seed / 4294967296.0 - 0.5) * exp(-4.0 * k / order);
+        }
+        double x = 0.0, input_power = 0.0, desired_power = 0.0;
+        for (int i = 0; i < SIGNAL_LEN; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            x = AR_POLE * x + ((double)seed / 4294967296.0 - 0.5);
+            input[i] = x;
+            input_power += x * x;
+        }
+        input_power /= SIGNAL_LEN;
+        for (int i = 0; i < SIGNAL_LEN; i++) {
+            double d = 0.0;
+            for (int k = 0; k < order && k < i; k++) {
+                d += plant[k] * input[i - k - 1];
+            }
+            desired[i] = d;
+            desired_power += d * d;
+        }
+        desired_power /= SIGNAL_LEN;
+        for (int i = 0; i < SIGNAL_LEN; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            desired[i] += 1e-3 * sqrt(12.0 * desired_power) * ((double)seed / 4294967296.0 - 0.5);
+        }
+
+        double threshold = desired_power * pow(10.0, CONV_DB / 10.0);
+        for (int kind = 0; kind < ADAPT_COUNT; kind++) {
+            AdaptCase c;
+            if (adapt_init(&c, kind, order, input_power) != 0) return;
+
+            bench_run("adaptive", adapt_names[kind], order, BLOCK_LEN, run_block, &c);
+
+            long needed = converge_point(&c, threshold);
+            c.len = needed > 0 ? (size_t)needed : SIGNAL_LEN;
+            char variant[16];
+            snprintf(variant, sizeof(variant), "%s/%d", adapt_names[kind], order);
+            bench_run("adaptive_conv", variant, needed, c.len, run_converge, &c);
+
+            adapt_free(&c);
+        }
+    }
+}
+/* End of bench_adaptive() */
+/******************************************************************************/
@@ -0,0 +1,115 @@
+/*
+ * @file bench_cic.c
+ *
+ * Benchmark cases for the CIC decimator/interpolator and the running-sum
+ * moving average on 24-bit samples held in int32, block of 65536 input
+ * samples. The cost per sample should stay flat as the ratio or length
+ * grows. For reference, the resampler decimating 64x runs on the same
+ * signal converted to double (fast preset).
+ *
+ *   cic_decimate      param = ratio R, N = 4 stages, M = 1
+ *   cic_interpolate   param = ratio R, N = 4, samples = outputs per call
+ *   moving_average    param = length
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdint.h>
+#include "bench.h"
+#include "cic.h"
+#include "resampler.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define CIC_BLOCK 65536
+#define CIC_STAGES 4
+#define CIC_INPUT_BITS 24
+
+static int32_t cic_input[CIC_BLOCK];
+static int32_t cic_output[CIC_BLOCK];
+static double cic_input_f64[CIC_BLOCK];
+static double cic_output_f64[CIC_BLOCK];
+
+typedef struct {
+    CicFilter cic;
+    MovingAverage ma;
+    Resampler rs;
+    size_t len;    /* inputs per call */
+} CicCase;
+
+static void run_decimate(void *ctx) {
+    CicCase *c = ctx;
+    cic_decimate(&c->cic, cic_input, c->len, cic_output);
+}
+
+static void run_decimate_double(void *ctx) {
+    CicCase *c = ctx;
+    cic_decimate_double(&c->cic, cic_input, c->len, cic_output_f64);
+}
+
+static void run_interpolate(void *ctx) {
+    CicCase *c = ctx;
+    cic_interpolate(&c->cic, cic_input, c->len, cic_output);
+}
+
+static void run_moving_average(void *ctx) {
+    CicCase *c = ctx;
+    moving_average_process(&c->ma, cic_input, cic_output_f64, c->len);
+}
+
+static void run_resampler_64x(void *ctx) {
+    CicCase *c = ctx;
+    resampler_process(&c->rs, cic_input_f64, c->len, cic_output_f64, CIC_BLOCK);
+}
+
+/******************************************************************************
+ * bench_cic
+ *
+ * @note Decimation ratios 16, 64 and 1000; interpolation 16 and 64;
+ *       moving-average lengths 16, 1024 and 16384.
+ */
+void bench_cic(void) {
+    if (!bench_selected("cic") && !bench_selected("moving_average")) return;
+
+    for (int i = 0; i < CIC_BLOCK; i++) {
+        cic_input[i] = (int32_t)(8000000 * sin(0.001 * i) + 100000 * sin(0.7 * i));
+        cic_input_f64[i] = cic_input[i] / 8388608.0;
+    }
+
+    CicCase c;
+    c.len = CIC_BLOCK;
+    static const int dec_ratios[] = { 16, 64, 1000 };
+    for (size_t r = 0; r < sizeof(dec_ratios) / sizeof(dec_ratios[0]); r++) {
+        if (!bench_selected("cic_decimate")) break;
+        if (cic_decimator_init(&c.cic, CIC_STAGES, dec_ratios[r], 1, CIC_INPUT_BITS) != 0) return;
+        bench_run("cic_decimate", "int32", dec_ratios[r], CIC_BLOCK, run_decimate, &c);
+        bench_run("cic_decimate", "double", dec_ratios[r], CIC_BLOCK, run_decimate_double, &c);
+    }
+    if (bench_selected("cic_decimate") && resampler_init(&c.rs, 64 * 1000, 1000, RESAMPLER_QUALITY_FAST) == 0) {
+        bench_run("cic_decimate", "resampler_ref", 64, CIC_BLOCK, run_resampler_64x, &c);
+        resampler_free(&c.rs);
+    }
+
+    static const int int_ratios[] = { 16, 64 };
+    for (size_t r = 0; r < sizeof(int_ratios) / sizeof(int_ratios[0]); r++) {
+        if (!bench_selected("cic_interpolate")) break;
+        if (cic_interpolator_init(&c.cic, CIC_STAGES, int_ratios[r], 1, CIC_INPUT_BITS) != 0) return;
+        c.len = CIC_BLOCK / int_ratios[r];
+        bench_run("cic_interpolate", "int32", int_ratios[r], CIC_BLOCK, run_interpolate, &c);
+    }
+
+    static const size_t lengths[] = { 16, 1024, 16384 };
+    c.len = CIC_BLOCK;
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        if (!bench_selected("moving_average")) break;
+        if (moving_average_init(&c.ma, lengths[l]) != 0) return;
+        bench_run("moving_average", "int32", (long)lengths[l], CIC_BLOCK, run_moving_average, &c);
+        moving_average_free(&c.ma);
+    }
+}
+/* End of bench_cic() */
+/******************************************************************************/
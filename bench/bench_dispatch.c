@@ -0,0 +1,139 @@
+/*
+ * @file bench_dispatch.c
+ *
+ * Benchmark cases for the runtime-dispatched SIMD kernels. Every level the
+ * CPU supports is first checked against the scalar kernels with
+ * dsp_kernels_verify() (a mismatch is reported on stderr and fails the
+ * run), then bound with dsp_cpu_set_level() and timed through the public
+ * entry points that use it. The level bound at startup is restored at the end.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "dsp_cpu.h"
+#include "fft.h"
+#include "fir_filter.h"
+#include "fixed_point.h"
+#include "spectrogram.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define DISPATCH_FFT 1024
+#define DISPATCH_TAPS 64
+#define DISPATCH_BLOCK 1024
+#define DISPATCH_BINS 2049
+
+typedef struct {
+    Complex input[DISPATCH_FFT];
+    Complex work[DISPATCH_FFT];
+    FIRFilter fir;
+    double block[DISPATCH_BLOCK];
+    Complex bins[DISPATCH_BINS];
+    double out[DISPATCH_BINS];
+    q15_t q15[DISPATCH_BLOCK];
+    q15_t q15_out[DISPATCH_BLOCK];
+    FIRFilterQ15 fir_q15;
+} DispatchCase;
+
+static void run_fft(void *ctx) {
+    DispatchCase *c = ctx;
+    memcpy(c->work, c->input, sizeof(c->work));
+    fft(c->work, DISPATCH_FFT);
+}
+
+static void run_fir(void *ctx) {
+    DispatchCase *c = ctx;
+    fir_filter_process_block(&c->fir, c->block, c->out, DISPATCH_BLOCK);
+}
+
+static void run_fir_q15(void *ctx) {
+    DispatchCase *c = ctx;
+    fir_q15_process_block(&c->fir_q15, c->q15, c->q15_out, DISPATCH_BLOCK);
+}
+
+static void run_magnitude(void *ctx) {
+    DispatchCase *c = ctx;
+    spectrogram_convert_bins(c->bins, c->out, DISPATCH_BINS, NULL);
+}
+
+static void run_convert(void *ctx) {
+    DispatchCase *c = ctx;
+    q15_from_double(c->block, c->q15, DISPATCH_BLOCK);
+    q15_to_double(c->q15, c->out, DISPATCH_BLOCK);
+}
+
+/******************************************************************************
+ * bench_dispatch
+ *
+ * @note 1024-point FFT, 64-tap FIR (double and Q15) over 1024 samples,
+ *       2049 magnitude bins and a 1024-sample Q15 round trip at every
+ *       supported level.
+ */
+void bench_dispatch(void) {
+    if (!bench_selected("dispatch")) return;
+
+    DispatchCase *c = malloc(sizeof(*c));
+    if (!c) return;
+
+    double coeffs[DISPATCH_TAPS];
+    for (int i = 0; i < DISPATCH_TAPS; i++) {
+        coeffs[i] = 1.0 / DISPATCH_TAPS;
+    }
+    q15_t coeffs_q15[DISPATCH_TAPS];
+    q15_from_double(coeffs, coeffs_q15, DISPATCH_TAPS);
+    if (fir_filter_init(&c->fir, coeffs, DISPATCH_TAPS) != 0) {
+        free(c);
+        return;
+    }
+    if (fir_q15_init(&c->fir_q15, coeffs_q15, DISPATCH_TAPS) != 0) {
+        fir_filter_free(&c->fir);
+        free(c);
+        return;
+    }
+    for (int i = 0; i < DISPATCH_FFT; i++) {
+        c->input[i].real = sin(0.1 * i) + 0.25 * cos(0.37 * i);
+        c->input[i].imag = 0.0;
+    }
+    for (int i = 0; i < DISPATCH_BLOCK; i++) {
+        c->block[i] = 0.9 * sin(0.05 * i);
+    }
+    q15_from_double(c->block, c->q15, DISPATCH_BLOCK);
+    for (int k = 0; k < DISPATCH_BINS; k++) {
+        c->bins[k].real = cos(0.1 * k) * (k + 1);
+        c->bins[k].imag = sin(0.3 * k);
+    }
+
+    DspCpuLevel startup = dsp_cpu_level();
+    for (int l = 0; l < DSP_CPU_LEVEL_COUNT; l++) {
+        DspCpuLevel level = (DspCpuLevel)l;
+        const char *name = dsp_cpu_level_name(level);
+        int verify = dsp_kernels_verify(level);
+        if (verify < 0) continue;
+        if (verify > 0) {
+            fprintf(stderr, "dispatch: %s kernels differ from scalar\n", name);
+            bench_failed = 1;
+        }
+
+        dsp_cpu_set_level(level);
+        bench_run("dispatch_fft", name, DISPATCH_FFT, DISPATCH_FFT, run_fft, c);
+        bench_run("dispatch_fir", name, DISPATCH_TAPS, DISPATCH_BLOCK, run_fir, c);
+        bench_run("dispatch_fir_q15", name, DISPATCH_TAPS, DISPATCH_BLOCK, run_fir_q15, c);
+        bench_run("dispatch_magnitude", name, DISPATCH_BINS, DISPATCH_BINS, run_magnitude, c);
+        bench_run("dispatch_q15", name, DISPATCH_BLOCK, DISPATCH_BLOCK, run_convert, c);
+    }
+    dsp_cpu_set_level(startup);
+
+    fir_filter_free(&c->fir);
+    fir_q15_free(&c->fir_q15);
+    free(c);
+}
+/* End of bench_dispatch() */
+/******************************************************************************/
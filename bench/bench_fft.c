@@ -0,0 +1,68 @@
+/*
+ * @file bench_fft.c
+ *
+ * Benchmark cases for fft() and ifft() across power-of-two sizes.
+ * Each call restores the input from a saved copy so repeated transforms
+ * operate on the same well-scaled data; the copy is included in the time.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "fft.h"
+
+/******************************************************************************/
+/** local definitions **/
+typedef struct {
+    Complex *input;
+    Complex *work;
+    int n;
+} FftCase;
+
+static void run_fft(void *ctx) {
+    FftCase *c = ctx;
+    memcpy(c->work, c->input, c->n * sizeof(Complex));
+    fft(c->work, c->n);
+}
+
+static void run_ifft(void *ctx) {
+    FftCase *c = ctx;
+    memcpy(c->work, c->input, c->n * sizeof(Complex));
+    ifft(c->work, c->n);
+}
+
+/******************************************************************************
+ * bench_fft
+ *
+ * @note Sizes 8 .. 256 in steps of 2x (the codelet range), then 4x up to 65536.
+ */
+void bench_fft(void) {
+    if (!bench_selected("fft")) return;
+
+    for (int n = 8; n <= 65536; n = n < 256 ? 2 * n : 4 * n) {
+        FftCase c = { malloc(n * sizeof(Complex)), malloc(n * sizeof(Complex)), n };
+        if (!c.input || !c.work) {
+            free(c.input);
+            free(c.work);
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            c.input[i].real = sin(0.1 * i) + 0.25 * cos(0.37 * i);
+            c.input[i].imag = 0.0;
+        }
+
+        bench_run("fft", "forward", n, n, run_fft, &c);
+        bench_run("fft", "inverse", n, n, run_ifft, &c);
+
+        free(c.input);
+        free(c.work);
+    }
+}
+/* End of bench_fft() */
+/******************************************************************************/
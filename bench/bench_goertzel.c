@@ -0,0 +1,92 @@
+/*
+ * @file bench_goertzel.c
+ *
+ * Benchmark cases for sparse-bin monitoring: a Goertzel bank and a sliding
+ * DFT tracking 8 or 32 tones over one second of 16 kHz mono audio, against
+ * compute_spectrogram() with the same block length as the baseline.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "goertzel.h"
+#include "spectrogram.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define GZ_RATE 16000
+#define GZ_BLOCK 1024
+#define GZ_MAX_BINS 32
+#define GZ_MAX_ROWS (GZ_RATE / GZ_BLOCK + 1)
+
+typedef struct {
+    WavData wav;
+    GoertzelBank bank;
+    SlidingDFT sdft;
+    double power[GZ_MAX_ROWS * GZ_MAX_BINS];
+} GoertzelCase;
+
+static void run_spectrogram_baseline(void *ctx) {
+    GoertzelCase *c = ctx;
+    int frames, bins;
+    double **s = compute_spectrogram(&c->wav, GZ_BLOCK, GZ_BLOCK, WINDOW_HANN, &frames, &bins);
+    free_spectrogram(s, frames);
+}
+
+static void run_goertzel(void *ctx) {
+    GoertzelCase *c = ctx;
+    goertzel_bank_reset(&c->bank);
+    goertzel_bank_process_wav(&c->bank, &c->wav, c->power, GZ_MAX_ROWS);
+}
+
+static void run_sdft(void *ctx) {
+    GoertzelCase *c = ctx;
+    sdft_process_wav(&c->sdft, &c->wav, GZ_BLOCK, c->power, GZ_MAX_ROWS);
+}
+
+/******************************************************************************
+ * bench_goertzel
+ *
+ * @note param is the number of monitored bins.
+ */
+void bench_goertzel(void) {
+    if (!bench_selected("goertzel") && !bench_selected("sdft")) return;
+
+    static GoertzelCase c;
+    c.wav.sample_rate = GZ_RATE;
+    c.wav.num_channels = 1;
+    c.wav.bits_per_sample = 16;
+    c.wav.num_samples = GZ_RATE;
+    c.wav.samples = malloc(c.wav.num_samples * sizeof(int16_t));
+    if (!c.wav.samples) return;
+    for (size_t i = 0; i < c.wav.num_samples; i++) {
+        c.wav.samples[i] = (int16_t)(12000 * sin(2 * 3.14159265358979323846 * 697.0 * i / GZ_RATE));
+    }
+
+    bench_run("goertzel", "fft_baseline", GZ_BLOCK / 2 + 1, c.wav.num_samples,
+              run_spectrogram_baseline, &c);
+
+    double freqs[GZ_MAX_BINS];
+    for (int num_bins = 8; num_bins <= GZ_MAX_BINS; num_bins *= 4) {
+        for (int k = 0; k < num_bins; k++) {
+            freqs[k] = 300.0 + 200.0 * k;
+        }
+        if (goertzel_bank_init(&c.bank, freqs, num_bins, GZ_RATE, GZ_BLOCK, WINDOW_HANN) == 0) {
+            bench_run("goertzel", "bank", num_bins, c.wav.num_samples, run_goertzel, &c);
+            goertzel_bank_free(&c.bank);
+        }
+        if (sdft_init(&c.sdft, freqs, num_bins, GZ_RATE, GZ_BLOCK, SDFT_DEFAULT_DAMPING) == 0) {
+            bench_run("sdft", "sliding", num_bins, c.wav.num_samples, run_sdft, &c);
+            sdft_free(&c.sdft);
+        }
+    }
+
+    free_wav(&c.wav);
+}
+/* End of bench_goertzel() */
+/******************************************************************************/
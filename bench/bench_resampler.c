@@ -0,0 +1,56 @@
+/*
+ * @file bench_resampler.c
+ *
+ * Benchmark cases for resampler_process() converting 44.1 kHz to 48 kHz
+ * (arbitrary-ratio path) and 48 kHz to 16 kHz (exact rational path) at
+ * every quality preset.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "resampler.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define RS_BLOCK 4096
+
+static double rs_input[RS_BLOCK];
+static double rs_output[4 * RS_BLOCK];
+
+static void run_resampler(void *ctx) {
+    Resampler *rs = ctx;
+    resampler_process(rs, rs_input, RS_BLOCK, rs_output, 4 * RS_BLOCK);
+}
+
+/******************************************************************************
+ * bench_resampler
+ *
+ * @note param is the quality preset index (0 = fast .. 2 = high).
+ */
+void bench_resampler(void) {
+    if (!bench_selected("resampler")) return;
+
+    static const int rates[][2] = { { 44100, 48000 }, { 48000, 16000 } };
+    static const char *variants[] = { "44k1_to_48k", "48k_to_16k" };
+
+    for (int i = 0; i < RS_BLOCK; i++) {
+        rs_input[i] = sin(0.01 * i);
+    }
+
+    for (int r = 0; r < 2; r++) {
+        for (int q = RESAMPLER_QUALITY_FAST; q <= RESAMPLER_QUALITY_HIGH; q++) {
+            Resampler rs;
+            if (resampler_init(&rs, rates[r][0], rates[r][1], (ResamplerQuality)q) != 0) return;
+            bench_run("resampler", variants[r], q, RS_BLOCK, run_resampler, &rs);
+            resampler_free(&rs);
+        }
+    }
+}
+/* End of bench_resampler() */
+/******************************************************************************/
@@ -0,0 +1,221 @@
+/*
+ * @file bench_ring_buffer.c
+ *
+ * Benchmark cases for handing samples between threads: the lock-free SPSC
+ * RingBuffer against a mutex/condition-variable queue of the same capacity.
+ *
+ *   throughput  a producer thread pushes 64-sample blocks while the calling
+ *               thread filters them with a 32-tap FIR (zero-copy for the ring)
+ *   latency     round trip of one 64-sample block to an echo thread and back
+ *
+ * Waiting sides yield the CPU instead of spinning, so the numbers stay
+ * meaningful on machines with a single core.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "fir_filter.h"
+#include "ring_buffer.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define RB_CAPACITY 4096
+#define RB_BLOCK 64
+#define RB_TOTAL (1 << 18)
+#define RB_TAPS 32
+
+/* Baseline: bounded sample queue guarded by a mutex */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    double data[RB_CAPACITY];
+    size_t head;
+    size_t count;
+} LockedQueue;
+
+typedef struct {
+    int locked;                 /* 1 = LockedQueue variant */
+    RingBuffer ring[2];         /* [0] forward, [1] return path (latency) */
+    LockedQueue queue[2];
+    FIRFilter fir;
+    double block[RB_BLOCK];
+    double out[RB_BLOCK];
+    atomic_int stop;            /* ends the echo thread */
+} RingCase;
+
+static size_t queue_write(LockedQueue *q, const double *samples, size_t n) {
+    pthread_mutex_lock(&q->lock);
+    while (q->count + n > RB_CAPACITY) pthread_cond_wait(&q->changed, &q->lock);
+    for (size_t i = 0; i < n; i++) {
+        q->data[(q->head + q->count + i) % RB_CAPACITY] = samples[i];
+    }
+    q->count += n;
+    pthread_cond_broadcast(&q->changed);
+    pthread_mutex_unlock(&q->lock);
+    return n;
+}
+
+/* Read up to n samples; waits until at least one is queued or *stop is set */
+static size_t queue_read(LockedQueue *q, double *samples, size_t n, atomic_int *stop) {
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0 && !(stop && atomic_load(stop))) {
+        pthread_cond_wait(&q->changed, &q->lock);
+    }
+    if (n > q->count) n = q->count;
+    for (size_t i = 0; i < n; i++) {
+        samples[i] = q->data[(q->head + i) % RB_CAPACITY];
+    }
+    q->head = (q->head + n) % RB_CAPACITY;
+    q->count -= n;
+    pthread_cond_broadcast(&q->changed);
+    pthread_mutex_unlock(&q->lock);
+    return n;
+}
+
+static void *throughput_producer(void *arg) {
+    RingCase *c = arg;
+    double block[RB_BLOCK];
+    for (int i = 0; i < RB_BLOCK; i++) block[i] = (i & 7) * 0.125;
+
+    for (size_t sent = 0; sent < RB_TOTAL; sent += RB_BLOCK) {
+        if (c->locked) {
+            queue_write(&c->queue[0], block, RB_BLOCK);
+        } else {
+            size_t done = 0;
+            while ((done += ring_buffer_write(&c->ring[0], block + done, RB_BLOCK - done)) < RB_BLOCK) {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+static void run_throughput(void *ctx) {
+    RingCase *c = ctx;
+    pthread_t producer;
+    if (pthread_create(&producer, NULL, throughput_producer, c) != 0) return;
+
+    size_t received = 0;
+    while (received < RB_TOTAL) {
+        if (c->locked) {
+            size_t n = queue_read(&c->queue[0], c->block, RB_BLOCK, NULL);
+            fir_filter_process_block(&c->fir, c->block, c->out, n);
+            received += n;
+        } else {
+            size_t n;
+            const double *src = ring_buffer_read_acquire(&c->ring[0], &n);
+            if (n == 0) {
+                sched_yield();
+                continue;
+            }
+            if (n > RB_BLOCK) n = RB_BLOCK;
+            fir_filter_process_block(&c->fir, src, c->out, n);
+            ring_buffer_read_release(&c->ring[0], n);
+            received += n;
+        }
+    }
+    pthread_join(producer, NULL);
+}
+
+static void *latency_echo(void *arg) {
+    RingCase *c = arg;
+    double block[RB_BLOCK];
+    while (!atomic_load(&c->stop)) {
+        if (c->locked) {
+            size_t n = queue_read(&c->queue[0], block, RB_BLOCK, &c->stop);
+            if (n) queue_write(&c->queue[1], block, n);
+        } else {
+            size_t n = ring_buffer_read(&c->ring[0], block, RB_BLOCK);
+            if (n == 0) {
+                sched_yield();
+                continue;
+            }
+            while (ring_buffer_write(&c->ring[1], block, n) == 0) sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void run_latency(void *ctx) {
+    RingCase *c = ctx;
+    size_t received = 0;
+    if (c->locked) {
+        queue_write(&c->queue[0], c->block, RB_BLOCK);
+        while (received < RB_BLOCK) {
+            received += queue_read(&c->queue[1], c->out, RB_BLOCK - received, NULL);
+        }
+    } else {
+        ring_buffer_write(&c->ring[0], c->block, RB_BLOCK);
+        while (received < RB_BLOCK) {
+            size_t n = ring_buffer_read(&c->ring[1], c->out, RB_BLOCK - received);
+            if (n == 0) sched_yield();
+            received += n;
+        }
+    }
+}
+
+static void run_case(RingCase *c, int locked) {
+    c->locked = locked;
+    const char *variant = locked ? "mutex" : "spsc";
+
+    bench_run("ring_buffer_throughput", variant, RB_BLOCK, RB_TOTAL, run_throughput, c);
+
+    pthread_t echo;
+    atomic_store(&c->stop, 0);
+    if (pthread_create(&echo, NULL, latency_echo, c) != 0) return;
+    bench_run("ring_buffer_latency", variant, RB_BLOCK, RB_BLOCK, run_latency, c);
+
+    atomic_store(&c->stop, 1);
+    pthread_mutex_lock(&c->queue[0].lock);
+    pthread_cond_broadcast(&c->queue[0].changed);
+    pthread_mutex_unlock(&c->queue[0].lock);
+    pthread_join(echo, NULL);
+}
+
+/******************************************************************************
+ * bench_ring_buffer
+ *
+ * @note param is the block size; samples_per_call is RB_TOTAL for the
+ *       throughput cases and one block for the latency (round trip) cases.
+ */
+void bench_ring_buffer(void) {
+    if (!bench_selected("ring_buffer")) return;
+
+    static RingCase c;
+    double coeffs[RB_TAPS];
+    for (int i = 0; i < RB_TAPS; i++) coeffs[i] = 1.0 / RB_TAPS;
+    for (int i = 0; i < RB_BLOCK; i++) c.block[i] = i * (1.0 / RB_BLOCK);
+
+    if (fir_filter_init(&c.fir, coeffs, RB_TAPS) != 0) return;
+    if (ring_buffer_init(&c.ring[0], RB_CAPACITY) != 0 ||
+        ring_buffer_init(&c.ring[1], RB_CAPACITY) != 0) {
+        ring_buffer_free(&c.ring[0]);
+        fir_filter_free(&c.fir);
+        return;
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_mutex_init(&c.queue[i].lock, NULL);
+        pthread_cond_init(&c.queue[i].changed, NULL);
+    }
+
+    run_case(&c, 0);
+    run_case(&c, 1);
+
+    for (int i = 0; i < 2; i++) {
+        pthread_mutex_destroy(&c.queue[i].lock);
+        pthread_cond_destroy(&c.queue[i].changed);
+        ring_buffer_free(&c.ring[i]);
+    }
+    fir_filter_free(&c.fir);
+}
+/* End of bench_ring_buffer() */
+/******************************************************************************/
@@ -0,0 +1,240 @@
+/*
+ * @file bench_spectrogram.c
+ *
+ * Benchmark cases for compute_spectrogram() on a synthetic 10 second,
+ * 48 kHz mono chirp. Each call includes allocating and freeing the result.
+ * The bin-conversion cases compare the old sqrt + separate 20*log10 pass
+ * with the fused spectrogram_convert_bins() modes. The workspace case runs
+ * spectrogram_compute_into() with preallocated buffers and should report
+ * zero allocations, as do the quantized float16 / uint8 dB workspace cases
+ * (2 and 1 bytes per bin instead of 8). The Welch cases stream the same signal through a WelchPSD
+ * per averaging mode, then run welch_compute() on a pool of every CPU. The
+ * constant-Q cases time compute_cqt() (cached kernel) inline and on the pool.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "cqt.h"
+#include "spectrogram.h"
+#include "thread_pool.h"
+#include "welch.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define SPEC_RATE 48000
+#define SPEC_SECONDS 10
+
+#define CONVERT_BINS 2049
+
+typedef struct {
+    WavData wav;
+    int fft_size;
+    int hop_size;
+    SpectrogramOptions options;
+    SpectrogramWorkspace ws;
+    double *out;
+    void *quant;
+    SpectrogramQuantType quant_type;
+    int max_frames;
+    WelchPSD welch;
+    ThreadPool pool;
+    CqtConfig cqt;
+    ThreadPool *cqt_pool;
+} SpecCase;
+
+typedef struct {
+    Complex bins[CONVERT_BINS];
+    double out[CONVERT_BINS];
+    uint16_t half[CONVERT_BINS];
+    uint8_t codes[CONVERT_BINS];
+    SpectrogramOptions options;
+} ConvertCase;
+
+static void run_spectrogram(void *ctx) {
+    SpecCase *c = ctx;
+    int frames, bins;
+    double **s = compute_spectrogram(&c->wav, c->fft_size, c->hop_size, WINDOW_HANN, &frames, &bins);
+    free_spectrogram(s, frames);
+}
+
+static void run_spectrogram_mode(void *ctx) {
+    SpecCase *c = ctx;
+    int frames, bins;
+    double **s = compute_spectrogram_ex(&c->wav, c->fft_size, c->hop_size, WINDOW_HANN,
+                                        &c->options, &frames, &bins);
+    free_spectrogram(s, frames);
+}
+
+static void run_spectrogram_into(void *ctx) {
+    SpecCase *c = ctx;
+    spectrogram_compute_into(&c->ws, &c->wav, c->hop_size, NULL, c->out, c->max_frames);
+}
+
+static void run_spectrogram_quantized(void *ctx) {
+    SpecCase *c = ctx;
+    spectrogram_compute_into_quantized(&c->ws, &c->wav, c->hop_size, &c->options, c->quant_type,
+                                       c->quant, c->max_frames);
+}
+
+static void run_welch_push(void *ctx) {
+    SpecCase *c = ctx;
+    welch_reset(&c->welch);
+    welch_push(&c->welch, c->wav.samples, c->wav.num_samples);
+    welch_estimate(&c->welch, c->wav.sample_rate, c->out);
+}
+
+static void run_welch_compute(void *ctx) {
+    SpecCase *c = ctx;
+    welch_compute(&c->wav, c->fft_size, c->hop_size, WINDOW_HANN, WELCH_AVERAGE_MEAN, 0.0,
+                  &c->pool, c->out);
+}
+
+static void run_cqt(void *ctx) {
+    SpecCase *c = ctx;
+    int frames, bins;
+    double **s = compute_cqt(&c->wav, &c->cqt, c->hop_size, NULL, c->cqt_pool, &frames, &bins);
+    free_spectrogram(s, frames);
+}
+
+static void run_convert_two_pass(void *ctx) {
+    ConvertCase *c = ctx;
+    for (int k = 0; k < CONVERT_BINS; k++) {
+        c->out[k] = complex_mag(c->bins[k]);
+    }
+    for (int k = 0; k < CONVERT_BINS; k++) {
+        c->out[k] = 20 * log10(c->out[k] + 1e-10);
+    }
+}
+
+static void run_convert_fused(void *ctx) {
+    ConvertCase *c = ctx;
+    spectrogram_convert_bins(c->bins, c->out, CONVERT_BINS, &c->options);
+}
+
+static void run_convert_f16(void *ctx) {
+    ConvertCase *c = ctx;
+    spectrogram_convert_bins_f16(c->bins, c->half, CONVERT_BINS, &c->options);
+}
+
+static void run_convert_u8_db(void *ctx) {
+    ConvertCase *c = ctx;
+    spectrogram_convert_bins_u8_db(c->bins, c->codes, CONVERT_BINS, 0.5f, -100.0f);
+}
+
+/******************************************************************************
+ * bench_spectrogram
+ *
+ * @note fft_size 256, 1024 and 4096 with 75% overlap; the workspace path,
+ *       output modes and the bin conversion kernel at fft_size 4096;
+ *       Welch at fft_size 1024 with 50% overlap; constant-Q with 96 bins
+ *       from 32.7 Hz at 12 per octave, hop 2048 (param of the pool cases =
+ *       thread count).
+ */
+void bench_spectrogram(void) {
+    if (!bench_selected("spectrogram")) return;
+
+    SpecCase c;
+    c.wav.sample_rate = SPEC_RATE;
+    c.wav.num_channels = 1;
+    c.wav.bits_per_sample = 16;
+    c.wav.num_samples = SPEC_RATE * SPEC_SECONDS;
+    c.wav.samples = malloc(c.wav.num_samples * sizeof(int16_t));
+    if (!c.wav.samples) return;
+
+    for (size_t i = 0; i < c.wav.num_samples; i++) {
+        double t = (double)i / SPEC_RATE;
+        c.wav.samples[i] = (int16_t)(16000 * sin(2 * 3.14159265358979323846 * (200 + 400 * t) * t));
+    }
+
+    for (c.fft_size = 256; c.fft_size <= 4096; c.fft_size *= 4) {
+        c.hop_size = c.fft_size / 4;
+        bench_run("compute_spectrogram", "hann", c.fft_size, c.wav.num_samples, run_spectrogram, &c);
+    }
+
+    c.fft_size = 4096;
+    c.hop_size = 1024;
+    c.max_frames = spectrogram_frame_count(&c.wav, c.fft_size, c.hop_size);
+    c.out = malloc((size_t)c.max_frames * (c.fft_size / 2 + 1) * sizeof(double));
+    c.quant = malloc((size_t)c.max_frames * (c.fft_size / 2 + 1) * sizeof(uint16_t));
+    if (c.out && c.quant && spectrogram_workspace_init(&c.ws, c.fft_size, WINDOW_HANN) == 0) {
+        bench_run("spectrogram_into", "workspace", c.fft_size, c.wav.num_samples,
+                  run_spectrogram_into, &c);
+        spectrogram_options_init(&c.options, SPEC_MODE_MAGNITUDE);
+        c.quant_type = SPEC_QUANT_F16;
+        bench_run("spectrogram_into", "f16", c.fft_size, c.wav.num_samples,
+                  run_spectrogram_quantized, &c);
+        spectrogram_options_init(&c.options, SPEC_MODE_DB);
+        c.options.floor = -100.0;
+        c.options.ceiling = 60.0;
+        c.quant_type = SPEC_QUANT_U8_DB;
+        bench_run("spectrogram_into", "u8_db", c.fft_size, c.wav.num_samples,
+                  run_spectrogram_quantized, &c);
+        spectrogram_workspace_free(&c.ws);
+    }
+    free(c.out);
+    free(c.quant);
+
+    static const char *mode_names[] = { "magnitude", "power", "db" };
+    c.fft_size = 4096;
+    c.hop_size = 1024;
+    for (int mode = SPEC_MODE_MAGNITUDE; mode <= SPEC_MODE_DB; mode++) {
+        spectrogram_options_init(&c.options, (SpectrogramMode)mode);
+        bench_run("compute_spectrogram_ex", mode_names[mode], c.fft_size, c.wav.num_samples,
+                  run_spectrogram_mode, &c);
+    }
+
+    static ConvertCase conv;
+    for (int k = 0; k < CONVERT_BINS; k++) {
+        conv.bins[k].real = cos(0.1 * k) * (k + 1);
+        conv.bins[k].imag = sin(0.3 * k);
+    }
+    bench_run("spectrogram_bins", "mag_then_db", CONVERT_BINS, CONVERT_BINS, run_convert_two_pass, &conv);
+    for (int mode = SPEC_MODE_MAGNITUDE; mode <= SPEC_MODE_DB; mode++) {
+        spectrogram_options_init(&conv.options, (SpectrogramMode)mode);
+        bench_run("spectrogram_bins", mode_names[mode], CONVERT_BINS, CONVERT_BINS, run_convert_fused, &conv);
+    }
+    spectrogram_options_init(&conv.options, SPEC_MODE_MAGNITUDE);
+    bench_run("spectrogram_bins", "f16", CONVERT_BINS, CONVERT_BINS, run_convert_f16, &conv);
+    bench_run("spectrogram_bins", "u8_db", CONVERT_BINS, CONVERT_BINS, run_convert_u8_db, &conv);
+
+    static const char *average_names[] = { "mean", "exponential", "median" };
+    c.fft_size = 1024;
+    c.hop_size = 512;
+    c.out = malloc((c.fft_size / 2 + 1) * sizeof(double));
+    for (int avg = WELCH_AVERAGE_MEAN; c.out && avg <= WELCH_AVERAGE_MEDIAN; avg++) {
+        if (welch_init(&c.welch, c.fft_size, c.hop_size, WINDOW_HANN, (WelchAveraging)avg, 0.05) != 0) break;
+        bench_run("spectrogram_welch", average_names[avg], c.fft_size, c.wav.num_samples,
+                  run_welch_push, &c);
+        welch_free(&c.welch);
+    }
+    if (c.out && thread_pool_init(&c.pool, 0) == 0) {
+        bench_run("spectrogram_welch", "mean_pool", c.pool.num_threads, c.wav.num_samples,
+                  run_welch_compute, &c);
+        thread_pool_free(&c.pool);
+    }
+    free(c.out);
+
+    c.cqt = (CqtConfig){ SPEC_RATE, 32.703, 12, 96, WINDOW_HANN };
+    c.hop_size = 2048;
+    if (cqt_kernel_cached(&c.cqt)) {
+        c.cqt_pool = NULL;
+        bench_run("spectrogram_cqt", "hann", c.cqt.num_bins, c.wav.num_samples, run_cqt, &c);
+        if (thread_pool_init(&c.pool, 0) == 0) {
+            c.cqt_pool = &c.pool;
+            bench_run("spectrogram_cqt", "hann_pool", c.pool.num_threads, c.wav.num_samples,
+                      run_cqt, &c);
+            thread_pool_free(&c.pool);
+        }
+        cqt_kernel_cache_clear();
+    }
+
+    free_wav(&c.wav);
+}
+/* End of bench_spectrogram() */
+/******************************************************************************/
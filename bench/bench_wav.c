@@ -0,0 +1,70 @@
+/*
+ * @file bench_wav.c
+ *
+ * Benchmark cases for save_wav() and load_wav() throughput on a 10 second,
+ * 48 kHz mono file written to $TMPDIR (default /tmp).
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "wav.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define WAV_RATE 48000
+#define WAV_SECONDS 10
+
+typedef struct {
+    WavData wav;
+    char path[512];
+} WavCase;
+
+static void run_save(void *ctx) {
+    WavCase *c = ctx;
+    save_wav(c->path, &c->wav);
+}
+
+static void run_load(void *ctx) {
+    WavCase *c = ctx;
+    WavData loaded;
+    if (load_wav(c->path, &loaded) == 0) {
+        free_wav(&loaded);
+    }
+}
+
+/******************************************************************************
+ * bench_wav
+ *
+ * @note The temporary file is removed afterwards.
+ */
+void bench_wav(void) {
+    if (!bench_selected("wav")) return;
+
+    WavCase c;
+    const char *tmp = getenv("TMPDIR");
+    snprintf(c.path, sizeof(c.path), "%s/dsp_bench.wav", tmp ? tmp : "/tmp");
+
+    c.wav.sample_rate = WAV_RATE;
+    c.wav.num_channels = 1;
+    c.wav.bits_per_sample = 16;
+    c.wav.num_samples = WAV_RATE * WAV_SECONDS;
+    c.wav.samples = malloc(c.wav.num_samples * sizeof(int16_t));
+    if (!c.wav.samples) return;
+    for (size_t i = 0; i < c.wav.num_samples; i++) {
+        c.wav.samples[i] = (int16_t)(i * 7);
+    }
+
+    bench_run("save_wav", "pcm16", WAV_SECONDS, c.wav.num_samples, run_save, &c);
+    bench_run("load_wav", "pcm16", WAV_SECONDS, c.wav.num_samples, run_load, &c);
+
+    remove(c.path);
+    free_wav(&c.wav);
+}
+/* End of bench_wav() */
+/******************************************************************************/
@@ -0,0 +1,113 @@
+/*
+ * @file goertzel_example.c
+ *
+ * Example of sparse-bin detection with GoertzelBank and SlidingDFT:
+ *   1. Synthesizes the DTMF sequence "159#" (100 ms tones, 50 ms gaps) at 8 kHz
+ *   2. Decodes it with a Goertzel bank over the 8 DTMF frequencies, one
+ *      power row per 20 ms block
+ *   3. Tracks the same frequencies with a sliding DFT and prints the row and
+ *      column powers at the middle of the first tone
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stdio.h>
+#include <math.h>
+#include "goertzel.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define PI 3.14159265358979323846
+#define SAMPLE_RATE 8000
+#define TONE_SAMPLES 800
+#define GAP_SAMPLES 400
+#define BLOCK 160
+#define NUM_DIGITS 4
+#define NUM_SAMPLES (NUM_DIGITS * (TONE_SAMPLES + GAP_SAMPLES))
+#define MAX_BLOCKS (NUM_SAMPLES / BLOCK)
+
+static const double dtmf_freqs[8] = { 697, 770, 852, 941, 1209, 1336, 1477, 1633 };
+static const char dtmf_keys[4][4] = {
+    { '1', '2', '3', 'A' },
+    { '4', '5', '6', 'B' },
+    { '7', '8', '9', 'C' },
+    { '*', '0', '#', 'D' }
+};
+
+/* Key for one power row, or 0 when no row/column pair stands out */
+static char detect_key(const double *power) {
+    int row = 0, col = 4;
+    for (int k = 1; k < 4; k++) {
+        if (power[k] > power[row]) row = k;
+        if (power[k + 4] > power[col]) col = k + 4;
+    }
+    return (power[row] > 1.0 && power[col] > 1.0) ? dtmf_keys[row][col - 4] : 0;
+}
+
+/******************************************************************************
+ * main
+ *
+ * @returns 0 if successful, 1 if an error occurred
+ */
+int main() {
+    static const char digits[NUM_DIGITS] = { '1', '5', '9', '#' };
+    static double signal[NUM_SAMPLES];
+
+    // Synthesize the key sequence
+    for (int d = 0; d < NUM_DIGITS; d++) {
+        int row = 0, col = 0;
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++) {
+                if (dtmf_keys[r][c] == digits[d]) {
+                    row = r;
+                    col = c;
+                }
+            }
+        }
+        double *tone = signal + d * (TONE_SAMPLES + GAP_SAMPLES);
+        for (int i = 0; i < TONE_SAMPLES; i++) {
+            tone[i] = 0.25 * sin(2 * PI * dtmf_freqs[row] * i / SAMPLE_RATE) +
+                      0.25 * sin(2 * PI * dtmf_freqs[col + 4] * i / SAMPLE_RATE);
+        }
+    }
+
+    // Block-mode decode
+    GoertzelBank bank;
+    if (goertzel_bank_init(&bank, dtmf_freqs, 8, SAMPLE_RATE, BLOCK, WINDOW_HANN) != 0) {
+        fprintf(stderr, "Failed to initialize Goertzel bank\n");
+        return 1;
+    }
+    static double power[MAX_BLOCKS * 8];
+    size_t blocks = goertzel_bank_process(&bank, signal, NUM_SAMPLES, power, MAX_BLOCKS);
+    goertzel_bank_free(&bank);
+
+    printf("Decoded: ");
+    char last = 0;
+    for (size_t b = 0; b < blocks; b++) {
+        char key = detect_key(power + b * 8);
+        if (key && key != last) putchar(key);
+        last = key;
+    }
+    printf("\n");
+
+    // Sliding DFT: bins are current after every sample
+    SlidingDFT sdft;
+    if (sdft_init(&sdft, dtmf_freqs, 8, SAMPLE_RATE, BLOCK, SDFT_DEFAULT_DAMPING) != 0) {
+        fprintf(stderr, "Failed to initialize sliding DFT\n");
+        return 1;
+    }
+    sdft_process(&sdft, signal, TONE_SAMPLES / 2);
+    sdft_power(&sdft, power);
+    printf("Sliding DFT at %d ms:\n", 1000 * TONE_SAMPLES / 2 / SAMPLE_RATE);
+    for (int k = 0; k < 8; k++) {
+        printf("  %4.0f Hz (bin %2d): %8.2f\n", dtmf_freqs[k], sdft.bin_index[k], power[k]);
+    }
+    sdft_free(&sdft);
+
+    return 0;
+}
+/* End of main() */
+/******************************************************************************/
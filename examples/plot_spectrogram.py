@@ -1,14 +1,36 @@
-import pandas as pd
+import struct
 import numpy as np
 import matplotlib.pyplot as plt
 import sys
 
-csv_file = sys.argv[1] if len(sys.argv) > 1 else "./plots/spectrogram.csv"
+spec_file = sys.argv[1] if len(sys.argv) > 1 else "./plots/spectrogram.dsps"
 
-data = pd.read_csv(csv_file, header=None)
-S = data.values
-S = S.T
-S_db = 20 * np.log10(S + 1e-12)
+
+def load_dsps(path):
+    """Memory-map a binary spectrogram written by spectrogram_io.c."""
+    with open(path, "rb") as f:
+        header = f.read(64)
+    (magic, version, dtype, sample_rate, fft_size, hop_size, window,
+     num_bins, _, num_frames, payload_offset, scale, offset) = struct.unpack(
+        "<4sHHIIIIIIQQff", header[:56])
+    if magic != b"DSPS" or version != 1:
+        raise ValueError(f"{path}: not a DSPS v1 file")
+    np_dtype = {1: "<f4", 2: "<f8", 3: "<f2", 4: "u1"}[dtype]
+    S = np.memmap(path, dtype=np_dtype, mode="r", offset=payload_offset,
+                  shape=(num_frames, num_bins))
+    if dtype == 4:
+        # uint8 codes hold dB: offset + scale * code
+        S = offset + scale * S.astype(np.float32)
+    return S, sample_rate, hop_size, dtype == 4
+
+
+is_db = False
+if spec_file.endswith(".csv"):
+    S = np.loadtxt(spec_file, delimiter=",")
+else:
+    S, _, _, is_db = load_dsps(spec_file)
+S = np.asarray(S, dtype=np.float64).T
+S_db = S if is_db else 20 * np.log10(S + 1e-12)
 
 plt.figure(figsize=(10, 4))
 plt.imshow(S_db, aspect='auto', origin='lower', cmap='magma')
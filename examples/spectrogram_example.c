@@ -3,8 +3,9 @@
  *
  * Example program to compute and visualize a spectrogram from a mono WAV file.
  *   1. Loads a mono WAV file from disk
- *   2. Computes a magnitude spectrogram using short-time FFT
- *   3. Saves the spectrogram to a CSV file
+ *   2. Streams magnitude frames from the short-time FFT straight into a
+ *      binary spectrogram file (float32, see spectrogram_io.h)
+ *   3. Maps the file back and prints the loudest bin of the middle frame
  *   4. Launches a Python script to visualize the result
  *
  * Created on: Jun 16, 2025
@@ -18,6 +19,18 @@
 #include <stdlib.h>
 #include "wav.h"
 #include "spectrogram.h"
+#include "spectrogram_io.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define OUTPUT_PATH "plots/spectrogram.dsps"
+
+/* Frame consumer: append each magnitude row to the open writer */
+static int write_frame(int frame, const double *bins, int num_bins, void *user) {
+    (void)frame;
+    (void)num_bins;
+    return spec_writer_write_frame((SpecWriter *)user, bins);
+}
 
 /******************************************************************************/ 
 /* main function */
@@ -32,7 +45,7 @@
  *
  * @note
  * - Only mono WAV files are supported.
- * - Outputs spectrogram data to CSV for external plotting.
+ * - Outputs spectrogram data in the binary .dsps format for external plotting.
  * - Requires a Python script at examples/plot_spectrogram.py.
  *
  * @warning
@@ -59,40 +72,51 @@ int main(int argc, char *argv[]) {
 
     int fft_size = 1024;
     int hop_size = 256;
-    int num_frames, num_bins;
 
-    double **spectrogram = compute_spectrogram(&wav, fft_size, hop_size, WINDOW_HANN, &num_frames, &num_bins);
-    if (!spectrogram) {
-        printf("Failed to compute spectrogram\n");
+    SpecFileInfo info = {
+        .sample_rate = wav.sample_rate,
+        .fft_size = fft_size,
+        .hop_size = hop_size,
+        .window_type = WINDOW_HANN,
+        .num_bins = fft_size / 2 + 1,
+        .dtype = SPEC_DTYPE_F32,
+    };
+
+    SpecWriter writer;
+    if (spec_writer_open(&writer, OUTPUT_PATH, &info) != 0) {
+        perror("Failed to open output file");
         free_wav(&wav);
         return 1;
     }
 
-    FILE *f = fopen("plots/spectrogram.csv", "w");
-    if (!f) {
-        perror("Failed to open output CSV");
-        free_spectrogram(spectrogram, num_frames);
-        free_wav(&wav);
+    int num_frames = spectrogram_for_each_frame(&wav, fft_size, hop_size, WINDOW_HANN, NULL,
+                                                write_frame, &writer);
+    int close_ret = spec_writer_close(&writer);
+    free_wav(&wav);
+    if (num_frames < 0 || close_ret != 0) {
+        printf("Failed to compute spectrogram\n");
         return 1;
     }
 
-    /* Write spectrogram data to CSV */
-    for (int frame = 0; frame < num_frames; frame++) {
-        for (int bin = 0; bin < num_bins; bin++) {
-            fprintf(f, "%f", spectrogram[frame][bin]);
-            if (bin < num_bins - 1) fprintf(f, ",");
+    printf("Spectrogram saved: frames=%d bins=%d\n", num_frames, info.num_bins);
+
+    /* Random access through the memory-mapped reader */
+    SpecReader reader;
+    if (spec_reader_open(&reader, OUTPUT_PATH) == 0) {
+        const float *row = spec_reader_frame_f32(&reader, reader.info.num_frames / 2);
+        if (row) {
+            int peak = 0;
+            for (int bin = 1; bin < reader.info.num_bins; bin++) {
+                if (row[bin] > row[peak]) peak = bin;
+            }
+            printf("Middle frame peak: bin %d (%.1f Hz)\n", peak,
+                   (double)peak * reader.info.sample_rate / reader.info.fft_size);
         }
-        fprintf(f, "\n");
+        spec_reader_close(&reader);
     }
-    fclose(f);
-
-    printf("Spectrogram saved: frames=%d bins=%d\n", num_frames, num_bins);
-
-    free_spectrogram(spectrogram, num_frames);
-    free_wav(&wav);
 
     /* Launch Python script to plot spectrogram */
-    int ret = system("python3 examples/plot_spectrogram.py plots/spectrogram.csv");
+    int ret = system("python3 examples/plot_spectrogram.py " OUTPUT_PATH);
     if (ret != 0) {
         fprintf(stderr, "Failed to run plot_spectrogram.py\n");
     }
@@ -0,0 +1,62 @@
+/**
+ * @file ap_filter.h
+ * @brief Header file for the affine projection (AP) adaptive filter.
+ *
+ * Affine projection generalizes normalized LMS from the newest input vector
+ * to the last `projection` input vectors. Each update decorrelates colored
+ * input through a small projection x projection system, so it converges far
+ * faster than LMS on speech-like signals at about `projection` times the
+ * LMS cost. The object model and block API match LMSFilter.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+#ifndef AP_FILTER_H
+#define AP_FILTER_H
+
+#include <stddef.h>
+
+/* Largest projection order */
+#define AP_MAX_PROJECTION 32
+
+/* Streaming affine projection filter state */
+typedef struct {
+    int order;          /* number of adaptive taps */
+    int projection;     /* input vectors per update (1 = normalized LMS) */
+    double mu;          /* step size, 0 < mu <= 1 */
+    double delta;       /* regularization added to the Gram matrix diagonal */
+    double *weights;    /* filter weights [order] */
+    double *history;    /* past inputs, doubled circular buffer [2 * (order + projection - 1)] */
+    int index;          /* position of the newest past input */
+    double *desired;    /* recent desired samples, doubled circular buffer [2 * projection] */
+    int d_index;        /* position of the newest desired sample */
+    double *gram;       /* input vector inner products, carried between samples [projection^2] */
+    double *chol;       /* Cholesky factor of gram + delta I [projection^2] */
+    double *err;        /* a priori errors, then the solved step [projection] */
+    void *owned_mem;    /* block allocated by ap_filter_init(), NULL for caller memory */
+} APFilter;
+
+// Initialize a streaming AP filter; returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+int ap_filter_init(APFilter *filter, int order, int projection, double mu, double delta);
+
+// Bytes of caller memory ap_filter_init_mem() needs
+size_t ap_filter_mem_size(int order, int projection);
+
+// ap_filter_init() inside caller memory; performs no allocation
+int ap_filter_init_mem(APFilter *filter, int order, int projection, double mu, double delta,
+                       void *mem);
+
+// Zero weights and history
+void ap_filter_reset(APFilter *filter);
+
+// Predict from past inputs, adapt toward desired, then record input; returns the prediction
+double ap_filter_process_sample(APFilter *filter, double input, double desired);
+
+// Block form of ap_filter_process_sample()
+void ap_filter_process_block(APFilter *filter, const double *input, const double *desired,
+                             double *output, size_t num_samples);
+
+// Free allocated memory
+void ap_filter_free(APFilter *filter);
+
+#endif
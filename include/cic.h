@@ -0,0 +1,111 @@
+/*
+ * @file cic.h
+ *
+ * Header file for cic.c
+ *
+ * Multiplier-free filters for high-ratio sample rate changes, with a cost
+ * per sample that does not depend on their length:
+ *
+ *   CicFilter      cascaded integrator-comb (Hogenauer) decimator or
+ *                  interpolator: N integrators at the high rate and N combs
+ *                  with differential delay M at the low rate. Response
+ *                  (sin(pi R M f) / (R M sin(pi f)))^N at input-rate
+ *                  frequency f (decimator), so the passband droops; see
+ *                  cic_compensator_init().
+ *   MovingAverage  running-sum boxcar of any length, one add and one
+ *                  subtract per sample.
+ *
+ * Both work on int32 samples with 64-bit two's complement registers that
+ * are allowed to wrap: the structures are linear with integer taps, so the
+ * output is exact modulo 2^64 and therefore exact whenever it fits. Init
+ * checks that input_bits plus the bit growth N log2(R M) fits in 64 bits.
+ *
+ * The int32 outputs drop out_shift = ceil(log2(gain)) bits with rounding,
+ * so they stay within input_bits (gain <= 1, exactly 1 when R M is a power
+ * of two); the double outputs divide by the gain exactly.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef CIC_H_
+#define CIC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fir_filter.h"
+
+#define CIC_MAX_STAGES 8
+#define CIC_MAX_DELAY 2
+
+/* CIC decimator or interpolator state; needs no memory of its own */
+typedef struct {
+    int stages;         /* N, 1 .. CIC_MAX_STAGES */
+    int ratio;          /* R, rate change factor */
+    int delay;          /* M, differential delay of each comb, 1 or 2 */
+    int interpolate;    /* 0 = decimator, 1 = interpolator */
+    int phase;          /* decimator: inputs since the last output */
+    int out_shift;      /* bits dropped by the int32 outputs */
+    double scale;       /* 1 / gain, for the double outputs */
+    uint64_t integ[CIC_MAX_STAGES];                  /* integrator registers (mod 2^64) */
+    uint64_t comb[CIC_MAX_STAGES][CIC_MAX_DELAY];    /* comb delay lines, newest first */
+} CicFilter;
+
+/* Running-sum moving average */
+typedef struct {
+    int32_t *history;   /* last length inputs, circular [length] */
+    size_t length;      /* averaging length */
+    size_t index;       /* slot of the oldest input */
+    int64_t sum;        /* sum of history */
+    double scale;       /* 1 / length */
+    void *owned_mem;    /* block allocated by moving_average_init(), NULL for caller memory */
+} MovingAverage;
+
+// Decimate by ratio with stages N and delay M; returns 0, or -1 on invalid
+// arguments or if input_bits + N log2(R M) exceeds 64
+int cic_decimator_init(CicFilter *cic, int stages, int ratio, int delay, int input_bits);
+
+// Interpolate by ratio; same arguments and checks as cic_decimator_init()
+int cic_interpolator_init(CicFilter *cic, int stages, int ratio, int delay, int input_bits);
+
+// Zero all registers and the decimation phase
+void cic_reset(CicFilter *cic);
+
+// DC gain (R M)^N (decimator) or (R M)^N / R (interpolator)
+double cic_gain(const CicFilter *cic);
+
+// Decimator: consume n inputs, write the outputs due (at most n / R + 1); returns their count
+size_t cic_decimate(CicFilter *cic, const int32_t *input, size_t n, int32_t *output);
+size_t cic_decimate_double(CicFilter *cic, const int32_t *input, size_t n, double *output);
+
+// Interpolator: consume n inputs, write n * R outputs; returns n * R
+size_t cic_interpolate(CicFilter *cic, const int32_t *input, size_t n, int32_t *output);
+size_t cic_interpolate_double(CicFilter *cic, const int32_t *input, size_t n, double *output);
+
+// Droop compensator h[num_taps] for cic at its low rate: inverse CIC response
+// up to cutoff (cycles per low-rate sample, 0 < cutoff < 0.5), zero above,
+// Hamming-windowed, unit DC gain; returns 0 or -1 on invalid arguments
+int cic_compensator_design(const CicFilter *cic, double cutoff, double *h, size_t num_taps);
+
+// cic_compensator_design() into a new FIRFilter; returns 0, -1 (invalid) or -2 (allocation)
+int cic_compensator_init(FIRFilter *fir, const CicFilter *cic, double cutoff, size_t num_taps);
+
+// Initialize a moving average of length samples; returns 0, -1 (length 0) or -2 (allocation)
+int moving_average_init(MovingAverage *ma, size_t length);
+
+// Bytes of caller memory moving_average_init_mem() needs
+size_t moving_average_mem_size(size_t length);
+
+// moving_average_init() inside caller memory; performs no allocation
+int moving_average_init_mem(MovingAverage *ma, size_t length, void *mem);
+
+// Zero the history and the sum
+void moving_average_reset(MovingAverage *ma);
+
+// output[i] = mean of the last length inputs (zeros before the first ones)
+void moving_average_process(MovingAverage *ma, const int32_t *input, double *output, size_t n);
+
+// Free the block allocated by moving_average_init()
+void moving_average_free(MovingAverage *ma);
+
+#endif /* CIC_H_ */
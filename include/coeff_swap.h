@@ -0,0 +1,90 @@
+/*
+ * @file coeff_swap.h
+ *
+ * Header file for coeff_swap.c
+ *
+ * Lock-free hand-over of filter coefficients from a control thread to the
+ * thread that runs the filter (RCU-style publish, four buffers). The
+ * swapper holds COEFF_SWAP_SETS coefficient sets of one fixed size, and
+ * each set belongs to exactly one party at a time:
+ *
+ *   - the processing thread: the active set, plus the retired set while a
+ *     crossfade runs (or a spare set otherwise);
+ *   - the control thread: the set it is writing;
+ *   - both: the published ("ready") set, handed over by atomic exchange.
+ *
+ * The control thread fills its set and exchanges it with ready; the
+ * processing thread polls ready once per block and, if a fresh set is
+ * there, exchanges its spare for it. Neither side ever waits, allocates or
+ * touches a set it does not own. Publishing again before the processing
+ * thread polls replaces the pending set (latest wins). While a crossfade
+ * runs the processing thread has no spare, so a pending set is picked up
+ * at the first block boundary after the fade ends.
+ *
+ * The filter modules (fir_filter, iir_filter, the fixed-point biquads)
+ * wrap this with typed x_swap_init()/x_update() calls; exactly one control
+ * thread may call x_update() at a time.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef COEFF_SWAP_H_
+#define COEFF_SWAP_H_
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/* Coefficient sets per swapper: active, retired/spare, ready, writing */
+#define COEFF_SWAP_SETS 4
+
+/* Swapper state; lives at the start of its own memory block */
+typedef struct {
+    atomic_int ready;       /* shared: published set, | COEFF_SWAP_FRESH until picked up */
+    int writing;            /* control thread: set being filled */
+    int active;             /* processing thread: set in use */
+    int retired;            /* processing thread: set being faded out, -1 when none */
+    int spare;              /* processing thread: free set, -1 while fading */
+    size_t fade_len;        /* crossfade length in samples (0 = switch at the block boundary) */
+    size_t fade_pos;        /* samples of the running crossfade done */
+    unsigned char *sets;    /* COEFF_SWAP_SETS sets of set_size bytes */
+    size_t set_size;        /* bytes per set, a multiple of DSP_MEM_ALIGN */
+    void *owned_mem;        /* block allocated by coeff_swap_create(), NULL for caller memory */
+} CoeffSwap;
+
+// Bytes of caller memory coeff_swap_create_mem() needs for sets of set_size bytes
+size_t coeff_swap_mem_size(size_t set_size);
+
+// Lay a swapper out at the start of mem; returns it (set 0 active, all sets zeroed)
+CoeffSwap *coeff_swap_create_mem(size_t set_size, size_t fade_len, void *mem);
+
+// coeff_swap_create_mem() on a new heap block; NULL on allocation failure
+CoeffSwap *coeff_swap_create(size_t set_size, size_t fade_len);
+
+// Free the block of coeff_swap_create(); caller memory is left alone (NULL is a no-op)
+void coeff_swap_destroy(CoeffSwap *swap);
+
+// Set by index (DSP_MEM_ALIGN aligned)
+void *coeff_swap_set(const CoeffSwap *swap, int index);
+
+// Control thread: set to fill before coeff_swap_publish()
+void *coeff_swap_write_begin(CoeffSwap *swap);
+
+// Control thread: hand the filled set over; replaces a set not yet picked up
+void coeff_swap_publish(CoeffSwap *swap);
+
+// Processing thread, at a block boundary: take a fresh set; returns 1 if active changed
+int coeff_swap_poll(CoeffSwap *swap);
+
+// Processing thread: samples of the running crossfade still to go (0 when none)
+size_t coeff_swap_fade_left(const CoeffSwap *swap);
+
+// Processing thread: n faded samples done; releases the retired set at the end
+void coeff_swap_fade_advance(CoeffSwap *swap, size_t n);
+
+// Weight of the new set for sample i of the current block's fade: (fade_pos + i + 1) / fade_len
+static inline double coeff_swap_gain(const CoeffSwap *swap, size_t i) {
+    return (double)(swap->fade_pos + i + 1) / (double)swap->fade_len;
+}
+
+#endif /* COEFF_SWAP_H_ */
@@ -0,0 +1,89 @@
+/*
+ * @file cqt.h
+ *
+ * Header file for cqt.c
+ *
+ * Constant-Q transform after Brown & Puckette ("An efficient algorithm for
+ * the calculation of a constant Q transform", JASA 1992). Bin k is centred
+ * on fmin * 2^(k / bins_per_octave) and analyses a windowed complex
+ * exponential of Q cycles, so every bin has the same ratio of frequency to
+ * bandwidth. Rather than correlating each kernel in time, the frame is
+ * transformed once with rfft_execute() and multiplied by the precomputed
+ * spectral kernels. These are sparse (a few FFT bins per CQ bin) and stored
+ * as a CSR matrix.
+ *
+ * Frames follow compute_spectrogram(): frame f covers samples
+ * [f * hop_size, f * hop_size + fft_size), where fft_size is the longest
+ * kernel rounded up to a power of two, and every kernel is centred in it.
+ * Output rows are [num_frames][num_bins] in the spectrogram output modes.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef CQT_H_
+#define CQT_H_
+
+#include <stddef.h>
+#include "complex.h"
+#include "fft.h"
+#include "spectrogram.h"
+#include "thread_pool.h"
+#include "wav.h"
+#include "window.h"
+
+/* Spectral kernel coefficients below this magnitude are dropped (the
+ * threshold of Brown & Puckette); the kernel peak is about 0.5 for Hann */
+#define CQT_KERNEL_THRESHOLD 0.0054
+
+/* Constant-Q analysis configuration; also the kernel cache key */
+typedef struct {
+    int sample_rate;         /* input sample rate in Hz */
+    double fmin;             /* centre frequency of bin 0 in Hz */
+    int bins_per_octave;     /* e.g. 12 (semitones), 24, 36 */
+    int num_bins;            /* number of CQ bins; the last must lie below Nyquist */
+    WindowType window_type;  /* kernel window */
+} CqtConfig;
+
+/* Precomputed sparse spectral kernel; read-only once built */
+typedef struct {
+    CqtConfig cfg;
+    int fft_size;            /* frame length: longest kernel rounded up to a power of two */
+    double q;                /* quality factor 1 / (2^(1 / bins_per_octave) - 1) */
+    int nnz;                 /* stored coefficients */
+    int *row_start;          /* CSR row pointers: bin k uses [row_start[k], row_start[k + 1]) [num_bins + 1] */
+    int *col;                /* FFT bin (0 .. fft_size / 2) of each coefficient [nnz] */
+    Complex *val;            /* conj(spectral kernel) / fft_size [nnz] */
+    RFFTPlan plan;           /* real FFT tables for fft_size, in the same block */
+    void *owned_mem;         /* block allocated by cqt_kernel_init() */
+} CqtKernel;
+
+// Build the sparse kernel for cfg; returns 0, -1 (invalid configuration) or -2 (allocation)
+int cqt_kernel_init(CqtKernel *kernel, const CqtConfig *cfg);
+
+// Free a kernel built with cqt_kernel_init()
+void cqt_kernel_free(CqtKernel *kernel);
+
+// Shared kernel for cfg, built on first use (thread safe, kept until cqt_kernel_cache_clear()); NULL on error
+const CqtKernel *cqt_kernel_cached(const CqtConfig *cfg);
+
+// Free every cached kernel; pointers from cqt_kernel_cached() become invalid
+void cqt_kernel_cache_clear(void);
+
+// Centre frequency of bin k in Hz
+double cqt_bin_frequency(const CqtConfig *cfg, int k);
+
+// Transform one frame of fft_size samples: work [fft_size + 1] is scratch, out [num_bins] complex CQ bins
+void cqt_frame(const CqtKernel *kernel, const int16_t *samples, Complex *work, Complex *out);
+
+// Analysis into out[max_frames][num_bins] on a pool (NULL: calling thread); returns frames, -1 or -2 (scratch allocation)
+int cqt_compute_into(const CqtKernel *kernel, const WavData *wav, int hop_size,
+                     const SpectrogramOptions *options, ThreadPool *pool,
+                     double *out, int max_frames);
+
+// Whole-WAV constant-Q spectrogram [num_frames][num_bins]; free with free_spectrogram(), NULL on error
+double **compute_cqt(const WavData *wav, const CqtConfig *cfg, int hop_size,
+                     const SpectrogramOptions *options, ThreadPool *pool,
+                     int *out_num_frames, int *out_num_bins);
+
+#endif /* CQT_H_ */
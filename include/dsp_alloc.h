@@ -0,0 +1,92 @@
+/*
+ * @file dsp_alloc.h
+ *
+ * Header file for dsp_alloc.c
+ *
+ * Caller-supplied memory for the library objects. Every object with buffers
+ * has a pair
+ *
+ *     size_t x_mem_size(<sizes>);
+ *     int    x_init_mem(X *obj, <args>, void *mem);
+ *
+ * x_init_mem() lays all of the object's buffers out inside mem (at least
+ * x_mem_size() bytes, aligned for double; DSP_MEM_ALIGN for best results)
+ * and never touches the heap; the matching x_free() then only detaches the
+ * object. The plain x_init() functions allocate one block of x_mem_size()
+ * bytes and call x_init_mem() on it.
+ *
+ * DspArena is a bump allocator over one buffer for carving several objects
+ * at startup and releasing them together; DspPool hands out fixed-size
+ * blocks (e.g. one per voice or per channel) with O(1) alloc/release.
+ * Neither is thread safe.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef DSP_ALLOC_H_
+#define DSP_ALLOC_H_
+
+#include <stddef.h>
+
+/* Alignment of every arena allocation and of the sub-buffers inside an
+ * object's memory block (one cache line) */
+#define DSP_MEM_ALIGN 64
+#define DSP_MEM_ALIGN_UP(size) \
+    (((size_t)(size) + DSP_MEM_ALIGN - 1) & ~(size_t)(DSP_MEM_ALIGN - 1))
+
+/* Bump allocator over one buffer */
+typedef struct {
+    unsigned char *base;    /* start of the buffer */
+    size_t size;            /* buffer size in bytes */
+    size_t used;            /* bytes handed out so far */
+    void *owned_mem;        /* buffer allocated by dsp_arena_init(), NULL when caller-supplied */
+} DspArena;
+
+/* Fixed-size block pool over one buffer */
+typedef struct {
+    unsigned char *base;    /* start of the buffer */
+    size_t block_size;      /* bytes per block (rounded up to DSP_MEM_ALIGN) */
+    size_t num_blocks;      /* blocks in the pool */
+    size_t num_free;        /* blocks currently available */
+    void *free_list;        /* singly linked list threaded through free blocks */
+    void *owned_mem;        /* buffer allocated by dsp_pool_init(), NULL when caller-supplied */
+} DspPool;
+
+// Arena over buffer [size], or over a new heap block when buffer is NULL; returns 0, -1 or -2
+int dsp_arena_init(DspArena *arena, void *buffer, size_t size);
+
+// DSP_MEM_ALIGN-aligned (relative to the buffer start) block of size bytes; NULL when exhausted
+void *dsp_arena_alloc(DspArena *arena, size_t size);
+
+// Current fill level, for a later dsp_arena_rewind()
+size_t dsp_arena_mark(const DspArena *arena);
+
+// Release everything allocated after mark
+void dsp_arena_rewind(DspArena *arena, size_t mark);
+
+// Release every allocation
+void dsp_arena_reset(DspArena *arena);
+
+// Bytes still available (before alignment padding)
+size_t dsp_arena_remaining(const DspArena *arena);
+
+// Free the heap block if the arena owns one
+void dsp_arena_free(DspArena *arena);
+
+// Buffer size dsp_pool_init() needs for num_blocks blocks of block_size bytes
+size_t dsp_pool_mem_size(size_t block_size, size_t num_blocks);
+
+// Pool over buffer [dsp_pool_mem_size()], or a new heap block when buffer is NULL; returns 0, -1 or -2
+int dsp_pool_init(DspPool *pool, void *buffer, size_t block_size, size_t num_blocks);
+
+// Take one block; NULL when the pool is empty
+void *dsp_pool_alloc(DspPool *pool);
+
+// Return a block obtained from dsp_pool_alloc()
+void dsp_pool_release(DspPool *pool, void *block);
+
+// Free the heap block if the pool owns one
+void dsp_pool_free(DspPool *pool);
+
+#endif /* DSP_ALLOC_H_ */
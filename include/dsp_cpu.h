@@ -0,0 +1,133 @@
+/*
+ * @file dsp_cpu.h
+ *
+ * Header file for dsp_cpu.c
+ *
+ * Runtime CPU feature dispatch for the SIMD kernels. The library is built
+ * for the baseline target (no -march), and the hot loops call through a
+ * DspKernels table that is bound once, on first use, to the widest variant
+ * the running CPU supports: scalar, SSE2, AVX2 or AVX-512.
+ *
+ * Every variant performs the same IEEE operations in the same order as the
+ * scalar kernel (no FMA contraction, the dot product keeps eight partial
+ * sums in every variant), so results are bit-identical whichever table is
+ * bound. dsp_kernels_verify() checks this on the running machine.
+ *
+ * Setting the environment variable DSP_CPU to scalar, sse2, avx2 or avx512
+ * before the first call caps the bound level (for testing and for comparing
+ * variants); a level the CPU lacks falls back to the best supported one.
+ *
+ * The floating-point mode helpers set flush-to-zero / denormals-are-zero
+ * (MXCSR on x86, FPCR.FZ on AArch64) for the calling thread only. The block
+ * entry points of the filters and the resampler enter such a scope when the
+ * library policy is DSP_DENORMALS_FLUSH and restore the caller's mode on
+ * return; per-sample entry points never touch the mode.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef DSP_CPU_H_
+#define DSP_CPU_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "complex.h"
+
+/* Name of the override environment variable */
+#define DSP_CPU_ENV "DSP_CPU"
+
+/* Kernel instruction set levels, in increasing order of width */
+typedef enum {
+    DSP_CPU_SCALAR,   /* portable C */
+    DSP_CPU_SSE2,     /* 128-bit, x86 */
+    DSP_CPU_AVX2,     /* 256-bit, x86 */
+    DSP_CPU_AVX512,   /* 512-bit (AVX-512F), x86 */
+    DSP_CPU_LEVEL_COUNT
+} DspCpuLevel;
+
+/* Kernel table; all pointers are set in every table */
+typedef struct {
+    DspCpuLevel level;
+
+    // One radix-2 stage over x[n]: butterflies of span 2*half, twiddle[k * step]
+    void (*fft_stage)(Complex *x, const Complex *twiddle, int n, int half, int step);
+
+    // sum a[i] * b[i] (eight interleaved partial sums, then the tail in order)
+    double (*dot)(const double *a, const double *b, size_t n);
+
+    // sum c[i] * (lo[i * stride] +- hi[-i * stride]), stride 1 or 2, minus if subtract
+    // (partial sums as dot); may read lo[0 .. n*stride-1] and hi[-(n*stride-1) .. 0]
+    double (*dot_folded)(const double *c, const double *lo, const double *hi, size_t n,
+                         int stride, int subtract);
+
+    // sum a[i] * b[i] of int16 values in wrapping int32 arithmetic: exact
+    // whenever the true sum fits in int32 (the order of the adds is free)
+    int32_t (*dot_q15)(const int16_t *a, const int16_t *b, size_t n);
+
+    // out[i] = (samples[i] / 32768) * window[i] + 0i
+    void (*window_s16)(const int16_t *samples, const double *window, Complex *out, size_t n);
+
+    // out[i] = |bins[i]|^2 clamped to [lo, hi]
+    void (*power)(const Complex *bins, double *out, size_t n, double lo, double hi);
+
+    // out[i] = |bins[i]| clamped to [lo, hi]
+    void (*magnitude)(const Complex *bins, double *out, size_t n, double lo, double hi);
+
+    // out[i] = in[i] / 32768
+    void (*s16_to_double)(const int16_t *in, double *out, size_t n);
+
+    // out[i] = in[i] * 32768, rounded half away from zero and saturated
+    void (*double_to_s16)(const double *in, int16_t *out, size_t n);
+} DspKernels;
+
+// Kernel table in use; bound on first call (honouring DSP_CPU) and thread safe
+const DspKernels *dsp_kernels(void);
+
+// Highest level the running CPU and this build support
+DspCpuLevel dsp_cpu_detect(void);
+
+// Table for one level, or NULL if the CPU or the build lacks it
+const DspKernels *dsp_kernels_for(DspCpuLevel level);
+
+// Rebind dsp_kernels() to level; returns 0, or -1 if the level is unavailable
+int dsp_cpu_set_level(DspCpuLevel level);
+
+// Level of the table dsp_kernels() returns
+DspCpuLevel dsp_cpu_level(void);
+
+// "scalar", "sse2", "avx2" or "avx512"
+const char *dsp_cpu_level_name(DspCpuLevel level);
+
+// Compare every kernel of level with the scalar table; 0 if bit-identical,
+// 1 on a mismatch, -1 if the level is unavailable
+int dsp_kernels_verify(DspCpuLevel level);
+
+/* What the block entry points do with subnormal operands and results */
+typedef enum {
+    DSP_DENORMALS_KEEP,   /* IEEE gradual underflow (default) */
+    DSP_DENORMALS_FLUSH   /* flush to zero inside each block call */
+} DspDenormalPolicy;
+
+/* Floating-point control state saved by dsp_fp_flush_begin() */
+typedef struct {
+    uint32_t csr;   /* MXCSR or FPCR before the scope */
+    int changed;    /* non-zero if the scope wrote the register */
+} DspFpState;
+
+// Set the library-wide policy; takes effect at the next block call, any thread
+void dsp_set_denormal_policy(DspDenormalPolicy policy);
+
+// Current policy
+DspDenormalPolicy dsp_denormal_policy(void);
+
+// Enable flush-to-zero for this thread, saving the previous mode in saved
+void dsp_fp_flush_begin(DspFpState *saved);
+
+// dsp_fp_flush_begin() only if the policy is DSP_DENORMALS_FLUSH
+void dsp_fp_scope_begin(DspFpState *saved);
+
+// Restore the mode saved by dsp_fp_flush_begin() or dsp_fp_scope_begin()
+void dsp_fp_scope_end(const DspFpState *saved);
+
+#endif /* DSP_CPU_H_ */
@@ -0,0 +1,99 @@
+/*
+ * @file dsp_graph.h
+ *
+ * Header file for dsp_graph.c
+ *
+ * Lightweight block-processing graph. Nodes (WAV file or buffer sources and
+ * sinks, FIR, IIR, LMS, STFT, resampler, or a user callback) exchange mono
+ * blocks of up to block_size samples through edges that own a fixed ring of
+ * preallocated blocks, so memory is bounded by the graph shape, not by the
+ * signal length.
+ *
+ * Nodes can only consume nodes added before them, which keeps the graph
+ * acyclic and makes insertion order a valid schedule. dsp_graph_run() either
+ * fuses all nodes on the calling thread (one block per node per tick, cache
+ * friendly) or runs every node on its own thread with queue_depth blocks in
+ * flight per edge.
+ *
+ * Every node output feeds exactly one consumer. Inputs of a multi-input node
+ * are consumed in step even when their producers deliver different block
+ * lengths (e.g. a resampled branch joined with a direct one). Multichannel
+ * WAV sources are downmixed to mono.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef DSP_GRAPH_H_
+#define DSP_GRAPH_H_
+
+#include <stddef.h>
+#include "resampler.h"
+#include "stft.h"
+#include "window.h"
+
+#define DSP_GRAPH_MAX_NODES 32
+#define DSP_GRAPH_MAX_INPUTS 2
+
+/* Scheduling strategy */
+typedef enum {
+    DSP_GRAPH_FUSED,     /* all nodes on the calling thread, in insertion order */
+    DSP_GRAPH_THREADED   /* one thread per node, bounded queues between them */
+} DspGraphMode;
+
+typedef struct DspGraph DspGraph;
+
+/* User node: process num_in samples from each of inputs[] and return the
+ * number written to output (<= out_capacity), or a negative value to abort
+ * the run; a count above out_capacity aborts the run too. With several inputs num_in is the shortest block on offer; the
+ * rest of the longer ones comes in the next calls, so inputs stay sample
+ * aligned. The node ends when its first input ends. */
+typedef int (*DspNodeFn)(void *user, const double *const *inputs, int num_in,
+                         double *output, int out_capacity);
+
+// Create an empty graph; returns NULL on invalid arguments or allocation failure
+DspGraph *dsp_graph_create(int block_size, int queue_depth);
+
+// Source: mono downmix of a 16-bit WAV file streamed from disk; returns node id or negative
+int dsp_graph_add_wav_source(DspGraph *g, const char *filename);
+
+// Source: caller buffer of num_samples samples (must outlive the run); returns node id or negative
+int dsp_graph_add_buffer_source(DspGraph *g, const double *samples, size_t num_samples);
+
+// FIR filter node
+int dsp_graph_add_fir(DspGraph *g, int input, const double *coeffs, size_t num_taps);
+
+// IIR filter node (same coefficient layout as iir_init())
+int dsp_graph_add_iir(DspGraph *g, int input, int order, const double *a, const double *b);
+
+// LMS node: adapts input toward desired and outputs the prediction
+int dsp_graph_add_lms(DspGraph *g, int input, int desired, int order, double mu);
+
+// STFT analysis/resynthesis node with an optional spectral callback (latency fft_size;
+// at end of stream fft_size zeros are pushed through so the last input samples come out)
+int dsp_graph_add_stft(DspGraph *g, int input, int fft_size, int hop_size,
+                       WindowType window_type, StftFrameFn fn, void *user);
+
+// Sample-rate conversion node; at end of stream the filter delay (num_taps / 2 input
+// samples of zeros) is flushed so the output covers the whole input
+int dsp_graph_add_resampler(DspGraph *g, int input, int in_rate, int out_rate,
+                            ResamplerQuality quality);
+
+// Custom node with up to DSP_GRAPH_MAX_INPUTS inputs; out_capacity >= block_size
+int dsp_graph_add_node(DspGraph *g, const int *inputs, int num_inputs, int out_capacity,
+                       DspNodeFn fn, void *user);
+
+// Sink: 16-bit mono WAV file written as blocks arrive (rounded to nearest, clipped to [-1, 1))
+int dsp_graph_add_wav_sink(DspGraph *g, int input, const char *filename, int sample_rate);
+
+// Sink: caller buffer; samples beyond capacity are dropped, total stored in *written
+int dsp_graph_add_buffer_sink(DspGraph *g, int input, double *buffer, size_t capacity,
+                              size_t *written);
+
+// Run until every source is exhausted; returns 0 on success, negative on error
+int dsp_graph_run(DspGraph *g, DspGraphMode mode);
+
+// Free the graph and all node state
+void dsp_graph_free(DspGraph *g);
+
+#endif /* DSP_GRAPH_H_ */
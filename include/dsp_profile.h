@@ -0,0 +1,100 @@
+/*
+ * @file dsp_profile.h
+ *
+ * Header file for dsp_profile.c
+ *
+ * Optional hot-path instrumentation. When the library is built with
+ * DSP_PROFILE defined (make PROFILE=1) the instrumented entry points record
+ * call counts, nanosecond and cycle totals, a log2 latency histogram and
+ * bytes allocated per stage. Without DSP_PROFILE the macros expand to
+ * nothing and the query functions report zeros.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef DSP_PROFILE_H_
+#define DSP_PROFILE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Instrumented stages */
+typedef enum {
+    DSP_PROF_FFT,              /* fft() */
+    DSP_PROF_IFFT,             /* ifft() */
+    DSP_PROF_SPECTROGRAM,      /* compute_spectrogram(), whole call */
+    DSP_PROF_SPEC_WINDOW,      /* spectrogram: sample conversion + windowing */
+    DSP_PROF_SPEC_FFT,         /* spectrogram: per-frame FFT */
+    DSP_PROF_SPEC_MAGNITUDE,   /* spectrogram: magnitude computation */
+    DSP_PROF_WELCH,            /* welch_push(), welch_compute() */
+    DSP_PROF_CQT,              /* cqt_compute_into(), compute_cqt() */
+    DSP_PROF_FIR,              /* fir_filter_process_sample/_block() */
+    DSP_PROF_IIR,              /* iir_process_sample/_block() */
+    DSP_PROF_LMS,              /* lms_filter() */
+    DSP_PROF_RLS,              /* rls_/ftrls_filter_process_sample/_block() */
+    DSP_PROF_AP,               /* ap_filter_process_sample/_block() */
+    DSP_PROF_CIC,              /* cic_decimate/_interpolate(), moving_average_process() */
+    DSP_PROF_RESAMPLER,        /* resampler_process() */
+    DSP_PROF_LOAD_WAV,         /* load_wav() */
+    DSP_PROF_SAVE_WAV,         /* save_wav() */
+    DSP_PROF_COUNT
+} DspProfileId;
+
+/* Histogram bucket i counts calls lasting [2^i, 2^(i+1)) nanoseconds */
+#define DSP_PROF_HIST_BUCKETS 40
+
+/* Snapshot of one stage's counters */
+typedef struct {
+    uint64_t calls;            /* number of completed calls */
+    uint64_t total_ns;         /* summed wall time */
+    uint64_t min_ns;           /* fastest call (0 when no calls) */
+    uint64_t max_ns;           /* slowest call */
+    uint64_t total_cycles;     /* summed time-stamp counter ticks (x86 only, else 0) */
+    uint64_t bytes_allocated;  /* bytes requested from malloc/calloc */
+    uint64_t hist[DSP_PROF_HIST_BUCKETS]; /* log2 latency histogram */
+} DspProfileStats;
+
+/* Dump format for dsp_profile_dump() */
+typedef enum {
+    DSP_PROF_FORMAT_CSV,
+    DSP_PROF_FORMAT_JSON
+} DspProfileFormat;
+
+/* Start timestamp captured by DSP_PROFILE_BEGIN() */
+typedef struct {
+    uint64_t ns;
+    uint64_t cycles;
+} DspProfileMark;
+
+// Nonzero when the library was compiled with DSP_PROFILE
+int dsp_profile_enabled(void);
+
+// Stage name used in dumps (e.g. "fft")
+const char *dsp_profile_name(DspProfileId id);
+
+// Copy the counters of one stage; returns 0 on success, -1 on bad id
+int dsp_profile_get(DspProfileId id, DspProfileStats *out);
+
+// Zero every counter
+void dsp_profile_reset(void);
+
+// Write all stages as CSV or JSON; returns 0 on success
+int dsp_profile_dump(FILE *f, DspProfileFormat format);
+
+// Recording primitives used by the macros below
+DspProfileMark dsp_profile_begin(void);
+void dsp_profile_end(DspProfileId id, DspProfileMark mark);
+void dsp_profile_alloc(DspProfileId id, uint64_t bytes);
+
+#ifdef DSP_PROFILE
+#define DSP_PROFILE_BEGIN(id)        DspProfileMark dsp_prof_mark_##id = dsp_profile_begin()
+#define DSP_PROFILE_END(id)          dsp_profile_end(id, dsp_prof_mark_##id)
+#define DSP_PROFILE_ALLOC(id, bytes) dsp_profile_alloc(id, (uint64_t)(bytes))
+#else
+#define DSP_PROFILE_BEGIN(id)        ((void)0)
+#define DSP_PROFILE_END(id)          ((void)0)
+#define DSP_PROFILE_ALLOC(id, bytes) ((void)0)
+#endif
+
+#endif /* DSP_PROFILE_H_ */
@@ -10,9 +10,69 @@
 #ifndef FFT_H
 #define FFT_H
 
+#include <stddef.h>
 #include "complex.h"
 
+/* Precomputed tables for an iterative radix-2 complex FFT of length n */
+typedef struct {
+    int n;              /* transform length, power of two */
+    int *bitrev;        /* bit-reversal permutation [n] */
+    Complex *twiddle;   /* exp(-2*pi*i*k/n), k < n/2 [n/2] */
+    void *owned_mem;    /* block allocated by fft_plan_init(), NULL for caller memory */
+} FFTPlan;
+
+/* Real-input FFT of length n, computed as a complex FFT of length n/2 */
+typedef struct {
+    int n;              /* real transform length, power of two >= 4 */
+    FFTPlan half;       /* complex plan of length n/2 */
+    Complex *twiddle;   /* exp(-2*pi*i*k/n), k <= n/4 [n/4 + 1] */
+    void *owned_mem;    /* block allocated by rfft_plan_init(), NULL for caller memory */
+} RFFTPlan;
+
 void fft(Complex *x, int n);
 void ifft(Complex *x, int n);
 
+// Build a complex plan; returns 0 on success, -1 if n is not a power of two, -2 on allocation failure
+int fft_plan_init(FFTPlan *plan, int n);
+
+// Bytes of caller memory fft_plan_init_mem() needs (0 for an invalid length)
+size_t fft_plan_mem_size(int n);
+
+// fft_plan_init() inside caller memory; performs no allocation
+int fft_plan_init_mem(FFTPlan *plan, int n, void *mem);
+
+// Forward FFT in place using a plan
+void fft_execute(const FFTPlan *plan, Complex *x);
+
+// Inverse FFT (scaled by 1/n) in place using a plan
+void ifft_execute(const FFTPlan *plan, Complex *x);
+
+// Free a plan built with fft_plan_init()
+void fft_plan_free(FFTPlan *plan);
+
+// Build a real-input plan; returns 0 on success, -1 if n is not a power of two >= 4, -2 on allocation failure
+int rfft_plan_init(RFFTPlan *plan, int n);
+
+// Bytes of caller memory rfft_plan_init_mem() needs (0 for an invalid length)
+size_t rfft_plan_mem_size(int n);
+
+// rfft_plan_init() inside caller memory; performs no allocation
+int rfft_plan_init_mem(RFFTPlan *plan, int n, void *mem);
+
+// Forward real FFT: input [n] samples, output [n/2 + 1] bins
+void rfft_execute(const RFFTPlan *plan, const double *input, Complex *output);
+
+// Inverse real FFT (scaled by 1/n): spectrum [n/2 + 1] (overwritten) to output [n] samples
+void irfft_execute(const RFFTPlan *plan, Complex *spectrum, double *output);
+
+// Free a plan built with rfft_plan_init()
+void rfft_plan_free(RFFTPlan *plan);
+
+// Shared, lazily built plans (thread safe, kept until fft_plan_cache_clear()); NULL on error
+const FFTPlan *fft_plan_cached(int n);
+const RFFTPlan *rfft_plan_cached(int n);
+
+// Free every cached plan; no cached plan may be in use
+void fft_plan_cache_clear(void);
+
 #endif /* FFT_H */
\ No newline at end of file
@@ -0,0 +1,35 @@
+/*
+ * @file fft_codelets.h
+ *
+ * Header file for fft_codelets.c (generated by tools/gen_fft_codelets.py)
+ *
+ * Straight-line forward FFTs for the small power-of-two sizes. fft(),
+ * fft_execute() and the fft_rec() fallback use them directly for n up to
+ * FFT_CODELET_MAX, and fft_execute() runs the bit-reversed-input variant
+ * of size FFT_CODELET_LEAF as the leaf of larger transforms.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef FFT_CODELETS_H_
+#define FFT_CODELETS_H_
+
+#include "complex.h"
+
+/* Largest size with a codelet (must match the generator) */
+#define FFT_CODELET_MAX 128
+
+/* Leaf size used by fft_execute() for longer transforms */
+#define FFT_CODELET_LEAF 32
+
+/* In-place forward FFT of a fixed size */
+typedef void (*FFTCodelet)(Complex *x);
+
+// Codelet for n in natural order, or NULL if n has none
+FFTCodelet fft_codelet(int n);
+
+// Codelet for n whose input is in bit-reversed order (output natural), or NULL
+FFTCodelet fft_codelet_bitrev(int n);
+
+#endif /* FFT_CODELETS_H_ */
@@ -4,7 +4,7 @@
  * Header file for fir_filter.c
  *
  * Provides a structure and functions for a Finite Impulse Response (FIR) filter.
- * Includes initialization, reset, sample processing, and cleanup routines.
+ * Includes initialization, reset, sample and block processing, and cleanup routines.
  *
  * Created on: Jun 16, 2025
  * Author: Omri Kebede
@@ -13,17 +13,44 @@
 #define FIR_FILTER_H
 
 #include <stddef.h>
+#include "coeff_swap.h"
+
+/* Coefficient structure detected at init; picks the kernel that runs */
+typedef enum {
+    FIR_GENERIC,        /* plain dot product, num_taps multiplies */
+    FIR_SYMMETRIC,      /* h[i] == h[N-1-i]: mirrored samples pre-added */
+    FIR_ANTISYMMETRIC,  /* h[i] == -h[N-1-i]: mirrored samples pre-subtracted */
+    FIR_HALFBAND        /* symmetric, odd N, every even offset from the centre zero */
+} FIRStructure;
 
 typedef struct {
     double *coeffs;
     double *history;
     size_t num_taps;
     size_t history_index;
+    FIRStructure structure;
+    double *folded;     /* one coefficient per mirrored pair [num_folded] */
+    size_t num_folded;
+    size_t fold_first;  /* offset of the first folded tap (half-band: 0 or 1) */
+    double center;      /* middle tap of odd-length symmetric filters, else 0 */
+    void *owned_mem;    /* block allocated by fir_filter_init(), NULL for caller memory */
+    CoeffSwap *swap;    /* coefficient hot-swap, NULL until fir_filter_swap_init() */
 } FIRFilter;
 
 int fir_filter_init(FIRFilter *filter, const double *coeffs, size_t num_taps);
+size_t fir_filter_mem_size(size_t num_taps);
+int fir_filter_init_mem(FIRFilter *filter, const double *coeffs, size_t num_taps, void *mem);
 void fir_filter_reset(FIRFilter *filter);
 double fir_filter_process_sample(FIRFilter *filter, double input);
+void fir_filter_process_block(FIRFilter *filter, const double *input,
+                              double *output, size_t num_samples);
 void fir_filter_free(FIRFilter *filter);
 
+// Coefficient hot-swap: fir_filter_update() from a control thread, picked up
+// by the next fir_filter_process_block() with a crossfade of crossfade samples
+size_t fir_filter_swap_mem_size(size_t num_taps);
+int fir_filter_swap_init(FIRFilter *filter, size_t crossfade);
+int fir_filter_swap_init_mem(FIRFilter *filter, size_t crossfade, void *mem);
+int fir_filter_update(FIRFilter *filter, const double *coeffs);
+
 #endif
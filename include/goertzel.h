@@ -0,0 +1,117 @@
+/*
+ * @file goertzel.h
+ *
+ * Header file for goertzel.c
+ *
+ * Sparse-bin spectral monitoring: a Goertzel filter bank that reports the
+ * power of selected frequencies once per block, and a sliding DFT that keeps
+ * selected bins of an N-point DFT current after every sample. Both process
+ * all bins together (SSE2, four bins per pass) and cost O(1) per sample per
+ * bin, independent of the analysis length.
+ *
+ * Power values are |X|^2 on the same scale as the FFT bins used by
+ * compute_spectrogram() (samples scaled by 1/32768 for WavData input).
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef GOERTZEL_H_
+#define GOERTZEL_H_
+
+#include <stddef.h>
+#include "complex.h"
+#include "wav.h"
+#include "window.h"
+
+/* Default sliding DFT damping r: bounds round-off growth; the oldest sample in
+ * the window is weighted by r^N (0.999 for N = 1024) */
+#define SDFT_DEFAULT_DAMPING 0.999999
+
+/* Goertzel filter bank, block mode */
+typedef struct {
+    int num_bins;       /* requested bins */
+    int padded_bins;    /* num_bins rounded up to a multiple of 4 */
+    int block_size;     /* samples per analysis block */
+    double *coeff;      /* 2*cos(w) [padded_bins] */
+    double *window;     /* block weighting [block_size] */
+    double *s1;         /* state s[n-1] [padded_bins] */
+    double *s2;         /* state s[n-2] [padded_bins] */
+    int count;          /* samples accumulated in the current block */
+    void *owned_mem;    /* block allocated by goertzel_bank_init(), NULL for caller memory */
+} GoertzelBank;
+
+/* Sliding DFT over the most recent window_len samples */
+typedef struct {
+    int num_bins;       /* requested bins */
+    int padded_bins;    /* num_bins rounded up to a multiple of 4 */
+    int window_len;     /* DFT length N */
+    int *bin_index;     /* DFT bin k of each requested frequency [num_bins] */
+    double *tw_re;      /* r*cos(2*pi*k/N) [padded_bins] */
+    double *tw_im;      /* r*sin(2*pi*k/N) [padded_bins] */
+    double *s_re;       /* bin state, real part [padded_bins] */
+    double *s_im;       /* bin state, imaginary part [padded_bins] */
+    double *history;    /* last window_len input samples (circular) */
+    int history_index;  /* oldest sample in history */
+    double damping_n;   /* r^N, applied to the sample leaving the window */
+    double *delta;      /* per-chunk input differences (scratch) */
+    void *owned_mem;    /* block allocated by sdft_init(), NULL for caller memory */
+} SlidingDFT;
+
+// Initialize a Goertzel bank for freqs[num_bins] (Hz, need not be bin-centered); returns 0 on success
+int goertzel_bank_init(GoertzelBank *g, const double *freqs, int num_bins,
+                       int sample_rate, int block_size, WindowType window_type);
+
+// Bytes of caller memory goertzel_bank_init_mem() needs (0 on invalid arguments)
+size_t goertzel_bank_mem_size(int num_bins, int block_size);
+
+// goertzel_bank_init() inside caller memory; performs no allocation
+int goertzel_bank_init_mem(GoertzelBank *g, const double *freqs, int num_bins,
+                           int sample_rate, int block_size, WindowType window_type,
+                           void *mem);
+
+// Discard the partially accumulated block
+void goertzel_bank_reset(GoertzelBank *g);
+
+// Feed samples; writes num_bins powers per completed block to power_out, returns blocks completed
+size_t goertzel_bank_process(GoertzelBank *g, const double *input, size_t num_samples,
+                             double *power_out, size_t max_blocks);
+
+// Run the bank over a mono WAV (continuing the current block); returns blocks completed or -1
+int goertzel_bank_process_wav(GoertzelBank *g, const WavData *wav,
+                              double *power_out, size_t max_blocks);
+
+// Free allocated memory
+void goertzel_bank_free(GoertzelBank *g);
+
+// Initialize a sliding DFT; freqs are rounded to the nearest of window_len bins. Returns 0 on success
+int sdft_init(SlidingDFT *s, const double *freqs, int num_bins,
+              int sample_rate, int window_len, double damping);
+
+// Bytes of caller memory sdft_init_mem() needs (0 on invalid arguments)
+size_t sdft_mem_size(int num_bins, int window_len);
+
+// sdft_init() inside caller memory; performs no allocation
+int sdft_init_mem(SlidingDFT *s, const double *freqs, int num_bins,
+                  int sample_rate, int window_len, double damping, void *mem);
+
+// Clear history and bin state
+void sdft_reset(SlidingDFT *s);
+
+// Advance all bins by num_samples samples
+void sdft_process(SlidingDFT *s, const double *input, size_t num_samples);
+
+// Current bin values [num_bins], equal to the FFT of the last window_len samples when r = 1
+void sdft_get_bins(const SlidingDFT *s, Complex *bins_out);
+
+// Current bin powers [num_bins]
+void sdft_power(const SlidingDFT *s, double *power_out);
+
+// Track a mono WAV, writing num_bins powers every hop_size samples; returns frames written or -1
+int sdft_process_wav(SlidingDFT *s, const WavData *wav, int hop_size,
+                     double *power_out, size_t max_frames);
+
+// Free allocated memory
+void sdft_free(SlidingDFT *s);
+
+#endif /* GOERTZEL_H_ */
@@ -10,21 +10,56 @@
 #ifndef IIR_FILTER_H_
 #define IIR_FILTER_H_
 
+#include <stddef.h>
+#include "coeff_swap.h"
+
+/* Suggested anti-denormal offset for iir_set_denormal_offset() */
+#define IIR_DENORMAL_OFFSET 1e-20
+
 /* Structure containing IIR filter parameters and state information */
 typedef struct {
     int order;          /* filter order */
     double *a;          /* feedback coefficients array (a[0] assumed 1 and not stored) */
     double *b;          /* feedforward coefficients array (length order+1) */
-    double *x_history;  /* input samples history buffer */
-    double *y_history;  /* output samples history buffer */
+    double *x_history;  /* input samples history buffer (doubled, 2*(order+1)) */
+    double *y_history;  /* output samples history buffer (doubled, 2*order) */
+    int x_index;        /* position of newest input sample in x_history */
+    int y_index;        /* position of newest output sample in y_history */
+    double denormal_offset; /* added to stored outputs (0 = off) */
+    void *owned_mem;    /* block allocated by iir_init(), NULL for caller memory */
+    CoeffSwap *swap;    /* coefficient hot-swap, NULL until iir_swap_init() */
 } IIRFilter;
 
 // Initialize IIR filter struct, allocate memory, and copy coeffs
 int iir_init(IIRFilter *filter, int order, const double *a, const double *b);
 
+// Bytes of caller memory iir_init_mem() needs for a filter of this order
+size_t iir_mem_size(int order);
+
+// iir_init() inside caller memory [iir_mem_size(order)]; performs no allocation
+int iir_init_mem(IIRFilter *filter, int order, const double *a, const double *b, void *mem);
+
 // Process one input sample and return filtered output
 double iir_process_sample(IIRFilter *filter, double input);
 
+// Process a block of samples; output may alias input
+void iir_process_block(IIRFilter *filter, const double *input, double *output, size_t num_samples);
+
+// Add offset to every stored output so a silent input never decays into subnormals (0 disables)
+void iir_set_denormal_offset(IIRFilter *filter, double offset);
+
+// Bytes of caller memory iir_swap_init_mem() needs
+size_t iir_swap_mem_size(int order);
+
+// Enable iir_update() with a crossfade of crossfade samples; returns 0, -1 (already enabled) or -2
+int iir_swap_init(IIRFilter *filter, size_t crossfade);
+
+// iir_swap_init() inside caller memory [iir_swap_mem_size(order)]; performs no allocation
+int iir_swap_init_mem(IIRFilter *filter, size_t crossfade, void *mem);
+
+// Control thread: publish a[order+1], b[order+1] for the next block; lock-free, returns 0 or -1
+int iir_update(IIRFilter *filter, const double *a, const double *b);
+
 // Free allocated memory
 void iir_free(IIRFilter *filter);
 
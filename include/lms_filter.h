@@ -12,6 +12,18 @@
 #ifndef LMS_FILTER_H
 #define LMS_FILTER_H
 
+#include <stddef.h>
+
+/* Streaming LMS adaptive filter state */
+typedef struct {
+    int order;          /* number of adaptive taps */
+    double mu;          /* adaptation step size */
+    double *weights;    /* filter weights [order] */
+    double *history;    /* past inputs, doubled circular buffer [2 * order] */
+    int index;          /* position of the newest past input */
+    void *owned_mem;    /* block allocated by lms_filter_init(), NULL for caller memory */
+} LMSFilter;
+
 void lms_filter(
     const double *noisy_signal,
     const double *desired_signal,
@@ -22,4 +34,26 @@ void lms_filter(
     double *final_weights
 );
 
+// Initialize a streaming LMS filter; returns 0 on success, negative on error
+int lms_filter_init(LMSFilter *filter, int order, double mu);
+
+// Bytes of caller memory lms_filter_init_mem() needs
+size_t lms_filter_mem_size(int order);
+
+// lms_filter_init() inside caller memory; performs no allocation
+int lms_filter_init_mem(LMSFilter *filter, int order, double mu, void *mem);
+
+// Zero weights and history
+void lms_filter_reset(LMSFilter *filter);
+
+// Predict from past inputs, adapt toward desired, then record input; returns the prediction
+double lms_filter_process_sample(LMSFilter *filter, double input, double desired);
+
+// Block form of lms_filter_process_sample()
+void lms_filter_process_block(LMSFilter *filter, const double *input, const double *desired,
+                              double *output, size_t num_samples);
+
+// Free allocated memory
+void lms_filter_free(LMSFilter *filter);
+
 #endif 
@@ -0,0 +1,109 @@
+/*
+ * @file mfcc.h
+ *
+ * Header file for mfcc.c
+ *
+ * Mel filterbank stored as a sparse band matrix and a fused
+ * window/FFT/power/mel/log/DCT pipeline producing MFCC features per frame,
+ * per streamed block, or for a whole WavData buffer.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef MFCC_H_
+#define MFCC_H_
+
+#include <stddef.h>
+#include "complex.h"
+#include "fft.h"
+#include "wav.h"
+#include "window.h"
+
+/* Triangular mel filters as a sparse band matrix: filter m covers bins
+ * [start_bin[m], start_bin[m] + num_weights[m]) with weights starting at
+ * weights[offset[m]] */
+typedef struct {
+    int num_filters;   /* number of mel bands */
+    int num_bins;      /* spectrum length the bank applies to (fft_size/2 + 1) */
+    int *start_bin;    /* first non-zero bin of each filter */
+    int *num_weights;  /* number of non-zero bins of each filter */
+    int *offset;       /* index of each filter's first weight in weights[] */
+    double *weights;   /* packed non-zero weights of all filters */
+    void *owned_mem;   /* block allocated by mel_filterbank_init(), NULL for caller memory */
+} MelFilterbank;
+
+/* MFCC configuration; framing follows compute_spectrogram() */
+typedef struct {
+    int sample_rate;         /* input sample rate in Hz */
+    int fft_size;            /* frame length, power of two */
+    int hop_size;            /* frame advance in samples */
+    WindowType window_type;  /* analysis window */
+    int num_filters;         /* mel bands, e.g. 40 */
+    int num_ceps;            /* cepstral coefficients kept, <= num_filters */
+    double fmin;             /* lowest filter edge in Hz */
+    double fmax;             /* highest filter edge in Hz (<= sample_rate / 2) */
+} MfccConfig;
+
+/* MFCC extractor state; all buffers live in one block, allocated by mfcc_init()
+ * or supplied to mfcc_init_mem() */
+typedef struct {
+    MfccConfig cfg;
+    MelFilterbank fb;
+    double *window;          /* analysis window [fft_size] */
+    double *dct;             /* orthonormal DCT-II matrix [num_ceps][num_filters] */
+    Complex *fft_buffer;     /* FFT work buffer [fft_size] */
+    double *power;           /* power spectrum scratch [num_bins] */
+    double *log_mel;         /* log mel energies scratch [num_filters] */
+    double *pending;         /* streaming frame buffer [fft_size] */
+    int pending_fill;        /* samples currently held in pending */
+    FFTPlan plan;            /* FFT tables for fft_size */
+    void *owned_mem;         /* block allocated by mfcc_init(), NULL for caller memory */
+} Mfcc;
+
+// Build a mel filterbank for the given FFT geometry (HTK mel scale)
+int mel_filterbank_init(MelFilterbank *fb, int sample_rate, int fft_size,
+                        int num_filters, double fmin, double fmax);
+
+// Bytes of caller memory mel_filterbank_init_mem() needs
+size_t mel_filterbank_mem_size(int fft_size, int num_filters);
+
+// mel_filterbank_init() inside caller memory; performs no allocation
+int mel_filterbank_init_mem(MelFilterbank *fb, int sample_rate, int fft_size,
+                            int num_filters, double fmin, double fmax, void *mem);
+
+// Apply the filterbank to a power spectrum [num_bins] -> mel energies [num_filters]
+void mel_filterbank_apply(const MelFilterbank *fb, const double *power, double *mel_out);
+
+// Free filterbank memory
+void mel_filterbank_free(MelFilterbank *fb);
+
+// Initialize an MFCC extractor; returns 0 on success
+int mfcc_init(Mfcc *m, const MfccConfig *cfg);
+
+// Bytes of caller memory mfcc_init_mem() needs (0 on invalid configuration)
+size_t mfcc_mem_size(const MfccConfig *cfg);
+
+// mfcc_init() inside caller memory; performs no allocation
+int mfcc_init_mem(Mfcc *m, const MfccConfig *cfg, void *mem);
+
+// Compute MFCCs of one frame of fft_size samples in [-1, 1)
+void mfcc_process_frame(Mfcc *m, const double *frame, double *ceps);
+
+// Stream samples; writes up to max_frames rows of num_ceps, returns rows written
+size_t mfcc_process_block(Mfcc *m, const double *input, size_t num_samples,
+                          double *ceps_out, size_t max_frames);
+
+// Drop any buffered streaming samples
+void mfcc_reset(Mfcc *m);
+
+// Free extractor memory
+void mfcc_free(Mfcc *m);
+
+// Whole-buffer MFCCs of a mono WAV: [num_frames][num_ceps], NULL on error
+double **compute_mfcc(const WavData *wav, const MfccConfig *cfg, int *out_num_frames);
+
+// Free the result of compute_mfcc()
+void free_mfcc(double **mfcc, int num_frames);
+
+#endif /* MFCC_H_ */
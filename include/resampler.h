@@ -0,0 +1,77 @@
+/*
+ * @file resampler.h
+ *
+ * Header file for resampler.c
+ *
+ * Provides a streaming polyphase sample-rate converter for rational and
+ * arbitrary conversion ratios, plus a one-shot helper for WavData buffers.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef RESAMPLER_H_
+#define RESAMPLER_H_
+
+#include <stddef.h>
+#include "wav.h"
+
+/* Quality presets trading filter length (taps per phase) for speed; when
+ * decimating, the taps are multiplied by ceil(in_rate / out_rate), up to 4096 */
+typedef enum {
+    RESAMPLER_QUALITY_FAST,   /* 8 taps per phase, 32 phases, linear interpolation */
+    RESAMPLER_QUALITY_MEDIUM, /* 16 taps per phase, 128 phases, linear interpolation */
+    RESAMPLER_QUALITY_HIGH    /* 32 taps per phase, 256 phases, cubic interpolation */
+} ResamplerQuality;
+
+/* Coefficient interpolation between neighbouring polyphase branches */
+typedef enum {
+    RESAMPLER_INTERP_NONE,   /* exact rational ratio: one branch per output phase */
+    RESAMPLER_INTERP_LINEAR, /* linear blend of two adjacent branches */
+    RESAMPLER_INTERP_CUBIC   /* Catmull-Rom blend of four adjacent branches */
+} ResamplerInterp;
+
+/* Streaming resampler state. All buffers live in one block, allocated by
+ * resampler_init() or supplied to resampler_init_mem() */
+typedef struct {
+    int in_rate;            /* input sample rate in Hz */
+    int out_rate;           /* output sample rate in Hz */
+    size_t num_taps;        /* taps per polyphase branch (even) */
+    size_t num_phases;      /* number of polyphase branches */
+    ResamplerInterp interp; /* branch interpolation mode */
+    double *bank;           /* (num_phases + 3) x num_taps coefficients, branch-major */
+    double *history;        /* doubled delay line (2 * num_taps) */
+    size_t history_index;   /* write position inside the delay line */
+    unsigned long long step;  /* input advance per output, in 1/den input samples */
+    unsigned long long den;   /* denominator of the reduced ratio (output rate units) */
+    unsigned long long acc;   /* fractional position of the next output, in 1/den */
+    void *owned_mem;          /* block allocated by resampler_init(), NULL for caller memory */
+} Resampler;
+
+// Initialize resampler for in_rate -> out_rate with the given quality preset
+int resampler_init(Resampler *rs, int in_rate, int out_rate, ResamplerQuality quality);
+
+// Bytes of caller memory resampler_init_mem() needs (0 on invalid arguments)
+size_t resampler_mem_size(int in_rate, int out_rate, ResamplerQuality quality);
+
+// resampler_init() inside caller memory; performs no allocation
+int resampler_init_mem(Resampler *rs, int in_rate, int out_rate, ResamplerQuality quality,
+                       void *mem);
+
+// Clear the delay line and phase accumulator
+void resampler_reset(Resampler *rs);
+
+// Upper bound on output samples produced for num_in input samples
+size_t resampler_max_output(const Resampler *rs, size_t num_in);
+
+// Resample a block; returns number of output samples written
+size_t resampler_process(Resampler *rs, const double *input, size_t num_in,
+                         double *output, size_t max_out);
+
+// Resample a 16-bit WavData buffer (any channel count) to out_rate
+int resample_wav(const WavData *in, int out_rate, ResamplerQuality quality, WavData *out);
+
+// Free allocated memory
+void resampler_free(Resampler *rs);
+
+#endif /* RESAMPLER_H_ */
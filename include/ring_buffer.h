@@ -0,0 +1,102 @@
+/*
+ * @file ring_buffer.h
+ *
+ * Header file for ring_buffer.c
+ *
+ * Wait-free single-producer/single-consumer ring buffer of double samples
+ * for handing audio between a capture thread and a DSP thread without locks
+ * (no priority inversion, bounded time per call).
+ *
+ * The producer owns head, the consumer owns tail; each index lives on its
+ * own cache line together with the owner's cached copy of the other index,
+ * so the two sides only touch shared lines when their cached view runs out.
+ *
+ * Besides copying read/write calls, the acquire/commit calls expose the
+ * next contiguous region of the buffer so a block can be produced or
+ * consumed in place (zero-copy). ring_buffer_fir()/ring_buffer_iir() run the
+ * filter block APIs straight from one ring into another.
+ *
+ * Exactly one thread may call the producer functions and one thread the
+ * consumer functions at a time.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include "fir_filter.h"
+#include "iir_filter.h"
+
+#define RING_BUFFER_CACHE_LINE 64
+
+/* SPSC ring buffer state */
+typedef struct {
+    /* producer side */
+    _Alignas(RING_BUFFER_CACHE_LINE) atomic_size_t head;  /* total samples written */
+    size_t cached_tail;                                   /* producer's view of tail */
+
+    /* consumer side */
+    _Alignas(RING_BUFFER_CACHE_LINE) atomic_size_t tail;  /* total samples read */
+    size_t cached_head;                                   /* consumer's view of head */
+
+    /* read-only after init */
+    _Alignas(RING_BUFFER_CACHE_LINE) double *data;        /* sample storage [capacity] */
+    size_t capacity;                                      /* power of two */
+    size_t mask;                                          /* capacity - 1 */
+    void *owned_mem;                                      /* storage allocated by ring_buffer_init(), NULL for caller memory */
+} RingBuffer;
+
+/* Block processing callback for ring_buffer_transfer(); output never aliases input */
+typedef void (*RingBlockFn)(void *state, const double *input, double *output, size_t n);
+
+// Allocate a ring holding at least min_capacity samples (rounded up to a power of two)
+int ring_buffer_init(RingBuffer *rb, size_t min_capacity);
+
+// Bytes of caller memory ring_buffer_init_mem() needs (0 on invalid capacity)
+size_t ring_buffer_mem_size(size_t min_capacity);
+
+// ring_buffer_init() inside caller memory; performs no allocation
+int ring_buffer_init_mem(RingBuffer *rb, size_t min_capacity, void *mem);
+
+// Discard all contents (only while neither side is running)
+void ring_buffer_reset(RingBuffer *rb);
+
+// Samples the consumer can read / free space the producer can write (snapshot)
+size_t ring_buffer_read_available(RingBuffer *rb);
+size_t ring_buffer_write_available(RingBuffer *rb);
+
+// Producer: contiguous writable region; *count receives its length (0 when full)
+double *ring_buffer_write_acquire(RingBuffer *rb, size_t *count);
+
+// Producer: publish n samples written into the acquired region
+void ring_buffer_write_commit(RingBuffer *rb, size_t n);
+
+// Consumer: contiguous readable region; *count receives its length (0 when empty)
+const double *ring_buffer_read_acquire(RingBuffer *rb, size_t *count);
+
+// Consumer: release n samples of the acquired region back to the producer
+void ring_buffer_read_release(RingBuffer *rb, size_t n);
+
+// Producer: copy up to n samples in; returns samples written
+size_t ring_buffer_write(RingBuffer *rb, const double *samples, size_t n);
+
+// Consumer: copy up to n samples out; returns samples read
+size_t ring_buffer_read(RingBuffer *rb, double *samples, size_t n);
+
+// Move up to max samples from in to out through fn without copying; returns samples moved
+// The caller must be the consumer of in and the producer of out
+size_t ring_buffer_transfer(RingBuffer *in, RingBuffer *out, size_t max,
+                            RingBlockFn fn, void *state);
+
+// ring_buffer_transfer() through fir_filter_process_block() / iir_process_block()
+size_t ring_buffer_fir(RingBuffer *in, RingBuffer *out, FIRFilter *filter, size_t max);
+size_t ring_buffer_iir(RingBuffer *in, RingBuffer *out, IIRFilter *filter, size_t max);
+
+// Free allocated memory
+void ring_buffer_free(RingBuffer *rb);
+
+#endif /* RING_BUFFER_H_ */
@@ -0,0 +1,104 @@
+/**
+ * @file rls_filter.h
+ * @brief Header file for the recursive least squares (RLS) adaptive filters.
+ *
+ * Two streaming filters with the object model and block API of LMSFilter:
+ * the prediction comes from the previous `order` inputs, the weights adapt
+ * toward `desired`, then the input is recorded.
+ *
+ *   RLSFilter    exponentially weighted RLS with an explicit inverse input
+ *                correlation matrix, O(order^2) per sample. Convergence does
+ *                not depend on the input's eigenvalue spread.
+ *   FTRLSFilter  stabilized fast transversal RLS, O(order) per sample. It
+ *                tracks forward and backward predictors instead of the matrix.
+ *                If the conversion factor leaves (0, 1], the predictors are
+ *                re-initialized and the weights kept (they pause for order + 1
+ *                samples while the predictors restart).
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+#ifndef RLS_FILTER_H
+#define RLS_FILTER_H
+
+#include <stddef.h>
+
+/* Streaming RLS adaptive filter state */
+typedef struct {
+    int order;          /* number of adaptive taps */
+    double lambda;      /* forgetting factor, 0 < lambda <= 1 */
+    double delta;       /* initial inverse correlation is I / delta */
+    double *weights;    /* filter weights [order] */
+    double *P;          /* inverse input correlation, row-major [order * stride] */
+    int stride;         /* row length of P, order rounded up to a cache line */
+    double *u;          /* scratch P x [order] */
+    double *history;    /* past inputs, doubled circular buffer [2 * order] */
+    int index;          /* position of the newest past input */
+    void *owned_mem;    /* block allocated by rls_filter_init(), NULL for caller memory */
+} RLSFilter;
+
+/* Streaming fast transversal RLS state */
+typedef struct {
+    int order;          /* number of adaptive taps */
+    double lambda;      /* forgetting factor, 0 < lambda < 1 */
+    double delta;       /* initial prediction error energies */
+    double *weights;    /* filter weights [order] */
+    double *fwd;        /* forward predictor [order] */
+    double *bwd;        /* backward predictor [order] */
+    double *gain;       /* normalized gain, one extra slot for the extended step [order + 1] */
+    double *history;    /* past inputs, doubled circular buffer [2 * (order + 1)] */
+    double *pred_history; /* predictor inputs: history, zeroed at a restart [2 * (order + 1)] */
+    int index;          /* position of the newest past input (both buffers) */
+    int warmup;         /* samples until the weights adapt again after a restart */
+    double gamma;       /* conversion factor, in (0, 1] */
+    double xi_f;        /* forward prediction error energy */
+    double xi_b;        /* backward prediction error energy */
+    unsigned long rescues; /* predictor re-initializations so far */
+    void *owned_mem;    /* block allocated by ftrls_filter_init(), NULL for caller memory */
+} FTRLSFilter;
+
+// Initialize a streaming RLS filter; returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+int rls_filter_init(RLSFilter *filter, int order, double lambda, double delta);
+
+// Bytes of caller memory rls_filter_init_mem() needs
+size_t rls_filter_mem_size(int order);
+
+// rls_filter_init() inside caller memory; performs no allocation
+int rls_filter_init_mem(RLSFilter *filter, int order, double lambda, double delta, void *mem);
+
+// Zero weights and history, restore P = I / delta
+void rls_filter_reset(RLSFilter *filter);
+
+// Predict from past inputs, adapt toward desired, then record input; returns the prediction
+double rls_filter_process_sample(RLSFilter *filter, double input, double desired);
+
+// Block form of rls_filter_process_sample()
+void rls_filter_process_block(RLSFilter *filter, const double *input, const double *desired,
+                              double *output, size_t num_samples);
+
+// Free allocated memory
+void rls_filter_free(RLSFilter *filter);
+
+// Initialize a fast transversal RLS filter; returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+int ftrls_filter_init(FTRLSFilter *filter, int order, double lambda, double delta);
+
+// Bytes of caller memory ftrls_filter_init_mem() needs
+size_t ftrls_filter_mem_size(int order);
+
+// ftrls_filter_init() inside caller memory; performs no allocation
+int ftrls_filter_init_mem(FTRLSFilter *filter, int order, double lambda, double delta, void *mem);
+
+// Zero weights, predictors and history
+void ftrls_filter_reset(FTRLSFilter *filter);
+
+// Predict from past inputs, adapt toward desired, then record input; returns the prediction
+double ftrls_filter_process_sample(FTRLSFilter *filter, double input, double desired);
+
+// Block form of ftrls_filter_process_sample()
+void ftrls_filter_process_block(FTRLSFilter *filter, const double *input, const double *desired,
+                                double *output, size_t num_samples);
+
+// Free allocated memory
+void ftrls_filter_free(FTRLSFilter *filter);
+
+#endif
@@ -10,9 +10,16 @@
 #ifndef SPECTROGRAM_H_
 #define SPECTROGRAM_H_
 
+#include <stddef.h>
+#include <stdint.h>
+#include "complex.h"
+#include "fft.h"
 #include "wav.h"
 #include "window.h"
 
+/* Lowest power fed to the dB conversion (-200 dB), so silent bins stay finite */
+#define SPECTROGRAM_DB_MIN_POWER 1e-20
+
 /* Contains spectrogram parameters and magnitude data */
 typedef struct {
     int numFrames;   /* number of time frames */
@@ -20,6 +27,51 @@ typedef struct {
     double **data;   /* pointer to 2D array of magnitudes [numFrames][numBins] */
 } Spectrogram;
 
+/* Output representation of each bin */
+typedef enum {
+    SPEC_MODE_MAGNITUDE,  /* |X| (default, matches compute_spectrogram()) */
+    SPEC_MODE_POWER,      /* |X|^2, no square root */
+    SPEC_MODE_DB          /* 10*log10(|X|^2) via a fast log, |error| < 1e-4 dB */
+} SpectrogramMode;
+
+/* Output options; see spectrogram_options_init() for the defaults */
+typedef struct {
+    SpectrogramMode mode;  /* output representation */
+    double floor;          /* outputs below floor are raised to it (output units) */
+    double ceiling;        /* outputs above ceiling are lowered to it (output units) */
+} SpectrogramOptions;
+
+/* Compact element types for quantized output */
+typedef enum {
+    SPEC_QUANT_F16,    /* IEEE float16 of the selected mode; relative error <= 2^-11, saturates at 65504 */
+    SPEC_QUANT_U8_DB   /* dB as offset + scale * code, codes 0..255 spanning [floor, ceiling] */
+} SpectrogramQuantType;
+
+/* Quantized spectrogram, row-major in one block */
+typedef struct {
+    SpectrogramQuantType type;
+    int num_frames;    /* number of time frames */
+    int num_bins;      /* number of frequency bins */
+    float scale;       /* uint8 dB: dB per code step (0 for float16) */
+    float offset;      /* uint8 dB: dB of code 0 (0 for float16) */
+    void *data;        /* uint16_t float16 bits or uint8_t codes [num_frames * num_bins] */
+} QuantizedSpectrogram;
+
+/* Reusable frame-loop buffers; with a workspace the analysis allocates nothing */
+typedef struct {
+    int fft_size;            /* frame length (power of two) */
+    int num_bins;            /* fft_size / 2 + 1 */
+    WindowType window_type;  /* analysis window */
+    double *window;          /* window coefficients [fft_size] */
+    Complex *fft_buffer;     /* FFT work space [fft_size] */
+    double *row;             /* output row for the callback form [num_bins] */
+    FFTPlan plan;            /* FFT tables, in the same memory block */
+    void *owned_mem;         /* block allocated by spectrogram_workspace_init(), NULL for caller memory */
+} SpectrogramWorkspace;
+
+/* Per-frame consumer for spectrogram_for_each_frame(); return non-zero to stop */
+typedef int (*SpectrogramFrameFn)(int frame, const double *bins, int num_bins, void *user);
+
 double **compute_spectrogram(const WavData *wav,
                              int fft_size,
                              int hop_size,
@@ -27,6 +79,88 @@ double **compute_spectrogram(const WavData *wav,
                              int *out_num_frames,
                              int *out_num_bins);
 
+// Same as compute_spectrogram() with a selectable output mode and clamping (options may be NULL)
+double **compute_spectrogram_ex(const WavData *wav,
+                                int fft_size,
+                                int hop_size,
+                                WindowType window_type,
+                                const SpectrogramOptions *options,
+                                int *out_num_frames,
+                                int *out_num_bins);
+
+// Set mode and disable clamping (floor -inf, ceiling +inf)
+void spectrogram_options_init(SpectrogramOptions *options, SpectrogramMode mode);
+
+// Fused conversion of FFT bins to the requested representation, one pass
+void spectrogram_convert_bins(const Complex *bins, double *out, int num_bins,
+                              const SpectrogramOptions *options);
+
 void free_spectrogram(double **spectrogram, int num_frames);
 
+// Scale and offset of uint8 dB codes over [options->floor, options->ceiling]; returns 0, or -1 if not finite and ordered
+int spectrogram_u8_db_range(const SpectrogramOptions *options, float *scale, float *offset);
+
+// spectrogram_convert_bins() rounded to float16 bit patterns, block by block
+void spectrogram_convert_bins_f16(const Complex *bins, uint16_t *out, int num_bins,
+                                  const SpectrogramOptions *options);
+
+// Fused power, dB and uint8 quantization (dB = offset + scale * code), one pass
+void spectrogram_convert_bins_u8_db(const Complex *bins, uint8_t *out, int num_bins,
+                                    float scale, float offset);
+
+// float16 encode (round to nearest even, saturating) and exact decode
+void spectrogram_double_to_f16(const double *in, uint16_t *out, size_t n);
+void spectrogram_f16_to_double(const uint16_t *in, double *out, size_t n);
+
+// uint8 dB encode (nearest code, clamped to 0..255) and decode
+void spectrogram_db_to_u8(const double *in, uint8_t *out, size_t n, float scale, float offset);
+void spectrogram_u8_to_db(const uint8_t *in, double *out, size_t n, float scale, float offset);
+
+// Whole-WAV quantized spectrogram; returns 0, -1 (invalid/too short) or -2 (allocation)
+int compute_spectrogram_quantized(const WavData *wav, int fft_size, int hop_size,
+                                  WindowType window_type, const SpectrogramOptions *options,
+                                  SpectrogramQuantType type, QuantizedSpectrogram *out);
+
+// Free the block of compute_spectrogram_quantized()
+void free_quantized_spectrogram(QuantizedSpectrogram *q);
+
+// Stream magnitude frames to a callback without materializing the spectrogram
+int spectrogram_for_each_frame(const WavData *wav,
+                               int fft_size,
+                               int hop_size,
+                               WindowType window_type,
+                               const SpectrogramOptions *options,
+                               SpectrogramFrameFn fn,
+                               void *user);
+
+// Number of frames the spectrogram functions produce for wav (0 if shorter than one frame)
+int spectrogram_frame_count(const WavData *wav, int fft_size, int hop_size);
+
+// Allocate a workspace for frames of fft_size; returns 0, -1 (invalid) or -2 (allocation)
+int spectrogram_workspace_init(SpectrogramWorkspace *ws, int fft_size, WindowType window_type);
+
+// Bytes of caller memory spectrogram_workspace_init_mem() needs (0 for an invalid size)
+size_t spectrogram_workspace_mem_size(int fft_size);
+
+// spectrogram_workspace_init() inside caller memory; performs no allocation
+int spectrogram_workspace_init_mem(SpectrogramWorkspace *ws, int fft_size,
+                                   WindowType window_type, void *mem);
+
+// Allocation-free analysis into out[max_frames][num_bins] (row-major); returns frames written or -1
+int spectrogram_compute_into(SpectrogramWorkspace *ws, const WavData *wav, int hop_size,
+                             const SpectrogramOptions *options, double *out, int max_frames);
+
+// Allocation-free quantized analysis into out[max_frames][num_bins] (uint16_t or uint8_t); returns frames written or -1
+int spectrogram_compute_into_quantized(SpectrogramWorkspace *ws, const WavData *wav,
+                                       int hop_size, const SpectrogramOptions *options,
+                                       SpectrogramQuantType type, void *out, int max_frames);
+
+// Allocation-free spectrogram_for_each_frame(); the row lives in the workspace
+int spectrogram_workspace_for_each_frame(SpectrogramWorkspace *ws, const WavData *wav,
+                                         int hop_size, const SpectrogramOptions *options,
+                                         SpectrogramFrameFn fn, void *user);
+
+// Free the block allocated by spectrogram_workspace_init()
+void spectrogram_workspace_free(SpectrogramWorkspace *ws);
+
 #endif /* SPECTROGRAM_H_ */
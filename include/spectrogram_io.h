@@ -0,0 +1,114 @@
+/*
+ * @file spectrogram_io.h
+ *
+ * Header file for spectrogram_io.c
+ *
+ * Compact binary spectrogram container ("DSPS"): a fixed 64-byte header
+ * followed by a 64-byte aligned, row-major payload of float32, float64,
+ * float16 or uint8 dB-coded bins. Frames can be streamed to disk as they are computed and read back
+ * through a memory map with O(1) random access.
+ *
+ * File layout (all header fields little-endian):
+ *   offset  size  field
+ *        0     4  magic "DSPS"
+ *        4     2  version (1)
+ *        6     2  dtype (SpecDtype)
+ *        8     4  sample_rate
+ *       12     4  fft_size
+ *       16     4  hop_size
+ *       20     4  window (WindowType)
+ *       24     4  num_bins
+ *       28     4  reserved (0)
+ *       32     8  num_frames
+ *       40     8  payload_offset (multiple of 64)
+ *       48     4  scale (float32; uint8 dB: dB per code, else 0)
+ *       52     4  offset (float32; uint8 dB: dB of code 0, else 0)
+ *       56     8  reserved (0)
+ *   payload_offset: num_frames rows of num_bins values in host (little-endian) order
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef SPECTROGRAM_IO_H_
+#define SPECTROGRAM_IO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "window.h"
+
+#define SPEC_FILE_HEADER_SIZE 64
+#define SPEC_FILE_VERSION 1
+
+/* Payload element type */
+typedef enum {
+    SPEC_DTYPE_F32 = 1,  /* 32-bit IEEE float */
+    SPEC_DTYPE_F64 = 2,  /* 64-bit IEEE float */
+    SPEC_DTYPE_F16 = 3,  /* 16-bit IEEE float (see spectrogram_double_to_f16()) */
+    SPEC_DTYPE_U8_DB = 4 /* dB = offset + scale * code (see spectrogram_db_to_u8()) */
+} SpecDtype;
+
+/* Metadata stored in the header */
+typedef struct {
+    int sample_rate;         /* sample rate of the analyzed audio */
+    int fft_size;            /* FFT size used for analysis */
+    int hop_size;            /* hop size used for analysis */
+    WindowType window_type;  /* analysis window */
+    int num_bins;            /* values per frame */
+    SpecDtype dtype;         /* payload element type */
+    float scale;             /* uint8 dB: dB per code step (spectrogram_u8_db_range()) */
+    float offset;            /* uint8 dB: dB of code 0 */
+    uint64_t num_frames;     /* frames in the payload (set by the writer on close) */
+} SpecFileInfo;
+
+/* Streaming writer */
+typedef struct {
+    FILE *f;
+    SpecFileInfo info;
+    void *row;               /* conversion scratch for float32/float16/uint8 payloads [num_bins] */
+} SpecWriter;
+
+/* Memory-mapped reader */
+typedef struct {
+    SpecFileInfo info;
+    void *map;                     /* mapping of the whole file */
+    size_t map_size;               /* mapping length in bytes */
+    const unsigned char *payload;  /* first byte of frame 0 */
+    size_t row_bytes;              /* bytes per frame */
+} SpecReader;
+
+// Create a file and write the header; frames follow with spec_writer_write_frame()
+int spec_writer_open(SpecWriter *w, const char *path, const SpecFileInfo *info);
+
+// Append one frame of num_bins values (converted to the file dtype)
+int spec_writer_write_frame(SpecWriter *w, const double *bins);
+
+// Append one frame already in the file dtype (e.g. from spectrogram_convert_bins_u8_db())
+int spec_writer_write_raw(SpecWriter *w, const void *row);
+
+// Patch the frame count into the header and close the file
+int spec_writer_close(SpecWriter *w);
+
+// Map a file for reading; returns 0 on success, negative on error
+int spec_reader_open(SpecReader *r, const char *path);
+
+// Direct pointer to a frame for float32 files (NULL on dtype mismatch or range error)
+const float *spec_reader_frame_f32(const SpecReader *r, uint64_t frame);
+
+// Direct pointer to a frame for float64 files (NULL on dtype mismatch or range error)
+const double *spec_reader_frame_f64(const SpecReader *r, uint64_t frame);
+
+// Direct pointer to a frame for float16 files (NULL on dtype mismatch or range error)
+const uint16_t *spec_reader_frame_f16(const SpecReader *r, uint64_t frame);
+
+// Direct pointer to a frame for uint8 dB files (NULL on dtype mismatch or range error)
+const uint8_t *spec_reader_frame_u8(const SpecReader *r, uint64_t frame);
+
+// Copy a frame into a double buffer whatever the file dtype (dequantized); returns 0 on success
+int spec_reader_read_frame(const SpecReader *r, uint64_t frame, double *out);
+
+// Unmap the file
+void spec_reader_close(SpecReader *r);
+
+#endif /* SPECTROGRAM_IO_H_ */
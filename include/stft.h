@@ -0,0 +1,91 @@
+/*
+ * @file stft.h
+ *
+ * Header file for stft.c
+ *
+ * Complex short-time Fourier transform and inverse STFT (weighted
+ * overlap-add), in whole-buffer form and as an allocation-free streaming
+ * analysis/synthesis object.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef STFT_H_
+#define STFT_H_
+
+#include <stddef.h>
+#include "complex.h"
+#include "fft.h"
+#include "wav.h"
+#include "window.h"
+
+/* Spectral processing hook for the streaming path: bins [num_bins] may be
+ * modified in place before resynthesis */
+typedef void (*StftFrameFn)(Complex *bins, int num_bins, void *user);
+
+/* Streaming STFT/ISTFT state. All buffers and the FFT plan live in one block,
+ * allocated by stft_stream_init() or supplied to stft_stream_init_mem() */
+typedef struct {
+    int fft_size;        /* frame length, power of two */
+    int hop_size;        /* frame advance, 1 .. fft_size */
+    int num_bins;        /* fft_size / 2 + 1 */
+    double *window;      /* analysis and synthesis window [fft_size] */
+    double *inv_norm;    /* 1 / sum of squared overlapping windows [hop_size] */
+    double *frame;       /* analysis frame, newest samples last [fft_size] */
+    double *overlap;     /* overlap-add accumulator [fft_size] */
+    Complex *fft_buffer; /* FFT work buffer [fft_size] */
+    Complex *spectrum;   /* bins handed to the callback [num_bins] */
+    double *in_hop;      /* samples collected towards the next hop [hop_size] */
+    double *out_hop;     /* last synthesized hop [hop_size] */
+    int fill;            /* samples held in in_hop */
+    FFTPlan plan;        /* FFT tables for fft_size */
+    void *owned_mem;     /* block allocated by stft_stream_init(), NULL for caller memory */
+} StftStream;
+
+// Whole-buffer complex STFT of a mono WAV: [num_frames][num_bins], same framing as compute_spectrogram()
+Complex **compute_stft(const WavData *wav,
+                       int fft_size,
+                       int hop_size,
+                       WindowType window_type,
+                       int *out_num_frames,
+                       int *out_num_bins);
+
+// Free the result of compute_stft()
+void free_stft(Complex **stft, int num_frames);
+
+// Whole-buffer inverse STFT into a caller buffer of output_len samples; returns 0 on success
+int istft(Complex *const *stft, int num_frames, int fft_size, int hop_size,
+          WindowType window_type, double *output, size_t output_len);
+
+// Whole-buffer inverse STFT into a newly allocated mono 16-bit WavData; returns 0 on success
+int istft_to_wav(Complex *const *stft, int num_frames, int fft_size, int hop_size,
+                 WindowType window_type, int sample_rate, WavData *out);
+
+// Initialize a streaming analysis/synthesis object; returns 0 on success
+int stft_stream_init(StftStream *s, int fft_size, int hop_size, WindowType window_type);
+
+// Bytes of caller memory stft_stream_init_mem() needs (0 on invalid arguments)
+size_t stft_stream_mem_size(int fft_size, int hop_size);
+
+// stft_stream_init() inside caller memory; performs no allocation
+int stft_stream_init_mem(StftStream *s, int fft_size, int hop_size, WindowType window_type,
+                         void *mem);
+
+// Clear all buffered samples
+void stft_stream_reset(StftStream *s);
+
+// Push hop_size samples and get the spectrum [num_bins] of the newest frame
+void stft_analyze(StftStream *s, const double *hop_in, Complex *bins_out);
+
+// Overlap-add one spectrum [num_bins] and emit hop_size finished samples
+void stft_synthesize(StftStream *s, const Complex *bins, double *hop_out);
+
+// Analyze, optionally process, and resynthesize any number of samples (latency fft_size)
+void stft_stream_process(StftStream *s, const double *input, double *output,
+                         size_t num_samples, StftFrameFn fn, void *user);
+
+// Free allocated memory
+void stft_stream_free(StftStream *s);
+
+#endif /* STFT_H_ */
@@ -0,0 +1,68 @@
+/*
+ * @file thread_pool.h
+ *
+ * Header file for thread_pool.c
+ *
+ * Work-stealing thread pool for parallel loops over independent tasks
+ * (files of a batch, channels, frequency bands). thread_pool_run() splits
+ * the task indices [0, num_tasks) into one contiguous range per worker;
+ * a worker takes tasks from the front of its own range and, once that is
+ * empty, steals the back half of another worker's range. Uneven task costs
+ * (short and long files) therefore balance without a shared queue.
+ *
+ * Workers are created once and sleep between runs. The calling thread
+ * takes part as worker 0, so a pool of one thread runs everything inline.
+ * Each task receives its worker index, which lets callers keep per-worker
+ * state (plans, windows, buffers) in an array indexed by it.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Largest num_tasks accepted by thread_pool_run() */
+#define THREAD_POOL_MAX_TASKS UINT32_MAX
+
+/* Task body: task in [0, num_tasks), worker in [0, num_threads) */
+typedef void (*ThreadPoolFn)(void *ctx, size_t task, int worker);
+
+/* Per-worker task range, one cache line each (opaque) */
+typedef struct ThreadPoolSlot ThreadPoolSlot;
+
+/* Thread pool state */
+typedef struct {
+    int num_threads;           /* workers including the calling thread */
+    pthread_t *threads;        /* helper threads [num_threads - 1] */
+    ThreadPoolSlot *slots;     /* task ranges [num_threads] */
+    pthread_mutex_t lock;
+    pthread_cond_t start;      /* signalled when a run begins or the pool stops */
+    pthread_cond_t done;       /* signalled when the last helper finishes a run */
+    unsigned long generation;  /* incremented per run */
+    int active;                /* helpers still working on the current run */
+    int stop;                  /* set by thread_pool_free() */
+    ThreadPoolFn fn;           /* current run */
+    void *ctx;
+} ThreadPool;
+
+// Start a pool of num_threads workers (0 = online CPUs); returns 0, -1 (invalid) or -2 (allocation/thread)
+int thread_pool_init(ThreadPool *pool, int num_threads);
+
+// Run fn for every task in [0, num_tasks) and wait for all of them; returns 0 or -1 (invalid)
+int thread_pool_run(ThreadPool *pool, size_t num_tasks, ThreadPoolFn fn, void *ctx);
+
+// Number of ranges workers stole during the last run
+size_t thread_pool_steals(const ThreadPool *pool);
+
+// Number of online CPUs (at least 1)
+int thread_pool_cpu_count(void);
+
+// Stop and join the workers
+void thread_pool_free(ThreadPool *pool);
+
+#endif /* THREAD_POOL_H_ */
@@ -9,18 +9,44 @@
 #ifndef WAV_H
 #define WAV_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+
+/* Largest RIFF chunk size; longer files are written as RF64 with a ds64
+ * chunk (EBU Tech 3306 / ITU-R BS.2088). Can be lowered at build time to
+ * exercise the RF64 path on small files. */
+#ifndef WAV_RIFF_MAX_SIZE
+#define WAV_RIFF_MAX_SIZE 0xFFFFFFFFull
+#endif
 
 /* Structure to hold WAV audio data */
 typedef struct {
     int sample_rate;       /* Sample rate in Hz */
     int num_channels;      /* Number of audio channels */
     uint16_t bits_per_sample; /* Bits per audio sample (should be 16) */
-    int num_samples;       /* Number of samples */
+    size_t num_samples;    /* Number of samples (all channels, interleaved) */
     int16_t *samples;      /* Pointer to audio samples */
 } WavData;
 
-/* Load a 16-bit PCM WAV file. Returns 0 on success, negative on error */
+/* Streaming reader: header parsed on open, samples read in blocks */
+typedef struct {
+    FILE *f;
+    int sample_rate;          /* Sample rate in Hz */
+    int num_channels;         /* Number of audio channels */
+    uint16_t bits_per_sample; /* Bits per audio sample (16) */
+    uint64_t frames_left;     /* Frames not yet read */
+} WavReader;
+
+/* Streaming writer: header sizes patched on close */
+typedef struct {
+    FILE *f;
+    int sample_rate;          /* Sample rate in Hz */
+    int num_channels;         /* Number of audio channels */
+    uint64_t data_bytes;      /* Bytes of sample data written */
+} WavWriter;
+
+/* Load a 16-bit PCM WAV or RF64/BW64 file. Returns 0 on success, negative on error */
 int load_wav(const char *filename, WavData *out);
 
 /* Check if WAV data is mono 16-bit. Returns 0 if valid */
@@ -29,7 +55,25 @@ int validate_wav_format(const WavData *wav);
 /* Free the memory used by WAV samples */
 void free_wav(WavData *wav);
 
-/* Save WAV data as a 16-bit PCM WAV file. Returns 0 on success */
+/* Save WAV data as a 16-bit PCM WAV file (RF64 when over 4 GB). Returns 0 on success */
 int save_wav(const char *filename, const WavData *wav);
 
+/* Open a 16-bit PCM WAV or RF64/BW64 file for streaming. Returns 0 on success, load_wav() error codes otherwise */
+int wav_reader_open(WavReader *r, const char *filename);
+
+/* Read up to max_frames interleaved frames. Returns frames read, 0 at end */
+size_t wav_reader_read(WavReader *r, int16_t *samples, size_t max_frames);
+
+/* Close a streaming reader */
+void wav_reader_close(WavReader *r);
+
+/* Create a 16-bit PCM WAV file for streaming (promoted to RF64 on close when over 4 GB). Returns 0 on success */
+int wav_writer_open(WavWriter *w, const char *filename, int sample_rate, int num_channels);
+
+/* Append interleaved frames. Returns 0 on success */
+int wav_writer_write(WavWriter *w, const int16_t *samples, size_t num_frames);
+
+/* Patch header sizes and close. Returns 0 on success */
+int wav_writer_close(WavWriter *w);
+
 #endif
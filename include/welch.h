@@ -0,0 +1,88 @@
+/*
+ * @file welch.h
+ *
+ * Header file for welch.c
+ *
+ * Welch power spectral density estimate (averaged modified periodograms).
+ * Frames, windowing and the FFT are those of the spectrogram path
+ * (SpectrogramWorkspace, spectrogram_frame_count()), but each frame's power
+ * is folded into a per-bin accumulator as soon as it is computed, so memory
+ * is O(num_bins) whatever the input length. Input can be pushed in blocks of
+ * any size (WelchPSD), or a whole WavData can be split across a thread pool
+ * with one accumulator per worker, reduced at the end (welch_compute()).
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+#ifndef WELCH_H_
+#define WELCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "spectrogram.h"
+#include "thread_pool.h"
+#include "wav.h"
+#include "window.h"
+
+/* Median mode: per-bin histogram of frame power in dB, cells of
+ * WELCH_MEDIAN_DB_STEP from WELCH_MEDIAN_DB_MIN (-200 dB is the spectrogram
+ * dB floor) up to +160 dB. The median is interpolated within its cell. */
+#define WELCH_MEDIAN_DB_MIN (-200.0)
+#define WELCH_MEDIAN_DB_STEP 0.5
+#define WELCH_MEDIAN_CELLS 720
+
+/* How frame periodograms are combined */
+typedef enum {
+    WELCH_AVERAGE_MEAN,        /* arithmetic mean of all frames (classic Welch) */
+    WELCH_AVERAGE_EXPONENTIAL, /* avg = (1 - alpha) avg + alpha frame, for tracking */
+    WELCH_AVERAGE_MEDIAN       /* per-bin median, bias-corrected; robust to transients */
+} WelchAveraging;
+
+/* Streaming Welch estimator; all buffers live in one block */
+typedef struct {
+    int fft_size;             /* frame length (power of two) */
+    int hop_size;             /* frame advance, 1 .. fft_size */
+    int num_bins;             /* fft_size / 2 + 1 */
+    WelchAveraging averaging; /* combination rule */
+    double alpha;             /* exponential weight of the newest frame */
+    SpectrogramWorkspace ws;  /* window, FFT buffer and plan */
+    double *accum;            /* power sum (mean) or running average (exponential) [num_bins] */
+    uint32_t *hist;           /* dB histograms, bin-major (median only) [num_bins * WELCH_MEDIAN_CELLS] */
+    int16_t *pending;         /* streamed samples not yet past a frame start [fft_size] */
+    int fill;                 /* samples held in pending */
+    long num_frames;          /* frames accumulated */
+    void *owned_mem;          /* block allocated by welch_init(), NULL for caller memory */
+} WelchPSD;
+
+// Initialize a streaming estimator (alpha used by exponential averaging only); returns 0, -1 (invalid) or -2 (allocation)
+int welch_init(WelchPSD *w, int fft_size, int hop_size, WindowType window_type,
+               WelchAveraging averaging, double alpha);
+
+// Bytes of caller memory welch_init_mem() needs (0 on invalid arguments)
+size_t welch_mem_size(int fft_size, WelchAveraging averaging);
+
+// welch_init() inside caller memory; performs no allocation
+int welch_init_mem(WelchPSD *w, int fft_size, int hop_size, WindowType window_type,
+                   WelchAveraging averaging, double alpha, void *mem);
+
+// Drop buffered samples and all accumulated frames
+void welch_reset(WelchPSD *w);
+
+// Push mono samples; every frame they complete is accumulated
+void welch_push(WelchPSD *w, const int16_t *samples, size_t num_samples);
+
+// Add src's frames into dst (mean and median; same fft size and window); returns 0 or -1
+int welch_merge(WelchPSD *dst, const WelchPSD *src);
+
+// One-sided PSD [num_bins] in full-scale^2/Hz (sample_rate <= 0: per unit frequency); returns 0, or -1 before the first frame
+int welch_estimate(const WelchPSD *w, int sample_rate, double *psd);
+
+// Whole-buffer estimate of a mono WAV on a pool (NULL: calling thread); returns frames averaged, -1 (invalid/too short) or -2 (allocation)
+long welch_compute(const WavData *wav, int fft_size, int hop_size, WindowType window_type,
+                   WelchAveraging averaging, double alpha, ThreadPool *pool, double *psd);
+
+// Free the block allocated by welch_init()
+void welch_free(WelchPSD *w);
+
+#endif /* WELCH_H_ */
@@ -0,0 +1,286 @@
+/**
+ * @file ap_filter.c
+ *
+ * @brief Implements the affine projection (AP) adaptive filter.
+ *
+ * With X = [x_0 .. x_{K-1}], the input vectors of the last K samples
+ * (x_0 newest), and e the K a priori errors against the matching desired
+ * samples, each update is
+ *     w += mu X (X'X + delta I)^-1 e
+ *
+ * Past inputs sit in one doubled circular buffer of order + K - 1 samples,
+ * newest first. x_j is then the contiguous window starting j samples in,
+ * so X needs no storage of its own. The Gram matrix X'X is carried from
+ * one sample to the next: the old matrix shifts down one row and one column,
+ * and only the new first row (K dot products) is computed. The K x K system
+ * is solved by Cholesky factorization in preallocated scratch.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ap_filter.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+#include "dsp_profile.h"
+
+/******************************************************************************/
+/** local definitions **/
+
+/* Internal helper: invalid init arguments */
+static int ap_invalid(int order, int projection, double mu, double delta) {
+    return order < 1 || projection < 1 || projection > AP_MAX_PROJECTION ||
+           !(mu > 0.0 && mu <= 1.0) || !(delta >= 0.0);
+}
+
+/******************************************************************************/
+/**
+ * @brief Initializes a streaming affine projection filter.
+ *
+ * @param[out] filter     Pointer to APFilter struct to initialize.
+ * @param[in]  order      Number of adaptive taps.
+ * @param[in]  projection Input vectors per update, 1 .. AP_MAX_PROJECTION
+ *                        (2 .. 8 is typical for echo cancellation).
+ * @param[in]  mu         Step size in (0, 1].
+ * @param[in]  delta      Regularization (>= 0), e.g. 1e-3 * order * input power.
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure.
+ *
+ * @warning Must call ap_filter_free() to release memory.
+ */
+int ap_filter_init(APFilter *filter, int order, int projection, double mu, double delta) {
+    filter->weights = NULL;
+    filter->history = NULL;
+    filter->desired = NULL;
+    filter->gram = NULL;
+    filter->chol = NULL;
+    filter->err = NULL;
+    filter->owned_mem = NULL;
+    if (ap_invalid(order, projection, mu, delta)) return -1;
+
+    void *mem = malloc(ap_filter_mem_size(order, projection));
+    if (!mem) return -2;
+    DSP_PROFILE_ALLOC(DSP_PROF_AP, ap_filter_mem_size(order, projection));
+
+    ap_filter_init_mem(filter, order, projection, mu, delta, mem);
+    filter->owned_mem = mem;
+    return 0;
+}
+/* End of ap_filter_init() */
+/******************************************************************************/
+
+/**
+ * @brief Bytes of memory ap_filter_init_mem() needs.
+ *
+ * @param[in] order      Number of adaptive taps.
+ * @param[in] projection Input vectors per update.
+ */
+size_t ap_filter_mem_size(int order, int projection) {
+    if (order < 1 || projection < 1 || projection > AP_MAX_PROJECTION) return 0;
+    size_t k = projection;
+    return DSP_MEM_ALIGN_UP(order * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(2 * (order + k - 1) * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(2 * k * sizeof(double)) +
+           2 * DSP_MEM_ALIGN_UP(k * k * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(k * sizeof(double));
+}
+/* End of ap_filter_mem_size() */
+/******************************************************************************/
+
+/**
+ * @brief Initializes a streaming affine projection filter inside caller memory.
+ *
+ * @param[out] filter     Pointer to APFilter struct to initialize.
+ * @param[in]  order      Number of adaptive taps.
+ * @param[in]  projection Input vectors per update, 1 .. AP_MAX_PROJECTION.
+ * @param[in]  mu         Step size in (0, 1].
+ * @param[in]  delta      Regularization (>= 0).
+ * @param[in]  mem        At least ap_filter_mem_size(order, projection) bytes
+ *                        aligned for double; must outlive the filter.
+ *
+ * @returns 0 on success, -1 on invalid arguments. Performs no allocation.
+ */
+int ap_filter_init_mem(APFilter *filter, int order, int projection, double mu, double delta,
+                       void *mem) {
+    filter->owned_mem = NULL;
+    if (ap_invalid(order, projection, mu, delta)) return -1;
+
+    size_t k = projection;
+    DspArena arena;
+    dsp_arena_init(&arena, mem, ap_filter_mem_size(order, projection));
+    filter->order = order;
+    filter->projection = projection;
+    filter->mu = mu;
+    filter->delta = delta;
+    filter->weights = dsp_arena_alloc(&arena, order * sizeof(double));
+    filter->history = dsp_arena_alloc(&arena, 2 * (order + k - 1) * sizeof(double));
+    filter->desired = dsp_arena_alloc(&arena, 2 * k * sizeof(double));
+    filter->gram = dsp_arena_alloc(&arena, k * k * sizeof(double));
+    filter->chol = dsp_arena_alloc(&arena, k * k * sizeof(double));
+    filter->err = dsp_arena_alloc(&arena, k * sizeof(double));
+    ap_filter_reset(filter);
+    return 0;
+}
+/* End of ap_filter_init_mem() */
+/******************************************************************************/
+
+/**
+ * @brief Zeros the weights, the input and desired history and the Gram matrix.
+ *
+ * @param[in,out] filter Pointer to APFilter.
+ */
+void ap_filter_reset(APFilter *filter) {
+    size_t k = filter->projection;
+    memset(filter->weights, 0, filter->order * sizeof(double));
+    memset(filter->history, 0, 2 * (filter->order + k - 1) * sizeof(double));
+    memset(filter->desired, 0, 2 * k * sizeof(double));
+    memset(filter->gram, 0, k * k * sizeof(double));
+    filter->index = 0;
+    filter->d_index = 0;
+}
+/* End of ap_filter_reset() */
+/******************************************************************************/
+
+/* Internal helper: solve (gram + delta I) a = err in place in err; returns
+ * 0, or -1 when the regularized matrix is not positive definite */
+static int ap_solve(APFilter *filter) {
+    int k = filter->projection;
+    double *L = filter->chol;
+    double *b = filter->err;
+
+    for (int j = 0; j < k; j++) {
+        for (int i = j; i < k; i++) {
+            double s = filter->gram[i * k + j] + (i == j ? filter->delta : 0.0);
+            for (int m = 0; m < j; m++) {
+                s -= L[i * k + m] * L[j * k + m];
+            }
+            if (i == j) {
+                if (!(s > 0.0)) return -1;
+                L[j * k + j] = sqrt(s);
+            } else {
+                L[i * k + j] = s / L[j * k + j];
+            }
+        }
+    }
+    for (int i = 0; i < k; i++) {
+        for (int m = 0; m < i; m++) b[i] -= L[i * k + m] * b[m];
+        b[i] /= L[i * k + i];
+    }
+    for (int i = k - 1; i >= 0; i--) {
+        for (int m = i + 1; m < k; m++) b[i] -= L[m * k + i] * b[m];
+        b[i] /= L[i * k + i];
+    }
+    return 0;
+}
+
+/* Internal helper: one affine projection step */
+static inline double ap_step(APFilter *filter, double input, double desired,
+                             const DspKernels *kern) {
+    int n = filter->order;
+    int k = filter->projection;
+    const double *x = filter->history + filter->index;  /* x_j = x + j, x[t] = input[i - t - 1] */
+    double *w = filter->weights;
+    double *gram = filter->gram;
+
+    filter->d_index = (filter->d_index == 0 ? k : filter->d_index) - 1;
+    filter->desired[filter->d_index] = desired;
+    filter->desired[filter->d_index + k] = desired;
+    const double *d = filter->desired + filter->d_index;  /* d[j] = desired[i - j] */
+
+    // Last sample's x_j is this sample's x_{j+1}: shift, then add the new row
+    for (int r = k - 1; r > 0; r--) {
+        for (int c = k - 1; c > 0; c--) {
+            gram[r * k + c] = gram[(r - 1) * k + (c - 1)];
+        }
+    }
+    for (int c = 0; c < k; c++) {
+        gram[c] = gram[c * k] = kern->dot(x, x + c, n);
+    }
+
+    double y = kern->dot(w, x, n);
+    filter->err[0] = d[0] - y;
+    for (int j = 1; j < k; j++) {
+        filter->err[j] = d[j] - kern->dot(w, x + j, n);
+    }
+
+    if (ap_solve(filter) == 0) {
+        for (int j = 0; j < k; j++) {
+            double step = filter->mu * filter->err[j];
+            const double *xj = x + j;
+            for (int t = 0; t < n; t++) {
+                w[t] += step * xj[t];
+            }
+        }
+    }
+
+    int len = n + k - 1;
+    filter->index = (filter->index == 0 ? len : filter->index) - 1;
+    filter->history[filter->index] = input;
+    filter->history[filter->index + len] = input;
+    return y;
+}
+
+/**
+ * @brief Processes one sample pair.
+ *
+ * @param[in,out] filter  Pointer to APFilter.
+ * @param[in]     input   Current input sample.
+ * @param[in]     desired Current desired (reference) sample.
+ *
+ * @returns The prediction from the previous `order` inputs.
+ */
+double ap_filter_process_sample(APFilter *filter, double input, double desired) {
+    DSP_PROFILE_BEGIN(DSP_PROF_AP);
+    double y = ap_step(filter, input, desired, dsp_kernels());
+    DSP_PROFILE_END(DSP_PROF_AP);
+    return y;
+}
+/* End of ap_filter_process_sample() */
+/******************************************************************************/
+
+/**
+ * @brief Processes a block of sample pairs.
+ *
+ * @param[in,out] filter      Pointer to APFilter.
+ * @param[in]     input       Input samples (length: num_samples).
+ * @param[in]     desired     Desired samples (length: num_samples).
+ * @param[out]    output      Predictions (length: num_samples); may alias input.
+ * @param[in]     num_samples Number of samples.
+ */
+void ap_filter_process_block(APFilter *filter, const double *input, const double *desired,
+                             double *output, size_t num_samples) {
+    DSP_PROFILE_BEGIN(DSP_PROF_AP);
+    DspFpState fp;
+    dsp_fp_scope_begin(&fp);
+    const DspKernels *kern = dsp_kernels();
+    for (size_t i = 0; i < num_samples; i++) {
+        output[i] = ap_step(filter, input[i], desired[i], kern);
+    }
+    dsp_fp_scope_end(&fp);
+    DSP_PROFILE_END(DSP_PROF_AP);
+}
+/* End of ap_filter_process_block() */
+/******************************************************************************/
+
+/**
+ * @brief Frees memory owned by a streaming affine projection filter.
+ *
+ * @param[in,out] filter Pointer to APFilter.
+ */
+void ap_filter_free(APFilter *filter) {
+    free(filter->owned_mem);
+    filter->owned_mem = NULL;
+    filter->weights = NULL;
+    filter->history = NULL;
+    filter->desired = NULL;
+    filter->gram = NULL;
+    filter->chol = NULL;
+    filter->err = NULL;
+}
+/* End of ap_filter_free() */
+/******************************************************************************/
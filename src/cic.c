@@ -0,0 +1,452 @@
+/*
+ * @file cic.c
+ *
+ * Cascaded integrator-comb decimators/interpolators, their droop
+ * compensator and a running-sum moving average.
+ *
+ * The high-rate loops are instantiated once per stage count (the stage
+ * loop is fully unrolled and the integrators live in registers), so a
+ * decimator costs N 64-bit adds per input sample and an interpolator
+ * N - 1 adds per output sample, whatever the ratio. The combs
+ * run once per low-rate sample from the CicFilter arrays.
+ *
+ * Registers are uint64_t so wrap-around is defined; the result is read back
+ * as two's complement.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cic.h"
+#include "dsp_alloc.h"
+#include "dsp_profile.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define PI 3.14159265358979323846
+#define CIC_COMP_GRID 2048   /* midpoint-rule points over [0, cutoff] */
+
+/* Instantiate body for the stage count of cic (1 .. CIC_MAX_STAGES) */
+#define CIC_DISPATCH(body, ...)                          \
+    switch (cic->stages) {                               \
+        case 1:  return body(__VA_ARGS__, 1);            \
+        case 2:  return body(__VA_ARGS__, 2);            \
+        case 3:  return body(__VA_ARGS__, 3);            \
+        case 4:  return body(__VA_ARGS__, 4);            \
+        case 5:  return body(__VA_ARGS__, 5);            \
+        case 6:  return body(__VA_ARGS__, 6);            \
+        case 7:  return body(__VA_ARGS__, 7);            \
+        default: return body(__VA_ARGS__, 8);            \
+    }
+
+/* Internal helper: shared init; growth is log2 of the DC gain */
+static int cic_init(CicFilter *cic, int stages, int ratio, int delay, int input_bits,
+                    int interpolate) {
+    if (stages < 1 || stages > CIC_MAX_STAGES || ratio < 1 ||
+        delay < 1 || delay > CIC_MAX_DELAY || input_bits < 1 || input_bits > 32) {
+        return -1;
+    }
+
+    cic->stages = stages;
+    cic->ratio = ratio;
+    cic->delay = delay;
+    cic->interpolate = interpolate;
+
+    double gain = cic_gain(cic);
+    int growth = (int)ceil(log2(gain) - 1e-9);
+    if (growth < 0) growth = 0;
+    if (input_bits + growth > 64) return -1;
+
+    cic->out_shift = growth;
+    cic->scale = 1.0 / gain;
+    cic_reset(cic);
+    return 0;
+}
+
+/* Internal helper: N combs of delay M on one low-rate sample */
+static inline int64_t cic_comb(CicFilter *cic, uint64_t v) {
+    int m = cic->delay;
+    for (int j = 0; j < cic->stages; j++) {
+        uint64_t *line = cic->comb[j];
+        uint64_t delayed = line[m - 1];
+        if (m == 2) line[1] = line[0];
+        line[0] = v;
+        v -= delayed;
+    }
+    return (int64_t)v;
+}
+
+/* Internal helper: drop shift bits rounding half up, saturate to int32 */
+static inline int32_t cic_narrow(int64_t y, int shift) {
+    if (shift > 0) {
+        y = (y >> shift) + ((y >> (shift - 1)) & 1);
+    }
+    return (int32_t)(y > INT32_MAX ? INT32_MAX : y < INT32_MIN ? INT32_MIN : y);
+}
+
+/* Internal helper: decimator loop for N stages; writes int32 or double */
+static inline __attribute__((always_inline))
+size_t cic_decimate_body(CicFilter *cic, const int32_t *input, size_t n,
+                         int32_t *out_s32, double *out_f64, const int N) {
+    uint64_t s[CIC_MAX_STAGES];
+#pragma GCC unroll 8
+    for (int j = 0; j < N; j++) s[j] = cic->integ[j];
+    size_t ratio = (size_t)cic->ratio;
+    size_t phase = (size_t)cic->phase;
+    size_t count = 0;
+
+    for (size_t i = 0; i < n;) {
+        size_t run = ratio - phase;
+        if (run > n - i) run = n - i;
+
+        const int32_t *x = input + i;
+        for (size_t k = 0; k < run; k++) {
+            s[0] += (uint64_t)(int64_t)x[k];
+#pragma GCC unroll 8
+            for (int j = 1; j < N; j++) s[j] += s[j - 1];
+        }
+        i += run;
+        phase += run;
+
+        if (phase == ratio) {
+            phase = 0;
+            int64_t y = cic_comb(cic, s[N - 1]);
+            if (out_f64) {
+                out_f64[count++] = (double)y * cic->scale;
+            } else {
+                out_s32[count++] = cic_narrow(y, cic->out_shift);
+            }
+        }
+    }
+
+#pragma GCC unroll 8
+    for (int j = 0; j < N; j++) cic->integ[j] = s[j];
+    cic->phase = (int)phase;
+    return count;
+}
+
+/* Internal helper: interpolator loop for N stages; the first integrator
+ * sees each comb output once followed by R - 1 zeros (zero stuffing) */
+static inline __attribute__((always_inline))
+size_t cic_interpolate_body(CicFilter *cic, const int32_t *input, size_t n,
+                            int32_t *out_s32, double *out_f64, const int N) {
+    uint64_t s[CIC_MAX_STAGES];
+#pragma GCC unroll 8
+    for (int j = 0; j < N; j++) s[j] = cic->integ[j];
+    size_t ratio = (size_t)cic->ratio;
+    int shift = cic->out_shift;
+    double scale = cic->scale;
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        s[0] += (uint64_t)cic_comb(cic, (uint64_t)(int64_t)input[i]);
+        for (size_t k = 0; k < ratio; k++) {
+#pragma GCC unroll 8
+            for (int j = 1; j < N; j++) s[j] += s[j - 1];
+            if (out_f64) {
+                out_f64[count++] = (double)(int64_t)s[N - 1] * scale;
+            } else {
+                out_s32[count++] = cic_narrow((int64_t)s[N - 1], shift);
+            }
+        }
+    }
+
+#pragma GCC unroll 8
+    for (int j = 0; j < N; j++) cic->integ[j] = s[j];
+    return count;
+}
+
+static size_t cic_decimate_s32(CicFilter *cic, const int32_t *input, size_t n, int32_t *output) {
+    CIC_DISPATCH(cic_decimate_body, cic, input, n, output, NULL)
+}
+
+static size_t cic_decimate_f64(CicFilter *cic, const int32_t *input, size_t n, double *output) {
+    CIC_DISPATCH(cic_decimate_body, cic, input, n, NULL, output)
+}
+
+static size_t cic_interpolate_s32(CicFilter *cic, const int32_t *input, size_t n, int32_t *output) {
+    CIC_DISPATCH(cic_interpolate_body, cic, input, n, output, NULL)
+}
+
+static size_t cic_interpolate_f64(CicFilter *cic, const int32_t *input, size_t n, double *output) {
+    CIC_DISPATCH(cic_interpolate_body, cic, input, n, NULL, output)
+}
+
+/* Internal helper: |CIC response| / DC gain at low-rate frequency f */
+static double cic_response(const CicFilter *cic, double f) {
+    double rm = (double)cic->ratio * cic->delay;
+    double den = rm * sin(PI * f / cic->ratio);
+    double r = den == 0.0 ? 1.0 : fabs(sin(PI * cic->delay * f) / den);
+    return pow(r, cic->stages);
+}
+
+/******************************************************************************
+ * cic_decimator_init
+ *
+ * @param[out] cic        Pointer to CicFilter struct to initialize
+ * @param[in]  stages     Number of integrator/comb pairs N
+ * @param[in]  ratio      Decimation factor R (>= 1)
+ * @param[in]  delay      Differential delay M (1 or 2)
+ * @param[in]  input_bits Significant bits of the signed input samples (1 .. 32)
+ *
+ * @returns 0 on success, -1 on invalid arguments or when the output would
+ *          need more than 64 bits (input_bits + ceil(N log2(R M)) > 64)
+ *
+ * @note E.g. 24-bit input allows N = 4 up to R = 1024 (M = 1), 16-bit
+ *       input N = 4 up to R = 4096. Performs no allocation.
+ */
+int cic_decimator_init(CicFilter *cic, int stages, int ratio, int delay, int input_bits) {
+    return cic_init(cic, stages, ratio, delay, input_bits, 0);
+}
+/* End of cic_decimator_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * cic_interpolator_init
+ *
+ * @param[out] cic        Pointer to CicFilter struct to initialize
+ * @param[in]  stages     Number of comb/integrator pairs N
+ * @param[in]  ratio      Interpolation factor R (>= 1)
+ * @param[in]  delay      Differential delay M (1 or 2)
+ * @param[in]  input_bits Significant bits of the signed input samples (1 .. 32)
+ *
+ * @returns 0 on success, -1 on invalid arguments or when the output would
+ *          need more than 64 bits (gain (R M)^N / R)
+ */
+int cic_interpolator_init(CicFilter *cic, int stages, int ratio, int delay, int input_bits) {
+    return cic_init(cic, stages, ratio, delay, input_bits, 1);
+}
+/* End of cic_interpolator_init() */
+/******************************************************************************/
+
+void cic_reset(CicFilter *cic) {
+    memset(cic->integ, 0, sizeof(cic->integ));
+    memset(cic->comb, 0, sizeof(cic->comb));
+    cic->phase = 0;
+}
+
+double cic_gain(const CicFilter *cic) {
+    double gain = pow((double)cic->ratio * cic->delay, cic->stages);
+    return cic->interpolate ? gain / cic->ratio : gain;
+}
+
+/******************************************************************************
+ * cic_decimate
+ *
+ * @param[in,out] cic    Initialized decimator
+ * @param[in]     input  Input samples [n], within input_bits
+ * @param[in]     n      Number of input samples (any block size)
+ * @param[out]    output Output samples, room for n / R + 1
+ *
+ * @returns Number of outputs written
+ *
+ * @note Outputs are the full-precision result shifted right by out_shift
+ *       with rounding; the phase carries over between calls so blocks need
+ *       not be multiples of R. cic_decimate_double() writes the exact result
+ *       divided by the gain instead.
+ */
+size_t cic_decimate(CicFilter *cic, const int32_t *input, size_t n, int32_t *output) {
+    DSP_PROFILE_BEGIN(DSP_PROF_CIC);
+    size_t count = cic_decimate_s32(cic, input, n, output);
+    DSP_PROFILE_END(DSP_PROF_CIC);
+    return count;
+}
+/* End of cic_decimate() */
+/******************************************************************************/
+
+size_t cic_decimate_double(CicFilter *cic, const int32_t *input, size_t n, double *output) {
+    DSP_PROFILE_BEGIN(DSP_PROF_CIC);
+    size_t count = cic_decimate_f64(cic, input, n, output);
+    DSP_PROFILE_END(DSP_PROF_CIC);
+    return count;
+}
+
+/******************************************************************************
+ * cic_interpolate
+ *
+ * @param[in,out] cic    Initialized interpolator
+ * @param[in]     input  Input samples [n], within input_bits
+ * @param[in]     n      Number of input samples
+ * @param[out]    output Output samples [n * R]
+ *
+ * @returns n * R
+ *
+ * @note Same output scaling as cic_decimate(); cic_interpolate_double()
+ *       divides by the gain (R M)^N / R.
+ */
+size_t cic_interpolate(CicFilter *cic, const int32_t *input, size_t n, int32_t *output) {
+    DSP_PROFILE_BEGIN(DSP_PROF_CIC);
+    size_t count = cic_interpolate_s32(cic, input, n, output);
+    DSP_PROFILE_END(DSP_PROF_CIC);
+    return count;
+}
+/* End of cic_interpolate() */
+/******************************************************************************/
+
+size_t cic_interpolate_double(CicFilter *cic, const int32_t *input, size_t n, double *output) {
+    DSP_PROFILE_BEGIN(DSP_PROF_CIC);
+    size_t count = cic_interpolate_f64(cic, input, n, output);
+    DSP_PROFILE_END(DSP_PROF_CIC);
+    return count;
+}
+
+/******************************************************************************
+ * cic_compensator_design
+ *
+ * @param[in]  cic      Initialized CIC filter (stages, ratio and delay are used)
+ * @param[in]  cutoff   Passband edge in cycles per low-rate sample, (0, 0.5)
+ * @param[out] h        Coefficients [num_taps]
+ * @param[in]  num_taps Number of taps (odd lengths give a centred filter)
+ *
+ * @returns 0 on success, -1 on invalid arguments
+ *
+ * @note Frequency-sampling design: h[n] = 2 * integral over [0, cutoff] of
+ *       cos(2 pi f (n - mid)) / |H_cic(f)| df (midpoint rule on
+ *       CIC_COMP_GRID points), times a Hamming window, scaled to unit DC
+ *       gain. The result is symmetric, so FIRFilter runs it folded. Runs
+ *       after a decimator or before an interpolator, at the low rate.
+ *       The response is about -6 dB at cutoff, so place it past the
+ *       passband edge (N = 4, R = 64, 63 taps, cutoff 0.2: within 0.02 dB
+ *       up to 0.16).
+ */
+int cic_compensator_design(const CicFilter *cic, double cutoff, double *h, size_t num_taps) {
+    if (!(cutoff > 0.0 && cutoff < 0.5) || num_taps == 0) return -1;
+
+    double mid = (num_taps - 1) / 2.0;
+    double df = cutoff / CIC_COMP_GRID;
+    memset(h, 0, num_taps * sizeof(double));
+
+    for (int g = 0; g < CIC_COMP_GRID; g++) {
+        double f = (g + 0.5) * df;
+        double weight = 2.0 * df / cic_response(cic, f);
+        for (size_t i = 0; i < num_taps; i++) {
+            h[i] += weight * cos(2 * PI * f * (i - mid));
+        }
+    }
+
+    double sum = 0.0;
+    for (size_t i = 0; i < num_taps; i++) {
+        double w = num_taps > 1 ? 0.54 - 0.46 * cos(2 * PI * i / (num_taps - 1)) : 1.0;
+        h[i] *= w;
+        sum += h[i];
+    }
+    for (size_t i = 0; i < num_taps; i++) {
+        h[i] /= sum;
+    }
+    return 0;
+}
+/* End of cic_compensator_design() */
+/******************************************************************************/
+
+int cic_compensator_init(FIRFilter *fir, const CicFilter *cic, double cutoff, size_t num_taps) {
+    if (num_taps == 0) return -1;
+
+    double *h = malloc(num_taps * sizeof(double));
+    if (!h) return -2;
+
+    int result = cic_compensator_design(cic, cutoff, h, num_taps);
+    if (result == 0 && fir_filter_init(fir, h, num_taps) != 0) result = -2;
+    free(h);
+    return result;
+}
+
+/******************************************************************************
+ * moving_average_init
+ *
+ * @param[out] ma     Pointer to MovingAverage struct to initialize
+ * @param[in]  length Averaging length in samples (>= 1)
+ *
+ * @returns 0 on success, -1 if length is 0, -2 on memory allocation failure
+ *
+ * @note Allocates one block of moving_average_mem_size() bytes and lays the
+ *       filter out in it with moving_average_init_mem().
+ */
+int moving_average_init(MovingAverage *ma, size_t length) {
+    ma->owned_mem = NULL;
+    if (length == 0) return -1;
+
+    void *mem = malloc(moving_average_mem_size(length));
+    if (!mem) return -2;
+
+    moving_average_init_mem(ma, length, mem);
+    ma->owned_mem = mem;
+    return 0;
+}
+/* End of moving_average_init() */
+/******************************************************************************/
+
+size_t moving_average_mem_size(size_t length) {
+    return DSP_MEM_ALIGN_UP(length * sizeof(int32_t));
+}
+
+int moving_average_init_mem(MovingAverage *ma, size_t length, void *mem) {
+    if (length == 0) return -1;
+
+    ma->history = mem;
+    ma->length = length;
+    ma->scale = 1.0 / length;
+    ma->owned_mem = NULL;
+    moving_average_reset(ma);
+    return 0;
+}
+
+void moving_average_reset(MovingAverage *ma) {
+    memset(ma->history, 0, ma->length * sizeof(int32_t));
+    ma->index = 0;
+    ma->sum = 0;
+}
+
+/******************************************************************************
+ * moving_average_process
+ *
+ * @param[in,out] ma     Initialized MovingAverage
+ * @param[in]     input  Input samples [n]
+ * @param[out]    output Averages [n]
+ * @param[in]     n      Number of samples
+ *
+ * @note The sum is kept exactly in 64 bits (one add and one subtract per
+ *       sample, no drift); each output is sum * (1 / length). The circular
+ *       history is walked in runs up to its end, so the inner loop has no
+ *       wrap test.
+ */
+void moving_average_process(MovingAverage *ma, const int32_t *input, double *output, size_t n) {
+    DSP_PROFILE_BEGIN(DSP_PROF_CIC);
+    int32_t *history = ma->history;
+    size_t length = ma->length;
+    size_t index = ma->index;
+    int64_t sum = ma->sum;
+    double scale = ma->scale;
+
+    for (size_t i = 0; i < n;) {
+        size_t run = length - index;
+        if (run > n - i) run = n - i;
+
+        int32_t *slot = history + index;
+        for (size_t k = 0; k < run; k++) {
+            int32_t x = input[i + k];
+            sum += (int64_t)x - slot[k];
+            slot[k] = x;
+            output[i + k] = (double)sum * scale;
+        }
+        i += run;
+        index += run;
+        if (index == length) index = 0;
+    }
+
+    ma->index = index;
+    ma->sum = sum;
+    DSP_PROFILE_END(DSP_PROF_CIC);
+}
+/* End of moving_average_process() */
+/******************************************************************************/
+
+void moving_average_free(MovingAverage *ma) {
+    free(ma->owned_mem);
+    ma->owned_mem = NULL;
+    ma->history = NULL;
+}
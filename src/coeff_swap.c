@@ -0,0 +1,162 @@
+/*
+ * @file coeff_swap.c
+ *
+ * Lock-free coefficient hand-over between one control thread and one
+ * processing thread.
+ *
+ * ready holds a set index, with COEFF_SWAP_FRESH added while the set has
+ * not been picked up. Both sides only ever exchange ready with a set they
+ * own, so ownership moves with the index and no set is reachable from two
+ * parties. The exchanges are acq_rel: the release half publishes the
+ * writes into the set handed over, the acquire half orders the other
+ * side's last use of the set received before our writes to it.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stdlib.h>
+#include <string.h>
+#include "coeff_swap.h"
+#include "dsp_alloc.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define COEFF_SWAP_FRESH 0x100   /* flag on ready: published, not yet picked up */
+#define COEFF_SWAP_INDEX 0xff
+
+/******************************************************************************
+ * coeff_swap_mem_size
+ *
+ * @param[in] set_size Bytes per coefficient set
+ *
+ * @returns Bytes of memory coeff_swap_create_mem() needs
+ */
+size_t coeff_swap_mem_size(size_t set_size) {
+    return DSP_MEM_ALIGN_UP(sizeof(CoeffSwap)) + COEFF_SWAP_SETS * DSP_MEM_ALIGN_UP(set_size);
+}
+/* End of coeff_swap_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * coeff_swap_create_mem
+ *
+ * @param[in] set_size Bytes per coefficient set
+ * @param[in] fade_len Crossfade length in samples after each pick-up (0 = none)
+ * @param[in] mem      At least coeff_swap_mem_size(set_size) bytes aligned for
+ *                     double; must outlive the swapper
+ *
+ * @returns The swapper, at the start of mem
+ *
+ * @note Set 0 starts active, set 1 as the (stale) ready set, set 2 with the
+ *       control thread and set 3 as the spare. Every set is zeroed; the
+ *       caller fills the active set before the first block. Performs no
+ *       allocation.
+ */
+CoeffSwap *coeff_swap_create_mem(size_t set_size, size_t fade_len, void *mem) {
+    CoeffSwap *swap = mem;
+    size_t header = DSP_MEM_ALIGN_UP(sizeof(CoeffSwap));
+
+    swap->set_size = DSP_MEM_ALIGN_UP(set_size);
+    swap->sets = (unsigned char *)mem + header;
+    memset(swap->sets, 0, COEFF_SWAP_SETS * swap->set_size);
+
+    swap->active = 0;
+    atomic_init(&swap->ready, 1);
+    swap->writing = 2;
+    swap->spare = 3;
+    swap->retired = -1;
+    swap->fade_len = fade_len;
+    swap->fade_pos = 0;
+    swap->owned_mem = NULL;
+    return swap;
+}
+/* End of coeff_swap_create_mem() */
+/******************************************************************************/
+
+CoeffSwap *coeff_swap_create(size_t set_size, size_t fade_len) {
+    void *mem = malloc(coeff_swap_mem_size(set_size));
+    if (!mem) return NULL;
+
+    CoeffSwap *swap = coeff_swap_create_mem(set_size, fade_len, mem);
+    swap->owned_mem = mem;
+    return swap;
+}
+
+void coeff_swap_destroy(CoeffSwap *swap) {
+    if (swap) free(swap->owned_mem);
+}
+
+void *coeff_swap_set(const CoeffSwap *swap, int index) {
+    return swap->sets + (size_t)index * swap->set_size;
+}
+
+void *coeff_swap_write_begin(CoeffSwap *swap) {
+    return coeff_swap_set(swap, swap->writing);
+}
+
+/******************************************************************************
+ * coeff_swap_publish
+ *
+ * @param[in,out] swap Swapper; control thread only
+ *
+ * @note Wait-free: one atomic exchange. The set received back (the previous
+ *       ready set, stale or never picked up) becomes the next write set.
+ */
+void coeff_swap_publish(CoeffSwap *swap) {
+    int old = atomic_exchange_explicit(&swap->ready, swap->writing | COEFF_SWAP_FRESH,
+                                       memory_order_acq_rel);
+    swap->writing = old & COEFF_SWAP_INDEX;
+}
+/* End of coeff_swap_publish() */
+/******************************************************************************/
+
+/******************************************************************************
+ * coeff_swap_poll
+ *
+ * @param[in,out] swap Swapper; processing thread only
+ *
+ * @returns 1 if a freshly published set became active, else 0
+ *
+ * @note One relaxed load when nothing is pending. On a pick-up the old
+ *       active set becomes the retired set for a crossfade of fade_len
+ *       samples, or the spare at once when fade_len is 0. Nothing is
+ *       picked up while a crossfade runs.
+ */
+int coeff_swap_poll(CoeffSwap *swap) {
+    if (swap->spare < 0) return 0;
+    if (!(atomic_load_explicit(&swap->ready, memory_order_relaxed) & COEFF_SWAP_FRESH)) return 0;
+
+    int got = atomic_exchange_explicit(&swap->ready, swap->spare, memory_order_acq_rel);
+    if (!(got & COEFF_SWAP_FRESH)) {
+        // Unreachable with one control thread (only we clear the flag); keep the set
+        swap->spare = got & COEFF_SWAP_INDEX;
+        return 0;
+    }
+
+    if (swap->fade_len > 0) {
+        swap->retired = swap->active;
+        swap->spare = -1;
+        swap->fade_pos = 0;
+    } else {
+        swap->spare = swap->active;
+    }
+    swap->active = got & COEFF_SWAP_INDEX;
+    return 1;
+}
+/* End of coeff_swap_poll() */
+/******************************************************************************/
+
+size_t coeff_swap_fade_left(const CoeffSwap *swap) {
+    return swap->retired < 0 ? 0 : swap->fade_len - swap->fade_pos;
+}
+
+void coeff_swap_fade_advance(CoeffSwap *swap, size_t n) {
+    swap->fade_pos += n;
+    if (swap->retired >= 0 && swap->fade_pos >= swap->fade_len) {
+        swap->spare = swap->retired;
+        swap->retired = -1;
+    }
+}
@@ -0,0 +1,411 @@
+/*
+ * @file cqt.c
+ *
+ * Constant-Q transform with a precomputed sparse spectral kernel.
+ *
+ * Kernel construction (once per configuration): for bin k with centre
+ * frequency f_k, the temporal kernel is w(n) / N_k * exp(j 2 pi f_k t / fs),
+ * with N_k = ceil(Q fs / f_k) samples centred in the frame and t measured
+ * from the frame centre. Its FFT is concentrated in a few bins around f_k,
+ * so coefficients below CQT_KERNEL_THRESHOLD are dropped and the rest are
+ * stored conjugated and divided by fft_size. By Parseval, each frame's
+ * CQ bin k is then the sparse dot product of the frame's FFT with row k.
+ * The kernels are analytic, so only bins 0 .. fft_size / 2 are kept and
+ * the frame goes through the real-input FFT.
+ *
+ * Frames run as thread pool tasks. The kernel is only read, and each worker
+ * has its own FFT buffer and row of complex bins.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cqt.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+#include "dsp_profile.h"
+
+/******************************************************************************/
+/** local definitions **/
+
+/* Kernel cache entry, one per distinct configuration */
+typedef struct CqtCacheEntry {
+    CqtKernel kernel;
+    struct CqtCacheEntry *next;
+} CqtCacheEntry;
+
+static CqtCacheEntry *cqt_cache;
+static pthread_mutex_t cqt_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Shared state of one cqt_compute_into() / compute_cqt() run */
+typedef struct {
+    const CqtKernel *kernel;
+    const WavData *wav;
+    int hop_size;
+    const SpectrogramOptions *options;
+    Complex *scratch;    /* per worker: cqt_frame() work [fft_size + 1] + CQ bins [num_bins] */
+    double **rows;       /* row-per-frame output, or NULL */
+    double *flat;        /* row-major output when rows is NULL */
+} CqtJob;
+
+/* Internal helper: kernel length in samples of bin k */
+static int cqt_kernel_length(const CqtConfig *cfg, double q, int k) {
+    return (int)ceil(q * cfg->sample_rate / cqt_bin_frequency(cfg, k));
+}
+
+/* Internal helper: 0 when cfg describes a usable transform */
+static int cqt_config_check(const CqtConfig *cfg) {
+    if (!cfg || cfg->sample_rate <= 0 || !(cfg->fmin > 0.0) || cfg->bins_per_octave < 1 ||
+        cfg->num_bins < 1) return -1;
+    if (!(cqt_bin_frequency(cfg, cfg->num_bins - 1) < 0.5 * cfg->sample_rate)) return -1;
+    return 0;
+}
+
+/* Internal helper: thread pool task, one frame */
+static void cqt_task(void *ctx, size_t task, int worker) {
+    CqtJob *job = ctx;
+    const CqtKernel *kernel = job->kernel;
+    int num_bins = kernel->cfg.num_bins;
+    Complex *work = job->scratch + (size_t)worker * (kernel->fft_size + 1 + num_bins);
+    Complex *bins = work + kernel->fft_size + 1;
+
+    cqt_frame(kernel, job->wav->samples + task * job->hop_size, work, bins);
+    double *out = job->rows ? job->rows[task] : job->flat + task * num_bins;
+    spectrogram_convert_bins(bins, out, num_bins, job->options);
+}
+
+/* Internal helper: run every frame of job on pool (or inline); returns 0 or -2 */
+static int cqt_run(CqtJob *job, ThreadPool *pool, int num_frames) {
+    int num_workers = pool ? pool->num_threads : 1;
+    size_t per_worker = job->kernel->fft_size + 1 + job->kernel->cfg.num_bins;
+    job->scratch = malloc(num_workers * per_worker * sizeof(Complex));
+    if (!job->scratch) return -2;
+
+    if (pool) {
+        thread_pool_run(pool, (size_t)num_frames, cqt_task, job);
+    } else {
+        for (int f = 0; f < num_frames; f++) {
+            cqt_task(job, (size_t)f, 0);
+        }
+    }
+    free(job->scratch);
+    job->scratch = NULL;
+    return 0;
+}
+
+/******************************************************************************
+ * cqt_bin_frequency
+ *
+ * @param[in] cfg Configuration
+ * @param[in] k   Bin index
+ *
+ * @returns fmin * 2^(k / bins_per_octave) in Hz
+ */
+double cqt_bin_frequency(const CqtConfig *cfg, int k) {
+    return cfg->fmin * pow(2.0, (double)k / cfg->bins_per_octave);
+}
+/* End of cqt_bin_frequency() */
+/******************************************************************************/
+
+/******************************************************************************
+ * cqt_kernel_init
+ *
+ * @param[out] kernel Kernel to build
+ * @param[in]  cfg    Configuration; copied into the kernel
+ *
+ * @returns 0 on success, -1 on an invalid configuration (including a top bin
+ *          at or above Nyquist), -2 on allocation failure
+ *
+ * @note Costs one FFT of fft_size per CQ bin; use cqt_kernel_cached() to
+ *       build each configuration once. All tables live in one block.
+ *
+ * @warning Must call cqt_kernel_free() to release memory.
+ */
+int cqt_kernel_init(CqtKernel *kernel, const CqtConfig *cfg) {
+    kernel->owned_mem = NULL;
+    if (cqt_config_check(cfg) != 0) return -1;
+
+    int num_bins = cfg->num_bins;
+    double q = 1.0 / (pow(2.0, 1.0 / cfg->bins_per_octave) - 1.0);
+    int longest = cqt_kernel_length(cfg, q, 0);
+    int fft_size = 4;
+    while (fft_size < longest) fft_size *= 2;
+    size_t plan_size = rfft_plan_mem_size(fft_size);
+    if (plan_size == 0) return -1;
+
+    // Build the rows into growing arrays first; nnz is known only at the end
+    FFTPlan plan;
+    Complex *buf = malloc(fft_size * sizeof(Complex));
+    double *window = malloc(longest * sizeof(double));
+    int *row_start = malloc((num_bins + 1) * sizeof(int));
+    int *col = NULL;
+    Complex *val = NULL;
+    int nnz = 0, capacity = 0, ret = 0;
+    if (!buf || !window || !row_start || fft_plan_init(&plan, fft_size) != 0) {
+        free(buf);
+        free(window);
+        free(row_start);
+        return -2;
+    }
+
+    double inv_fft = 1.0 / fft_size;
+    for (int k = 0; k < num_bins && ret == 0; k++) {
+        int len = cqt_kernel_length(cfg, q, k);
+        int start = (fft_size - len) / 2;
+        double w = 2.0 * M_PI * cqt_bin_frequency(cfg, k) / cfg->sample_rate;
+        generate_window(window, len, cfg->window_type);
+        memset(buf, 0, fft_size * sizeof(Complex));
+        for (int n = 0; n < len; n++) {
+            double t = start + n - fft_size / 2;
+            buf[start + n].real = window[n] / len * cos(w * t);
+            buf[start + n].imag = window[n] / len * sin(w * t);
+        }
+        fft_execute(&plan, buf);
+
+        row_start[k] = nnz;
+        for (int j = 0; j <= fft_size / 2; j++) {
+            if (buf[j].real * buf[j].real + buf[j].imag * buf[j].imag <
+                CQT_KERNEL_THRESHOLD * CQT_KERNEL_THRESHOLD) continue;
+            if (nnz == capacity) {
+                capacity = capacity ? 2 * capacity : 1024;
+                int *c = realloc(col, capacity * sizeof(int));
+                if (c) col = c;
+                Complex *v = realloc(val, capacity * sizeof(Complex));
+                if (v) val = v;
+                if (!c || !v) {
+                    ret = -2;
+                    break;
+                }
+            }
+            col[nnz] = j;
+            val[nnz].real = buf[j].real * inv_fft;
+            val[nnz].imag = -buf[j].imag * inv_fft;
+            nnz++;
+        }
+    }
+    row_start[num_bins] = nnz;
+    fft_plan_free(&plan);
+    free(buf);
+    free(window);
+
+    void *mem = NULL;
+    size_t size = plan_size +
+                  DSP_MEM_ALIGN_UP((num_bins + 1) * sizeof(int)) +
+                  DSP_MEM_ALIGN_UP((size_t)nnz * sizeof(int)) +
+                  DSP_MEM_ALIGN_UP((size_t)nnz * sizeof(Complex));
+    if (ret == 0 && !(mem = malloc(size))) ret = -2;
+    if (ret == 0) {
+        DspArena arena;
+        dsp_arena_init(&arena, mem, size);
+        rfft_plan_init_mem(&kernel->plan, fft_size, dsp_arena_alloc(&arena, plan_size));
+        kernel->cfg = *cfg;
+        kernel->fft_size = fft_size;
+        kernel->q = q;
+        kernel->nnz = nnz;
+        kernel->row_start = dsp_arena_alloc(&arena, (num_bins + 1) * sizeof(int));
+        kernel->col = dsp_arena_alloc(&arena, (size_t)nnz * sizeof(int));
+        kernel->val = dsp_arena_alloc(&arena, (size_t)nnz * sizeof(Complex));
+        memcpy(kernel->row_start, row_start, (num_bins + 1) * sizeof(int));
+        memcpy(kernel->col, col, (size_t)nnz * sizeof(int));
+        memcpy(kernel->val, val, (size_t)nnz * sizeof(Complex));
+        kernel->owned_mem = mem;
+    }
+    free(row_start);
+    free(col);
+    free(val);
+    return ret;
+}
+/* End of cqt_kernel_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * cqt_kernel_free
+ *
+ * @param[in,out] kernel Kernel built with cqt_kernel_init()
+ */
+void cqt_kernel_free(CqtKernel *kernel) {
+    free(kernel->owned_mem);
+    kernel->owned_mem = NULL;
+    kernel->row_start = NULL;
+    kernel->col = NULL;
+    kernel->val = NULL;
+}
+/* End of cqt_kernel_free() */
+/******************************************************************************/
+
+/******************************************************************************
+ * cqt_kernel_cached
+ *
+ * @param[in] cfg Configuration
+ *
+ * @returns Shared kernel for cfg, built on first use, or NULL on an invalid
+ *          configuration or allocation failure
+ *
+ * @note Entries are matched on every CqtConfig field. Kernels are only read
+ *       after construction, so one may be used by any number of threads.
+ */
+const CqtKernel *cqt_kernel_cached(const CqtConfig *cfg) {
+    if (cqt_config_check(cfg) != 0) return NULL;
+
+    pthread_mutex_lock(&cqt_cache_lock);
+    CqtCacheEntry *e;
+    for (e = cqt_cache; e; e = e->next) {
+        const CqtConfig *c = &e->kernel.cfg;
+        if (c->sample_rate == cfg->sample_rate && c->fmin == cfg->fmin &&
+            c->bins_per_octave == cfg->bins_per_octave && c->num_bins == cfg->num_bins &&
+            c->window_type == cfg->window_type) break;
+    }
+    if (!e) {
+        e = malloc(sizeof(CqtCacheEntry));
+        if (e && cqt_kernel_init(&e->kernel, cfg) != 0) {
+            free(e);
+            e = NULL;
+        }
+        if (e) {
+            e->next = cqt_cache;
+            cqt_cache = e;
+        }
+    }
+    pthread_mutex_unlock(&cqt_cache_lock);
+    return e ? &e->kernel : NULL;
+}
+/* End of cqt_kernel_cached() */
+/******************************************************************************/
+
+/******************************************************************************
+ * cqt_kernel_cache_clear
+ *
+ * @warning Pointers returned by the cache become invalid.
+ */
+void cqt_kernel_cache_clear(void) {
+    pthread_mutex_lock(&cqt_cache_lock);
+    while (cqt_cache) {
+        CqtCacheEntry *next = cqt_cache->next;
+        cqt_kernel_free(&cqt_cache->kernel);
+        free(cqt_cache);
+        cqt_cache = next;
+    }
+    pthread_mutex_unlock(&cqt_cache_lock);
+}
+/* End of cqt_kernel_cache_clear() */
+/******************************************************************************/
+
+/******************************************************************************
+ * cqt_frame
+ *
+ * @param[in]  kernel  Kernel
+ * @param[in]  samples fft_size mono samples
+ * @param[out] work    Scratch [fft_size + 1]: the frame as doubles, then its
+ *                     real FFT from work + fft_size / 2
+ * @param[out] out     Complex CQ bins [num_bins]
+ *
+ * @note A sinusoid of amplitude A (full scale 1.0) at a bin centre gives
+ *       |out| of about A * mean(window) / 2. Performs no allocation.
+ */
+void cqt_frame(const CqtKernel *kernel, const int16_t *samples, Complex *work, Complex *out) {
+    double *frame = (double *)work;
+    Complex *spectrum = work + kernel->fft_size / 2;
+    dsp_kernels()->s16_to_double(samples, frame, kernel->fft_size);
+    rfft_execute(&kernel->plan, frame, spectrum);
+
+    const int *col = kernel->col;
+    const Complex *val = kernel->val;
+    for (int k = 0; k < kernel->cfg.num_bins; k++) {
+        double re = 0.0, im = 0.0;
+        for (int i = kernel->row_start[k]; i < kernel->row_start[k + 1]; i++) {
+            Complex x = spectrum[col[i]];
+            re += x.real * val[i].real - x.imag * val[i].imag;
+            im += x.real * val[i].imag + x.imag * val[i].real;
+        }
+        out[k].real = re;
+        out[k].imag = im;
+    }
+}
+/* End of cqt_frame() */
+/******************************************************************************/
+
+/******************************************************************************
+ * cqt_compute_into
+ *
+ * @param[in]  kernel     Kernel (fixes the frame length and bins)
+ * @param[in]  wav        Mono WAV
+ * @param[in]  hop_size   Hop size between frames
+ * @param[in]  options    Output mode and clamp range, or NULL for magnitude
+ * @param[in]  pool       Thread pool, or NULL to run on the calling thread
+ * @param[out] out        Row-major output [max_frames][num_bins]
+ * @param[in]  max_frames Rows available in out
+ *
+ * @returns Frames written (spectrogram_frame_count() with the kernel's
+ *          fft_size, at most max_frames), -1 on invalid arguments, -2 when
+ *          the per-worker scratch cannot be allocated
+ */
+int cqt_compute_into(const CqtKernel *kernel, const WavData *wav, int hop_size,
+                     const SpectrogramOptions *options, ThreadPool *pool,
+                     double *out, int max_frames) {
+    if (!kernel || !wav || wav->num_channels != 1 || hop_size < 1 || max_frames < 0) return -1;
+    DSP_PROFILE_BEGIN(DSP_PROF_CQT);
+
+    int num_frames = spectrogram_frame_count(wav, kernel->fft_size, hop_size);
+    if (num_frames > max_frames) num_frames = max_frames;
+    CqtJob job = { kernel, wav, hop_size, options, NULL, NULL, out };
+    int ret = cqt_run(&job, pool, num_frames);
+
+    DSP_PROFILE_END(DSP_PROF_CQT);
+    return ret == 0 ? num_frames : ret;
+}
+/* End of cqt_compute_into() */
+/******************************************************************************/
+
+/******************************************************************************
+ * compute_cqt
+ *
+ * @param[in]  wav            Mono WAV
+ * @param[in]  cfg            Configuration; the kernel comes from the cache
+ * @param[in]  hop_size       Hop size between frames
+ * @param[in]  options        Output mode and clamp range, or NULL for magnitude
+ * @param[in]  pool           Thread pool, or NULL to run on the calling thread
+ * @param[out] out_num_frames Number of time frames
+ * @param[out] out_num_bins   Number of CQ bins (cfg->num_bins)
+ *
+ * @returns 2D array [num_frames][num_bins], or NULL on error (invalid
+ *          configuration, WAV shorter than one frame, allocation failure);
+ *          free with free_spectrogram()
+ */
+double **compute_cqt(const WavData *wav, const CqtConfig *cfg, int hop_size,
+                     const SpectrogramOptions *options, ThreadPool *pool,
+                     int *out_num_frames, int *out_num_bins) {
+    if (!wav || wav->num_channels != 1 || hop_size < 1) return NULL;
+    const CqtKernel *kernel = cqt_kernel_cached(cfg);
+    if (!kernel) return NULL;
+    int num_frames = spectrogram_frame_count(wav, kernel->fft_size, hop_size);
+    int num_bins = cfg->num_bins;
+    if (num_frames == 0) return NULL;
+    DSP_PROFILE_BEGIN(DSP_PROF_CQT);
+
+    double **rows = calloc(num_frames, sizeof(double *));
+    int ok = rows != NULL;
+    for (int i = 0; ok && i < num_frames; i++) {
+        rows[i] = malloc(num_bins * sizeof(double));
+        ok = rows[i] != NULL;
+    }
+    CqtJob job = { kernel, wav, hop_size, options, NULL, rows, NULL };
+    if (!ok || cqt_run(&job, pool, num_frames) != 0) {
+        free_spectrogram(rows, rows ? num_frames : 0);
+        DSP_PROFILE_END(DSP_PROF_CQT);
+        return NULL;
+    }
+    DSP_PROFILE_ALLOC(DSP_PROF_CQT, num_frames * (sizeof(double *) + num_bins * sizeof(double)));
+
+    *out_num_frames = num_frames;
+    *out_num_bins = num_bins;
+    DSP_PROFILE_END(DSP_PROF_CQT);
+    return rows;
+}
+/* End of compute_cqt() */
+/******************************************************************************/
@@ -0,0 +1,160 @@
+/*
+ * @file dsp_alloc.c
+ *
+ * Arena and pool allocators for caller-supplied memory.
+ *
+ * The arena aligns offsets from the buffer start, so an object laid out by
+ * x_init_mem() in a block of x_mem_size() bytes never overruns it, whatever
+ * the alignment of the block itself. Pools thread their free list through
+ * the unused blocks, so they need no bookkeeping memory of their own.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stdlib.h>
+#include <string.h>
+#include "dsp_alloc.h"
+
+/******************************************************************************
+ * dsp_arena_init
+ *
+ * @param[out] arena  Pointer to DspArena struct to initialize
+ * @param[in]  buffer Memory to carve, or NULL to allocate size bytes
+ * @param[in]  size   Buffer size in bytes
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @warning Call dsp_arena_free() when buffer was NULL.
+ */
+int dsp_arena_init(DspArena *arena, void *buffer, size_t size) {
+    memset(arena, 0, sizeof(*arena));
+    if (size == 0) return -1;
+
+    if (!buffer) {
+        buffer = malloc(size);
+        if (!buffer) return -2;
+        arena->owned_mem = buffer;
+    }
+    arena->base = buffer;
+    arena->size = size;
+    return 0;
+}
+/* End of dsp_arena_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_arena_alloc
+ *
+ * @param[in,out] arena Arena to draw from
+ * @param[in]     size  Bytes needed
+ *
+ * @returns Block starting at a multiple of DSP_MEM_ALIGN from the buffer
+ *          start, or NULL when the arena cannot hold it
+ */
+void *dsp_arena_alloc(DspArena *arena, size_t size) {
+    size_t offset = DSP_MEM_ALIGN_UP(arena->used);
+    if (offset > arena->size || size > arena->size - offset) return NULL;
+    arena->used = offset + size;
+    return arena->base + offset;
+}
+/* End of dsp_arena_alloc() */
+/******************************************************************************/
+
+size_t dsp_arena_mark(const DspArena *arena) {
+    return arena->used;
+}
+
+void dsp_arena_rewind(DspArena *arena, size_t mark) {
+    if (mark < arena->used) arena->used = mark;
+}
+
+void dsp_arena_reset(DspArena *arena) {
+    arena->used = 0;
+}
+
+size_t dsp_arena_remaining(const DspArena *arena) {
+    return arena->size - arena->used;
+}
+
+void dsp_arena_free(DspArena *arena) {
+    free(arena->owned_mem);
+    memset(arena, 0, sizeof(*arena));
+}
+
+/******************************************************************************
+ * dsp_pool_mem_size
+ *
+ * @param[in] block_size Bytes per block
+ * @param[in] num_blocks Number of blocks
+ *
+ * @returns Buffer size for dsp_pool_init(), or 0 on overflow
+ */
+size_t dsp_pool_mem_size(size_t block_size, size_t num_blocks) {
+    size_t stride = DSP_MEM_ALIGN_UP(block_size < sizeof(void *) ? sizeof(void *) : block_size);
+    if (num_blocks > (size_t)-1 / stride) return 0;
+    return stride * num_blocks;
+}
+/* End of dsp_pool_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_pool_init
+ *
+ * @param[out] pool       Pointer to DspPool struct to initialize
+ * @param[in]  buffer     dsp_pool_mem_size() bytes aligned for a pointer,
+ *                        or NULL to allocate them
+ * @param[in]  block_size Bytes per block
+ * @param[in]  num_blocks Number of blocks
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @warning Call dsp_pool_free() when buffer was NULL.
+ */
+int dsp_pool_init(DspPool *pool, void *buffer, size_t block_size, size_t num_blocks) {
+    memset(pool, 0, sizeof(*pool));
+    size_t size = dsp_pool_mem_size(block_size, num_blocks);
+    if (block_size == 0 || num_blocks == 0 || size == 0) return -1;
+
+    if (!buffer) {
+        buffer = malloc(size);
+        if (!buffer) return -2;
+        pool->owned_mem = buffer;
+    }
+    pool->base = buffer;
+    pool->block_size = size / num_blocks;
+    pool->num_blocks = num_blocks;
+
+    // Link every block, lowest address first
+    for (size_t i = num_blocks; i-- > 0;) {
+        void **block = (void **)(pool->base + i * pool->block_size);
+        *block = pool->free_list;
+        pool->free_list = block;
+    }
+    pool->num_free = num_blocks;
+    return 0;
+}
+/* End of dsp_pool_init() */
+/******************************************************************************/
+
+void *dsp_pool_alloc(DspPool *pool) {
+    void **block = pool->free_list;
+    if (!block) return NULL;
+    pool->free_list = *block;
+    pool->num_free--;
+    return block;
+}
+
+void dsp_pool_release(DspPool *pool, void *block) {
+    if (!block) return;
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->num_free++;
+}
+
+void dsp_pool_free(DspPool *pool) {
+    free(pool->owned_mem);
+    memset(pool, 0, sizeof(*pool));
+}
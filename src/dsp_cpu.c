@@ -0,0 +1,997 @@
+/*
+ * @file dsp_cpu.c
+ *
+ * Scalar, SSE2, AVX2 and AVX-512 kernel variants and the runtime binding
+ * between them.
+ *
+ * The SIMD variants are compiled with per-function target attributes, so
+ * the rest of the library keeps building for the baseline target. This file
+ * must be built with -ffp-contract=off (the makefile does so): AVX-512F
+ * implies FMA, and a fused multiply-add rounds once instead of twice, which
+ * would make the variants disagree with the scalar kernel.
+ * Complex multiplies swap the real/imaginary lanes and combine with an
+ * add/subtract per lane, which is the scalar expression term by term.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dsp_cpu.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DSP_CPU_X86 1
+#include <immintrin.h>
+#define DSP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define DSP_CPU_X86 0
+#endif
+
+/******************************************************************************/
+/** local definitions **/
+#define PI 3.14159265358979323846
+#define S16_SCALE (1.0 / 32768.0)
+
+/* Lengths exercised by dsp_kernels_verify(): every tail length, plus one long run */
+#define VERIFY_MAX_SHORT 40
+#define VERIFY_LONG 1000
+#define VERIFY_MAX_FFT 1024
+
+/* MXCSR flush-to-zero and denormals-are-zero, FPCR flush-to-zero */
+#define MXCSR_FTZ_DAZ 0x8040u
+#define FPCR_FZ (1u << 24)
+
+static _Atomic(const DspKernels *) dsp_active;
+static atomic_int denormal_policy = DSP_DENORMALS_KEEP;
+
+static const char *const level_names[DSP_CPU_LEVEL_COUNT] = {
+    "scalar", "sse2", "avx2", "avx512"
+};
+
+/******************************************************************************/
+/* scalar kernels */
+
+static void fft_stage_scalar(Complex *x, const Complex *twiddle, int n, int half, int step) {
+    for (int start = 0; start < n; start += 2 * half) {
+        for (int k = 0; k < half; k++) {
+            Complex w = twiddle[k * step];
+            Complex *a = &x[start + k];
+            Complex *b = &x[start + k + half];
+            Complex temp = {
+                w.real * b->real - w.imag * b->imag,
+                w.real * b->imag + w.imag * b->real
+            };
+            b->real = a->real - temp.real;
+            b->imag = a->imag - temp.imag;
+            a->real += temp.real;
+            a->imag += temp.imag;
+        }
+    }
+}
+
+/* Lane j accumulates the products i = j (mod 8); the partial sums are
+ * combined pairwise in the order a 512/256/128-bit reduction produces */
+static double dot_scalar(const double *a, const double *b, size_t n) {
+    double acc[8] = { 0 };
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int j = 0; j < 8; j++) {
+            acc[j] += a[i + j] * b[i + j];
+        }
+    }
+    double sum = ((acc[0] + acc[4]) + (acc[2] + acc[6])) + ((acc[1] + acc[5]) + (acc[3] + acc[7]));
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/* Same lanes and combine order as dot_scalar() */
+static double dot_folded_scalar(const double *c, const double *lo, const double *hi, size_t n,
+                                int stride, int subtract) {
+    double acc[8] = { 0 };
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int j = 0; j < 8; j++) {
+            size_t off = (i + j) * stride;
+            double pair = subtract ? lo[off] - hi[-(ptrdiff_t)off] : lo[off] + hi[-(ptrdiff_t)off];
+            acc[j] += c[i + j] * pair;
+        }
+    }
+    double sum = ((acc[0] + acc[4]) + (acc[2] + acc[6])) + ((acc[1] + acc[5]) + (acc[3] + acc[7]));
+    for (; i < n; i++) {
+        size_t off = i * stride;
+        sum += c[i] * (subtract ? lo[off] - hi[-(ptrdiff_t)off] : lo[off] + hi[-(ptrdiff_t)off]);
+    }
+    return sum;
+}
+
+static int32_t dot_q15_scalar(const int16_t *a, const int16_t *b, size_t n) {
+    uint32_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc += (uint32_t)((int32_t)a[i] * b[i]);
+    }
+    return (int32_t)acc;
+}
+
+static void window_s16_scalar(const int16_t *samples, const double *window, Complex *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i].real = samples[i] * S16_SCALE * window[i];
+        out[i].imag = 0.0;
+    }
+}
+
+static void power_scalar(const Complex *bins, double *out, size_t n, double lo, double hi) {
+    for (size_t i = 0; i < n; i++) {
+        double v = bins[i].real * bins[i].real + bins[i].imag * bins[i].imag;
+        if (v < lo) v = lo;
+        if (v > hi) v = hi;
+        out[i] = v;
+    }
+}
+
+static void magnitude_scalar(const Complex *bins, double *out, size_t n, double lo, double hi) {
+    for (size_t i = 0; i < n; i++) {
+        double v = sqrt(bins[i].real * bins[i].real + bins[i].imag * bins[i].imag);
+        if (v < lo) v = lo;
+        if (v > hi) v = hi;
+        out[i] = v;
+    }
+}
+
+static void s16_to_double_scalar(const int16_t *in, double *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = in[i] * S16_SCALE;
+    }
+}
+
+static void double_to_s16_scalar(const double *in, int16_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double v = in[i] * 32768.0;
+        v = v < 0 ? v - 0.5 : v + 0.5;
+        if (v > 32767.0) v = 32767.0;
+        if (v < -32768.0) v = -32768.0;
+        out[i] = (int16_t)v;
+    }
+}
+
+static const DspKernels kernels_scalar = {
+    DSP_CPU_SCALAR,
+    fft_stage_scalar,
+    dot_scalar,
+    dot_folded_scalar,
+    dot_q15_scalar,
+    window_s16_scalar,
+    power_scalar,
+    magnitude_scalar,
+    s16_to_double_scalar,
+    double_to_s16_scalar
+};
+
+#if DSP_CPU_X86
+/******************************************************************************/
+/* SSE2 kernels: one complex or two doubles per register */
+
+DSP_TARGET("sse2")
+static void fft_stage_sse2(Complex *x, const Complex *twiddle, int n, int half, int step) {
+    const __m128d neg_real = _mm_set_pd(0.0, -0.0);
+    for (int start = 0; start < n; start += 2 * half) {
+        for (int k = 0; k < half; k++) {
+            __m128d w = _mm_loadu_pd(&twiddle[k * step].real);
+            double *pa = &x[start + k].real;
+            double *pb = &x[start + k + half].real;
+            __m128d b = _mm_loadu_pd(pb);
+            __m128d p = _mm_mul_pd(_mm_unpacklo_pd(w, w), b);
+            __m128d q = _mm_mul_pd(_mm_unpackhi_pd(w, w), _mm_shuffle_pd(b, b, 1));
+            __m128d t = _mm_add_pd(p, _mm_xor_pd(q, neg_real));
+            __m128d a = _mm_loadu_pd(pa);
+            _mm_storeu_pd(pb, _mm_sub_pd(a, t));
+            _mm_storeu_pd(pa, _mm_add_pd(a, t));
+        }
+    }
+}
+
+DSP_TARGET("sse2")
+static double dot_sse2(const double *a, const double *b, size_t n) {
+    __m128d v0 = _mm_setzero_pd(), v1 = v0, v2 = v0, v3 = v0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        v0 = _mm_add_pd(v0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        v1 = _mm_add_pd(v1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+        v2 = _mm_add_pd(v2, _mm_mul_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4)));
+        v3 = _mm_add_pd(v3, _mm_mul_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6)));
+    }
+    __m128d s = _mm_add_pd(_mm_add_pd(v0, v2), _mm_add_pd(v1, v3));
+    double sum = _mm_cvtsd_f64(s) + _mm_cvtsd_f64(_mm_unpackhi_pd(s, s));
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/* Internal helper: lo[i*stride] +- hi[-i*stride] for i, i+1 */
+DSP_TARGET("sse2")
+static inline __m128d fold2_sse2(const double *lo, const double *hi, size_t i, int stride,
+                                 int subtract) {
+    __m128d l, h;
+    if (stride == 1) {
+        l = _mm_loadu_pd(lo + i);
+        h = _mm_loadu_pd(hi - i - 1);
+        h = _mm_shuffle_pd(h, h, 1);
+    } else {
+        l = _mm_unpacklo_pd(_mm_loadu_pd(lo + 2 * i), _mm_loadu_pd(lo + 2 * i + 2));
+        h = _mm_unpackhi_pd(_mm_loadu_pd(hi - 2 * i - 1), _mm_loadu_pd(hi - 2 * i - 3));
+    }
+    return subtract ? _mm_sub_pd(l, h) : _mm_add_pd(l, h);
+}
+
+/* Internal helper: body of dot_folded_sse2(), inlined per (stride, subtract) */
+DSP_TARGET("sse2")
+static inline __attribute__((always_inline))
+double dot_folded_sse2_body(const double *c, const double *lo, const double *hi, size_t n,
+                            int stride, int subtract) {
+    __m128d v0 = _mm_setzero_pd(), v1 = v0, v2 = v0, v3 = v0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        v0 = _mm_add_pd(v0, _mm_mul_pd(_mm_loadu_pd(c + i), fold2_sse2(lo, hi, i, stride, subtract)));
+        v1 = _mm_add_pd(v1, _mm_mul_pd(_mm_loadu_pd(c + i + 2), fold2_sse2(lo, hi, i + 2, stride, subtract)));
+        v2 = _mm_add_pd(v2, _mm_mul_pd(_mm_loadu_pd(c + i + 4), fold2_sse2(lo, hi, i + 4, stride, subtract)));
+        v3 = _mm_add_pd(v3, _mm_mul_pd(_mm_loadu_pd(c + i + 6), fold2_sse2(lo, hi, i + 6, stride, subtract)));
+    }
+    __m128d s = _mm_add_pd(_mm_add_pd(v0, v2), _mm_add_pd(v1, v3));
+    double sum = _mm_cvtsd_f64(s) + _mm_cvtsd_f64(_mm_unpackhi_pd(s, s));
+    for (; i < n; i++) {
+        size_t off = i * stride;
+        sum += c[i] * (subtract ? lo[off] - hi[-(ptrdiff_t)off] : lo[off] + hi[-(ptrdiff_t)off]);
+    }
+    return sum;
+}
+
+DSP_TARGET("sse2")
+static double dot_folded_sse2(const double *c, const double *lo, const double *hi, size_t n,
+                              int stride, int subtract) {
+    if (stride == 1) {
+        return subtract ? dot_folded_sse2_body(c, lo, hi, n, 1, 1) : dot_folded_sse2_body(c, lo, hi, n, 1, 0);
+    }
+    return subtract ? dot_folded_sse2_body(c, lo, hi, n, 2, 1) : dot_folded_sse2_body(c, lo, hi, n, 2, 0);
+}
+
+/* Internal helper: four int16 samples to two pairs of scaled doubles */
+/* Eight int16 products per register, summed in pairs by pmaddwd; the
+ * lanes wrap like the scalar uint32 accumulator */
+DSP_TARGET("sse2")
+static int32_t dot_q15_sse2(const int16_t *a, const int16_t *b, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(x, y));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (int32_t)((uint32_t)_mm_cvtsi128_si32(acc) + (uint32_t)dot_q15_scalar(a + i, b + i, n - i));
+}
+
+DSP_TARGET("sse2")
+static inline void s16x4_to_pd(const int16_t *in, __m128d *lo, __m128d *hi) {
+    __m128i x = _mm_loadl_epi64((const __m128i *)in);
+    __m128i x32 = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+    __m128d scale = _mm_set1_pd(S16_SCALE);
+    *lo = _mm_mul_pd(_mm_cvtepi32_pd(x32), scale);
+    *hi = _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(x32, 0xEE)), scale);
+}
+
+DSP_TARGET("sse2")
+static void window_s16_sse2(const int16_t *samples, const double *window, Complex *out, size_t n) {
+    __m128d zero = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d lo, hi;
+        s16x4_to_pd(samples + i, &lo, &hi);
+        lo = _mm_mul_pd(lo, _mm_loadu_pd(window + i));
+        hi = _mm_mul_pd(hi, _mm_loadu_pd(window + i + 2));
+        double *o = &out[i].real;
+        _mm_storeu_pd(o, _mm_unpacklo_pd(lo, zero));
+        _mm_storeu_pd(o + 2, _mm_unpackhi_pd(lo, zero));
+        _mm_storeu_pd(o + 4, _mm_unpacklo_pd(hi, zero));
+        _mm_storeu_pd(o + 6, _mm_unpackhi_pd(hi, zero));
+    }
+    window_s16_scalar(samples + i, window + i, out + i, n - i);
+}
+
+/* Internal helper: |X|^2 of two adjacent bins */
+DSP_TARGET("sse2")
+static inline __m128d power2_sse2(const Complex *bins) {
+    __m128d a = _mm_loadu_pd(&bins[0].real);
+    __m128d b = _mm_loadu_pd(&bins[1].real);
+    a = _mm_mul_pd(a, a);
+    b = _mm_mul_pd(b, b);
+    return _mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b));
+}
+
+DSP_TARGET("sse2")
+static void power_sse2(const Complex *bins, double *out, size_t n, double lo, double hi) {
+    __m128d vlo = _mm_set1_pd(lo), vhi = _mm_set1_pd(hi);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_min_pd(vhi, _mm_max_pd(vlo, power2_sse2(bins + i))));
+    }
+    power_scalar(bins + i, out + i, n - i, lo, hi);
+}
+
+DSP_TARGET("sse2")
+static void magnitude_sse2(const Complex *bins, double *out, size_t n, double lo, double hi) {
+    __m128d vlo = _mm_set1_pd(lo), vhi = _mm_set1_pd(hi);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_sqrt_pd(power2_sse2(bins + i));
+        _mm_storeu_pd(out + i, _mm_min_pd(vhi, _mm_max_pd(vlo, v)));
+    }
+    magnitude_scalar(bins + i, out + i, n - i, lo, hi);
+}
+
+DSP_TARGET("sse2")
+static void s16_to_double_sse2(const int16_t *in, double *out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d lo, hi;
+        s16x4_to_pd(in + i, &lo, &hi);
+        _mm_storeu_pd(out + i, lo);
+        _mm_storeu_pd(out + i + 2, hi);
+    }
+    s16_to_double_scalar(in + i, out + i, n - i);
+}
+
+/* Internal helper: scale, round half away from zero and clamp two samples */
+DSP_TARGET("sse2")
+static inline __m128i round_s16x2_sse2(const double *in) {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    __m128d v = _mm_mul_pd(_mm_loadu_pd(in), _mm_set1_pd(32768.0));
+    v = _mm_add_pd(v, _mm_or_pd(_mm_and_pd(v, sign), _mm_set1_pd(0.5)));
+    v = _mm_min_pd(_mm_set1_pd(32767.0), _mm_max_pd(_mm_set1_pd(-32768.0), v));
+    return _mm_cvttpd_epi32(v);
+}
+
+DSP_TARGET("sse2")
+static void double_to_s16_sse2(const double *in, int16_t *out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_unpacklo_epi64(round_s16x2_sse2(in + i), round_s16x2_sse2(in + i + 2));
+        _mm_storel_epi64((__m128i *)(out + i), _mm_packs_epi32(x, x));
+    }
+    double_to_s16_scalar(in + i, out + i, n - i);
+}
+
+static const DspKernels kernels_sse2 = {
+    DSP_CPU_SSE2,
+    fft_stage_sse2,
+    dot_sse2,
+    dot_folded_sse2,
+    dot_q15_sse2,
+    window_s16_sse2,
+    power_sse2,
+    magnitude_sse2,
+    s16_to_double_sse2,
+    double_to_s16_sse2
+};
+
+/******************************************************************************/
+/* AVX2 kernels: two complexes or four doubles per register */
+
+DSP_TARGET("avx2")
+static void fft_stage_avx2(Complex *x, const Complex *twiddle, int n, int half, int step) {
+    if (half < 2) {
+        fft_stage_sse2(x, twiddle, n, half, step);
+        return;
+    }
+    for (int start = 0; start < n; start += 2 * half) {
+        for (int k = 0; k < half; k += 2) {
+            __m256d w;
+            if (step == 1) {
+                w = _mm256_loadu_pd(&twiddle[k].real);
+            } else {
+                w = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(&twiddle[k * step].real)),
+                                         _mm_loadu_pd(&twiddle[(k + 1) * step].real), 1);
+            }
+            double *pa = &x[start + k].real;
+            double *pb = &x[start + k + half].real;
+            __m256d b = _mm256_loadu_pd(pb);
+            __m256d p = _mm256_mul_pd(_mm256_movedup_pd(w), b);
+            __m256d q = _mm256_mul_pd(_mm256_permute_pd(w, 0xF), _mm256_permute_pd(b, 0x5));
+            __m256d t = _mm256_addsub_pd(p, q);
+            __m256d a = _mm256_loadu_pd(pa);
+            _mm256_storeu_pd(pb, _mm256_sub_pd(a, t));
+            _mm256_storeu_pd(pa, _mm256_add_pd(a, t));
+        }
+    }
+}
+
+DSP_TARGET("avx2")
+static double dot_avx2(const double *a, const double *b, size_t n) {
+    __m256d v0 = _mm256_setzero_pd(), v1 = v0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        v0 = _mm256_add_pd(v0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        v1 = _mm256_add_pd(v1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+    }
+    __m256d s4 = _mm256_add_pd(v0, v1);
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(s4), _mm256_extractf128_pd(s4, 1));
+    double sum = _mm_cvtsd_f64(s) + _mm_cvtsd_f64(_mm_unpackhi_pd(s, s));
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/* Internal helper: lo[i*stride] +- hi[-i*stride] for i .. i+3 */
+DSP_TARGET("avx2")
+static inline __m256d fold4_avx2(const double *lo, const double *hi, size_t i, int stride,
+                                 int subtract) {
+    __m256d l, h;
+    if (stride == 1) {
+        l = _mm256_loadu_pd(lo + i);
+        h = _mm256_permute4x64_pd(_mm256_loadu_pd(hi - i - 3), 0x1B);
+    } else {
+        // (l0 l4 l2 l6) -> (l0 l2 l4 l6); (h-2 h-6 h0 h-4) -> (h0 h-2 h-4 h-6)
+        l = _mm256_unpacklo_pd(_mm256_loadu_pd(lo + 2 * i), _mm256_loadu_pd(lo + 2 * i + 4));
+        l = _mm256_permute4x64_pd(l, 0xD8);
+        h = _mm256_unpackhi_pd(_mm256_loadu_pd(hi - 2 * i - 3), _mm256_loadu_pd(hi - 2 * i - 7));
+        h = _mm256_permute4x64_pd(h, 0x72);
+    }
+    return subtract ? _mm256_sub_pd(l, h) : _mm256_add_pd(l, h);
+}
+
+/* Internal helper: body of dot_folded_avx2(), inlined per (stride, subtract) */
+DSP_TARGET("avx2")
+static inline __attribute__((always_inline))
+double dot_folded_avx2_body(const double *c, const double *lo, const double *hi, size_t n,
+                            int stride, int subtract) {
+    __m256d v0 = _mm256_setzero_pd(), v1 = v0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        v0 = _mm256_add_pd(v0, _mm256_mul_pd(_mm256_loadu_pd(c + i),
+                                             fold4_avx2(lo, hi, i, stride, subtract)));
+        v1 = _mm256_add_pd(v1, _mm256_mul_pd(_mm256_loadu_pd(c + i + 4),
+                                             fold4_avx2(lo, hi, i + 4, stride, subtract)));
+    }
+    __m256d s4 = _mm256_add_pd(v0, v1);
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(s4), _mm256_extractf128_pd(s4, 1));
+    double sum = _mm_cvtsd_f64(s) + _mm_cvtsd_f64(_mm_unpackhi_pd(s, s));
+    for (; i < n; i++) {
+        size_t off = i * stride;
+        sum += c[i] * (subtract ? lo[off] - hi[-(ptrdiff_t)off] : lo[off] + hi[-(ptrdiff_t)off]);
+    }
+    return sum;
+}
+
+DSP_TARGET("avx2")
+static double dot_folded_avx2(const double *c, const double *lo, const double *hi, size_t n,
+                              int stride, int subtract) {
+    if (stride == 1) {
+        return subtract ? dot_folded_avx2_body(c, lo, hi, n, 1, 1) : dot_folded_avx2_body(c, lo, hi, n, 1, 0);
+    }
+    return subtract ? dot_folded_avx2_body(c, lo, hi, n, 2, 1) : dot_folded_avx2_body(c, lo, hi, n, 2, 0);
+}
+
+DSP_TARGET("avx2")
+static int32_t dot_q15_avx2(const int16_t *a, const int16_t *b, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(x, y));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (int32_t)((uint32_t)_mm_cvtsi128_si32(sum) + (uint32_t)dot_q15_scalar(a + i, b + i, n - i));
+}
+
+DSP_TARGET("avx2")
+static inline __m256d s16x4_to_pd_avx2(const int16_t *in) {
+    __m128i x32 = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)in));
+    return _mm256_mul_pd(_mm256_cvtepi32_pd(x32), _mm256_set1_pd(S16_SCALE));
+}
+
+DSP_TARGET("avx2")
+static void window_s16_avx2(const int16_t *samples, const double *window, Complex *out, size_t n) {
+    __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_mul_pd(s16x4_to_pd_avx2(samples + i), _mm256_loadu_pd(window + i));
+        __m256d even = _mm256_unpacklo_pd(v, zero);   /* v0 0 v2 0 */
+        __m256d odd = _mm256_unpackhi_pd(v, zero);    /* v1 0 v3 0 */
+        double *o = &out[i].real;
+        _mm256_storeu_pd(o, _mm256_permute2f128_pd(even, odd, 0x20));
+        _mm256_storeu_pd(o + 4, _mm256_permute2f128_pd(even, odd, 0x31));
+    }
+    window_s16_scalar(samples + i, window + i, out + i, n - i);
+}
+
+/* Internal helper: |X|^2 of four adjacent bins, in order */
+DSP_TARGET("avx2")
+static inline __m256d power4_avx2(const Complex *bins) {
+    __m256d a = _mm256_loadu_pd(&bins[0].real);
+    __m256d b = _mm256_loadu_pd(&bins[2].real);
+    __m256d s = _mm256_hadd_pd(_mm256_mul_pd(a, a), _mm256_mul_pd(b, b));  /* P0 P2 P1 P3 */
+    return _mm256_permute4x64_pd(s, 0xD8);
+}
+
+DSP_TARGET("avx2")
+static void power_avx2(const Complex *bins, double *out, size_t n, double lo, double hi) {
+    __m256d vlo = _mm256_set1_pd(lo), vhi = _mm256_set1_pd(hi);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_min_pd(vhi, _mm256_max_pd(vlo, power4_avx2(bins + i))));
+    }
+    power_sse2(bins + i, out + i, n - i, lo, hi);
+}
+
+DSP_TARGET("avx2")
+static void magnitude_avx2(const Complex *bins, double *out, size_t n, double lo, double hi) {
+    __m256d vlo = _mm256_set1_pd(lo), vhi = _mm256_set1_pd(hi);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_sqrt_pd(power4_avx2(bins + i));
+        _mm256_storeu_pd(out + i, _mm256_min_pd(vhi, _mm256_max_pd(vlo, v)));
+    }
+    magnitude_sse2(bins + i, out + i, n - i, lo, hi);
+}
+
+DSP_TARGET("avx2")
+static void s16_to_double_avx2(const int16_t *in, double *out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, s16x4_to_pd_avx2(in + i));
+    }
+    s16_to_double_scalar(in + i, out + i, n - i);
+}
+
+DSP_TARGET("avx2")
+static inline __m128i round_s16x4_avx2(const double *in) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d v = _mm256_mul_pd(_mm256_loadu_pd(in), _mm256_set1_pd(32768.0));
+    v = _mm256_add_pd(v, _mm256_or_pd(_mm256_and_pd(v, sign), _mm256_set1_pd(0.5)));
+    v = _mm256_min_pd(_mm256_set1_pd(32767.0), _mm256_max_pd(_mm256_set1_pd(-32768.0), v));
+    return _mm256_cvttpd_epi32(v);
+}
+
+DSP_TARGET("avx2")
+static void double_to_s16_avx2(const double *in, int16_t *out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = _mm_packs_epi32(round_s16x4_avx2(in + i), round_s16x4_avx2(in + i + 4));
+        _mm_storeu_si128((__m128i *)(out + i), x);
+    }
+    double_to_s16_scalar(in + i, out + i, n - i);
+}
+
+static const DspKernels kernels_avx2 = {
+    DSP_CPU_AVX2,
+    fft_stage_avx2,
+    dot_avx2,
+    dot_folded_avx2,
+    dot_q15_avx2,
+    window_s16_avx2,
+    power_avx2,
+    magnitude_avx2,
+    s16_to_double_avx2,
+    double_to_s16_avx2
+};
+
+/******************************************************************************/
+/* AVX-512 kernels: four complexes or eight doubles per register */
+
+DSP_TARGET("avx512f")
+static void fft_stage_avx512(Complex *x, const Complex *twiddle, int n, int half, int step) {
+    if (half < 4) {
+        fft_stage_avx2(x, twiddle, n, half, step);
+        return;
+    }
+    for (int start = 0; start < n; start += 2 * half) {
+        for (int k = 0; k < half; k += 4) {
+            __m512d w;
+            if (step == 1) {
+                w = _mm512_loadu_pd(&twiddle[k].real);
+            } else {
+                __m256d w01 = _mm256_insertf128_pd(
+                    _mm256_castpd128_pd256(_mm_loadu_pd(&twiddle[k * step].real)),
+                    _mm_loadu_pd(&twiddle[(k + 1) * step].real), 1);
+                __m256d w23 = _mm256_insertf128_pd(
+                    _mm256_castpd128_pd256(_mm_loadu_pd(&twiddle[(k + 2) * step].real)),
+                    _mm_loadu_pd(&twiddle[(k + 3) * step].real), 1);
+                w = _mm512_insertf64x4(_mm512_castpd256_pd512(w01), w23, 1);
+            }
+            double *pa = &x[start + k].real;
+            double *pb = &x[start + k + half].real;
+            __m512d b = _mm512_loadu_pd(pb);
+            __m512d p = _mm512_mul_pd(_mm512_movedup_pd(w), b);
+            __m512d q = _mm512_mul_pd(_mm512_permute_pd(w, 0xFF), _mm512_permute_pd(b, 0x55));
+            // Subtract in the real lanes, add in the imaginary ones
+            __m512d t = _mm512_mask_sub_pd(_mm512_add_pd(p, q), 0x55, p, q);
+            __m512d a = _mm512_loadu_pd(pa);
+            _mm512_storeu_pd(pb, _mm512_sub_pd(a, t));
+            _mm512_storeu_pd(pa, _mm512_add_pd(a, t));
+        }
+    }
+}
+
+DSP_TARGET("avx512f")
+static inline __m512d s16x8_to_pd_avx512(const int16_t *in) {
+    __m256i x32 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)in));
+    return _mm512_mul_pd(_mm512_cvtepi32_pd(x32), _mm512_set1_pd(S16_SCALE));
+}
+
+DSP_TARGET("avx512f")
+static void window_s16_avx512(const int16_t *samples, const double *window, Complex *out, size_t n) {
+    const __m512i lo_idx = _mm512_set_epi64(8, 3, 8, 2, 8, 1, 8, 0);
+    const __m512i hi_idx = _mm512_set_epi64(8, 7, 8, 6, 8, 5, 8, 4);
+    __m512d zero = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_mul_pd(s16x8_to_pd_avx512(samples + i), _mm512_loadu_pd(window + i));
+        double *o = &out[i].real;
+        _mm512_storeu_pd(o, _mm512_permutex2var_pd(v, lo_idx, zero));
+        _mm512_storeu_pd(o + 8, _mm512_permutex2var_pd(v, hi_idx, zero));
+    }
+    window_s16_avx2(samples + i, window + i, out + i, n - i);
+}
+
+/* Internal helper: |X|^2 of eight adjacent bins, in order */
+DSP_TARGET("avx512f")
+static inline __m512d power8_avx512(const Complex *bins) {
+    const __m512i re_idx = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i im_idx = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+    __m512d a = _mm512_loadu_pd(&bins[0].real);
+    __m512d b = _mm512_loadu_pd(&bins[4].real);
+    a = _mm512_mul_pd(a, a);
+    b = _mm512_mul_pd(b, b);
+    return _mm512_add_pd(_mm512_permutex2var_pd(a, re_idx, b), _mm512_permutex2var_pd(a, im_idx, b));
+}
+
+DSP_TARGET("avx512f")
+static void power_avx512(const Complex *bins, double *out, size_t n, double lo, double hi) {
+    __m512d vlo = _mm512_set1_pd(lo), vhi = _mm512_set1_pd(hi);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_min_pd(vhi, _mm512_max_pd(vlo, power8_avx512(bins + i))));
+    }
+    power_avx2(bins + i, out + i, n - i, lo, hi);
+}
+
+DSP_TARGET("avx512f")
+static void magnitude_avx512(const Complex *bins, double *out, size_t n, double lo, double hi) {
+    __m512d vlo = _mm512_set1_pd(lo), vhi = _mm512_set1_pd(hi);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_sqrt_pd(power8_avx512(bins + i));
+        _mm512_storeu_pd(out + i, _mm512_min_pd(vhi, _mm512_max_pd(vlo, v)));
+    }
+    magnitude_avx2(bins + i, out + i, n - i, lo, hi);
+}
+
+DSP_TARGET("avx512f")
+static void s16_to_double_avx512(const int16_t *in, double *out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, s16x8_to_pd_avx512(in + i));
+    }
+    s16_to_double_avx2(in + i, out + i, n - i);
+}
+
+DSP_TARGET("avx512f")
+static void double_to_s16_avx512(const double *in, int16_t *out, size_t n) {
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d lo = _mm512_set1_pd(-32768.0), hi = _mm512_set1_pd(32767.0);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_mul_pd(_mm512_loadu_pd(in + i), _mm512_set1_pd(32768.0));
+        // Add or subtract one half by the sign of v
+        __mmask8 neg = _mm512_cmp_pd_mask(v, _mm512_setzero_pd(), _CMP_LT_OQ);
+        v = _mm512_mask_sub_pd(_mm512_add_pd(v, half), neg, v, half);
+        __m256i x = _mm512_cvttpd_epi32(_mm512_min_pd(hi, _mm512_max_pd(lo, v)));
+        _mm_storeu_si128((__m128i *)(out + i),
+                         _mm_packs_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+    }
+    double_to_s16_avx2(in + i, out + i, n - i);
+}
+
+/* The dot products keep the AVX2 kernels: FIR delay lines start at arbitrary
+ * offsets, so most 512-bit loads split a cache line and ran slower (and
+ * 512-bit pmaddwd needs AVX-512BW) */
+static const DspKernels kernels_avx512 = {
+    DSP_CPU_AVX512,
+    fft_stage_avx512,
+    dot_avx2,
+    dot_folded_avx2,
+    dot_q15_avx2,
+    window_s16_avx512,
+    power_avx512,
+    magnitude_avx512,
+    s16_to_double_avx512,
+    double_to_s16_avx512
+};
+#endif /* DSP_CPU_X86 */
+
+/******************************************************************************/
+/* binding */
+
+/******************************************************************************
+ * dsp_cpu_detect
+ *
+ * @returns Highest kernel level the running CPU and this build support
+ *
+ * @note Reads cpuid (and the OS-enabled register state for AVX/AVX-512)
+ *       through the compiler's CPU model builtins.
+ */
+DspCpuLevel dsp_cpu_detect(void) {
+#if DSP_CPU_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return DSP_CPU_AVX512;
+    if (__builtin_cpu_supports("avx2")) return DSP_CPU_AVX2;
+    if (__builtin_cpu_supports("sse2")) return DSP_CPU_SSE2;
+#endif
+    return DSP_CPU_SCALAR;
+}
+/* End of dsp_cpu_detect() */
+/******************************************************************************/
+
+const DspKernels *dsp_kernels_for(DspCpuLevel level) {
+    if ((unsigned)level >= DSP_CPU_LEVEL_COUNT || level > dsp_cpu_detect()) return NULL;
+
+    switch (level) {
+#if DSP_CPU_X86
+        case DSP_CPU_SSE2:   return &kernels_sse2;
+        case DSP_CPU_AVX2:   return &kernels_avx2;
+        case DSP_CPU_AVX512: return &kernels_avx512;
+#endif
+        default:             return &kernels_scalar;
+    }
+}
+
+const char *dsp_cpu_level_name(DspCpuLevel level) {
+    return (unsigned)level < DSP_CPU_LEVEL_COUNT ? level_names[level] : "unknown";
+}
+
+/* Internal helper: detected level, capped by the DSP_CPU override */
+static DspCpuLevel dsp_cpu_select(void) {
+    DspCpuLevel level = dsp_cpu_detect();
+    const char *env = getenv(DSP_CPU_ENV);
+    if (!env) return level;
+
+    for (int l = 0; l < DSP_CPU_LEVEL_COUNT; l++) {
+        if (strcmp(env, level_names[l]) == 0) {
+            return (DspCpuLevel)l < level ? (DspCpuLevel)l : level;
+        }
+    }
+    return level;
+}
+
+/******************************************************************************
+ * dsp_kernels
+ *
+ * @returns The kernel table in use
+ *
+ * @note The first call selects the table; concurrent first calls all pick
+ *       the same one, so no lock is needed.
+ */
+const DspKernels *dsp_kernels(void) {
+    const DspKernels *k = atomic_load_explicit(&dsp_active, memory_order_acquire);
+    if (!k) {
+        k = dsp_kernels_for(dsp_cpu_select());
+        atomic_store_explicit(&dsp_active, k, memory_order_release);
+    }
+    return k;
+}
+/* End of dsp_kernels() */
+/******************************************************************************/
+
+int dsp_cpu_set_level(DspCpuLevel level) {
+    const DspKernels *k = dsp_kernels_for(level);
+    if (!k) return -1;
+    atomic_store_explicit(&dsp_active, k, memory_order_release);
+    return 0;
+}
+
+DspCpuLevel dsp_cpu_level(void) {
+    return dsp_kernels()->level;
+}
+
+/******************************************************************************/
+/* floating-point mode */
+
+void dsp_set_denormal_policy(DspDenormalPolicy policy) {
+    atomic_store_explicit(&denormal_policy, (int)policy, memory_order_relaxed);
+}
+
+DspDenormalPolicy dsp_denormal_policy(void) {
+    return (DspDenormalPolicy)atomic_load_explicit(&denormal_policy, memory_order_relaxed);
+}
+
+/******************************************************************************
+ * dsp_fp_flush_begin
+ *
+ * @param[out] saved Receives the mode to restore with dsp_fp_scope_end()
+ *
+ * @note Sets FTZ and DAZ on x86 (SSE arithmetic only; x87 is unaffected)
+ *       and FZ on AArch64. The register is written only if a bit is
+ *       missing, so nested scopes cost one read. A no-op on other targets.
+ */
+void dsp_fp_flush_begin(DspFpState *saved) {
+    saved->changed = 0;
+#if DSP_CPU_X86
+    saved->csr = _mm_getcsr();
+    if ((saved->csr & MXCSR_FTZ_DAZ) != MXCSR_FTZ_DAZ) {
+        _mm_setcsr(saved->csr | MXCSR_FTZ_DAZ);
+        saved->changed = 1;
+    }
+#elif defined(__GNUC__) && defined(__aarch64__)
+    uint64_t fpcr;
+    __asm__ volatile("mrs %0, fpcr" : "=r"(fpcr));
+    saved->csr = (uint32_t)fpcr;
+    if (!(fpcr & FPCR_FZ)) {
+        __asm__ volatile("msr fpcr, %0" : : "r"(fpcr | FPCR_FZ));
+        saved->changed = 1;
+    }
+#else
+    saved->csr = 0;
+#endif
+}
+/* End of dsp_fp_flush_begin() */
+/******************************************************************************/
+
+void dsp_fp_scope_begin(DspFpState *saved) {
+    if (dsp_denormal_policy() == DSP_DENORMALS_FLUSH) {
+        dsp_fp_flush_begin(saved);
+    } else {
+        saved->changed = 0;
+    }
+}
+
+void dsp_fp_scope_end(const DspFpState *saved) {
+    if (!saved->changed) return;
+#if DSP_CPU_X86
+    _mm_setcsr(saved->csr);
+#elif defined(__GNUC__) && defined(__aarch64__)
+    __asm__ volatile("msr fpcr, %0" : : "r"((uint64_t)saved->csr));
+#endif
+}
+
+/******************************************************************************/
+/* verification */
+
+/* Internal helper: deterministic values in [-1, 1) */
+static double verify_random(uint32_t *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return (double)(*state >> 8) / (1u << 23) - 1.0;
+}
+
+/******************************************************************************
+ * dsp_kernels_verify
+ *
+ * @param[in] level Kernel level to check
+ *
+ * @returns 0 if every kernel matches the scalar table bit for bit, 1 on a
+ *          mismatch, -1 if the level is unavailable on this machine
+ *
+ * @note Covers every length up to VERIFY_MAX_SHORT (all tail cases), a long
+ *       run, out-of-range and exactly-half samples for the conversion, and
+ *       every stage of FFTs up to VERIFY_MAX_FFT points. Allocates scratch.
+ */
+int dsp_kernels_verify(DspCpuLevel level) {
+    const DspKernels *k = dsp_kernels_for(level);
+    if (!k) return -1;
+    const DspKernels *ref = &kernels_scalar;
+
+    size_t len = VERIFY_LONG > 2 * VERIFY_MAX_FFT ? VERIFY_LONG : 2 * VERIFY_MAX_FFT;
+    double *a = malloc(len * sizeof(double));
+    double *b = malloc(len * sizeof(double));
+    double *out_ref = malloc(len * sizeof(double));
+    double *out = malloc(len * sizeof(double));
+    int16_t *s16 = malloc(len * sizeof(int16_t));
+    int16_t *s16_ref = malloc(len * sizeof(int16_t));
+    Complex *c = malloc(len * sizeof(Complex));
+    Complex *c_ref = malloc(len * sizeof(Complex));
+    Complex *twiddle = malloc(VERIFY_MAX_FFT / 2 * sizeof(Complex));
+    int result = 0;
+    if (!a || !b || !out_ref || !out || !s16 || !s16_ref || !c || !c_ref || !twiddle) {
+        result = -1;
+        goto done;
+    }
+
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < len; i++) {
+        a[i] = verify_random(&seed);
+        b[i] = verify_random(&seed) * 1e3;
+        s16[i] = (int16_t)(verify_random(&seed) * 32768.0);
+    }
+    // Conversion edge cases: saturation and halfway points
+    a[0] = 1.5;
+    a[1] = -1.5;
+    a[2] = 0.5 / 32768.0;
+    a[3] = -0.5 / 32768.0;
+    a[4] = -0.0;
+    s16[0] = INT16_MIN;
+    s16[1] = INT16_MAX;
+
+    for (size_t pass = 0; pass <= VERIFY_MAX_SHORT + 1 && !result; pass++) {
+        size_t n = pass <= VERIFY_MAX_SHORT ? pass : VERIFY_LONG;
+
+        double d_ref = ref->dot(a, b, n), d = k->dot(a, b, n);
+        if (memcmp(&d_ref, &d, sizeof(d)) != 0) result = 1;
+
+        // Full-range int16 (s16[0] and s16[1] are the extremes) so the sums wrap
+        if (ref->dot_q15(s16, s16 + 1, n) != k->dot_q15(s16, s16 + 1, n)) result = 1;
+
+        // Folded taps read a[0 .. 2n-1] forwards and a[2n .. 1] backwards
+        for (int stride = 1; stride <= 2; stride++) {
+            for (int subtract = 0; subtract <= 1; subtract++) {
+                d_ref = ref->dot_folded(b, a, a + 2 * n, n, stride, subtract);
+                d = k->dot_folded(b, a, a + 2 * n, n, stride, subtract);
+                if (memcmp(&d_ref, &d, sizeof(d)) != 0) result = 1;
+            }
+        }
+
+        ref->s16_to_double(s16, out_ref, n);
+        k->s16_to_double(s16, out, n);
+        if (memcmp(out_ref, out, n * sizeof(double)) != 0) result = 1;
+
+        ref->double_to_s16(a, s16_ref, n);
+        int16_t *conv = (int16_t *)c;
+        k->double_to_s16(a, conv, n);
+        if (memcmp(s16_ref, conv, n * sizeof(int16_t)) != 0) result = 1;
+
+        ref->window_s16(s16, a, c_ref, n);
+        k->window_s16(s16, a, c, n);
+        if (memcmp(c_ref, c, n * sizeof(Complex)) != 0) result = 1;
+
+        for (size_t i = 0; i < n; i++) {
+            c[i].real = b[i];
+            c[i].imag = a[i];
+        }
+        ref->power(c, out_ref, n, -HUGE_VAL, 5e5);
+        k->power(c, out, n, -HUGE_VAL, 5e5);
+        if (memcmp(out_ref, out, n * sizeof(double)) != 0) result = 1;
+
+        ref->magnitude(c, out_ref, n, 10.0, HUGE_VAL);
+        k->magnitude(c, out, n, 10.0, HUGE_VAL);
+        if (memcmp(out_ref, out, n * sizeof(double)) != 0) result = 1;
+    }
+
+    for (int n = 2; n <= VERIFY_MAX_FFT && !result; n *= 2) {
+        for (int i = 0; i < n / 2; i++) {
+            twiddle[i].real = cos(2 * PI * i / n);
+            twiddle[i].imag = -sin(2 * PI * i / n);
+        }
+        for (int i = 0; i < n; i++) {
+            c_ref[i].real = c[i].real = a[i];
+            c_ref[i].imag = c[i].imag = b[i];
+        }
+        for (int span = 2; span <= n; span *= 2) {
+            ref->fft_stage(c_ref, twiddle, n, span / 2, n / span);
+            k->fft_stage(c, twiddle, n, span / 2, n / span);
+        }
+        if (memcmp(c_ref, c, n * sizeof(Complex)) != 0) result = 1;
+    }
+
+done:
+    free(a);
+    free(b);
+    free(out_ref);
+    free(out);
+    free(s16);
+    free(s16_ref);
+    free(c);
+    free(c_ref);
+    free(twiddle);
+    return result;
+}
+/* End of dsp_kernels_verify() */
+/******************************************************************************/
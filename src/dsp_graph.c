@@ -0,0 +1,791 @@
+/*
+ * @file dsp_graph.c
+ *
+ * Block-processing graph: node construction, bounded block queues and the
+ * fused and threaded schedulers.
+ *
+ * Each node owns the edge carrying its output: a ring of queue_depth blocks
+ * of out_capacity samples, allocated when the node is added. A node step
+ * takes one block from each input edge, processes it straight into a free
+ * slot of its own edge and publishes it. A multi-input node processes as
+ * many samples as its shortest input block holds; the rest of the longer
+ * blocks stay at the head of their edges (read_pos) for the next step, so
+ * inputs stay aligned even when their block lengths differ. End of stream
+ * travels as an empty block with the eos flag set; a node ends with its
+ * first input to end. STFT and resampler nodes delay their output, so
+ * before passing eos on they feed their delay (tail) in zeros and emit
+ * what was still buffered. When a node finishes early its input edges
+ * are closed, so upstream producers stop instead of blocking on a queue
+ * nobody drains.
+ *
+ * The fused scheduler steps nodes in insertion order on the calling thread.
+ * Blocks are normally consumed in the tick they are produced; a node whose
+ * output edge still holds unread blocks skips the tick instead of waiting,
+ * so partly consumed blocks never stall the single thread. The threaded
+ * scheduler runs one thread per node and lets up to queue_depth blocks
+ * queue on each edge.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dsp_graph.h"
+#include "dsp_cpu.h"
+#include "fir_filter.h"
+#include "iir_filter.h"
+#include "lms_filter.h"
+#include "wav.h"
+
+/******************************************************************************/
+/** local definitions **/
+
+/* Kinds of built-in node */
+typedef enum {
+    NODE_WAV_SOURCE,
+    NODE_BUFFER_SOURCE,
+    NODE_FIR,
+    NODE_IIR,
+    NODE_LMS,
+    NODE_STFT,
+    NODE_RESAMPLER,
+    NODE_CUSTOM,
+    NODE_WAV_SINK,
+    NODE_BUFFER_SINK
+} NodeKind;
+
+/* One preallocated block */
+typedef struct {
+    double *data;   /* [capacity] */
+    int length;     /* valid samples */
+    int eos;        /* end of stream marker (length 0) */
+} DspBlock;
+
+/* Bounded single-producer single-consumer block queue */
+typedef struct {
+    DspBlock *slots;        /* [depth] */
+    int depth;
+    int capacity;           /* samples per block */
+    int head;               /* next slot to read */
+    int count;              /* published blocks */
+    int closed;             /* consumer finished; writes are discarded */
+    int read_pos;           /* samples of the head block consumed (consumer only) */
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} DspEdge;
+
+typedef struct {
+    WavReader reader;
+    int16_t *pcm;           /* [block_size * channels] */
+} WavSourceState;
+
+typedef struct {
+    const double *samples;
+    size_t num_samples;
+    size_t pos;
+} BufferSourceState;
+
+typedef struct {
+    WavWriter writer;
+    int16_t *pcm;           /* [input capacity] */
+} WavSinkState;
+
+typedef struct {
+    double *buffer;
+    size_t capacity;
+    size_t *written;
+} BufferSinkState;
+
+typedef struct {
+    StftStream stream;
+    StftFrameFn fn;
+    void *user;
+} StftState;
+
+typedef struct {
+    NodeKind kind;
+    int inputs[DSP_GRAPH_MAX_INPUTS];
+    int num_inputs;
+    int in_capacity;        /* largest block any input can deliver */
+    int out_capacity;       /* 0 for sinks */
+    int has_consumer;
+    void *state;            /* kind-specific state */
+    DspNodeFn fn;           /* NODE_CUSTOM only */
+    void *user;
+    int tail;               /* zeros still to feed at end of stream (STFT, resampler) */
+    int done;
+} DspNode;
+
+struct DspGraph {
+    int block_size;
+    int queue_depth;
+    int num_nodes;
+    int error;
+    atomic_int abort;
+    pthread_mutex_t error_lock;
+    double *silence;        /* zeros flushing node tails [silence_len] */
+    int silence_len;
+    DspNode nodes[DSP_GRAPH_MAX_NODES];
+    DspEdge edges[DSP_GRAPH_MAX_NODES];
+};
+
+/******************************************************************************/
+/* Edge queue */
+
+/* Internal helper: allocate depth blocks of capacity samples */
+static int edge_init(DspEdge *e, int depth, int capacity) {
+    e->slots = calloc(depth, sizeof(DspBlock));
+    if (!e->slots) return -1;
+    e->depth = depth;
+    e->capacity = capacity;
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->changed, NULL);
+    for (int i = 0; i < depth; i++) {
+        e->slots[i].data = malloc(capacity * sizeof(double));
+        if (!e->slots[i].data) return -1;
+    }
+    return 0;
+}
+
+static void edge_free(DspEdge *e) {
+    if (!e->slots) return;
+    for (int i = 0; i < e->depth; i++) {
+        free(e->slots[i].data);
+    }
+    free(e->slots);
+    e->slots = NULL;
+    pthread_mutex_destroy(&e->lock);
+    pthread_cond_destroy(&e->changed);
+}
+
+/* Internal helper: free slot for the producer, or NULL on abort. A closed
+ * edge hands out a slot that is never published. */
+static DspBlock *edge_begin_write(DspGraph *g, DspEdge *e) {
+    pthread_mutex_lock(&e->lock);
+    while (e->count == e->depth && !e->closed && !g->abort) {
+        pthread_cond_wait(&e->changed, &e->lock);
+    }
+    DspBlock *slot = g->abort ? NULL : &e->slots[(e->head + e->count) % e->depth];
+    if (e->closed && slot) slot = &e->slots[e->head];
+    pthread_mutex_unlock(&e->lock);
+    return slot;
+}
+
+static void edge_end_write(DspEdge *e) {
+    pthread_mutex_lock(&e->lock);
+    if (!e->closed) {
+        e->count++;
+        pthread_cond_broadcast(&e->changed);
+    }
+    pthread_mutex_unlock(&e->lock);
+}
+
+/* Internal helper: oldest published block, or NULL on abort */
+static DspBlock *edge_begin_read(DspGraph *g, DspEdge *e) {
+    pthread_mutex_lock(&e->lock);
+    while (e->count == 0 && !g->abort) {
+        pthread_cond_wait(&e->changed, &e->lock);
+    }
+    DspBlock *slot = g->abort ? NULL : &e->slots[e->head];
+    pthread_mutex_unlock(&e->lock);
+    return slot;
+}
+
+static void edge_end_read(DspEdge *e) {
+    pthread_mutex_lock(&e->lock);
+    e->head = (e->head + 1) % e->depth;
+    e->count--;
+    pthread_cond_broadcast(&e->changed);
+    pthread_mutex_unlock(&e->lock);
+}
+
+/* Internal helper: is every slot published and unread? */
+static int edge_is_full(DspEdge *e) {
+    pthread_mutex_lock(&e->lock);
+    int full = e->count == e->depth && !e->closed;
+    pthread_mutex_unlock(&e->lock);
+    return full;
+}
+
+/* Internal helper: has the consumer finished? */
+static int edge_is_closed(DspEdge *e) {
+    pthread_mutex_lock(&e->lock);
+    int closed = e->closed;
+    pthread_mutex_unlock(&e->lock);
+    return closed;
+}
+
+/* Internal helper: consumer is gone; release a blocked producer */
+static void edge_close(DspEdge *e) {
+    pthread_mutex_lock(&e->lock);
+    e->closed = 1;
+    pthread_cond_broadcast(&e->changed);
+    pthread_mutex_unlock(&e->lock);
+}
+
+/* Internal helper: record the first error and wake every waiting node */
+static void graph_abort(DspGraph *g, int error) {
+    pthread_mutex_lock(&g->error_lock);
+    if (!g->error) g->error = error;
+    g->abort = 1;
+    pthread_mutex_unlock(&g->error_lock);
+
+    for (int i = 0; i < g->num_nodes; i++) {
+        DspEdge *e = &g->edges[i];
+        if (!e->slots) continue;
+        pthread_mutex_lock(&e->lock);
+        pthread_cond_broadcast(&e->changed);
+        pthread_mutex_unlock(&e->lock);
+    }
+}
+
+/******************************************************************************/
+/* Node construction */
+
+/* Internal helper: validate inputs and append a node; returns its id or a
+ * negative error. out_capacity < 0 means "same as the input capacity". */
+static int add_node(DspGraph *g, NodeKind kind, const int *inputs, int num_inputs,
+                    int out_capacity, void *state) {
+    if (!g || g->num_nodes == DSP_GRAPH_MAX_NODES || num_inputs > DSP_GRAPH_MAX_INPUTS) {
+        return -1;
+    }
+
+    int in_capacity = g->block_size;
+    for (int i = 0; i < num_inputs; i++) {
+        int src = inputs[i];
+        if (src < 0 || src >= g->num_nodes || g->nodes[src].out_capacity == 0 ||
+            g->nodes[src].has_consumer) {
+            return -1;
+        }
+        for (int j = 0; j < i; j++) {
+            if (inputs[j] == src) return -1;
+        }
+        if (i == 0 || g->nodes[src].out_capacity > in_capacity) {
+            in_capacity = g->nodes[src].out_capacity;
+        }
+    }
+    if (out_capacity < 0) out_capacity = in_capacity;
+
+    int id = g->num_nodes;
+    DspNode *n = &g->nodes[id];
+    memset(n, 0, sizeof(*n));
+    n->kind = kind;
+    n->num_inputs = num_inputs;
+    n->in_capacity = in_capacity;
+    n->out_capacity = out_capacity;
+    n->state = state;
+    for (int i = 0; i < num_inputs; i++) {
+        n->inputs[i] = inputs[i];
+    }
+
+    if (out_capacity > 0 && edge_init(&g->edges[id], g->queue_depth, out_capacity) != 0) {
+        edge_free(&g->edges[id]);
+        return -2;
+    }
+    for (int i = 0; i < num_inputs; i++) {
+        g->nodes[inputs[i]].has_consumer = 1;
+    }
+    g->num_nodes++;
+    return id;
+}
+
+/* Internal helper: grow the shared zero block that flushes node tails to
+ * the block length of input (ignored if input is invalid; add_node rejects it) */
+static int reserve_silence(DspGraph *g, int input) {
+    if (!g || input < 0 || input >= g->num_nodes) return 0;
+    int len = g->nodes[input].out_capacity;
+    if (len > g->silence_len) {
+        double *zeros = calloc(len, sizeof(double));
+        if (!zeros) return -2;
+        free(g->silence);
+        g->silence = zeros;
+        g->silence_len = len;
+    }
+    return 0;
+}
+
+/* Internal helper: release kind-specific state */
+static void node_free_state(DspNode *n) {
+    if (!n->state) return;
+    switch (n->kind) {
+        case NODE_WAV_SOURCE: {
+            WavSourceState *s = n->state;
+            wav_reader_close(&s->reader);
+            free(s->pcm);
+            break;
+        }
+        case NODE_FIR: fir_filter_free(n->state); break;
+        case NODE_IIR: iir_free(n->state); break;
+        case NODE_LMS: lms_filter_free(n->state); break;
+        case NODE_STFT: stft_stream_free(&((StftState *)n->state)->stream); break;
+        case NODE_RESAMPLER: resampler_free(n->state); break;
+        case NODE_WAV_SINK: {
+            WavSinkState *s = n->state;
+            wav_writer_close(&s->writer);
+            free(s->pcm);
+            break;
+        }
+        default: break;
+    }
+    free(n->state);
+    n->state = NULL;
+}
+
+/******************************************************************************
+ * dsp_graph_create
+ *
+ * @param[in] block_size  Samples per source block
+ * @param[in] queue_depth Blocks buffered per edge in threaded mode (>= 1)
+ *
+ * @returns New graph, or NULL on invalid arguments or allocation failure
+ *
+ * @warning Must call dsp_graph_free() to release memory.
+ */
+DspGraph *dsp_graph_create(int block_size, int queue_depth) {
+    if (block_size < 1 || queue_depth < 1) return NULL;
+
+    DspGraph *g = calloc(1, sizeof(DspGraph));
+    if (!g) return NULL;
+    g->block_size = block_size;
+    g->queue_depth = queue_depth;
+    pthread_mutex_init(&g->error_lock, NULL);
+    return g;
+}
+/* End of dsp_graph_create() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_graph_add_wav_source / dsp_graph_add_buffer_source
+ *
+ * @returns Node id, -1 on invalid arguments, -2 on allocation failure,
+ *          -3 if the WAV file cannot be opened
+ *
+ * @note The WAV file is opened immediately and read one block at a time.
+ */
+int dsp_graph_add_wav_source(DspGraph *g, const char *filename) {
+    if (!g) return -1;
+    WavSourceState *s = calloc(1, sizeof(WavSourceState));
+    if (!s) return -2;
+    if (wav_reader_open(&s->reader, filename) != 0) {
+        free(s);
+        return -3;
+    }
+    s->pcm = malloc((size_t)g->block_size * s->reader.num_channels * sizeof(int16_t));
+
+    int id = s->pcm ? add_node(g, NODE_WAV_SOURCE, NULL, 0, g->block_size, s) : -2;
+    if (id < 0) {
+        wav_reader_close(&s->reader);
+        free(s->pcm);
+        free(s);
+    }
+    return id;
+}
+
+int dsp_graph_add_buffer_source(DspGraph *g, const double *samples, size_t num_samples) {
+    if (!g || (!samples && num_samples > 0)) return -1;
+    BufferSourceState *s = calloc(1, sizeof(BufferSourceState));
+    if (!s) return -2;
+    s->samples = samples;
+    s->num_samples = num_samples;
+
+    int id = add_node(g, NODE_BUFFER_SOURCE, NULL, 0, g->block_size, s);
+    if (id < 0) free(s);
+    return id;
+}
+
+/******************************************************************************
+ * dsp_graph_add_fir / _iir / _lms / _stft / _resampler
+ *
+ * @returns Node id, -1 on invalid arguments (including an input that already
+ *          has a consumer), -2 on allocation or module init failure
+ */
+int dsp_graph_add_fir(DspGraph *g, int input, const double *coeffs, size_t num_taps) {
+    FIRFilter *f = malloc(sizeof(FIRFilter));
+    if (!f) return -2;
+    if (fir_filter_init(f, coeffs, num_taps) != 0) {
+        free(f);
+        return -2;
+    }
+    int id = add_node(g, NODE_FIR, &input, 1, -1, f);
+    if (id < 0) {
+        fir_filter_free(f);
+        free(f);
+    }
+    return id;
+}
+
+int dsp_graph_add_iir(DspGraph *g, int input, int order, const double *a, const double *b) {
+    IIRFilter *f = malloc(sizeof(IIRFilter));
+    if (!f) return -2;
+    if (iir_init(f, order, a, b) != 0) {
+        free(f);
+        return -2;
+    }
+    int id = add_node(g, NODE_IIR, &input, 1, -1, f);
+    if (id < 0) {
+        iir_free(f);
+        free(f);
+    }
+    return id;
+}
+
+int dsp_graph_add_lms(DspGraph *g, int input, int desired, int order, double mu) {
+    LMSFilter *f = malloc(sizeof(LMSFilter));
+    if (!f) return -2;
+    if (lms_filter_init(f, order, mu) != 0) {
+        free(f);
+        return -2;
+    }
+    int inputs[2] = { input, desired };
+    int id = add_node(g, NODE_LMS, inputs, 2, -1, f);
+    if (id < 0) {
+        lms_filter_free(f);
+        free(f);
+    }
+    return id;
+}
+
+int dsp_graph_add_stft(DspGraph *g, int input, int fft_size, int hop_size,
+                       WindowType window_type, StftFrameFn fn, void *user) {
+    StftState *s = malloc(sizeof(StftState));
+    if (!s) return -2;
+    if (stft_stream_init(&s->stream, fft_size, hop_size, window_type) != 0) {
+        free(s);
+        return -2;
+    }
+    s->fn = fn;
+    s->user = user;
+    int id = reserve_silence(g, input) == 0 ? add_node(g, NODE_STFT, &input, 1, -1, s) : -2;
+    if (id >= 0) g->nodes[id].tail = fft_size;
+    if (id < 0) {
+        stft_stream_free(&s->stream);
+        free(s);
+    }
+    return id;
+}
+
+int dsp_graph_add_resampler(DspGraph *g, int input, int in_rate, int out_rate,
+                            ResamplerQuality quality) {
+    if (!g || input < 0 || input >= g->num_nodes) return -1;
+    Resampler *rs = malloc(sizeof(Resampler));
+    if (!rs) return -2;
+    if (resampler_init(rs, in_rate, out_rate, quality) != 0) {
+        free(rs);
+        return -2;
+    }
+    size_t cap = resampler_max_output(rs, (size_t)g->nodes[input].out_capacity);
+    int id = reserve_silence(g, input) == 0 ?
+             add_node(g, NODE_RESAMPLER, &input, 1, (int)cap, rs) : -2;
+    if (id >= 0) g->nodes[id].tail = (int)(rs->num_taps / 2);
+    if (id < 0) {
+        resampler_free(rs);
+        free(rs);
+    }
+    return id;
+}
+
+/******************************************************************************
+ * dsp_graph_add_node
+ *
+ * @param[in] g            Graph
+ * @param[in] inputs       Producer node ids [num_inputs]
+ * @param[in] num_inputs   0 .. DSP_GRAPH_MAX_INPUTS (0 makes a source; fn then
+ *                         returns 0 at end of stream)
+ * @param[in] out_capacity Largest block fn can produce (0 for a sink)
+ * @param[in] fn           Processing callback
+ * @param[in] user         Opaque pointer passed to fn
+ *
+ * @returns Node id or negative error
+ *
+ * @note fn runs on a worker thread in threaded mode.
+ */
+int dsp_graph_add_node(DspGraph *g, const int *inputs, int num_inputs, int out_capacity,
+                       DspNodeFn fn, void *user) {
+    if (!fn || out_capacity < 0 || num_inputs < 0 || (num_inputs == 0 && out_capacity == 0)) {
+        return -1;
+    }
+    int id = add_node(g, NODE_CUSTOM, inputs, num_inputs, out_capacity, NULL);
+    if (id >= 0) {
+        g->nodes[id].fn = fn;
+        g->nodes[id].user = user;
+    }
+    return id;
+}
+
+/******************************************************************************
+ * dsp_graph_add_wav_sink / dsp_graph_add_buffer_sink
+ *
+ * @returns Node id, -1 on invalid arguments, -2 on allocation failure,
+ *          -3 if the WAV file cannot be created
+ */
+int dsp_graph_add_wav_sink(DspGraph *g, int input, const char *filename, int sample_rate) {
+    if (!g || input < 0 || input >= g->num_nodes) return -1;
+    WavSinkState *s = calloc(1, sizeof(WavSinkState));
+    if (!s) return -2;
+    s->pcm = malloc(g->nodes[input].out_capacity * sizeof(int16_t));
+    int ret = !s->pcm ? -2 : wav_writer_open(&s->writer, filename, sample_rate, 1) != 0 ? -3 : 0;
+    if (ret != 0) {
+        free(s->pcm);
+        free(s);
+        return ret;
+    }
+
+    int id = add_node(g, NODE_WAV_SINK, &input, 1, 0, s);
+    if (id < 0) {
+        wav_writer_close(&s->writer);
+        free(s->pcm);
+        free(s);
+    }
+    return id;
+}
+
+int dsp_graph_add_buffer_sink(DspGraph *g, int input, double *buffer, size_t capacity,
+                              size_t *written) {
+    if (!written || (!buffer && capacity > 0)) return -1;
+    BufferSinkState *s = malloc(sizeof(BufferSinkState));
+    if (!s) return -2;
+    s->buffer = buffer;
+    s->capacity = capacity;
+    s->written = written;
+    *written = 0;
+
+    int id = add_node(g, NODE_BUFFER_SINK, &input, 1, 0, s);
+    if (id < 0) free(s);
+    return id;
+}
+
+/******************************************************************************/
+/* Scheduling */
+
+/* Internal helper: run one node on one set of input blocks. Returns samples
+ * written to out, 0 at the end of a source, or a negative error. */
+static int node_process(DspGraph *g, DspNode *n, const double *const *in, int num_in,
+                        double *out) {
+    switch (n->kind) {
+        case NODE_WAV_SOURCE: {
+            WavSourceState *s = n->state;
+            int channels = s->reader.num_channels;
+            size_t frames = wav_reader_read(&s->reader, s->pcm, g->block_size);
+            for (size_t i = 0; i < frames; i++) {
+                double acc = 0.0;
+                for (int ch = 0; ch < channels; ch++) {
+                    acc += s->pcm[i * channels + ch];
+                }
+                out[i] = acc / (32768.0 * channels);
+            }
+            return (int)frames;
+        }
+        case NODE_BUFFER_SOURCE: {
+            BufferSourceState *s = n->state;
+            size_t count = s->num_samples - s->pos;
+            if (count > (size_t)g->block_size) count = g->block_size;
+            memcpy(out, s->samples + s->pos, count * sizeof(double));
+            s->pos += count;
+            return (int)count;
+        }
+        case NODE_FIR:
+            fir_filter_process_block(n->state, in[0], out, num_in);
+            return num_in;
+        case NODE_IIR:
+            iir_process_block(n->state, in[0], out, num_in);
+            return num_in;
+        case NODE_LMS:
+            lms_filter_process_block(n->state, in[0], in[1], out, num_in);
+            return num_in;
+        case NODE_STFT: {
+            StftState *s = n->state;
+            stft_stream_process(&s->stream, in[0], out, num_in, s->fn, s->user);
+            return num_in;
+        }
+        case NODE_RESAMPLER:
+            return (int)resampler_process(n->state, in[0], num_in, out, n->out_capacity);
+        case NODE_CUSTOM:
+            return n->fn(n->user, in, num_in, out, n->out_capacity);
+        case NODE_WAV_SINK: {
+            WavSinkState *s = n->state;
+            dsp_kernels()->double_to_s16(in[0], s->pcm, num_in);
+            return wav_writer_write(&s->writer, s->pcm, num_in);
+        }
+        case NODE_BUFFER_SINK: {
+            BufferSinkState *s = n->state;
+            size_t room = s->capacity - *s->written;
+            size_t count = (size_t)num_in < room ? (size_t)num_in : room;
+            memcpy(s->buffer + *s->written, in[0], count * sizeof(double));
+            *s->written += count;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* Internal helper: mark a node finished and release its producers */
+static void node_finish(DspGraph *g, DspNode *n) {
+    n->done = 1;
+    for (int i = 0; i < n->num_inputs; i++) {
+        edge_close(&g->edges[n->inputs[i]]);
+    }
+}
+
+/* Internal helper: one block through one node. Returns 1 once the node has
+ * finished, 0 to keep going, -1 on abort. With nowait set (fused
+ * scheduler) a node whose output edge is full returns 0 without running. */
+static int node_step(DspGraph *g, int id, int nowait) {
+    DspNode *n = &g->nodes[id];
+    DspEdge *out_edge = n->out_capacity > 0 ? &g->edges[id] : NULL;
+
+    // Consumer gone: nothing downstream needs more output
+    if (out_edge && edge_is_closed(out_edge)) {
+        node_finish(g, n);
+        return 1;
+    }
+    if (nowait && out_edge && edge_is_full(out_edge)) return 0;
+
+    // Unread samples of each head block, starting at its read position
+    DspBlock *in_blocks[DSP_GRAPH_MAX_INPUTS];
+    const double *in_data[DSP_GRAPH_MAX_INPUTS];
+    int eos = 0;
+    int num_in = 0;
+    for (int i = 0; i < n->num_inputs; i++) {
+        DspEdge *in_edge = &g->edges[n->inputs[i]];
+        in_blocks[i] = edge_begin_read(g, in_edge);
+        if (!in_blocks[i]) return -1;
+        in_data[i] = in_blocks[i]->data + in_edge->read_pos;
+        eos |= in_blocks[i]->eos;
+        int avail = in_blocks[i]->length - in_edge->read_pos;
+        if (i == 0 || avail < num_in) num_in = avail;
+    }
+
+    DspBlock *out = NULL;
+    if (out_edge) {
+        out = edge_begin_write(g, out_edge);
+        if (!out) return -1;
+    }
+
+    // End of stream reached a node with delayed output: push zeros through
+    // it until its tail is out, holding the eos block back until then
+    int flushing = eos && n->tail > 0;
+    if (flushing) {
+        num_in = n->tail < n->in_capacity ? n->tail : n->in_capacity;
+        n->tail -= num_in;
+        in_data[0] = g->silence;
+    }
+
+    int produced = 0;
+    if (!eos || flushing) {
+        produced = node_process(g, n, in_data, num_in, out ? out->data : NULL);
+        // A callback claiming more than its block holds would overrun readers
+        if (produced < 0 || (out && produced > n->out_capacity)) {
+            graph_abort(g, -4);
+            return -1;
+        }
+        if (n->num_inputs == 0 && produced == 0) eos = 1;
+    }
+
+    // Release the blocks used up; at end of stream every input is released
+    for (int i = 0; i < n->num_inputs && !flushing; i++) {
+        DspEdge *in_edge = &g->edges[n->inputs[i]];
+        in_edge->read_pos += num_in;
+        if (eos || in_edge->read_pos >= in_blocks[i]->length) {
+            in_edge->read_pos = 0;
+            edge_end_read(in_edge);
+        }
+    }
+    if (flushing) eos = 0;
+    if (out) {
+        out->length = eos ? 0 : produced;
+        out->eos = eos;
+        edge_end_write(out_edge);
+    }
+
+    if (eos) node_finish(g, n);
+    return eos;
+}
+
+/* Internal helper: worker thread body for the threaded scheduler */
+typedef struct {
+    DspGraph *g;
+    int id;
+} NodeThread;
+
+static void *node_thread(void *arg) {
+    NodeThread *t = arg;
+    while (node_step(t->g, t->id, 0) == 0) {
+    }
+    return NULL;
+}
+
+/******************************************************************************
+ * dsp_graph_run
+ *
+ * @param[in,out] g    Graph
+ * @param[in]     mode DSP_GRAPH_FUSED or DSP_GRAPH_THREADED
+ *
+ * @returns 0 on success, -1 on an invalid graph (no nodes, or an output
+ *          without a consumer), -3 if threads cannot be started, -4 if a
+ *          node failed while processing (including a custom node returning
+ *          more than its out_capacity)
+ *
+ * @note A graph runs once; WAV sinks are finalized by dsp_graph_free().
+ */
+int dsp_graph_run(DspGraph *g, DspGraphMode mode) {
+    if (!g || g->num_nodes == 0) return -1;
+    for (int i = 0; i < g->num_nodes; i++) {
+        if (g->nodes[i].out_capacity > 0 && !g->nodes[i].has_consumer) return -1;
+    }
+
+    if (mode == DSP_GRAPH_FUSED) {
+        int remaining = g->num_nodes;
+        while (remaining > 0 && !g->abort) {
+            for (int i = 0; i < g->num_nodes; i++) {
+                if (g->nodes[i].done) continue;
+                int ret = node_step(g, i, 1);
+                if (ret < 0) break;
+                remaining -= ret;
+            }
+        }
+        return g->error;
+    }
+
+    pthread_t threads[DSP_GRAPH_MAX_NODES];
+    NodeThread args[DSP_GRAPH_MAX_NODES];
+    int started = 0;
+    for (; started < g->num_nodes; started++) {
+        args[started].g = g;
+        args[started].id = started;
+        if (pthread_create(&threads[started], NULL, node_thread, &args[started]) != 0) {
+            graph_abort(g, -3);
+            break;
+        }
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return g->error;
+}
+/* End of dsp_graph_run() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_graph_free
+ *
+ * @param[in,out] g Graph (may be NULL)
+ *
+ * @note Closes WAV sinks, which patches their headers.
+ */
+void dsp_graph_free(DspGraph *g) {
+    if (!g) return;
+    for (int i = 0; i < g->num_nodes; i++) {
+        node_free_state(&g->nodes[i]);
+        edge_free(&g->edges[i]);
+    }
+    free(g->silence);
+    pthread_mutex_destroy(&g->error_lock);
+    free(g);
+}
+/* End of dsp_graph_free() */
+/******************************************************************************/
@@ -0,0 +1,292 @@
+/*
+ * @file dsp_profile.c
+ *
+ * Per-stage profiling counters for the instrumented library entry points.
+ *
+ * Counters are C11 atomics updated with relaxed ordering, so instrumented
+ * functions may run concurrently on several threads and a monitoring
+ * thread may call dsp_profile_get()/dsp_profile_dump() at any time.
+ * Snapshots are per-field consistent, not transactionally consistent.
+ *
+ * The recording functions are always compiled so the query API links in
+ * every build; they are only called when the library itself is compiled
+ * with DSP_PROFILE (see dsp_profile.h).
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stdatomic.h>
+#include <time.h>
+#include "dsp_profile.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define DSP_PROF_HAVE_TSC 1
+#endif
+
+/******************************************************************************/
+/** local definitions **/
+typedef struct {
+    _Atomic uint64_t calls;
+    _Atomic uint64_t total_ns;
+    _Atomic uint64_t min_ns;
+    _Atomic uint64_t max_ns;
+    _Atomic uint64_t total_cycles;
+    _Atomic uint64_t bytes_allocated;
+    _Atomic uint64_t hist[DSP_PROF_HIST_BUCKETS];
+} DspProfileSlot;
+
+static DspProfileSlot slots[DSP_PROF_COUNT];
+
+static const char *const stage_names[DSP_PROF_COUNT] = {
+    "fft",
+    "ifft",
+    "spectrogram",
+    "spectrogram_window",
+    "spectrogram_fft",
+    "spectrogram_magnitude",
+    "welch",
+    "cqt",
+    "fir_filter",
+    "iir_filter",
+    "lms_filter",
+    "rls_filter",
+    "ap_filter",
+    "cic",
+    "resampler",
+    "load_wav",
+    "save_wav"
+};
+
+/* Internal helper: monotonic clock in nanoseconds */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Internal helper: floor(log2(v)) clamped to the histogram range */
+static int hist_bucket(uint64_t v) {
+    int b = 0;
+    while (v > 1 && b < DSP_PROF_HIST_BUCKETS - 1) {
+        v >>= 1;
+        b++;
+    }
+    return b;
+}
+
+/******************************************************************************
+ * dsp_profile_enabled
+ *
+ * @returns 1 if the library was built with DSP_PROFILE, 0 otherwise
+ */
+int dsp_profile_enabled(void) {
+#ifdef DSP_PROFILE
+    return 1;
+#else
+    return 0;
+#endif
+}
+/* End of dsp_profile_enabled() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_profile_name
+ *
+ * @param[in] id Stage identifier
+ *
+ * @returns Stage name, or "unknown" for an out-of-range id
+ */
+const char *dsp_profile_name(DspProfileId id) {
+    if ((int)id < 0 || id >= DSP_PROF_COUNT) return "unknown";
+    return stage_names[id];
+}
+/* End of dsp_profile_name() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_profile_begin
+ *
+ * @returns Start mark holding the current time and cycle counter
+ *
+ * @note Called through DSP_PROFILE_BEGIN(); not normally used directly.
+ */
+DspProfileMark dsp_profile_begin(void) {
+    DspProfileMark mark;
+#ifdef DSP_PROF_HAVE_TSC
+    mark.cycles = __rdtsc();
+#else
+    mark.cycles = 0;
+#endif
+    mark.ns = now_ns();
+    return mark;
+}
+/* End of dsp_profile_begin() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_profile_end
+ *
+ * @param[in] id   Stage being closed
+ * @param[in] mark Start mark from dsp_profile_begin()
+ *
+ * @note Adds one call, its duration, cycle count and histogram entry.
+ */
+void dsp_profile_end(DspProfileId id, DspProfileMark mark) {
+    uint64_t elapsed = now_ns() - mark.ns;
+#ifdef DSP_PROF_HAVE_TSC
+    uint64_t cycles = __rdtsc() - mark.cycles;
+#else
+    uint64_t cycles = 0;
+#endif
+    DspProfileSlot *s = &slots[id];
+
+    atomic_fetch_add_explicit(&s->calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->total_ns, elapsed, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->total_cycles, cycles, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->hist[hist_bucket(elapsed)], 1, memory_order_relaxed);
+
+    uint64_t cur = atomic_load_explicit(&s->max_ns, memory_order_relaxed);
+    while (elapsed > cur &&
+           !atomic_compare_exchange_weak_explicit(&s->max_ns, &cur, elapsed,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+
+    // min_ns == 0 means "no calls yet"; store elapsed + 1 internally
+    uint64_t biased = elapsed + 1;
+    cur = atomic_load_explicit(&s->min_ns, memory_order_relaxed);
+    while ((cur == 0 || biased < cur) &&
+           !atomic_compare_exchange_weak_explicit(&s->min_ns, &cur, biased,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+/* End of dsp_profile_end() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_profile_alloc
+ *
+ * @param[in] id    Stage performing the allocation
+ * @param[in] bytes Number of bytes requested
+ */
+void dsp_profile_alloc(DspProfileId id, uint64_t bytes) {
+    atomic_fetch_add_explicit(&slots[id].bytes_allocated, bytes, memory_order_relaxed);
+}
+/* End of dsp_profile_alloc() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_profile_get
+ *
+ * @param[in]  id  Stage identifier
+ * @param[out] out Snapshot of the stage's counters
+ *
+ * @returns 0 on success, -1 if id is out of range
+ */
+int dsp_profile_get(DspProfileId id, DspProfileStats *out) {
+    if ((int)id < 0 || id >= DSP_PROF_COUNT || !out) return -1;
+
+    DspProfileSlot *s = &slots[id];
+    uint64_t min_biased = atomic_load_explicit(&s->min_ns, memory_order_relaxed);
+
+    out->calls = atomic_load_explicit(&s->calls, memory_order_relaxed);
+    out->total_ns = atomic_load_explicit(&s->total_ns, memory_order_relaxed);
+    out->min_ns = min_biased ? min_biased - 1 : 0;
+    out->max_ns = atomic_load_explicit(&s->max_ns, memory_order_relaxed);
+    out->total_cycles = atomic_load_explicit(&s->total_cycles, memory_order_relaxed);
+    out->bytes_allocated = atomic_load_explicit(&s->bytes_allocated, memory_order_relaxed);
+    for (int b = 0; b < DSP_PROF_HIST_BUCKETS; b++) {
+        out->hist[b] = atomic_load_explicit(&s->hist[b], memory_order_relaxed);
+    }
+    return 0;
+}
+/* End of dsp_profile_get() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_profile_reset
+ *
+ * @note Safe to call while instrumented code runs; in-flight calls are
+ *       counted after the reset.
+ */
+void dsp_profile_reset(void) {
+    for (int id = 0; id < DSP_PROF_COUNT; id++) {
+        DspProfileSlot *s = &slots[id];
+        atomic_store_explicit(&s->calls, 0, memory_order_relaxed);
+        atomic_store_explicit(&s->total_ns, 0, memory_order_relaxed);
+        atomic_store_explicit(&s->min_ns, 0, memory_order_relaxed);
+        atomic_store_explicit(&s->max_ns, 0, memory_order_relaxed);
+        atomic_store_explicit(&s->total_cycles, 0, memory_order_relaxed);
+        atomic_store_explicit(&s->bytes_allocated, 0, memory_order_relaxed);
+        for (int b = 0; b < DSP_PROF_HIST_BUCKETS; b++) {
+            atomic_store_explicit(&s->hist[b], 0, memory_order_relaxed);
+        }
+    }
+}
+/* End of dsp_profile_reset() */
+/******************************************************************************/
+
+/******************************************************************************
+ * dsp_profile_dump
+ *
+ * @param[in] f      Output stream
+ * @param[in] format DSP_PROF_FORMAT_CSV or DSP_PROF_FORMAT_JSON
+ *
+ * @returns 0 on success, -1 on a NULL stream
+ *
+ * @note
+ * - CSV: one row per stage; the histogram is a ';'-separated list of
+ *   bucket counts up to the last non-empty bucket.
+ * - JSON: an object keyed by stage name.
+ */
+int dsp_profile_dump(FILE *f, DspProfileFormat format) {
+    if (!f) return -1;
+
+    if (format == DSP_PROF_FORMAT_CSV) {
+        fprintf(f, "stage,calls,total_ns,mean_ns,min_ns,max_ns,total_cycles,bytes_allocated,hist_log2_ns\n");
+    } else {
+        fprintf(f, "{\n");
+    }
+
+    for (int id = 0; id < DSP_PROF_COUNT; id++) {
+        DspProfileStats st;
+        dsp_profile_get((DspProfileId)id, &st);
+
+        int last = DSP_PROF_HIST_BUCKETS - 1;
+        while (last > 0 && st.hist[last] == 0) last--;
+        double mean = st.calls ? (double)st.total_ns / st.calls : 0.0;
+
+        if (format == DSP_PROF_FORMAT_CSV) {
+            fprintf(f, "%s,%llu,%llu,%.1f,%llu,%llu,%llu,%llu,", stage_names[id],
+                    (unsigned long long)st.calls, (unsigned long long)st.total_ns, mean,
+                    (unsigned long long)st.min_ns, (unsigned long long)st.max_ns,
+                    (unsigned long long)st.total_cycles, (unsigned long long)st.bytes_allocated);
+            for (int b = 0; b <= last; b++) {
+                fprintf(f, "%s%llu", b ? ";" : "", (unsigned long long)st.hist[b]);
+            }
+            fprintf(f, "\n");
+        } else {
+            fprintf(f, "  \"%s\": {\"calls\": %llu, \"total_ns\": %llu, \"mean_ns\": %.1f, "
+                       "\"min_ns\": %llu, \"max_ns\": %llu, \"total_cycles\": %llu, "
+                       "\"bytes_allocated\": %llu, \"hist_log2_ns\": [",
+                    stage_names[id], (unsigned long long)st.calls,
+                    (unsigned long long)st.total_ns, mean,
+                    (unsigned long long)st.min_ns, (unsigned long long)st.max_ns,
+                    (unsigned long long)st.total_cycles, (unsigned long long)st.bytes_allocated);
+            for (int b = 0; b <= last; b++) {
+                fprintf(f, "%s%llu", b ? ", " : "", (unsigned long long)st.hist[b]);
+            }
+            fprintf(f, "]}%s\n", id < DSP_PROF_COUNT - 1 ? "," : "");
+        }
+    }
+
+    if (format == DSP_PROF_FORMAT_JSON) {
+        fprintf(f, "}\n");
+    }
+    return 0;
+}
+/* End of dsp_profile_dump() */
+/******************************************************************************/
@@ -9,6 +9,12 @@
  *   - Supports input length N where N is a power of two
  *   - In-place transform of complex data array
  *   - IFFT implemented via conjugation, FFT, and scaling
+ *   - Plan-based iterative FFT (bit-reversal + precomputed twiddles, no
+ *     allocation per call) and a real-input FFT of length n built on a
+ *     complex FFT of length n/2
+ *   - Process-wide plan cache so repeated transforms share their tables
+ *   - Generated straight-line codelets (fft_codelets.h) for n <= 128, which
+ *     also serve as the leaf kernels of longer transforms
  *
  * Usage:
  *   - fft(Complex *x, int n) computes the forward FFT of input array x of length n.
@@ -25,8 +31,10 @@
  *   - Combines results using twiddle factors (complex exponentials)
  *
  * Memory:
- *   - Dynamic memory allocation for even and odd arrays at each recursion level.
- *   - May be inefficient for very large input sizes or embedded systems.
+ *   - fft() and ifft() run on the cached plan for n, so after the first call
+ *     of a given size they allocate nothing. fft_rec() remains as the
+ *     fallback and recurses through a single scratch buffer.
+ *   - fft_plan_init_mem()/rfft_plan_init_mem() build plans in caller memory.
  *
  * Created on: [Insert Date]
  * Author: Omri Kebede
@@ -35,44 +43,63 @@
 /******************************************************************************/
 
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include "fft.h"
+#include "fft_codelets.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+#include "dsp_profile.h"
 // #include "complex.h"
 
 #define PI 3.14159265358979323846
+#define FFT_CACHE_SLOTS 31
+
+/* Plan cache, one slot per power of two. Published plans are read with an
+ * acquire load; the lock only serializes building them (and clearing). */
+static _Atomic(FFTPlan *) fft_cache[FFT_CACHE_SLOTS];
+static _Atomic(RFFTPlan *) rfft_cache[FFT_CACHE_SLOTS];
+static pthread_mutex_t fft_cache_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /******************************************************************************
  * fft_rec
  *
  * @brief        Recursive radix-2 Cooley-Tukey FFT implementation
  *
- * @param[inout] x  Pointer to an array of Complex numbers representing the input
- *                  time-domain samples. The array is overwritten with frequency-domain
- *                  output.
- * @param[in]    n  Length of the input array. Must be a power of two.
+ * @param[inout] x       Pointer to an array of Complex numbers representing the input
+ *                       time-domain samples. The array is overwritten with frequency-domain
+ *                       output.
+ * @param[in]    n       Length of the input array. Must be a power of two.
+ * @param[out]   scratch Work space of n elements, clobbered
  *
  * @returns      void
  *
  * @details
  *   This function performs an in-place recursive FFT on the input array x:
  *   1. Base case: if n <= 1, the FFT of a single element is the element itself.
- *   2. The array is split into even-indexed and odd-indexed elements.
- *   3. fft_rec is called recursively on each half.
+ *   2. The array is split into even-indexed and odd-indexed elements, stored
+ *      in the two halves of scratch.
+ *   3. fft_rec is called recursively on each half, with the (now free) halves
+ *      of x as their scratch.
  *   4. Results are combined using twiddle factors W_N^k = exp(-2*pi*i*k/N).
  *
  * @note
  *   - The function assumes the input size n is a power of two.
- *   - Allocates temporary memory for even and odd arrays at each recursion.
- *   - Called internally by fft() and ifft() functions.
- *
- * @warning
- *   - Recursive allocation may be costly in memory and time for large inputs.
+ *   - Performs no allocation.
+ *   - Fallback for fft() and ifft() when no plan can be built; the
+ *     recursion bottoms out in a codelet at FFT_CODELET_MAX.
  ******************************************************************************/
-static void fft_rec(Complex *x, int n) {
+static void fft_rec(Complex *x, int n, Complex *scratch) {
     if (n <= 1) return;
+    FFTCodelet codelet = fft_codelet(n);
+    if (codelet) {
+        codelet(x);
+        return;
+    }
 
-    Complex *even = malloc(n / 2 * sizeof(Complex));
-    Complex *odd = malloc(n / 2 * sizeof(Complex));
+    Complex *even = scratch;
+    Complex *odd = scratch + n / 2;
 
     // Split input into even and odd elements
     for (int i = 0; i < n / 2; i++) {
@@ -81,8 +108,8 @@ static void fft_rec(Complex *x, int n) {
     }
 
     // Recursive FFT calls
-    fft_rec(even, n / 2);
-    fft_rec(odd, n / 2);
+    fft_rec(even, n / 2, x);
+    fft_rec(odd, n / 2, x + n / 2);
 
     // Combine step with twiddle factors
     for (int k = 0; k < n / 2; k++) {
@@ -98,9 +125,29 @@ static void fft_rec(Complex *x, int n) {
         x[k + n / 2].real = even[k].real - temp.real;
         x[k + n / 2].imag = even[k].imag - temp.imag;
     }
+}
 
-    free(even);
-    free(odd);
+/* Internal helper: forward transform behind fft() and ifft(). Small sizes
+ * go straight to their codelet; otherwise runs the cached plan and only
+ * falls back to the recursion when no plan can be built. */
+static void fft_transform(Complex *x, int n) {
+    if (n < 2) return;
+    FFTCodelet codelet = fft_codelet(n);
+    if (codelet) {
+        codelet(x);
+        return;
+    }
+    const FFTPlan *plan = fft_plan_cached(n);
+    if (plan) {
+        fft_execute(plan, x);
+        return;
+    }
+
+    Complex *scratch = malloc(n * sizeof(Complex));
+    if (!scratch) return;
+    DSP_PROFILE_ALLOC(DSP_PROF_FFT, n * sizeof(Complex));
+    fft_rec(x, n, scratch);
+    free(scratch);
 }
 
 /******************************************************************************
@@ -115,10 +162,13 @@ static void fft_rec(Complex *x, int n) {
  * @returns      void
  *
  * @details
- *   Wrapper function calling the recursive FFT implementation.
+ *   Runs the shared plan for n (built on first use); allocation-free after
+ *   the first call of each size.
  ******************************************************************************/
 void fft(Complex *x, int n) {
-    fft_rec(x, n);
+    DSP_PROFILE_BEGIN(DSP_PROF_FFT);
+    fft_transform(x, n);
+    DSP_PROFILE_END(DSP_PROF_FFT);
 }
 
 /******************************************************************************
@@ -139,18 +189,455 @@ void fft(Complex *x, int n) {
  *   3. Conjugating the FFT output and scaling by 1/n.
  ******************************************************************************/
 void ifft(Complex *x, int n) {
+    DSP_PROFILE_BEGIN(DSP_PROF_IFFT);
+
     // Conjugate input
     for (int i = 0; i < n; i++) {
         x[i].imag = -x[i].imag;
     }
 
-    fft_rec(x, n);
+    fft_transform(x, n);
 
     // Conjugate output and scale
     for (int i = 0; i < n; i++) {
         x[i].real = x[i].real / n;
         x[i].imag = -x[i].imag / n;
     }
+
+    DSP_PROFILE_END(DSP_PROF_IFFT);
+}
+
+/* Internal helper: log2 of a power of two, -1 otherwise */
+static int fft_log2(int n) {
+    if (n < 1 || (n & (n - 1)) != 0) return -1;
+    int log2n = 0;
+    while ((1 << log2n) < n) log2n++;
+    return log2n;
+}
+
+/******************************************************************************
+ * fft_plan_init
+ *
+ * @param[out] plan Pointer to FFTPlan struct to initialize
+ * @param[in]  n    Transform length (power of two)
+ *
+ * @returns 0 on success, -1 if n is not a power of two, -2 on allocation failure
+ *
+ * @warning Must call fft_plan_free() to release memory.
+ ******************************************************************************/
+int fft_plan_init(FFTPlan *plan, int n) {
+    plan->bitrev = NULL;
+    plan->twiddle = NULL;
+    plan->owned_mem = NULL;
+    if (fft_log2(n) < 0) return -1;
+
+    void *mem = malloc(fft_plan_mem_size(n));
+    if (!mem) return -2;
+    fft_plan_init_mem(plan, n, mem);
+    plan->owned_mem = mem;
+    return 0;
+}
+/* End of fft_plan_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fft_plan_mem_size
+ *
+ * @param[in] n Transform length (power of two)
+ *
+ * @returns Bytes of memory fft_plan_init_mem() needs, 0 for an invalid length
+ ******************************************************************************/
+size_t fft_plan_mem_size(int n) {
+    if (fft_log2(n) < 0) return 0;
+    return DSP_MEM_ALIGN_UP(n * sizeof(int)) +
+           DSP_MEM_ALIGN_UP((n / 2 > 0 ? n / 2 : 1) * sizeof(Complex));
+}
+/* End of fft_plan_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fft_plan_init_mem
+ *
+ * @param[out] plan Pointer to FFTPlan struct to initialize
+ * @param[in]  n    Transform length (power of two)
+ * @param[in]  mem  At least fft_plan_mem_size(n) bytes aligned for double;
+ *                  must outlive the plan
+ *
+ * @returns 0 on success, -1 if n is not a power of two
+ *
+ * @note Performs no allocation; fft_plan_free() leaves mem alone.
+ ******************************************************************************/
+int fft_plan_init_mem(FFTPlan *plan, int n, void *mem) {
+    plan->owned_mem = NULL;
+    int log2n = fft_log2(n);
+    if (log2n < 0) return -1;
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, fft_plan_mem_size(n));
+    plan->n = n;
+    plan->bitrev = dsp_arena_alloc(&arena, n * sizeof(int));
+    plan->twiddle = dsp_arena_alloc(&arena, (n / 2 > 0 ? n / 2 : 1) * sizeof(Complex));
+
+    for (int i = 0; i < n; i++) {
+        int r = 0;
+        for (int b = 0; b < log2n; b++) {
+            r |= ((i >> b) & 1) << (log2n - 1 - b);
+        }
+        plan->bitrev[i] = r;
+    }
+    for (int k = 0; k < n / 2; k++) {
+        double t = -2 * PI * k / n;
+        plan->twiddle[k].real = cos(t);
+        plan->twiddle[k].imag = sin(t);
+    }
+    return 0;
+}
+/* End of fft_plan_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fft_execute
+ *
+ * @param[in]    plan Plan for the transform length
+ * @param[inout] x    Data [plan->n], replaced by its forward FFT
+ *
+ * @note Iterative radix-2 decimation in time; no memory is allocated.
+ *       Lengths up to FFT_CODELET_MAX run their codelet. Longer ones are
+ *       permuted, transformed in blocks of FFT_CODELET_LEAF by the
+ *       bit-reversed-input codelet, then finished with dispatched stages.
+ ******************************************************************************/
+void fft_execute(const FFTPlan *plan, Complex *x) {
+    int n = plan->n;
+    if (n < 2) return;
+
+    FFTCodelet codelet = fft_codelet(n);
+    if (codelet) {
+        codelet(x);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        int j = plan->bitrev[i];
+        if (j > i) {
+            Complex tmp = x[i];
+            x[i] = x[j];
+            x[j] = tmp;
+        }
+    }
+
+    // After the permutation each leaf block holds its own bit-reversed input;
+    // lengths below the leaf (only reachable without their codelet) run every stage
+    int first_len = 2;
+    if (n >= FFT_CODELET_LEAF) {
+        FFTCodelet leaf = fft_codelet_bitrev(FFT_CODELET_LEAF);
+        for (int start = 0; start < n; start += FFT_CODELET_LEAF) {
+            leaf(x + start);
+        }
+        first_len = 2 * FFT_CODELET_LEAF;
+    }
+
+    // Remaining butterfly stages run on the widest kernel the CPU supports
+    const DspKernels *kernels = dsp_kernels();
+    for (int len = first_len; len <= n; len <<= 1) {
+        kernels->fft_stage(x, plan->twiddle, n, len / 2, n / len);
+    }
+}
+/* End of fft_execute() */
+/******************************************************************************/
+
+/******************************************************************************
+ * ifft_execute
+ *
+ * @param[in]    plan Plan for the transform length
+ * @param[inout] x    Spectrum [plan->n], replaced by its inverse FFT
+ ******************************************************************************/
+void ifft_execute(const FFTPlan *plan, Complex *x) {
+    int n = plan->n;
+    if (n < 2) return;
+    for (int i = 0; i < n; i++) {
+        x[i].imag = -x[i].imag;
+    }
+    fft_execute(plan, x);
+    for (int i = 0; i < n; i++) {
+        x[i].real = x[i].real / n;
+        x[i].imag = -x[i].imag / n;
+    }
+}
+/* End of ifft_execute() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fft_plan_free
+ *
+ * @param[inout] plan Plan to release
+ ******************************************************************************/
+void fft_plan_free(FFTPlan *plan) {
+    free(plan->owned_mem);
+    plan->owned_mem = NULL;
+    plan->bitrev = NULL;
+    plan->twiddle = NULL;
 }
+/* End of fft_plan_free() */
+/******************************************************************************/
+
+/******************************************************************************
+ * rfft_plan_init
+ *
+ * @param[out] plan Pointer to RFFTPlan struct to initialize
+ * @param[in]  n    Real transform length (power of two, at least 4)
+ *
+ * @returns 0 on success, -1 on invalid length, -2 on allocation failure
+ *
+ * @warning Must call rfft_plan_free() to release memory.
+ ******************************************************************************/
+int rfft_plan_init(RFFTPlan *plan, int n) {
+    plan->twiddle = NULL;
+    plan->half.bitrev = NULL;
+    plan->half.twiddle = NULL;
+    plan->half.owned_mem = NULL;
+    plan->owned_mem = NULL;
+    if (n < 4 || fft_log2(n) < 0) return -1;
+
+    void *mem = malloc(rfft_plan_mem_size(n));
+    if (!mem) return -2;
+    rfft_plan_init_mem(plan, n, mem);
+    plan->owned_mem = mem;
+    return 0;
+}
+/* End of rfft_plan_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * rfft_plan_mem_size
+ *
+ * @param[in] n Real transform length (power of two, at least 4)
+ *
+ * @returns Bytes of memory rfft_plan_init_mem() needs, 0 for an invalid length
+ ******************************************************************************/
+size_t rfft_plan_mem_size(int n) {
+    if (n < 4 || fft_log2(n) < 0) return 0;
+    return fft_plan_mem_size(n / 2) + DSP_MEM_ALIGN_UP((n / 4 + 1) * sizeof(Complex));
+}
+/* End of rfft_plan_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * rfft_plan_init_mem
+ *
+ * @param[out] plan Pointer to RFFTPlan struct to initialize
+ * @param[in]  n    Real transform length (power of two, at least 4)
+ * @param[in]  mem  At least rfft_plan_mem_size(n) bytes aligned for double;
+ *                  must outlive the plan
+ *
+ * @returns 0 on success, -1 on invalid length
+ *
+ * @note The half-length complex plan is laid out first, then the split
+ *       twiddles. Performs no allocation.
+ ******************************************************************************/
+int rfft_plan_init_mem(RFFTPlan *plan, int n, void *mem) {
+    plan->owned_mem = NULL;
+    if (n < 4 || fft_log2(n) < 0) return -1;
+
+    size_t half_size = fft_plan_mem_size(n / 2);
+    plan->n = n;
+    fft_plan_init_mem(&plan->half, n / 2, mem);
+    plan->twiddle = (Complex *)((unsigned char *)mem + half_size);
+    for (int k = 0; k <= n / 4; k++) {
+        double t = -2 * PI * k / n;
+        plan->twiddle[k].real = cos(t);
+        plan->twiddle[k].imag = sin(t);
+    }
+    return 0;
+}
+/* End of rfft_plan_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * rfft_execute
+ *
+ * @param[in]  plan   Real-input plan
+ * @param[in]  input  Real samples [plan->n]
+ * @param[out] output Non-negative frequency bins [plan->n / 2 + 1]
+ *
+ * @details
+ *   Packs even/odd samples into z[k] = x[2k] + i x[2k+1], transforms z with
+ *   the half-length plan, then splits Z into the spectra E (even) and O (odd)
+ *   and combines X[k] = E[k] + W^k O[k], pairing bins k and n/2 - k in place.
+ ******************************************************************************/
+void rfft_execute(const RFFTPlan *plan, const double *input, Complex *output) {
+    int m = plan->n / 2;
+
+    for (int k = 0; k < m; k++) {
+        output[k].real = input[2 * k];
+        output[k].imag = input[2 * k + 1];
+    }
+    fft_execute(&plan->half, output);
+
+    Complex z0 = output[0];
+    output[0].real = z0.real + z0.imag;
+    output[0].imag = 0.0;
+    output[m].real = z0.real - z0.imag;
+    output[m].imag = 0.0;
+
+    for (int k = 1; k <= m / 2; k++) {
+        Complex a = output[k];
+        Complex b = output[m - k];
+        Complex w = plan->twiddle[k];
+
+        // E = (Z[k] + conj(Z[m-k])) / 2, O = -i (Z[k] - conj(Z[m-k])) / 2
+        Complex e = { 0.5 * (a.real + b.real), 0.5 * (a.imag - b.imag) };
+        Complex o = { 0.5 * (a.imag + b.imag), -0.5 * (a.real - b.real) };
+        Complex wo = { w.real * o.real - w.imag * o.imag, w.real * o.imag + w.imag * o.real };
+
+        // X[k] = E + W^k O, X[m-k] = conj(E - W^k O)
+        output[k].real = e.real + wo.real;
+        output[k].imag = e.imag + wo.imag;
+        output[m - k].real = e.real - wo.real;
+        output[m - k].imag = -(e.imag - wo.imag);
+    }
+}
+/* End of rfft_execute() */
+/******************************************************************************/
+
+/******************************************************************************
+ * irfft_execute
+ *
+ * @param[in]    plan     Real-input plan
+ * @param[inout] spectrum Bins [plan->n / 2 + 1]; used as work space
+ * @param[out]   output   Real samples [plan->n]
+ *
+ * @note Inverse of rfft_execute(), including the 1/n scaling. The imaginary
+ *       parts of bins 0 and n/2 are ignored.
+ ******************************************************************************/
+void irfft_execute(const RFFTPlan *plan, Complex *spectrum, double *output) {
+    int m = plan->n / 2;
+
+    double x0 = spectrum[0].real;
+    double xm = spectrum[m].real;
+    spectrum[0].real = 0.5 * (x0 + xm);
+    spectrum[0].imag = 0.5 * (x0 - xm);
+
+    for (int k = 1; k <= m / 2; k++) {
+        Complex a = spectrum[k];
+        Complex b = spectrum[m - k];
+        Complex w = plan->twiddle[k];
+
+        // E = (X[k] + conj(X[m-k])) / 2, W^k O = (X[k] - conj(X[m-k])) / 2
+        Complex e = { 0.5 * (a.real + b.real), 0.5 * (a.imag - b.imag) };
+        Complex wo = { 0.5 * (a.real - b.real), 0.5 * (a.imag + b.imag) };
+        Complex o = { w.real * wo.real + w.imag * wo.imag, w.real * wo.imag - w.imag * wo.real };
+
+        // Z[k] = E + i O, Z[m-k] = conj(E) + i conj(O)
+        spectrum[k].real = e.real - o.imag;
+        spectrum[k].imag = e.imag + o.real;
+        spectrum[m - k].real = e.real + o.imag;
+        spectrum[m - k].imag = o.real - e.imag;
+    }
+
+    ifft_execute(&plan->half, spectrum);
+    for (int k = 0; k < m; k++) {
+        output[2 * k] = spectrum[k].real;
+        output[2 * k + 1] = spectrum[k].imag;
+    }
+}
+/* End of irfft_execute() */
+/******************************************************************************/
+
+/******************************************************************************
+ * rfft_plan_free
+ *
+ * @param[inout] plan Plan to release
+ ******************************************************************************/
+void rfft_plan_free(RFFTPlan *plan) {
+    fft_plan_free(&plan->half);
+    free(plan->owned_mem);
+    plan->owned_mem = NULL;
+    plan->twiddle = NULL;
+}
+/* End of rfft_plan_free() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fft_plan_cached / rfft_plan_cached
+ *
+ * @param[in] n Transform length
+ *
+ * @returns Shared plan for n, built on first use, or NULL on invalid length
+ *          or allocation failure
+ *
+ * @note Execution only reads the plan, so one cached plan may be used by
+ *       any number of threads at once. Once a size is built, lookups are a
+ *       single acquire load; only the first call of a size takes the lock
+ *       (and rechecks, so concurrent first calls build one plan).
+ ******************************************************************************/
+const FFTPlan *fft_plan_cached(int n) {
+    int log2n = fft_log2(n);
+    if (log2n < 0 || log2n >= FFT_CACHE_SLOTS) return NULL;
+
+    FFTPlan *plan = atomic_load_explicit(&fft_cache[log2n], memory_order_acquire);
+    if (plan) return plan;
+
+    pthread_mutex_lock(&fft_cache_lock);
+    plan = atomic_load_explicit(&fft_cache[log2n], memory_order_relaxed);
+    if (!plan) {
+        plan = malloc(sizeof(FFTPlan));
+        if (plan && fft_plan_init(plan, n) != 0) {
+            free(plan);
+            plan = NULL;
+        }
+        if (plan) atomic_store_explicit(&fft_cache[log2n], plan, memory_order_release);
+    }
+    pthread_mutex_unlock(&fft_cache_lock);
+    return plan;
+}
+/* End of fft_plan_cached() */
+/******************************************************************************/
+
+const RFFTPlan *rfft_plan_cached(int n) {
+    int log2n = fft_log2(n);
+    if (n < 4 || log2n < 0 || log2n >= FFT_CACHE_SLOTS) return NULL;
+
+    RFFTPlan *plan = atomic_load_explicit(&rfft_cache[log2n], memory_order_acquire);
+    if (plan) return plan;
+
+    pthread_mutex_lock(&fft_cache_lock);
+    plan = atomic_load_explicit(&rfft_cache[log2n], memory_order_relaxed);
+    if (!plan) {
+        plan = malloc(sizeof(RFFTPlan));
+        if (plan && rfft_plan_init(plan, n) != 0) {
+            free(plan);
+            plan = NULL;
+        }
+        if (plan) atomic_store_explicit(&rfft_cache[log2n], plan, memory_order_release);
+    }
+    pthread_mutex_unlock(&fft_cache_lock);
+    return plan;
+}
+/* End of rfft_plan_cached() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fft_plan_cache_clear
+ *
+ * @warning Pointers returned by the cache become invalid.
+ ******************************************************************************/
+void fft_plan_cache_clear(void) {
+    pthread_mutex_lock(&fft_cache_lock);
+    for (int i = 0; i < FFT_CACHE_SLOTS; i++) {
+        FFTPlan *plan = atomic_exchange_explicit(&fft_cache[i], NULL, memory_order_acq_rel);
+        if (plan) {
+            fft_plan_free(plan);
+            free(plan);
+        }
+        RFFTPlan *rplan = atomic_exchange_explicit(&rfft_cache[i], NULL, memory_order_acq_rel);
+        if (rplan) {
+            rfft_plan_free(rplan);
+            free(rplan);
+        }
+    }
+    pthread_mutex_unlock(&fft_cache_lock);
+}
+/* End of fft_plan_cache_clear() */
+/******************************************************************************/
 /* End of file */
 /******************************************************************************/
\ No newline at end of file
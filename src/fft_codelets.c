@@ -0,0 +1,796 @@
+/*
+ * @file fft_codelets.c
+ *
+ * GENERATED by tools/gen_fft_codelets.py -- do not edit by hand.
+ *
+ * Fully unrolled radix-2 FFTs for n = 2 .. 128 with constant twiddles.
+ * Twiddles equal to 1, -i or (+-1 - i)/sqrt(2) are folded into adds and
+ * one shared multiply; the rest appear as literals. The _br codelets take
+ * their input in bit-reversed order (leaf kernels of fft_execute()); the
+ * plain ones take natural order.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stddef.h>
+#include "fft_codelets.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define SQRT1_2 0.70710678118654752440
+
+#define SWAP(a, b) do { Complex t_ = x[a]; x[a] = x[b]; x[b] = t_; } while (0)
+
+/******************************************************************************/
+/* n = 2 */
+
+static void fft_codelet_2_br(Complex *x) {
+    double r0 = x[0].real, i0 = x[0].imag;
+    double r1 = x[1].real, i1 = x[1].imag;
+    double tr, ti;
+
+    // stage: span 2
+    tr = r1; ti = i1;
+    r1 = r0 - tr; i1 = i0 - ti; r0 += tr; i0 += ti;
+
+    x[0].real = r0; x[0].imag = i0;
+    x[1].real = r1; x[1].imag = i1;
+}
+
+static void fft_codelet_2(Complex *x) {
+    fft_codelet_2_br(x);
+}
+
+/******************************************************************************/
+/* n = 4 */
+
+static void fft_codelet_4_br(Complex *x) {
+    double r0 = x[0].real, i0 = x[0].imag;
+    double r1 = x[1].real, i1 = x[1].imag;
+    double r2 = x[2].real, i2 = x[2].imag;
+    double r3 = x[3].real, i3 = x[3].imag;
+    double tr, ti;
+
+    // stage: span 2
+    tr = r1; ti = i1;
+    r1 = r0 - tr; i1 = i0 - ti; r0 += tr; i0 += ti;
+    tr = r3; ti = i3;
+    r3 = r2 - tr; i3 = i2 - ti; r2 += tr; i2 += ti;
+    // stage: span 4
+    tr = r2; ti = i2;
+    r2 = r0 - tr; i2 = i0 - ti; r0 += tr; i0 += ti;
+    tr = i3; ti = -r3;
+    r3 = r1 - tr; i3 = i1 - ti; r1 += tr; i1 += ti;
+
+    x[0].real = r0; x[0].imag = i0;
+    x[1].real = r1; x[1].imag = i1;
+    x[2].real = r2; x[2].imag = i2;
+    x[3].real = r3; x[3].imag = i3;
+}
+
+static void fft_codelet_4(Complex *x) {
+    SWAP(1, 2);
+    fft_codelet_4_br(x);
+}
+
+/******************************************************************************/
+/* n = 8 */
+
+static void fft_codelet_8_br(Complex *x) {
+    double r0 = x[0].real, i0 = x[0].imag;
+    double r1 = x[1].real, i1 = x[1].imag;
+    double r2 = x[2].real, i2 = x[2].imag;
+    double r3 = x[3].real, i3 = x[3].imag;
+    double r4 = x[4].real, i4 = x[4].imag;
+    double r5 = x[5].real, i5 = x[5].imag;
+    double r6 = x[6].real, i6 = x[6].imag;
+    double r7 = x[7].real, i7 = x[7].imag;
+    double tr, ti;
+
+    // stage: span 2
+    tr = r1; ti = i1;
+    r1 = r0 - tr; i1 = i0 - ti; r0 += tr; i0 += ti;
+    tr = r3; ti = i3;
+    r3 = r2 - tr; i3 = i2 - ti; r2 += tr; i2 += ti;
+    tr = r5; ti = i5;
+    r5 = r4 - tr; i5 = i4 - ti; r4 += tr; i4 += ti;
+    tr = r7; ti = i7;
+    r7 = r6 - tr; i7 = i6 - ti; r6 += tr; i6 += ti;
+    // stage: span 4
+    tr = r2; ti = i2;
+    r2 = r0 - tr; i2 = i0 - ti; r0 += tr; i0 += ti;
+    tr = i3; ti = -r3;
+    r3 = r1 - tr; i3 = i1 - ti; r1 += tr; i1 += ti;
+    tr = r6; ti = i6;
+    r6 = r4 - tr; i6 = i4 - ti; r4 += tr; i4 += ti;
+    tr = i7; ti = -r7;
+    r7 = r5 - tr; i7 = i5 - ti; r5 += tr; i5 += ti;
+    // stage: span 8
+    tr = r4; ti = i4;
+    r4 = r0 - tr; i4 = i0 - ti; r0 += tr; i0 += ti;
+    tr = SQRT1_2 * (r5 + i5); ti = SQRT1_2 * (i5 - r5);
+    r5 = r1 - tr; i5 = i1 - ti; r1 += tr; i1 += ti;
+    tr = i6; ti = -r6;
+    r6 = r2 - tr; i6 = i2 - ti; r2 += tr; i2 += ti;
+    tr = SQRT1_2 * (i7 - r7); ti = -SQRT1_2 * (r7 + i7);
+    r7 = r3 - tr; i7 = i3 - ti; r3 += tr; i3 += ti;
+
+    x[0].real = r0; x[0].imag = i0;
+    x[1].real = r1; x[1].imag = i1;
+    x[2].real = r2; x[2].imag = i2;
+    x[3].real = r3; x[3].imag = i3;
+    x[4].real = r4; x[4].imag = i4;
+    x[5].real = r5; x[5].imag = i5;
+    x[6].real = r6; x[6].imag = i6;
+    x[7].real = r7; x[7].imag = i7;
+}
+
+static void fft_codelet_8(Complex *x) {
+    SWAP(1, 4); SWAP(3, 6);
+    fft_codelet_8_br(x);
+}
+
+/******************************************************************************/
+/* n = 16 */
+
+static void fft_codelet_16_br(Complex *x) {
+    double r0 = x[0].real, i0 = x[0].imag;
+    double r1 = x[1].real, i1 = x[1].imag;
+    double r2 = x[2].real, i2 = x[2].imag;
+    double r3 = x[3].real, i3 = x[3].imag;
+    double r4 = x[4].real, i4 = x[4].imag;
+    double r5 = x[5].real, i5 = x[5].imag;
+    double r6 = x[6].real, i6 = x[6].imag;
+    double r7 = x[7].real, i7 = x[7].imag;
+    double r8 = x[8].real, i8 = x[8].imag;
+    double r9 = x[9].real, i9 = x[9].imag;
+    double r10 = x[10].real, i10 = x[10].imag;
+    double r11 = x[11].real, i11 = x[11].imag;
+    double r12 = x[12].real, i12 = x[12].imag;
+    double r13 = x[13].real, i13 = x[13].imag;
+    double r14 = x[14].real, i14 = x[14].imag;
+    double r15 = x[15].real, i15 = x[15].imag;
+    double tr, ti;
+
+    // stage: span 2
+    tr = r1; ti = i1;
+    r1 = r0 - tr; i1 = i0 - ti; r0 += tr; i0 += ti;
+    tr = r3; ti = i3;
+    r3 = r2 - tr; i3 = i2 - ti; r2 += tr; i2 += ti;
+    tr = r5; ti = i5;
+    r5 = r4 - tr; i5 = i4 - ti; r4 += tr; i4 += ti;
+    tr = r7; ti = i7;
+    r7 = r6 - tr; i7 = i6 - ti; r6 += tr; i6 += ti;
+    tr = r9; ti = i9;
+    r9 = r8 - tr; i9 = i8 - ti; r8 += tr; i8 += ti;
+    tr = r11; ti = i11;
+    r11 = r10 - tr; i11 = i10 - ti; r10 += tr; i10 += ti;
+    tr = r13; ti = i13;
+    r13 = r12 - tr; i13 = i12 - ti; r12 += tr; i12 += ti;
+    tr = r15; ti = i15;
+    r15 = r14 - tr; i15 = i14 - ti; r14 += tr; i14 += ti;
+    // stage: span 4
+    tr = r2; ti = i2;
+    r2 = r0 - tr; i2 = i0 - ti; r0 += tr; i0 += ti;
+    tr = i3; ti = -r3;
+    r3 = r1 - tr; i3 = i1 - ti; r1 += tr; i1 += ti;
+    tr = r6; ti = i6;
+    r6 = r4 - tr; i6 = i4 - ti; r4 += tr; i4 += ti;
+    tr = i7; ti = -r7;
+    r7 = r5 - tr; i7 = i5 - ti; r5 += tr; i5 += ti;
+    tr = r10; ti = i10;
+    r10 = r8 - tr; i10 = i8 - ti; r8 += tr; i8 += ti;
+    tr = i11; ti = -r11;
+    r11 = r9 - tr; i11 = i9 - ti; r9 += tr; i9 += ti;
+    tr = r14; ti = i14;
+    r14 = r12 - tr; i14 = i12 - ti; r12 += tr; i12 += ti;
+    tr = i15; ti = -r15;
+    r15 = r13 - tr; i15 = i13 - ti; r13 += tr; i13 += ti;
+    // stage: span 8
+    tr = r4; ti = i4;
+    r4 = r0 - tr; i4 = i0 - ti; r0 += tr; i0 += ti;
+    tr = SQRT1_2 * (r5 + i5); ti = SQRT1_2 * (i5 - r5);
+    r5 = r1 - tr; i5 = i1 - ti; r1 += tr; i1 += ti;
+    tr = i6; ti = -r6;
+    r6 = r2 - tr; i6 = i2 - ti; r2 += tr; i2 += ti;
+    tr = SQRT1_2 * (i7 - r7); ti = -SQRT1_2 * (r7 + i7);
+    r7 = r3 - tr; i7 = i3 - ti; r3 += tr; i3 += ti;
+    tr = r12; ti = i12;
+    r12 = r8 - tr; i12 = i8 - ti; r8 += tr; i8 += ti;
+    tr = SQRT1_2 * (r13 + i13); ti = SQRT1_2 * (i13 - r13);
+    r13 = r9 - tr; i13 = i9 - ti; r9 += tr; i9 += ti;
+    tr = i14; ti = -r14;
+    r14 = r10 - tr; i14 = i10 - ti; r10 += tr; i10 += ti;
+    tr = SQRT1_2 * (i15 - r15); ti = -SQRT1_2 * (r15 + i15);
+    r15 = r11 - tr; i15 = i11 - ti; r11 += tr; i11 += ti;
+    // stage: span 16
+    tr = r8; ti = i8;
+    r8 = r0 - tr; i8 = i0 - ti; r0 += tr; i0 += ti;
+    tr = 0.9238795325112867 * r9 - -0.3826834323650898 * i9; ti = 0.9238795325112867 * i9 + -0.3826834323650898 * r9;
+    r9 = r1 - tr; i9 = i1 - ti; r1 += tr; i1 += ti;
+    tr = SQRT1_2 * (r10 + i10); ti = SQRT1_2 * (i10 - r10);
+    r10 = r2 - tr; i10 = i2 - ti; r2 += tr; i2 += ti;
+    tr = 0.38268343236508984 * r11 - -0.9238795325112867 * i11; ti = 0.38268343236508984 * i11 + -0.9238795325112867 * r11;
+    r11 = r3 - tr; i11 = i3 - ti; r3 += tr; i3 += ti;
+    tr = i12; ti = -r12;
+    r12 = r4 - tr; i12 = i4 - ti; r4 += tr; i4 += ti;
+    tr = -0.3826834323650897 * r13 - -0.9238795325112867 * i13; ti = -0.3826834323650897 * i13 + -0.9238795325112867 * r13;
+    r13 = r5 - tr; i13 = i5 - ti; r5 += tr; i5 += ti;
+    tr = SQRT1_2 * (i14 - r14); ti = -SQRT1_2 * (r14 + i14);
+    r14 = r6 - tr; i14 = i6 - ti; r6 += tr; i6 += ti;
+    tr = -0.9238795325112867 * r15 - -0.3826834323650899 * i15; ti = -0.9238795325112867 * i15 + -0.3826834323650899 * r15;
+    r15 = r7 - tr; i15 = i7 - ti; r7 += tr; i7 += ti;
+
+    x[0].real = r0; x[0].imag = i0;
+    x[1].real = r1; x[1].imag = i1;
+    x[2].real = r2; x[2].imag = i2;
+    x[3].real = r3; x[3].imag = i3;
+    x[4].real = r4; x[4].imag = i4;
+    x[5].real = r5; x[5].imag = i5;
+    x[6].real = r6; x[6].imag = i6;
+    x[7].real = r7; x[7].imag = i7;
+    x[8].real = r8; x[8].imag = i8;
+    x[9].real = r9; x[9].imag = i9;
+    x[10].real = r10; x[10].imag = i10;
+    x[11].real = r11; x[11].imag = i11;
+    x[12].real = r12; x[12].imag = i12;
+    x[13].real = r13; x[13].imag = i13;
+    x[14].real = r14; x[14].imag = i14;
+    x[15].real = r15; x[15].imag = i15;
+}
+
+static void fft_codelet_16(Complex *x) {
+    SWAP(1, 8); SWAP(2, 4); SWAP(3, 12); SWAP(5, 10);
+    SWAP(7, 14); SWAP(11, 13);
+    fft_codelet_16_br(x);
+}
+
+/******************************************************************************/
+/* n = 32 */
+
+static void fft_codelet_32_br(Complex *x) {
+    double r0 = x[0].real, i0 = x[0].imag;
+    double r1 = x[1].real, i1 = x[1].imag;
+    double r2 = x[2].real, i2 = x[2].imag;
+    double r3 = x[3].real, i3 = x[3].imag;
+    double r4 = x[4].real, i4 = x[4].imag;
+    double r5 = x[5].real, i5 = x[5].imag;
+    double r6 = x[6].real, i6 = x[6].imag;
+    double r7 = x[7].real, i7 = x[7].imag;
+    double r8 = x[8].real, i8 = x[8].imag;
+    double r9 = x[9].real, i9 = x[9].imag;
+    double r10 = x[10].real, i10 = x[10].imag;
+    double r11 = x[11].real, i11 = x[11].imag;
+    double r12 = x[12].real, i12 = x[12].imag;
+    double r13 = x[13].real, i13 = x[13].imag;
+    double r14 = x[14].real, i14 = x[14].imag;
+    double r15 = x[15].real, i15 = x[15].imag;
+    double r16 = x[16].real, i16 = x[16].imag;
+    double r17 = x[17].real, i17 = x[17].imag;
+    double r18 = x[18].real, i18 = x[18].imag;
+    double r19 = x[19].real, i19 = x[19].imag;
+    double r20 = x[20].real, i20 = x[20].imag;
+    double r21 = x[21].real, i21 = x[21].imag;
+    double r22 = x[22].real, i22 = x[22].imag;
+    double r23 = x[23].real, i23 = x[23].imag;
+    double r24 = x[24].real, i24 = x[24].imag;
+    double r25 = x[25].real, i25 = x[25].imag;
+    double r26 = x[26].real, i26 = x[26].imag;
+    double r27 = x[27].real, i27 = x[27].imag;
+    double r28 = x[28].real, i28 = x[28].imag;
+    double r29 = x[29].real, i29 = x[29].imag;
+    double r30 = x[30].real, i30 = x[30].imag;
+    double r31 = x[31].real, i31 = x[31].imag;
+    double tr, ti;
+
+    // stage: span 2
+    tr = r1; ti = i1;
+    r1 = r0 - tr; i1 = i0 - ti; r0 += tr; i0 += ti;
+    tr = r3; ti = i3;
+    r3 = r2 - tr; i3 = i2 - ti; r2 += tr; i2 += ti;
+    tr = r5; ti = i5;
+    r5 = r4 - tr; i5 = i4 - ti; r4 += tr; i4 += ti;
+    tr = r7; ti = i7;
+    r7 = r6 - tr; i7 = i6 - ti; r6 += tr; i6 += ti;
+    tr = r9; ti = i9;
+    r9 = r8 - tr; i9 = i8 - ti; r8 += tr; i8 += ti;
+    tr = r11; ti = i11;
+    r11 = r10 - tr; i11 = i10 - ti; r10 += tr; i10 += ti;
+    tr = r13; ti = i13;
+    r13 = r12 - tr; i13 = i12 - ti; r12 += tr; i12 += ti;
+    tr = r15; ti = i15;
+    r15 = r14 - tr; i15 = i14 - ti; r14 += tr; i14 += ti;
+    tr = r17; ti = i17;
+    r17 = r16 - tr; i17 = i16 - ti; r16 += tr; i16 += ti;
+    tr = r19; ti = i19;
+    r19 = r18 - tr; i19 = i18 - ti; r18 += tr; i18 += ti;
+    tr = r21; ti = i21;
+    r21 = r20 - tr; i21 = i20 - ti; r20 += tr; i20 += ti;
+    tr = r23; ti = i23;
+    r23 = r22 - tr; i23 = i22 - ti; r22 += tr; i22 += ti;
+    tr = r25; ti = i25;
+    r25 = r24 - tr; i25 = i24 - ti; r24 += tr; i24 += ti;
+    tr = r27; ti = i27;
+    r27 = r26 - tr; i27 = i26 - ti; r26 += tr; i26 += ti;
+    tr = r29; ti = i29;
+    r29 = r28 - tr; i29 = i28 - ti; r28 += tr; i28 += ti;
+    tr = r31; ti = i31;
+    r31 = r30 - tr; i31 = i30 - ti; r30 += tr; i30 += ti;
+    // stage: span 4
+    tr = r2; ti = i2;
+    r2 = r0 - tr; i2 = i0 - ti; r0 += tr; i0 += ti;
+    tr = i3; ti = -r3;
+    r3 = r1 - tr; i3 = i1 - ti; r1 += tr; i1 += ti;
+    tr = r6; ti = i6;
+    r6 = r4 - tr; i6 = i4 - ti; r4 += tr; i4 += ti;
+    tr = i7; ti = -r7;
+    r7 = r5 - tr; i7 = i5 - ti; r5 += tr; i5 += ti;
+    tr = r10; ti = i10;
+    r10 = r8 - tr; i10 = i8 - ti; r8 += tr; i8 += ti;
+    tr = i11; ti = -r11;
+    r11 = r9 - tr; i11 = i9 - ti; r9 += tr; i9 += ti;
+    tr = r14; ti = i14;
+    r14 = r12 - tr; i14 = i12 - ti; r12 += tr; i12 += ti;
+    tr = i15; ti = -r15;
+    r15 = r13 - tr; i15 = i13 - ti; r13 += tr; i13 += ti;
+    tr = r18; ti = i18;
+    r18 = r16 - tr; i18 = i16 - ti; r16 += tr; i16 += ti;
+    tr = i19; ti = -r19;
+    r19 = r17 - tr; i19 = i17 - ti; r17 += tr; i17 += ti;
+    tr = r22; ti = i22;
+    r22 = r20 - tr; i22 = i20 - ti; r20 += tr; i20 += ti;
+    tr = i23; ti = -r23;
+    r23 = r21 - tr; i23 = i21 - ti; r21 += tr; i21 += ti;
+    tr = r26; ti = i26;
+    r26 = r24 - tr; i26 = i24 - ti; r24 += tr; i24 += ti;
+    tr = i27; ti = -r27;
+    r27 = r25 - tr; i27 = i25 - ti; r25 += tr; i25 += ti;
+    tr = r30; ti = i30;
+    r30 = r28 - tr; i30 = i28 - ti; r28 += tr; i28 += ti;
+    tr = i31; ti = -r31;
+    r31 = r29 - tr; i31 = i29 - ti; r29 += tr; i29 += ti;
+    // stage: span 8
+    tr = r4; ti = i4;
+    r4 = r0 - tr; i4 = i0 - ti; r0 += tr; i0 += ti;
+    tr = SQRT1_2 * (r5 + i5); ti = SQRT1_2 * (i5 - r5);
+    r5 = r1 - tr; i5 = i1 - ti; r1 += tr; i1 += ti;
+    tr = i6; ti = -r6;
+    r6 = r2 - tr; i6 = i2 - ti; r2 += tr; i2 += ti;
+    tr = SQRT1_2 * (i7 - r7); ti = -SQRT1_2 * (r7 + i7);
+    r7 = r3 - tr; i7 = i3 - ti; r3 += tr; i3 += ti;
+    tr = r12; ti = i12;
+    r12 = r8 - tr; i12 = i8 - ti; r8 += tr; i8 += ti;
+    tr = SQRT1_2 * (r13 + i13); ti = SQRT1_2 * (i13 - r13);
+    r13 = r9 - tr; i13 = i9 - ti; r9 += tr; i9 += ti;
+    tr = i14; ti = -r14;
+    r14 = r10 - tr; i14 = i10 - ti; r10 += tr; i10 += ti;
+    tr = SQRT1_2 * (i15 - r15); ti = -SQRT1_2 * (r15 + i15);
+    r15 = r11 - tr; i15 = i11 - ti; r11 += tr; i11 += ti;
+    tr = r20; ti = i20;
+    r20 = r16 - tr; i20 = i16 - ti; r16 += tr; i16 += ti;
+    tr = SQRT1_2 * (r21 + i21); ti = SQRT1_2 * (i21 - r21);
+    r21 = r17 - tr; i21 = i17 - ti; r17 += tr; i17 += ti;
+    tr = i22; ti = -r22;
+    r22 = r18 - tr; i22 = i18 - ti; r18 += tr; i18 += ti;
+    tr = SQRT1_2 * (i23 - r23); ti = -SQRT1_2 * (r23 + i23);
+    r23 = r19 - tr; i23 = i19 - ti; r19 += tr; i19 += ti;
+    tr = r28; ti = i28;
+    r28 = r24 - tr; i28 = i24 - ti; r24 += tr; i24 += ti;
+    tr = SQRT1_2 * (r29 + i29); ti = SQRT1_2 * (i29 - r29);
+    r29 = r25 - tr; i29 = i25 - ti; r25 += tr; i25 += ti;
+    tr = i30; ti = -r30;
+    r30 = r26 - tr; i30 = i26 - ti; r26 += tr; i26 += ti;
+    tr = SQRT1_2 * (i31 - r31); ti = -SQRT1_2 * (r31 + i31);
+    r31 = r27 - tr; i31 = i27 - ti; r27 += tr; i27 += ti;
+    // stage: span 16
+    tr = r8; ti = i8;
+    r8 = r0 - tr; i8 = i0 - ti; r0 += tr; i0 += ti;
+    tr = 0.9238795325112867 * r9 - -0.3826834323650898 * i9; ti = 0.9238795325112867 * i9 + -0.3826834323650898 * r9;
+    r9 = r1 - tr; i9 = i1 - ti; r1 += tr; i1 += ti;
+    tr = SQRT1_2 * (r10 + i10); ti = SQRT1_2 * (i10 - r10);
+    r10 = r2 - tr; i10 = i2 - ti; r2 += tr; i2 += ti;
+    tr = 0.38268343236508984 * r11 - -0.9238795325112867 * i11; ti = 0.38268343236508984 * i11 + -0.9238795325112867 * r11;
+    r11 = r3 - tr; i11 = i3 - ti; r3 += tr; i3 += ti;
+    tr = i12; ti = -r12;
+    r12 = r4 - tr; i12 = i4 - ti; r4 += tr; i4 += ti;
+    tr = -0.3826834323650897 * r13 - -0.9238795325112867 * i13; ti = -0.3826834323650897 * i13 + -0.9238795325112867 * r13;
+    r13 = r5 - tr; i13 = i5 - ti; r5 += tr; i5 += ti;
+    tr = SQRT1_2 * (i14 - r14); ti = -SQRT1_2 * (r14 + i14);
+    r14 = r6 - tr; i14 = i6 - ti; r6 += tr; i6 += ti;
+    tr = -0.9238795325112867 * r15 - -0.3826834323650899 * i15; ti = -0.9238795325112867 * i15 + -0.3826834323650899 * r15;
+    r15 = r7 - tr; i15 = i7 - ti; r7 += tr; i7 += ti;
+    tr = r24; ti = i24;
+    r24 = r16 - tr; i24 = i16 - ti; r16 += tr; i16 += ti;
+    tr = 0.9238795325112867 * r25 - -0.3826834323650898 * i25; ti = 0.9238795325112867 * i25 + -0.3826834323650898 * r25;
+    r25 = r17 - tr; i25 = i17 - ti; r17 += tr; i17 += ti;
+    tr = SQRT1_2 * (r26 + i26); ti = SQRT1_2 * (i26 - r26);
+    r26 = r18 - tr; i26 = i18 - ti; r18 += tr; i18 += ti;
+    tr = 0.38268343236508984 * r27 - -0.9238795325112867 * i27; ti = 0.38268343236508984 * i27 + -0.9238795325112867 * r27;
+    r27 = r19 - tr; i27 = i19 - ti; r19 += tr; i19 += ti;
+    tr = i28; ti = -r28;
+    r28 = r20 - tr; i28 = i20 - ti; r20 += tr; i20 += ti;
+    tr = -0.3826834323650897 * r29 - -0.9238795325112867 * i29; ti = -0.3826834323650897 * i29 + -0.9238795325112867 * r29;
+    r29 = r21 - tr; i29 = i21 - ti; r21 += tr; i21 += ti;
+    tr = SQRT1_2 * (i30 - r30); ti = -SQRT1_2 * (r30 + i30);
+    r30 = r22 - tr; i30 = i22 - ti; r22 += tr; i22 += ti;
+    tr = -0.9238795325112867 * r31 - -0.3826834323650899 * i31; ti = -0.9238795325112867 * i31 + -0.3826834323650899 * r31;
+    r31 = r23 - tr; i31 = i23 - ti; r23 += tr; i23 += ti;
+    // stage: span 32
+    tr = r16; ti = i16;
+    r16 = r0 - tr; i16 = i0 - ti; r0 += tr; i0 += ti;
+    tr = 0.9807852804032304 * r17 - -0.19509032201612825 * i17; ti = 0.9807852804032304 * i17 + -0.19509032201612825 * r17;
+    r17 = r1 - tr; i17 = i1 - ti; r1 += tr; i1 += ti;
+    tr = 0.9238795325112867 * r18 - -0.3826834323650898 * i18; ti = 0.9238795325112867 * i18 + -0.3826834323650898 * r18;
+    r18 = r2 - tr; i18 = i2 - ti; r2 += tr; i2 += ti;
+    tr = 0.8314696123025452 * r19 - -0.5555702330196022 * i19; ti = 0.8314696123025452 * i19 + -0.5555702330196022 * r19;
+    r19 = r3 - tr; i19 = i3 - ti; r3 += tr; i3 += ti;
+    tr = SQRT1_2 * (r20 + i20); ti = SQRT1_2 * (i20 - r20);
+    r20 = r4 - tr; i20 = i4 - ti; r4 += tr; i4 += ti;
+    tr = 0.5555702330196023 * r21 - -0.8314696123025452 * i21; ti = 0.5555702330196023 * i21 + -0.8314696123025452 * r21;
+    r21 = r5 - tr; i21 = i5 - ti; r5 += tr; i5 += ti;
+    tr = 0.38268343236508984 * r22 - -0.9238795325112867 * i22; ti = 0.38268343236508984 * i22 + -0.9238795325112867 * r22;
+    r22 = r6 - tr; i22 = i6 - ti; r6 += tr; i6 += ti;
+    tr = 0.19509032201612833 * r23 - -0.9807852804032304 * i23; ti = 0.19509032201612833 * i23 + -0.9807852804032304 * r23;
+    r23 = r7 - tr; i23 = i7 - ti; r7 += tr; i7 += ti;
+    tr = i24; ti = -r24;
+    r24 = r8 - tr; i24 = i8 - ti; r8 += tr; i8 += ti;
+    tr = -0.1950903220161282 * r25 - -0.9807852804032304 * i25; ti = -0.1950903220161282 * i25 + -0.9807852804032304 * r25;
+    r25 = r9 - tr; i25 = i9 - ti; r9 += tr; i9 += ti;
+    tr = -0.3826834323650897 * r26 - -0.9238795325112867 * i26; ti = -0.3826834323650897 * i26 + -0.9238795325112867 * r26;
+    r26 = r10 - tr; i26 = i10 - ti; r10 += tr; i10 += ti;
+    tr = -0.555570233019602 * r27 - -0.8314696123025455 * i27; ti = -0.555570233019602 * i27 + -0.8314696123025455 * r27;
+    r27 = r11 - tr; i27 = i11 - ti; r11 += tr; i11 += ti;
+    tr = SQRT1_2 * (i28 - r28); ti = -SQRT1_2 * (r28 + i28);
+    r28 = r12 - tr; i28 = i12 - ti; r12 += tr; i12 += ti;
+    tr = -0.8314696123025453 * r29 - -0.5555702330196022 * i29; ti = -0.8314696123025453 * i29 + -0.5555702330196022 * r29;
+    r29 = r13 - tr; i29 = i13 - ti; r13 += tr; i13 += ti;
+    tr = -0.9238795325112867 * r30 - -0.3826834323650899 * i30; ti = -0.9238795325112867 * i30 + -0.3826834323650899 * r30;
+    r30 = r14 - tr; i30 = i14 - ti; r14 += tr; i14 += ti;
+    tr = -0.9807852804032304 * r31 - -0.1950903220161286 * i31; ti = -0.9807852804032304 * i31 + -0.1950903220161286 * r31;
+    r31 = r15 - tr; i31 = i15 - ti; r15 += tr; i15 += ti;
+
+    x[0].real = r0; x[0].imag = i0;
+    x[1].real = r1; x[1].imag = i1;
+    x[2].real = r2; x[2].imag = i2;
+    x[3].real = r3; x[3].imag = i3;
+    x[4].real = r4; x[4].imag = i4;
+    x[5].real = r5; x[5].imag = i5;
+    x[6].real = r6; x[6].imag = i6;
+    x[7].real = r7; x[7].imag = i7;
+    x[8].real = r8; x[8].imag = i8;
+    x[9].real = r9; x[9].imag = i9;
+    x[10].real = r10; x[10].imag = i10;
+    x[11].real = r11; x[11].imag = i11;
+    x[12].real = r12; x[12].imag = i12;
+    x[13].real = r13; x[13].imag = i13;
+    x[14].real = r14; x[14].imag = i14;
+    x[15].real = r15; x[15].imag = i15;
+    x[16].real = r16; x[16].imag = i16;
+    x[17].real = r17; x[17].imag = i17;
+    x[18].real = r18; x[18].imag = i18;
+    x[19].real = r19; x[19].imag = i19;
+    x[20].real = r20; x[20].imag = i20;
+    x[21].real = r21; x[21].imag = i21;
+    x[22].real = r22; x[22].imag = i22;
+    x[23].real = r23; x[23].imag = i23;
+    x[24].real = r24; x[24].imag = i24;
+    x[25].real = r25; x[25].imag = i25;
+    x[26].real = r26; x[26].imag = i26;
+    x[27].real = r27; x[27].imag = i27;
+    x[28].real = r28; x[28].imag = i28;
+    x[29].real = r29; x[29].imag = i29;
+    x[30].real = r30; x[30].imag = i30;
+    x[31].real = r31; x[31].imag = i31;
+}
+
+static void fft_codelet_32(Complex *x) {
+    SWAP(1, 16); SWAP(2, 8); SWAP(3, 24); SWAP(5, 20);
+    SWAP(6, 12); SWAP(7, 28); SWAP(9, 18); SWAP(11, 26);
+    SWAP(13, 22); SWAP(15, 30); SWAP(19, 25); SWAP(23, 29);
+    fft_codelet_32_br(x);
+}
+
+/******************************************************************************/
+/* n = 64 */
+
+static void fft_codelet_64_br(Complex *x) {
+    fft_codelet_32_br(x);
+    fft_codelet_32_br(x + 32);
+    double ar, ai, tr, ti;
+
+    // stage: span 64
+    ar = x[0].real; ai = x[0].imag; tr = x[32].real; ti = x[32].imag;
+    x[32].real = ar - tr; x[32].imag = ai - ti; x[0].real = ar + tr; x[0].imag = ai + ti;
+    ar = x[1].real; ai = x[1].imag; tr = 0.9951847266721969 * x[33].real - -0.0980171403295606 * x[33].imag; ti = 0.9951847266721969 * x[33].imag + -0.0980171403295606 * x[33].real;
+    x[33].real = ar - tr; x[33].imag = ai - ti; x[1].real = ar + tr; x[1].imag = ai + ti;
+    ar = x[2].real; ai = x[2].imag; tr = 0.9807852804032304 * x[34].real - -0.19509032201612825 * x[34].imag; ti = 0.9807852804032304 * x[34].imag + -0.19509032201612825 * x[34].real;
+    x[34].real = ar - tr; x[34].imag = ai - ti; x[2].real = ar + tr; x[2].imag = ai + ti;
+    ar = x[3].real; ai = x[3].imag; tr = 0.9569403357322088 * x[35].real - -0.29028467725446233 * x[35].imag; ti = 0.9569403357322088 * x[35].imag + -0.29028467725446233 * x[35].real;
+    x[35].real = ar - tr; x[35].imag = ai - ti; x[3].real = ar + tr; x[3].imag = ai + ti;
+    ar = x[4].real; ai = x[4].imag; tr = 0.9238795325112867 * x[36].real - -0.3826834323650898 * x[36].imag; ti = 0.9238795325112867 * x[36].imag + -0.3826834323650898 * x[36].real;
+    x[36].real = ar - tr; x[36].imag = ai - ti; x[4].real = ar + tr; x[4].imag = ai + ti;
+    ar = x[5].real; ai = x[5].imag; tr = 0.881921264348355 * x[37].real - -0.47139673682599764 * x[37].imag; ti = 0.881921264348355 * x[37].imag + -0.47139673682599764 * x[37].real;
+    x[37].real = ar - tr; x[37].imag = ai - ti; x[5].real = ar + tr; x[5].imag = ai + ti;
+    ar = x[6].real; ai = x[6].imag; tr = 0.8314696123025452 * x[38].real - -0.5555702330196022 * x[38].imag; ti = 0.8314696123025452 * x[38].imag + -0.5555702330196022 * x[38].real;
+    x[38].real = ar - tr; x[38].imag = ai - ti; x[6].real = ar + tr; x[6].imag = ai + ti;
+    ar = x[7].real; ai = x[7].imag; tr = 0.773010453362737 * x[39].real - -0.6343932841636455 * x[39].imag; ti = 0.773010453362737 * x[39].imag + -0.6343932841636455 * x[39].real;
+    x[39].real = ar - tr; x[39].imag = ai - ti; x[7].real = ar + tr; x[7].imag = ai + ti;
+    ar = x[8].real; ai = x[8].imag; tr = SQRT1_2 * (x[40].real + x[40].imag); ti = SQRT1_2 * (x[40].imag - x[40].real);
+    x[40].real = ar - tr; x[40].imag = ai - ti; x[8].real = ar + tr; x[8].imag = ai + ti;
+    ar = x[9].real; ai = x[9].imag; tr = 0.6343932841636455 * x[41].real - -0.773010453362737 * x[41].imag; ti = 0.6343932841636455 * x[41].imag + -0.773010453362737 * x[41].real;
+    x[41].real = ar - tr; x[41].imag = ai - ti; x[9].real = ar + tr; x[9].imag = ai + ti;
+    ar = x[10].real; ai = x[10].imag; tr = 0.5555702330196023 * x[42].real - -0.8314696123025452 * x[42].imag; ti = 0.5555702330196023 * x[42].imag + -0.8314696123025452 * x[42].real;
+    x[42].real = ar - tr; x[42].imag = ai - ti; x[10].real = ar + tr; x[10].imag = ai + ti;
+    ar = x[11].real; ai = x[11].imag; tr = 0.4713967368259978 * x[43].real - -0.8819212643483549 * x[43].imag; ti = 0.4713967368259978 * x[43].imag + -0.8819212643483549 * x[43].real;
+    x[43].real = ar - tr; x[43].imag = ai - ti; x[11].real = ar + tr; x[11].imag = ai + ti;
+    ar = x[12].real; ai = x[12].imag; tr = 0.38268343236508984 * x[44].real - -0.9238795325112867 * x[44].imag; ti = 0.38268343236508984 * x[44].imag + -0.9238795325112867 * x[44].real;
+    x[44].real = ar - tr; x[44].imag = ai - ti; x[12].real = ar + tr; x[12].imag = ai + ti;
+    ar = x[13].real; ai = x[13].imag; tr = 0.29028467725446233 * x[45].real - -0.9569403357322089 * x[45].imag; ti = 0.29028467725446233 * x[45].imag + -0.9569403357322089 * x[45].real;
+    x[45].real = ar - tr; x[45].imag = ai - ti; x[13].real = ar + tr; x[13].imag = ai + ti;
+    ar = x[14].real; ai = x[14].imag; tr = 0.19509032201612833 * x[46].real - -0.9807852804032304 * x[46].imag; ti = 0.19509032201612833 * x[46].imag + -0.9807852804032304 * x[46].real;
+    x[46].real = ar - tr; x[46].imag = ai - ti; x[14].real = ar + tr; x[14].imag = ai + ti;
+    ar = x[15].real; ai = x[15].imag; tr = 0.09801714032956077 * x[47].real - -0.9951847266721968 * x[47].imag; ti = 0.09801714032956077 * x[47].imag + -0.9951847266721968 * x[47].real;
+    x[47].real = ar - tr; x[47].imag = ai - ti; x[15].real = ar + tr; x[15].imag = ai + ti;
+    ar = x[16].real; ai = x[16].imag; tr = x[48].imag; ti = -x[48].real;
+    x[48].real = ar - tr; x[48].imag = ai - ti; x[16].real = ar + tr; x[16].imag = ai + ti;
+    ar = x[17].real; ai = x[17].imag; tr = -0.09801714032956065 * x[49].real - -0.9951847266721969 * x[49].imag; ti = -0.09801714032956065 * x[49].imag + -0.9951847266721969 * x[49].real;
+    x[49].real = ar - tr; x[49].imag = ai - ti; x[17].real = ar + tr; x[17].imag = ai + ti;
+    ar = x[18].real; ai = x[18].imag; tr = -0.1950903220161282 * x[50].real - -0.9807852804032304 * x[50].imag; ti = -0.1950903220161282 * x[50].imag + -0.9807852804032304 * x[50].real;
+    x[50].real = ar - tr; x[50].imag = ai - ti; x[18].real = ar + tr; x[18].imag = ai + ti;
+    ar = x[19].real; ai = x[19].imag; tr = -0.29028467725446216 * x[51].real - -0.9569403357322089 * x[51].imag; ti = -0.29028467725446216 * x[51].imag + -0.9569403357322089 * x[51].real;
+    x[51].real = ar - tr; x[51].imag = ai - ti; x[19].real = ar + tr; x[19].imag = ai + ti;
+    ar = x[20].real; ai = x[20].imag; tr = -0.3826834323650897 * x[52].real - -0.9238795325112867 * x[52].imag; ti = -0.3826834323650897 * x[52].imag + -0.9238795325112867 * x[52].real;
+    x[52].real = ar - tr; x[52].imag = ai - ti; x[20].real = ar + tr; x[20].imag = ai + ti;
+    ar = x[21].real; ai = x[21].imag; tr = -0.4713967368259977 * x[53].real - -0.881921264348355 * x[53].imag; ti = -0.4713967368259977 * x[53].imag + -0.881921264348355 * x[53].real;
+    x[53].real = ar - tr; x[53].imag = ai - ti; x[21].real = ar + tr; x[21].imag = ai + ti;
+    ar = x[22].real; ai = x[22].imag; tr = -0.555570233019602 * x[54].real - -0.8314696123025455 * x[54].imag; ti = -0.555570233019602 * x[54].imag + -0.8314696123025455 * x[54].real;
+    x[54].real = ar - tr; x[54].imag = ai - ti; x[22].real = ar + tr; x[22].imag = ai + ti;
+    ar = x[23].real; ai = x[23].imag; tr = -0.6343932841636454 * x[55].real - -0.7730104533627371 * x[55].imag; ti = -0.6343932841636454 * x[55].imag + -0.7730104533627371 * x[55].real;
+    x[55].real = ar - tr; x[55].imag = ai - ti; x[23].real = ar + tr; x[23].imag = ai + ti;
+    ar = x[24].real; ai = x[24].imag; tr = SQRT1_2 * (x[56].imag - x[56].real); ti = -SQRT1_2 * (x[56].real + x[56].imag);
+    x[56].real = ar - tr; x[56].imag = ai - ti; x[24].real = ar + tr; x[24].imag = ai + ti;
+    ar = x[25].real; ai = x[25].imag; tr = -0.773010453362737 * x[57].real - -0.6343932841636455 * x[57].imag; ti = -0.773010453362737 * x[57].imag + -0.6343932841636455 * x[57].real;
+    x[57].real = ar - tr; x[57].imag = ai - ti; x[25].real = ar + tr; x[25].imag = ai + ti;
+    ar = x[26].real; ai = x[26].imag; tr = -0.8314696123025453 * x[58].real - -0.5555702330196022 * x[58].imag; ti = -0.8314696123025453 * x[58].imag + -0.5555702330196022 * x[58].real;
+    x[58].real = ar - tr; x[58].imag = ai - ti; x[26].real = ar + tr; x[26].imag = ai + ti;
+    ar = x[27].real; ai = x[27].imag; tr = -0.8819212643483549 * x[59].real - -0.47139673682599786 * x[59].imag; ti = -0.8819212643483549 * x[59].imag + -0.47139673682599786 * x[59].real;
+    x[59].real = ar - tr; x[59].imag = ai - ti; x[27].real = ar + tr; x[27].imag = ai + ti;
+    ar = x[28].real; ai = x[28].imag; tr = -0.9238795325112867 * x[60].real - -0.3826834323650899 * x[60].imag; ti = -0.9238795325112867 * x[60].imag + -0.3826834323650899 * x[60].real;
+    x[60].real = ar - tr; x[60].imag = ai - ti; x[28].real = ar + tr; x[28].imag = ai + ti;
+    ar = x[29].real; ai = x[29].imag; tr = -0.9569403357322088 * x[61].real - -0.2902846772544624 * x[61].imag; ti = -0.9569403357322088 * x[61].imag + -0.2902846772544624 * x[61].real;
+    x[61].real = ar - tr; x[61].imag = ai - ti; x[29].real = ar + tr; x[29].imag = ai + ti;
+    ar = x[30].real; ai = x[30].imag; tr = -0.9807852804032304 * x[62].real - -0.1950903220161286 * x[62].imag; ti = -0.9807852804032304 * x[62].imag + -0.1950903220161286 * x[62].real;
+    x[62].real = ar - tr; x[62].imag = ai - ti; x[30].real = ar + tr; x[30].imag = ai + ti;
+    ar = x[31].real; ai = x[31].imag; tr = -0.9951847266721968 * x[63].real - -0.09801714032956083 * x[63].imag; ti = -0.9951847266721968 * x[63].imag + -0.09801714032956083 * x[63].real;
+    x[63].real = ar - tr; x[63].imag = ai - ti; x[31].real = ar + tr; x[31].imag = ai + ti;
+}
+
+static void fft_codelet_64(Complex *x) {
+    SWAP(1, 32); SWAP(2, 16); SWAP(3, 48); SWAP(4, 8);
+    SWAP(5, 40); SWAP(6, 24); SWAP(7, 56); SWAP(9, 36);
+    SWAP(10, 20); SWAP(11, 52); SWAP(13, 44); SWAP(14, 28);
+    SWAP(15, 60); SWAP(17, 34); SWAP(19, 50); SWAP(21, 42);
+    SWAP(22, 26); SWAP(23, 58); SWAP(25, 38); SWAP(27, 54);
+    SWAP(29, 46); SWAP(31, 62); SWAP(35, 49); SWAP(37, 41);
+    SWAP(39, 57); SWAP(43, 53); SWAP(47, 61); SWAP(55, 59);
+    fft_codelet_64_br(x);
+}
+
+/******************************************************************************/
+/* n = 128 */
+
+static void fft_codelet_128_br(Complex *x) {
+    fft_codelet_64_br(x);
+    fft_codelet_64_br(x + 64);
+    double ar, ai, tr, ti;
+
+    // stage: span 128
+    ar = x[0].real; ai = x[0].imag; tr = x[64].real; ti = x[64].imag;
+    x[64].real = ar - tr; x[64].imag = ai - ti; x[0].real = ar + tr; x[0].imag = ai + ti;
+    ar = x[1].real; ai = x[1].imag; tr = 0.9987954562051724 * x[65].real - -0.049067674327418015 * x[65].imag; ti = 0.9987954562051724 * x[65].imag + -0.049067674327418015 * x[65].real;
+    x[65].real = ar - tr; x[65].imag = ai - ti; x[1].real = ar + tr; x[1].imag = ai + ti;
+    ar = x[2].real; ai = x[2].imag; tr = 0.9951847266721969 * x[66].real - -0.0980171403295606 * x[66].imag; ti = 0.9951847266721969 * x[66].imag + -0.0980171403295606 * x[66].real;
+    x[66].real = ar - tr; x[66].imag = ai - ti; x[2].real = ar + tr; x[2].imag = ai + ti;
+    ar = x[3].real; ai = x[3].imag; tr = 0.989176509964781 * x[67].real - -0.14673047445536175 * x[67].imag; ti = 0.989176509964781 * x[67].imag + -0.14673047445536175 * x[67].real;
+    x[67].real = ar - tr; x[67].imag = ai - ti; x[3].real = ar + tr; x[3].imag = ai + ti;
+    ar = x[4].real; ai = x[4].imag; tr = 0.9807852804032304 * x[68].real - -0.19509032201612825 * x[68].imag; ti = 0.9807852804032304 * x[68].imag + -0.19509032201612825 * x[68].real;
+    x[68].real = ar - tr; x[68].imag = ai - ti; x[4].real = ar + tr; x[4].imag = ai + ti;
+    ar = x[5].real; ai = x[5].imag; tr = 0.970031253194544 * x[69].real - -0.24298017990326387 * x[69].imag; ti = 0.970031253194544 * x[69].imag + -0.24298017990326387 * x[69].real;
+    x[69].real = ar - tr; x[69].imag = ai - ti; x[5].real = ar + tr; x[5].imag = ai + ti;
+    ar = x[6].real; ai = x[6].imag; tr = 0.9569403357322088 * x[70].real - -0.29028467725446233 * x[70].imag; ti = 0.9569403357322088 * x[70].imag + -0.29028467725446233 * x[70].real;
+    x[70].real = ar - tr; x[70].imag = ai - ti; x[6].real = ar + tr; x[6].imag = ai + ti;
+    ar = x[7].real; ai = x[7].imag; tr = 0.9415440651830208 * x[71].real - -0.33688985339222005 * x[71].imag; ti = 0.9415440651830208 * x[71].imag + -0.33688985339222005 * x[71].real;
+    x[71].real = ar - tr; x[71].imag = ai - ti; x[7].real = ar + tr; x[7].imag = ai + ti;
+    ar = x[8].real; ai = x[8].imag; tr = 0.9238795325112867 * x[72].real - -0.3826834323650898 * x[72].imag; ti = 0.9238795325112867 * x[72].imag + -0.3826834323650898 * x[72].real;
+    x[72].real = ar - tr; x[72].imag = ai - ti; x[8].real = ar + tr; x[8].imag = ai + ti;
+    ar = x[9].real; ai = x[9].imag; tr = 0.9039892931234433 * x[73].real - -0.4275550934302821 * x[73].imag; ti = 0.9039892931234433 * x[73].imag + -0.4275550934302821 * x[73].real;
+    x[73].real = ar - tr; x[73].imag = ai - ti; x[9].real = ar + tr; x[9].imag = ai + ti;
+    ar = x[10].real; ai = x[10].imag; tr = 0.881921264348355 * x[74].real - -0.47139673682599764 * x[74].imag; ti = 0.881921264348355 * x[74].imag + -0.47139673682599764 * x[74].real;
+    x[74].real = ar - tr; x[74].imag = ai - ti; x[10].real = ar + tr; x[10].imag = ai + ti;
+    ar = x[11].real; ai = x[11].imag; tr = 0.8577286100002721 * x[75].real - -0.5141027441932217 * x[75].imag; ti = 0.8577286100002721 * x[75].imag + -0.5141027441932217 * x[75].real;
+    x[75].real = ar - tr; x[75].imag = ai - ti; x[11].real = ar + tr; x[11].imag = ai + ti;
+    ar = x[12].real; ai = x[12].imag; tr = 0.8314696123025452 * x[76].real - -0.5555702330196022 * x[76].imag; ti = 0.8314696123025452 * x[76].imag + -0.5555702330196022 * x[76].real;
+    x[76].real = ar - tr; x[76].imag = ai - ti; x[12].real = ar + tr; x[12].imag = ai + ti;
+    ar = x[13].real; ai = x[13].imag; tr = 0.8032075314806449 * x[77].real - -0.5956993044924334 * x[77].imag; ti = 0.8032075314806449 * x[77].imag + -0.5956993044924334 * x[77].real;
+    x[77].real = ar - tr; x[77].imag = ai - ti; x[13].real = ar + tr; x[13].imag = ai + ti;
+    ar = x[14].real; ai = x[14].imag; tr = 0.773010453362737 * x[78].real - -0.6343932841636455 * x[78].imag; ti = 0.773010453362737 * x[78].imag + -0.6343932841636455 * x[78].real;
+    x[78].real = ar - tr; x[78].imag = ai - ti; x[14].real = ar + tr; x[14].imag = ai + ti;
+    ar = x[15].real; ai = x[15].imag; tr = 0.7409511253549591 * x[79].real - -0.6715589548470183 * x[79].imag; ti = 0.7409511253549591 * x[79].imag + -0.6715589548470183 * x[79].real;
+    x[79].real = ar - tr; x[79].imag = ai - ti; x[15].real = ar + tr; x[15].imag = ai + ti;
+    ar = x[16].real; ai = x[16].imag; tr = SQRT1_2 * (x[80].real + x[80].imag); ti = SQRT1_2 * (x[80].imag - x[80].real);
+    x[80].real = ar - tr; x[80].imag = ai - ti; x[16].real = ar + tr; x[16].imag = ai + ti;
+    ar = x[17].real; ai = x[17].imag; tr = 0.6715589548470183 * x[81].real - -0.7409511253549591 * x[81].imag; ti = 0.6715589548470183 * x[81].imag + -0.7409511253549591 * x[81].real;
+    x[81].real = ar - tr; x[81].imag = ai - ti; x[17].real = ar + tr; x[17].imag = ai + ti;
+    ar = x[18].real; ai = x[18].imag; tr = 0.6343932841636455 * x[82].real - -0.773010453362737 * x[82].imag; ti = 0.6343932841636455 * x[82].imag + -0.773010453362737 * x[82].real;
+    x[82].real = ar - tr; x[82].imag = ai - ti; x[18].real = ar + tr; x[18].imag = ai + ti;
+    ar = x[19].real; ai = x[19].imag; tr = 0.5956993044924335 * x[83].real - -0.8032075314806448 * x[83].imag; ti = 0.5956993044924335 * x[83].imag + -0.8032075314806448 * x[83].real;
+    x[83].real = ar - tr; x[83].imag = ai - ti; x[19].real = ar + tr; x[19].imag = ai + ti;
+    ar = x[20].real; ai = x[20].imag; tr = 0.5555702330196023 * x[84].real - -0.8314696123025452 * x[84].imag; ti = 0.5555702330196023 * x[84].imag + -0.8314696123025452 * x[84].real;
+    x[84].real = ar - tr; x[84].imag = ai - ti; x[20].real = ar + tr; x[20].imag = ai + ti;
+    ar = x[21].real; ai = x[21].imag; tr = 0.5141027441932217 * x[85].real - -0.8577286100002721 * x[85].imag; ti = 0.5141027441932217 * x[85].imag + -0.8577286100002721 * x[85].real;
+    x[85].real = ar - tr; x[85].imag = ai - ti; x[21].real = ar + tr; x[21].imag = ai + ti;
+    ar = x[22].real; ai = x[22].imag; tr = 0.4713967368259978 * x[86].real - -0.8819212643483549 * x[86].imag; ti = 0.4713967368259978 * x[86].imag + -0.8819212643483549 * x[86].real;
+    x[86].real = ar - tr; x[86].imag = ai - ti; x[22].real = ar + tr; x[22].imag = ai + ti;
+    ar = x[23].real; ai = x[23].imag; tr = 0.4275550934302822 * x[87].real - -0.9039892931234433 * x[87].imag; ti = 0.4275550934302822 * x[87].imag + -0.9039892931234433 * x[87].real;
+    x[87].real = ar - tr; x[87].imag = ai - ti; x[23].real = ar + tr; x[23].imag = ai + ti;
+    ar = x[24].real; ai = x[24].imag; tr = 0.38268343236508984 * x[88].real - -0.9238795325112867 * x[88].imag; ti = 0.38268343236508984 * x[88].imag + -0.9238795325112867 * x[88].real;
+    x[88].real = ar - tr; x[88].imag = ai - ti; x[24].real = ar + tr; x[24].imag = ai + ti;
+    ar = x[25].real; ai = x[25].imag; tr = 0.33688985339222005 * x[89].real - -0.9415440651830208 * x[89].imag; ti = 0.33688985339222005 * x[89].imag + -0.9415440651830208 * x[89].real;
+    x[89].real = ar - tr; x[89].imag = ai - ti; x[25].real = ar + tr; x[25].imag = ai + ti;
+    ar = x[26].real; ai = x[26].imag; tr = 0.29028467725446233 * x[90].real - -0.9569403357322089 * x[90].imag; ti = 0.29028467725446233 * x[90].imag + -0.9569403357322089 * x[90].real;
+    x[90].real = ar - tr; x[90].imag = ai - ti; x[26].real = ar + tr; x[26].imag = ai + ti;
+    ar = x[27].real; ai = x[27].imag; tr = 0.24298017990326398 * x[91].real - -0.970031253194544 * x[91].imag; ti = 0.24298017990326398 * x[91].imag + -0.970031253194544 * x[91].real;
+    x[91].real = ar - tr; x[91].imag = ai - ti; x[27].real = ar + tr; x[27].imag = ai + ti;
+    ar = x[28].real; ai = x[28].imag; tr = 0.19509032201612833 * x[92].real - -0.9807852804032304 * x[92].imag; ti = 0.19509032201612833 * x[92].imag + -0.9807852804032304 * x[92].real;
+    x[92].real = ar - tr; x[92].imag = ai - ti; x[28].real = ar + tr; x[28].imag = ai + ti;
+    ar = x[29].real; ai = x[29].imag; tr = 0.14673047445536175 * x[93].real - -0.989176509964781 * x[93].imag; ti = 0.14673047445536175 * x[93].imag + -0.989176509964781 * x[93].real;
+    x[93].real = ar - tr; x[93].imag = ai - ti; x[29].real = ar + tr; x[29].imag = ai + ti;
+    ar = x[30].real; ai = x[30].imag; tr = 0.09801714032956077 * x[94].real - -0.9951847266721968 * x[94].imag; ti = 0.09801714032956077 * x[94].imag + -0.9951847266721968 * x[94].real;
+    x[94].real = ar - tr; x[94].imag = ai - ti; x[30].real = ar + tr; x[30].imag = ai + ti;
+    ar = x[31].real; ai = x[31].imag; tr = 0.049067674327418126 * x[95].real - -0.9987954562051724 * x[95].imag; ti = 0.049067674327418126 * x[95].imag + -0.9987954562051724 * x[95].real;
+    x[95].real = ar - tr; x[95].imag = ai - ti; x[31].real = ar + tr; x[31].imag = ai + ti;
+    ar = x[32].real; ai = x[32].imag; tr = x[96].imag; ti = -x[96].real;
+    x[96].real = ar - tr; x[96].imag = ai - ti; x[32].real = ar + tr; x[32].imag = ai + ti;
+    ar = x[33].real; ai = x[33].imag; tr = -0.04906767432741801 * x[97].real - -0.9987954562051724 * x[97].imag; ti = -0.04906767432741801 * x[97].imag + -0.9987954562051724 * x[97].real;
+    x[97].real = ar - tr; x[97].imag = ai - ti; x[33].real = ar + tr; x[33].imag = ai + ti;
+    ar = x[34].real; ai = x[34].imag; tr = -0.09801714032956065 * x[98].real - -0.9951847266721969 * x[98].imag; ti = -0.09801714032956065 * x[98].imag + -0.9951847266721969 * x[98].real;
+    x[98].real = ar - tr; x[98].imag = ai - ti; x[34].real = ar + tr; x[34].imag = ai + ti;
+    ar = x[35].real; ai = x[35].imag; tr = -0.14673047445536164 * x[99].real - -0.989176509964781 * x[99].imag; ti = -0.14673047445536164 * x[99].imag + -0.989176509964781 * x[99].real;
+    x[99].real = ar - tr; x[99].imag = ai - ti; x[35].real = ar + tr; x[35].imag = ai + ti;
+    ar = x[36].real; ai = x[36].imag; tr = -0.1950903220161282 * x[100].real - -0.9807852804032304 * x[100].imag; ti = -0.1950903220161282 * x[100].imag + -0.9807852804032304 * x[100].real;
+    x[100].real = ar - tr; x[100].imag = ai - ti; x[36].real = ar + tr; x[36].imag = ai + ti;
+    ar = x[37].real; ai = x[37].imag; tr = -0.24298017990326387 * x[101].real - -0.970031253194544 * x[101].imag; ti = -0.24298017990326387 * x[101].imag + -0.970031253194544 * x[101].real;
+    x[101].real = ar - tr; x[101].imag = ai - ti; x[37].real = ar + tr; x[37].imag = ai + ti;
+    ar = x[38].real; ai = x[38].imag; tr = -0.29028467725446216 * x[102].real - -0.9569403357322089 * x[102].imag; ti = -0.29028467725446216 * x[102].imag + -0.9569403357322089 * x[102].real;
+    x[102].real = ar - tr; x[102].imag = ai - ti; x[38].real = ar + tr; x[38].imag = ai + ti;
+    ar = x[39].real; ai = x[39].imag; tr = -0.33688985339221994 * x[103].real - -0.9415440651830208 * x[103].imag; ti = -0.33688985339221994 * x[103].imag + -0.9415440651830208 * x[103].real;
+    x[103].real = ar - tr; x[103].imag = ai - ti; x[39].real = ar + tr; x[39].imag = ai + ti;
+    ar = x[40].real; ai = x[40].imag; tr = -0.3826834323650897 * x[104].real - -0.9238795325112867 * x[104].imag; ti = -0.3826834323650897 * x[104].imag + -0.9238795325112867 * x[104].real;
+    x[104].real = ar - tr; x[104].imag = ai - ti; x[40].real = ar + tr; x[40].imag = ai + ti;
+    ar = x[41].real; ai = x[41].imag; tr = -0.42755509343028186 * x[105].real - -0.9039892931234434 * x[105].imag; ti = -0.42755509343028186 * x[105].imag + -0.9039892931234434 * x[105].real;
+    x[105].real = ar - tr; x[105].imag = ai - ti; x[41].real = ar + tr; x[41].imag = ai + ti;
+    ar = x[42].real; ai = x[42].imag; tr = -0.4713967368259977 * x[106].real - -0.881921264348355 * x[106].imag; ti = -0.4713967368259977 * x[106].imag + -0.881921264348355 * x[106].real;
+    x[106].real = ar - tr; x[106].imag = ai - ti; x[42].real = ar + tr; x[42].imag = ai + ti;
+    ar = x[43].real; ai = x[43].imag; tr = -0.5141027441932217 * x[107].real - -0.8577286100002721 * x[107].imag; ti = -0.5141027441932217 * x[107].imag + -0.8577286100002721 * x[107].real;
+    x[107].real = ar - tr; x[107].imag = ai - ti; x[43].real = ar + tr; x[43].imag = ai + ti;
+    ar = x[44].real; ai = x[44].imag; tr = -0.555570233019602 * x[108].real - -0.8314696123025455 * x[108].imag; ti = -0.555570233019602 * x[108].imag + -0.8314696123025455 * x[108].real;
+    x[108].real = ar - tr; x[108].imag = ai - ti; x[44].real = ar + tr; x[44].imag = ai + ti;
+    ar = x[45].real; ai = x[45].imag; tr = -0.5956993044924334 * x[109].real - -0.8032075314806449 * x[109].imag; ti = -0.5956993044924334 * x[109].imag + -0.8032075314806449 * x[109].real;
+    x[109].real = ar - tr; x[109].imag = ai - ti; x[45].real = ar + tr; x[45].imag = ai + ti;
+    ar = x[46].real; ai = x[46].imag; tr = -0.6343932841636454 * x[110].real - -0.7730104533627371 * x[110].imag; ti = -0.6343932841636454 * x[110].imag + -0.7730104533627371 * x[110].real;
+    x[110].real = ar - tr; x[110].imag = ai - ti; x[46].real = ar + tr; x[46].imag = ai + ti;
+    ar = x[47].real; ai = x[47].imag; tr = -0.6715589548470184 * x[111].real - -0.740951125354959 * x[111].imag; ti = -0.6715589548470184 * x[111].imag + -0.740951125354959 * x[111].real;
+    x[111].real = ar - tr; x[111].imag = ai - ti; x[47].real = ar + tr; x[47].imag = ai + ti;
+    ar = x[48].real; ai = x[48].imag; tr = SQRT1_2 * (x[112].imag - x[112].real); ti = -SQRT1_2 * (x[112].real + x[112].imag);
+    x[112].real = ar - tr; x[112].imag = ai - ti; x[48].real = ar + tr; x[48].imag = ai + ti;
+    ar = x[49].real; ai = x[49].imag; tr = -0.7409511253549589 * x[113].real - -0.6715589548470186 * x[113].imag; ti = -0.7409511253549589 * x[113].imag + -0.6715589548470186 * x[113].real;
+    x[113].real = ar - tr; x[113].imag = ai - ti; x[49].real = ar + tr; x[49].imag = ai + ti;
+    ar = x[50].real; ai = x[50].imag; tr = -0.773010453362737 * x[114].real - -0.6343932841636455 * x[114].imag; ti = -0.773010453362737 * x[114].imag + -0.6343932841636455 * x[114].real;
+    x[114].real = ar - tr; x[114].imag = ai - ti; x[50].real = ar + tr; x[50].imag = ai + ti;
+    ar = x[51].real; ai = x[51].imag; tr = -0.8032075314806448 * x[115].real - -0.5956993044924335 * x[115].imag; ti = -0.8032075314806448 * x[115].imag + -0.5956993044924335 * x[115].real;
+    x[115].real = ar - tr; x[115].imag = ai - ti; x[51].real = ar + tr; x[51].imag = ai + ti;
+    ar = x[52].real; ai = x[52].imag; tr = -0.8314696123025453 * x[116].real - -0.5555702330196022 * x[116].imag; ti = -0.8314696123025453 * x[116].imag + -0.5555702330196022 * x[116].real;
+    x[116].real = ar - tr; x[116].imag = ai - ti; x[52].real = ar + tr; x[52].imag = ai + ti;
+    ar = x[53].real; ai = x[53].imag; tr = -0.857728610000272 * x[117].real - -0.5141027441932218 * x[117].imag; ti = -0.857728610000272 * x[117].imag + -0.5141027441932218 * x[117].real;
+    x[117].real = ar - tr; x[117].imag = ai - ti; x[53].real = ar + tr; x[53].imag = ai + ti;
+    ar = x[54].real; ai = x[54].imag; tr = -0.8819212643483549 * x[118].real - -0.47139673682599786 * x[118].imag; ti = -0.8819212643483549 * x[118].imag + -0.47139673682599786 * x[118].real;
+    x[118].real = ar - tr; x[118].imag = ai - ti; x[54].real = ar + tr; x[54].imag = ai + ti;
+    ar = x[55].real; ai = x[55].imag; tr = -0.9039892931234433 * x[119].real - -0.42755509343028203 * x[119].imag; ti = -0.9039892931234433 * x[119].imag + -0.42755509343028203 * x[119].real;
+    x[119].real = ar - tr; x[119].imag = ai - ti; x[55].real = ar + tr; x[55].imag = ai + ti;
+    ar = x[56].real; ai = x[56].imag; tr = -0.9238795325112867 * x[120].real - -0.3826834323650899 * x[120].imag; ti = -0.9238795325112867 * x[120].imag + -0.3826834323650899 * x[120].real;
+    x[120].real = ar - tr; x[120].imag = ai - ti; x[56].real = ar + tr; x[56].imag = ai + ti;
+    ar = x[57].real; ai = x[57].imag; tr = -0.9415440651830207 * x[121].real - -0.33688985339222033 * x[121].imag; ti = -0.9415440651830207 * x[121].imag + -0.33688985339222033 * x[121].real;
+    x[121].real = ar - tr; x[121].imag = ai - ti; x[57].real = ar + tr; x[57].imag = ai + ti;
+    ar = x[58].real; ai = x[58].imag; tr = -0.9569403357322088 * x[122].real - -0.2902846772544624 * x[122].imag; ti = -0.9569403357322088 * x[122].imag + -0.2902846772544624 * x[122].real;
+    x[122].real = ar - tr; x[122].imag = ai - ti; x[58].real = ar + tr; x[58].imag = ai + ti;
+    ar = x[59].real; ai = x[59].imag; tr = -0.970031253194544 * x[123].real - -0.24298017990326407 * x[123].imag; ti = -0.970031253194544 * x[123].imag + -0.24298017990326407 * x[123].real;
+    x[123].real = ar - tr; x[123].imag = ai - ti; x[59].real = ar + tr; x[59].imag = ai + ti;
+    ar = x[60].real; ai = x[60].imag; tr = -0.9807852804032304 * x[124].real - -0.1950903220161286 * x[124].imag; ti = -0.9807852804032304 * x[124].imag + -0.1950903220161286 * x[124].real;
+    x[124].real = ar - tr; x[124].imag = ai - ti; x[60].real = ar + tr; x[60].imag = ai + ti;
+    ar = x[61].real; ai = x[61].imag; tr = -0.989176509964781 * x[125].real - -0.1467304744553618 * x[125].imag; ti = -0.989176509964781 * x[125].imag + -0.1467304744553618 * x[125].real;
+    x[125].real = ar - tr; x[125].imag = ai - ti; x[61].real = ar + tr; x[61].imag = ai + ti;
+    ar = x[62].real; ai = x[62].imag; tr = -0.9951847266721968 * x[126].real - -0.09801714032956083 * x[126].imag; ti = -0.9951847266721968 * x[126].imag + -0.09801714032956083 * x[126].real;
+    x[126].real = ar - tr; x[126].imag = ai - ti; x[62].real = ar + tr; x[62].imag = ai + ti;
+    ar = x[63].real; ai = x[63].imag; tr = -0.9987954562051724 * x[127].real - -0.049067674327417966 * x[127].imag; ti = -0.9987954562051724 * x[127].imag + -0.049067674327417966 * x[127].real;
+    x[127].real = ar - tr; x[127].imag = ai - ti; x[63].real = ar + tr; x[63].imag = ai + ti;
+}
+
+static void fft_codelet_128(Complex *x) {
+    SWAP(1, 64); SWAP(2, 32); SWAP(3, 96); SWAP(4, 16);
+    SWAP(5, 80); SWAP(6, 48); SWAP(7, 112); SWAP(9, 72);
+    SWAP(10, 40); SWAP(11, 104); SWAP(12, 24); SWAP(13, 88);
+    SWAP(14, 56); SWAP(15, 120); SWAP(17, 68); SWAP(18, 36);
+    SWAP(19, 100); SWAP(21, 84); SWAP(22, 52); SWAP(23, 116);
+    SWAP(25, 76); SWAP(26, 44); SWAP(27, 108); SWAP(29, 92);
+    SWAP(30, 60); SWAP(31, 124); SWAP(33, 66); SWAP(35, 98);
+    SWAP(37, 82); SWAP(38, 50); SWAP(39, 114); SWAP(41, 74);
+    SWAP(43, 106); SWAP(45, 90); SWAP(46, 58); SWAP(47, 122);
+    SWAP(49, 70); SWAP(51, 102); SWAP(53, 86); SWAP(55, 118);
+    SWAP(57, 78); SWAP(59, 110); SWAP(61, 94); SWAP(63, 126);
+    SWAP(67, 97); SWAP(69, 81); SWAP(71, 113); SWAP(75, 105);
+    SWAP(77, 89); SWAP(79, 121); SWAP(83, 101); SWAP(87, 117);
+    SWAP(91, 109); SWAP(95, 125); SWAP(103, 115); SWAP(111, 123);
+    fft_codelet_128_br(x);
+}
+
+/******************************************************************************/
+/* lookup, indexed by log2(n) */
+
+static const FFTCodelet codelets[] = {
+    NULL,
+    fft_codelet_2,
+    fft_codelet_4,
+    fft_codelet_8,
+    fft_codelet_16,
+    fft_codelet_32,
+    fft_codelet_64,
+    fft_codelet_128,
+};
+
+static const FFTCodelet codelets_br[] = {
+    NULL,
+    fft_codelet_2_br,
+    fft_codelet_4_br,
+    fft_codelet_8_br,
+    fft_codelet_16_br,
+    fft_codelet_32_br,
+    fft_codelet_64_br,
+    fft_codelet_128_br,
+};
+
+/******************************************************************************
+ * fft_codelet
+ *
+ * @param[in] n Transform length
+ *
+ * @returns Natural-order codelet for n, NULL unless n is a power
+ *          of two in 2 .. FFT_CODELET_MAX
+ ******************************************************************************/
+FFTCodelet fft_codelet(int n) {
+    if (n < 2 || n > FFT_CODELET_MAX || (n & (n - 1)) != 0) return NULL;
+    int log2n = 0;
+    while ((1 << log2n) < n) log2n++;
+    return codelets[log2n];
+}
+/* End of fft_codelet() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fft_codelet_bitrev
+ *
+ * @param[in] n Transform length
+ *
+ * @returns Bit-reversed-input codelet for n, NULL unless n is a power
+ *          of two in 2 .. FFT_CODELET_MAX
+ ******************************************************************************/
+FFTCodelet fft_codelet_bitrev(int n) {
+    if (n < 2 || n > FFT_CODELET_MAX || (n & (n - 1)) != 0) return NULL;
+    int log2n = 0;
+    while ((1 << log2n) < n) log2n++;
+    return codelets_br[log2n];
+}
+/* End of fft_codelet_bitrev() */
+/******************************************************************************/
@@ -5,15 +5,144 @@
  * Provides functions for filter initialization, resetting state,
  * processing individual input samples, and freeing resources.
  *
+ * Linear-phase filters are detected at init. Symmetric and antisymmetric
+ * coefficients run a folded kernel that adds (subtracts) each pair of
+ * mirrored delay-line samples before the single multiply, halving the
+ * multiplies. Half-band filters also skip their zero taps, which leaves
+ * about a quarter. Results match the plain dot product within rounding.
+ *
+ * With fir_filter_swap_init() the coefficients live in a CoeffSwap: each
+ * set is laid out as a history-less FIRFilter (coefficients, structure and
+ * folded taps), so the control thread runs the structure detection and
+ * the processing thread only repoints its coefficient fields at a block
+ * boundary. During a crossfade the retired set's view filters the same
+ * delay line and the two outputs are mixed linearly.
+ *
  * Created on: Jun 16, 2025
  * Author: Omri Kebede
  */
 
 /******************************************************************************/ 
 /* include block */
+#include <float.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include "fir_filter.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+#include "dsp_profile.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define FIR_FOLD_MIN_TAPS 8          /* shorter filters keep the plain dot product */
+#define FIR_SYMMETRY_TOL (4 * DBL_EPSILON)  /* relative to the largest tap */
+
+/* Internal helper: pick the structure and fill the folded coefficients */
+static void fir_detect_structure(FIRFilter *filter) {
+    const double *h = filter->coeffs;
+    size_t n = filter->num_taps;
+    filter->structure = FIR_GENERIC;
+    filter->num_folded = 0;
+    filter->fold_first = 0;
+    filter->center = 0.0;
+    if (n < FIR_FOLD_MIN_TAPS) return;
+
+    double peak = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        if (fabs(h[i]) > peak) peak = fabs(h[i]);
+    }
+    double tol = FIR_SYMMETRY_TOL * peak;
+
+    int symmetric = 1, antisymmetric = 1;
+    for (size_t i = 0; i < n / 2; i++) {
+        if (fabs(h[i] - h[n - 1 - i]) > tol) symmetric = 0;
+        if (fabs(h[i] + h[n - 1 - i]) > tol) antisymmetric = 0;
+    }
+    if (n % 2 == 1 && fabs(h[n / 2]) > tol) antisymmetric = 0;
+
+    if (symmetric) {
+        size_t mid = n / 2;
+        int halfband = n % 2 == 1;
+        for (size_t d = 2; halfband && d <= mid; d += 2) {
+            if (fabs(h[mid - d]) > tol) halfband = 0;
+        }
+        filter->center = n % 2 == 1 ? h[mid] : 0.0;
+        if (halfband) {
+            // Pairs at odd offsets 1, 3, .. from the centre, outermost first
+            filter->structure = FIR_HALFBAND;
+            filter->num_folded = (mid + 1) / 2;
+            filter->fold_first = mid - (2 * filter->num_folded - 1);
+            for (size_t i = 0; i < filter->num_folded; i++) {
+                size_t j = filter->fold_first + 2 * i;
+                filter->folded[i] = 0.5 * (h[j] + h[n - 1 - j]);
+            }
+        } else {
+            filter->structure = FIR_SYMMETRIC;
+            filter->num_folded = n / 2;
+            for (size_t i = 0; i < n / 2; i++) {
+                filter->folded[i] = 0.5 * (h[i] + h[n - 1 - i]);
+            }
+        }
+    } else if (antisymmetric) {
+        filter->structure = FIR_ANTISYMMETRIC;
+        filter->num_folded = n / 2;
+        for (size_t i = 0; i < n / 2; i++) {
+            filter->folded[i] = 0.5 * (h[i] - h[n - 1 - i]);
+        }
+    }
+}
+
+/* Internal helper: output for the delay line w (newest sample first) */
+static inline double fir_output(const FIRFilter *filter, const double *w, const DspKernels *k) {
+    size_t n = filter->num_taps;
+    const double *lo = w + filter->fold_first;
+    const double *hi = w + n - 1 - filter->fold_first;
+    switch (filter->structure) {
+        case FIR_SYMMETRIC:
+            return k->dot_folded(filter->folded, lo, hi, filter->num_folded, 1, 0) +
+                   filter->center * w[n / 2];
+        case FIR_ANTISYMMETRIC:
+            return k->dot_folded(filter->folded, lo, hi, filter->num_folded, 1, 1);
+        case FIR_HALFBAND:
+            return k->dot_folded(filter->folded, lo, hi, filter->num_folded, 2, 0) +
+                   filter->center * w[n / 2];
+        default:
+            return k->dot(filter->coeffs, w, n);
+    }
+}
+
+/* Internal helper: bytes of one hot-swap set (FIRFilter view, coeffs, folded) */
+static size_t fir_set_size(size_t num_taps) {
+    return DSP_MEM_ALIGN_UP(sizeof(FIRFilter)) +
+           DSP_MEM_ALIGN_UP(num_taps * sizeof(double)) +
+           DSP_MEM_ALIGN_UP((num_taps / 2 + 1) * sizeof(double));
+}
+
+/* Internal helper: fill set with coefficients h and their structure */
+static void fir_set_fill(void *set, const double *h, size_t num_taps) {
+    DspArena arena;
+    dsp_arena_init(&arena, set, fir_set_size(num_taps));
+
+    FIRFilter *view = dsp_arena_alloc(&arena, sizeof(FIRFilter));
+    memset(view, 0, sizeof(FIRFilter));
+    view->num_taps = num_taps;
+    view->coeffs = dsp_arena_alloc(&arena, num_taps * sizeof(double));
+    view->folded = dsp_arena_alloc(&arena, (num_taps / 2 + 1) * sizeof(double));
+    memcpy(view->coeffs, h, num_taps * sizeof(double));
+    fir_detect_structure(view);
+}
+
+/* Internal helper: run filter on the coefficients of set */
+static void fir_set_use(FIRFilter *filter, const void *set) {
+    const FIRFilter *view = set;
+    filter->coeffs = view->coeffs;
+    filter->structure = view->structure;
+    filter->folded = view->folded;
+    filter->num_folded = view->num_folded;
+    filter->fold_first = view->fold_first;
+    filter->center = view->center;
+}
 
 /******************************************************************************
  * fir_filter_init
@@ -24,30 +153,82 @@
  *
  * @returns 0 on success, -1 on memory allocation failure.
  *
- * @note Initializes the FIR filter structure by allocating memory for the
- *       coefficients and history buffers, copies coefficients, and
- *       sets the initial history index to zero.
+ * @note Allocates one block of fir_filter_mem_size() bytes and lays the
+ *       filter out in it with fir_filter_init_mem().
  *
  * @warning Caller must ensure fir_filter_free() is called to avoid leaks.
  */
 int fir_filter_init(FIRFilter *filter, const double *coeffs, size_t num_taps) {
-    filter->num_taps = num_taps;
-    filter->coeffs = (double*)malloc(sizeof(double) * num_taps);
-    filter->history = (double*)calloc(num_taps, sizeof(double));
-    filter->history_index = 0;
-
-    if (!filter->coeffs || !filter->history) {
-        free(filter->coeffs);
-        free(filter->history);
+    void *mem = malloc(fir_filter_mem_size(num_taps));
+    if (!mem) {
+        filter->coeffs = NULL;
+        filter->history = NULL;
+        filter->folded = NULL;
+        filter->owned_mem = NULL;
+        filter->swap = NULL;
         return -1; // Allocation failed
     }
 
-    memcpy(filter->coeffs, coeffs, sizeof(double) * num_taps);
+    fir_filter_init_mem(filter, coeffs, num_taps, mem);
+    filter->owned_mem = mem;
     return 0; // Success
 }
 /* End of fir_filter_init() */
 /******************************************************************************/
 
+/******************************************************************************
+ * fir_filter_mem_size
+ *
+ * @param[in] num_taps Number of filter taps.
+ *
+ * @returns Bytes of memory fir_filter_init_mem() needs.
+ */
+size_t fir_filter_mem_size(size_t num_taps) {
+    return DSP_MEM_ALIGN_UP(num_taps * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(2 * num_taps * sizeof(double)) +
+           DSP_MEM_ALIGN_UP((num_taps / 2 + 1) * sizeof(double));
+}
+/* End of fir_filter_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fir_filter_init_mem
+ *
+ * @param[in,out] filter Pointer to FIRFilter struct to initialize.
+ * @param[in] coeffs     Array of FIR filter coefficients.
+ * @param[in] num_taps   Number of filter taps (length of coeffs).
+ * @param[in] mem        At least fir_filter_mem_size(num_taps) bytes, aligned
+ *                       for double; must outlive the filter.
+ *
+ * @returns 0 (cannot fail).
+ *
+ * @note Copies the coefficients, zeroes the history and sets the initial
+ *       history index to zero. The history is a doubled circular buffer
+ *       (2 * num_taps) so the newest num_taps samples are always contiguous,
+ *       newest first, starting at history_index. Detects symmetric,
+ *       antisymmetric and half-band coefficients (to FIR_SYMMETRY_TOL of
+ *       the largest tap) and sets filter->structure. Performs no allocation.
+ */
+int fir_filter_init_mem(FIRFilter *filter, const double *coeffs, size_t num_taps, void *mem) {
+    DspArena arena;
+    dsp_arena_init(&arena, mem, fir_filter_mem_size(num_taps));
+
+    filter->num_taps = num_taps;
+    filter->coeffs = dsp_arena_alloc(&arena, num_taps * sizeof(double));
+    filter->history = dsp_arena_alloc(&arena, 2 * num_taps * sizeof(double));
+    filter->folded = dsp_arena_alloc(&arena, (num_taps / 2 + 1) * sizeof(double));
+    filter->history_index = 0;
+    filter->owned_mem = NULL;
+    filter->swap = NULL;
+
+    memcpy(filter->coeffs, coeffs, sizeof(double) * num_taps);
+    memset(filter->history, 0, 2 * sizeof(double) * num_taps);
+    fir_detect_structure(filter);
+    return 0;
+}
+/* End of fir_filter_init_mem() */
+/******************************************************************************/
+
 /******************************************************************************
  * fir_filter_reset
  *
@@ -62,7 +243,7 @@ int fir_filter_init(FIRFilter *filter, const double *coeffs, size_t num_taps) {
  */
 void fir_filter_reset(FIRFilter *filter) {
     if (filter->history) {
-        memset(filter->history, 0, sizeof(double) * filter->num_taps);
+        memset(filter->history, 0, 2 * sizeof(double) * filter->num_taps);
     }
     filter->history_index = 0;
 }
@@ -79,28 +260,92 @@ void fir_filter_reset(FIRFilter *filter) {
  *
  * @note Inserts the input sample into the history buffer and computes
  *       the FIR output by convolving the coefficients with the delay line.
- *       Uses a circular buffer approach for the history.
+ *       Uses a doubled circular buffer so the convolution is a single
+ *       contiguous dot product with no index wrapping (folded for
+ *       linear-phase filters, see filter->structure).
  *
  * @warning None
  */
 double fir_filter_process_sample(FIRFilter *filter, double input) {
+    DSP_PROFILE_BEGIN(DSP_PROF_FIR);
+    size_t n = filter->num_taps;
+
+    // Step back one slot and write the sample into both halves
+    filter->history_index = (filter->history_index == 0 ? n : filter->history_index) - 1;
     filter->history[filter->history_index] = input;
+    filter->history[filter->history_index + n] = input;
+
+    double output = fir_output(filter, filter->history + filter->history_index, dsp_kernels());
+    DSP_PROFILE_END(DSP_PROF_FIR);
+    return output;
+}
+/* End of fir_filter_process_sample() */
+/******************************************************************************/
 
-    double output = 0.0;
+/******************************************************************************
+ * fir_filter_process_block
+ *
+ * @param[in,out] filter      Pointer to FIRFilter struct.
+ * @param[in]     input       Block of input samples.
+ * @param[out]    output      Block of filtered samples (may alias input).
+ * @param[in]     num_samples Number of samples in the block.
+ *
+ * @returns None
+ *
+ * @note Equivalent to calling fir_filter_process_sample() for every sample,
+ *       with the filter state kept in locals for the whole block.
+ *       With hot-swap enabled, first picks up coefficients published by
+ *       fir_filter_update(), then crossfades from the previous ones while
+ *       a fade runs (both outputs are computed for those samples).
+ *
+ * @warning None
+ */
+void fir_filter_process_block(FIRFilter *filter, const double *input,
+                              double *output, size_t num_samples) {
+    DSP_PROFILE_BEGIN(DSP_PROF_FIR);
+    DspFpState fp;
+    dsp_fp_scope_begin(&fp);
+    size_t n = filter->num_taps;
     size_t index = filter->history_index;
+    double *history = filter->history;
+    const DspKernels *kernels = dsp_kernels();
+    size_t s = 0;
 
-    for (size_t i = 0; i < filter->num_taps; i++) {
-        output += filter->coeffs[i] * filter->history[index];
-        if (index == 0)
-            index = filter->num_taps - 1;
-        else
-            index--;
+    CoeffSwap *swap = filter->swap;
+    if (swap) {
+        if (coeff_swap_poll(swap)) {
+            fir_set_use(filter, coeff_swap_set(swap, swap->active));
+        }
+        size_t fade = coeff_swap_fade_left(swap);
+        if (fade > num_samples) fade = num_samples;
+        if (fade > 0) {
+            const FIRFilter *old = coeff_swap_set(swap, swap->retired);
+            for (; s < fade; s++) {
+                double x = input[s];
+                index = (index == 0 ? n : index) - 1;
+                history[index] = x;
+                history[index + n] = x;
+                double y_old = fir_output(old, history + index, kernels);
+                double y_new = fir_output(filter, history + index, kernels);
+                output[s] = y_old + coeff_swap_gain(swap, s) * (y_new - y_old);
+            }
+            coeff_swap_fade_advance(swap, fade);
+        }
     }
 
-    filter->history_index = (filter->history_index + 1) % filter->num_taps;
-    return output;
+    for (; s < num_samples; s++) {
+        double x = input[s];
+        index = (index == 0 ? n : index) - 1;
+        history[index] = x;
+        history[index + n] = x;
+        output[s] = fir_output(filter, history + index, kernels);
+    }
+
+    filter->history_index = index;
+    dsp_fp_scope_end(&fp);
+    DSP_PROFILE_END(DSP_PROF_FIR);
 }
-/* End of fir_filter_process_sample() */
+/* End of fir_filter_process_block() */
 /******************************************************************************/
 
 /******************************************************************************
@@ -110,18 +355,113 @@ double fir_filter_process_sample(FIRFilter *filter, double input) {
  *
  * @returns None
  *
- * @note Frees memory allocated for coefficients and history buffers
- *       and clears struct members to safe defaults.
+ * @note Frees the block allocated by fir_filter_init() and the one of
+ *       fir_filter_swap_init() (caller memory from the _mem variants is left
+ *       alone) and clears struct members to safe defaults.
  *
  * @warning After calling this, filter should not be used unless reinitialized.
  */
 void fir_filter_free(FIRFilter *filter) {
-    free(filter->coeffs);
-    free(filter->history);
+    coeff_swap_destroy(filter->swap);
+    filter->swap = NULL;
+    free(filter->owned_mem);
+    filter->owned_mem = NULL;
     filter->coeffs = NULL;
     filter->history = NULL;
+    filter->folded = NULL;
     filter->num_taps = 0;
+    filter->num_folded = 0;
+    filter->structure = FIR_GENERIC;
     filter->history_index = 0;
 }
 /* End of fir_filter_free() */
 /******************************************************************************/
+
+/******************************************************************************
+ * fir_filter_swap_mem_size
+ *
+ * @param[in] num_taps Number of filter taps.
+ *
+ * @returns Bytes of memory fir_filter_swap_init_mem() needs.
+ */
+size_t fir_filter_swap_mem_size(size_t num_taps) {
+    return coeff_swap_mem_size(fir_set_size(num_taps));
+}
+/* End of fir_filter_swap_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fir_filter_swap_init_mem
+ *
+ * @param[in,out] filter    Initialized FIRFilter; not yet running.
+ * @param[in]     crossfade Samples over which each update fades in (0 = the
+ *                          new coefficients apply from the block boundary).
+ * @param[in]     mem       At least fir_filter_swap_mem_size(num_taps) bytes,
+ *                          aligned for double; must outlive the filter.
+ *
+ * @returns 0 on success, -1 if hot-swap is already enabled.
+ *
+ * @note Moves the current coefficients into the active set; the history is
+ *       kept. Performs no allocation.
+ */
+int fir_filter_swap_init_mem(FIRFilter *filter, size_t crossfade, void *mem) {
+    if (filter->swap) return -1;
+
+    CoeffSwap *swap = coeff_swap_create_mem(fir_set_size(filter->num_taps), crossfade, mem);
+    void *set = coeff_swap_set(swap, swap->active);
+    fir_set_fill(set, filter->coeffs, filter->num_taps);
+    fir_set_use(filter, set);
+    filter->swap = swap;
+    return 0;
+}
+/* End of fir_filter_swap_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fir_filter_swap_init
+ *
+ * @param[in,out] filter    Initialized FIRFilter; not yet running.
+ * @param[in]     crossfade Crossfade length in samples (0 = none).
+ *
+ * @returns 0 on success, -1 if hot-swap is already enabled, -2 on memory
+ *          allocation failure.
+ *
+ * @note fir_filter_swap_init_mem() on a block that fir_filter_free() releases.
+ */
+int fir_filter_swap_init(FIRFilter *filter, size_t crossfade) {
+    if (filter->swap) return -1;
+
+    void *mem = malloc(fir_filter_swap_mem_size(filter->num_taps));
+    if (!mem) return -2;
+
+    fir_filter_swap_init_mem(filter, crossfade, mem);
+    filter->swap->owned_mem = mem;
+    return 0;
+}
+/* End of fir_filter_swap_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fir_filter_update
+ *
+ * @param[in,out] filter Filter with hot-swap enabled.
+ * @param[in]     coeffs New coefficients [num_taps]; the length is fixed.
+ *
+ * @returns 0 on success, -1 if hot-swap is not enabled.
+ *
+ * @note Control thread: lock-free and allocation-free, safe while another
+ *       thread runs fir_filter_process_block(). Structure detection runs
+ *       here, not on the processing thread. Only one thread may update a
+ *       filter at a time; fir_filter_process_sample() uses the active
+ *       coefficients and picks nothing up.
+ */
+int fir_filter_update(FIRFilter *filter, const double *coeffs) {
+    CoeffSwap *swap = filter->swap;
+    if (!swap) return -1;
+
+    fir_set_fill(coeff_swap_write_begin(swap), coeffs, filter->num_taps);
+    coeff_swap_publish(swap);
+    return 0;
+}
+/* End of fir_filter_update() */
+/******************************************************************************/
@@ -0,0 +1,938 @@
+/*
+ * @file fixed_point.c
+ *
+ * Q15/Q31 fixed-point implementations of the FIR filter, a direct form I
+ * biquad section and a radix-2 FFT, plus block conversions to and from
+ * double.
+ *
+ * Features:
+ *   - Saturating arithmetic everywhere a result is narrowed
+ *   - FIR delay lines use the same doubled circular buffer as FIRFilter, so
+ *     every output is one contiguous int16 x int16 dot product. Whenever
+ *     sum(|coeffs|) guarantees the sum fits in 32 bits, the Q15 filter runs
+ *     the dispatched dot_q15 kernel (pmaddwd: 8 int16 products per SSE2
+ *     register, 16 per AVX2 register); other coefficient sets keep a
+ *     scalar 64-bit accumulator.
+ *   - Biquads take double coefficients in the iir_init() convention and
+ *     store them in Q14/Q30 so |a1| < 2 is representable. With hot-swap
+ *     each CoeffSwap set is a whole section: the control thread quantizes
+ *     into it, and during a crossfade the retired set runs the old section
+ *     from a copy of the live state.
+ *   - The FFT uses block floating point: before every stage the data is
+ *     shifted right just enough to guarantee the butterflies cannot
+ *     overflow, and the total shift is returned as an exponent.
+ *
+ * See fixed_point.h for the documented accuracy bounds.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fixed_point.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define PI 3.14159265358979323846
+
+/* Largest component magnitude that survives a radix-2 butterfly:
+ * |a + w*b| <= M + sqrt(2) * M must stay below the format's maximum */
+#define FFT_Q15_HEADROOM 13572
+#define FFT_Q31_HEADROOM 889516852
+
+/* Twiddle tables W_n^k, k < n/2, per log2 size: built once under the lock,
+ * then read lock-free through the acquire load */
+#define FFT_Q_CACHE_SLOTS 31
+static _Atomic(ComplexQ15 *) fft_q15_twiddles[FFT_Q_CACHE_SLOTS];
+static _Atomic(ComplexQ31 *) fft_q31_twiddles[FFT_Q_CACHE_SLOTS];
+static pthread_mutex_t fft_q_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Internal helper: round and saturate a double to a signed integer range */
+static int64_t round_sat(double v, double lo, double hi) {
+    if (v > hi) return (int64_t)hi;
+    if (v < lo) return (int64_t)lo;
+    return (int64_t)(v < 0 ? v - 0.5 : v + 0.5);
+}
+
+/******************************************************************************/
+/* conversions */
+
+/******************************************************************************
+ * q15_from_double / q15_to_double / q31_from_double / q31_to_double
+ *
+ * @param[in]  input  Source samples
+ * @param[out] output Destination samples
+ * @param[in]  n      Number of samples
+ *
+ * @note Conversions to fixed point round to nearest and saturate values
+ *       outside [-1, 1).
+ */
+void q15_from_double(const double *input, q15_t *output, size_t n) {
+    dsp_kernels()->double_to_s16(input, output, n);
+}
+
+void q15_to_double(const q15_t *input, double *output, size_t n) {
+    dsp_kernels()->s16_to_double(input, output, n);
+}
+
+void q31_from_double(const double *input, q31_t *output, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        output[i] = (q31_t)round_sat(input[i] * 2147483648.0, INT32_MIN, INT32_MAX);
+    }
+}
+
+void q31_to_double(const q31_t *input, double *output, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        output[i] = input[i] / 2147483648.0;
+    }
+}
+/* End of conversions */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Q15 FIR */
+
+/* Internal helper: Q15 dot product with rounding and saturation */
+static inline q15_t fir_q15_dot(const DspKernels *kernels, const q15_t *coeffs,
+                                const q15_t *history, size_t num_taps, int wide_acc) {
+    if (!wide_acc) {
+        // sum(|coeffs|) <= 65535 keeps |acc| below 2^31, so the kernel is exact
+        int32_t acc = (1 << 14) + kernels->dot_q15(coeffs, history, num_taps);
+        return q15_sat(acc >> 15);
+    }
+
+    int64_t acc = 1 << 14;
+    for (size_t i = 0; i < num_taps; i++) {
+        acc += (int32_t)coeffs[i] * history[i];
+    }
+    acc >>= 15;
+    return (q15_t)(acc > INT16_MAX ? INT16_MAX : acc < INT16_MIN ? INT16_MIN : acc);
+}
+
+/******************************************************************************
+ * fir_q15_init
+ *
+ * @param[in,out] filter   Pointer to FIRFilterQ15 struct to initialize
+ * @param[in]     coeffs   Q15 coefficients
+ * @param[in]     num_taps Number of taps
+ *
+ * @returns 0 on success, -1 on memory allocation failure
+ *
+ * @note Allocates one block of fir_q15_mem_size() bytes and initializes it
+ *       with fir_q15_init_mem().
+ *
+ * @warning Caller must ensure fir_q15_free() is called to avoid leaks.
+ */
+int fir_q15_init(FIRFilterQ15 *filter, const q15_t *coeffs, size_t num_taps) {
+    void *mem = malloc(fir_q15_mem_size(num_taps));
+    if (!mem) {
+        filter->coeffs = NULL;
+        filter->history = NULL;
+        filter->owned_mem = NULL;
+        return -1;
+    }
+
+    fir_q15_init_mem(filter, coeffs, num_taps, mem);
+    filter->owned_mem = mem;
+    return 0;
+}
+/* End of fir_q15_init() */
+/******************************************************************************/
+
+/* Bytes of caller memory fir_q15_init_mem() needs */
+size_t fir_q15_mem_size(size_t num_taps) {
+    return DSP_MEM_ALIGN_UP(num_taps * sizeof(q15_t)) +
+           DSP_MEM_ALIGN_UP(2 * num_taps * sizeof(q15_t));
+}
+
+/******************************************************************************
+ * fir_q15_init_mem
+ *
+ * @param[in,out] filter   Pointer to FIRFilterQ15 struct to initialize
+ * @param[in]     coeffs   Q15 coefficients
+ * @param[in]     num_taps Number of taps
+ * @param[in]     mem      At least fir_q15_mem_size(num_taps) bytes; must
+ *                         outlive the filter
+ *
+ * @returns 0 (cannot fail)
+ *
+ * @note Selects the 32-bit accumulator when the coefficient L1 norm makes
+ *       overflow impossible, otherwise a 64-bit accumulator. Performs no
+ *       allocation.
+ */
+int fir_q15_init_mem(FIRFilterQ15 *filter, const q15_t *coeffs, size_t num_taps, void *mem) {
+    DspArena arena;
+    dsp_arena_init(&arena, mem, fir_q15_mem_size(num_taps));
+
+    filter->num_taps = num_taps;
+    filter->coeffs = dsp_arena_alloc(&arena, num_taps * sizeof(q15_t));
+    filter->history = dsp_arena_alloc(&arena, 2 * num_taps * sizeof(q15_t));
+    filter->history_index = 0;
+    filter->owned_mem = NULL;
+
+    memcpy(filter->coeffs, coeffs, num_taps * sizeof(q15_t));
+    memset(filter->history, 0, 2 * num_taps * sizeof(q15_t));
+
+    int64_t l1 = 0;
+    for (size_t i = 0; i < num_taps; i++) {
+        l1 += coeffs[i] < 0 ? -(int64_t)coeffs[i] : coeffs[i];
+    }
+    filter->wide_acc = l1 > 65535;
+    return 0;
+}
+/* End of fir_q15_init_mem() */
+/******************************************************************************/
+
+void fir_q15_reset(FIRFilterQ15 *filter) {
+    if (filter->history) {
+        memset(filter->history, 0, 2 * filter->num_taps * sizeof(q15_t));
+    }
+    filter->history_index = 0;
+}
+
+/******************************************************************************
+ * fir_q15_process_sample
+ *
+ * @param[in,out] filter Pointer to FIRFilterQ15 struct
+ * @param[in]     input  Q15 input sample (e.g. a WavData int16 sample)
+ *
+ * @returns Q15 output sample, rounded and saturated
+ */
+q15_t fir_q15_process_sample(FIRFilterQ15 *filter, q15_t input) {
+    size_t n = filter->num_taps;
+
+    filter->history_index = (filter->history_index == 0 ? n : filter->history_index) - 1;
+    filter->history[filter->history_index] = input;
+    filter->history[filter->history_index + n] = input;
+
+    return fir_q15_dot(dsp_kernels(), filter->coeffs, filter->history + filter->history_index, n,
+                       filter->wide_acc);
+}
+/* End of fir_q15_process_sample() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fir_q15_process_block
+ *
+ * @param[in,out] filter Pointer to FIRFilterQ15 struct
+ * @param[in]     input  Q15 input block
+ * @param[out]    output Q15 output block (may alias input)
+ * @param[in]     n      Number of samples
+ */
+void fir_q15_process_block(FIRFilterQ15 *filter, const q15_t *input, q15_t *output, size_t n) {
+    const DspKernels *kernels = dsp_kernels();
+    size_t taps = filter->num_taps;
+    size_t index = filter->history_index;
+
+    for (size_t s = 0; s < n; s++) {
+        q15_t x = input[s];
+        index = (index == 0 ? taps : index) - 1;
+        filter->history[index] = x;
+        filter->history[index + taps] = x;
+        output[s] = fir_q15_dot(kernels, filter->coeffs, filter->history + index, taps,
+                                filter->wide_acc);
+    }
+
+    filter->history_index = index;
+}
+/* End of fir_q15_process_block() */
+/******************************************************************************/
+
+void fir_q15_free(FIRFilterQ15 *filter) {
+    free(filter->owned_mem);
+    filter->owned_mem = NULL;
+    filter->coeffs = NULL;
+    filter->history = NULL;
+    filter->num_taps = 0;
+    filter->history_index = 0;
+}
+
+/******************************************************************************/
+/* Q31 FIR */
+
+/* Internal helper: Q31 dot product; each Q62 product is truncated to Q31
+ * and accumulated in 64 bits, leaving 32 guard bits */
+static inline q31_t fir_q31_dot(const q31_t *coeffs, const q31_t *history, size_t num_taps) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < num_taps; i++) {
+        acc += ((int64_t)coeffs[i] * history[i]) >> 31;
+    }
+    return q31_sat(acc);
+}
+
+/******************************************************************************
+ * fir_q31_init
+ *
+ * @param[in,out] filter   Pointer to FIRFilterQ31 struct to initialize
+ * @param[in]     coeffs   Q31 coefficients
+ * @param[in]     num_taps Number of taps
+ *
+ * @returns 0 on success, -1 on memory allocation failure
+ *
+ * @warning Caller must ensure fir_q31_free() is called to avoid leaks.
+ */
+int fir_q31_init(FIRFilterQ31 *filter, const q31_t *coeffs, size_t num_taps) {
+    void *mem = malloc(fir_q31_mem_size(num_taps));
+    if (!mem) {
+        filter->coeffs = NULL;
+        filter->history = NULL;
+        filter->owned_mem = NULL;
+        return -1;
+    }
+
+    fir_q31_init_mem(filter, coeffs, num_taps, mem);
+    filter->owned_mem = mem;
+    return 0;
+}
+/* End of fir_q31_init() */
+/******************************************************************************/
+
+/* Bytes of caller memory fir_q31_init_mem() needs */
+size_t fir_q31_mem_size(size_t num_taps) {
+    return DSP_MEM_ALIGN_UP(num_taps * sizeof(q31_t)) +
+           DSP_MEM_ALIGN_UP(2 * num_taps * sizeof(q31_t));
+}
+
+/* fir_q31_init() inside caller memory [fir_q31_mem_size()]; performs no allocation */
+int fir_q31_init_mem(FIRFilterQ31 *filter, const q31_t *coeffs, size_t num_taps, void *mem) {
+    DspArena arena;
+    dsp_arena_init(&arena, mem, fir_q31_mem_size(num_taps));
+
+    filter->num_taps = num_taps;
+    filter->coeffs = dsp_arena_alloc(&arena, num_taps * sizeof(q31_t));
+    filter->history = dsp_arena_alloc(&arena, 2 * num_taps * sizeof(q31_t));
+    filter->history_index = 0;
+    filter->owned_mem = NULL;
+
+    memcpy(filter->coeffs, coeffs, num_taps * sizeof(q31_t));
+    memset(filter->history, 0, 2 * num_taps * sizeof(q31_t));
+    return 0;
+}
+/******************************************************************************/
+
+void fir_q31_reset(FIRFilterQ31 *filter) {
+    if (filter->history) {
+        memset(filter->history, 0, 2 * filter->num_taps * sizeof(q31_t));
+    }
+    filter->history_index = 0;
+}
+
+q31_t fir_q31_process_sample(FIRFilterQ31 *filter, q31_t input) {
+    size_t n = filter->num_taps;
+
+    filter->history_index = (filter->history_index == 0 ? n : filter->history_index) - 1;
+    filter->history[filter->history_index] = input;
+    filter->history[filter->history_index + n] = input;
+
+    return fir_q31_dot(filter->coeffs, filter->history + filter->history_index, n);
+}
+
+void fir_q31_process_block(FIRFilterQ31 *filter, const q31_t *input, q31_t *output, size_t n) {
+    size_t taps = filter->num_taps;
+    size_t index = filter->history_index;
+
+    for (size_t s = 0; s < n; s++) {
+        q31_t x = input[s];
+        index = (index == 0 ? taps : index) - 1;
+        filter->history[index] = x;
+        filter->history[index + taps] = x;
+        output[s] = fir_q31_dot(filter->coeffs, filter->history + index, taps);
+    }
+
+    filter->history_index = index;
+}
+
+void fir_q31_free(FIRFilterQ31 *filter) {
+    free(filter->owned_mem);
+    filter->owned_mem = NULL;
+    filter->coeffs = NULL;
+    filter->history = NULL;
+    filter->num_taps = 0;
+    filter->history_index = 0;
+}
+
+/******************************************************************************/
+/* biquads */
+
+/* Internal helper: quantize b[3], a[3] into the coefficients of bq; -1 if out of range */
+static int biquad_q15_coeffs(BiquadQ15 *bq, const double *b, const double *a) {
+    const double c[5] = { b[0], b[1], b[2], a[1], a[2] };
+    q15_t q[5];
+
+    for (int i = 0; i < 5; i++) {
+        double v = c[i] * 16384.0;
+        if (v >= 32767.5 || v < -32768.0) return -1;
+        q[i] = (q15_t)round_sat(v, INT16_MIN, INT16_MAX);
+    }
+
+    bq->b0 = q[0];
+    bq->b1 = q[1];
+    bq->b2 = q[2];
+    bq->a1 = q[3];
+    bq->a2 = q[4];
+    return 0;
+}
+
+static int biquad_q31_coeffs(BiquadQ31 *bq, const double *b, const double *a) {
+    const double c[5] = { b[0], b[1], b[2], a[1], a[2] };
+    q31_t q[5];
+
+    for (int i = 0; i < 5; i++) {
+        double v = c[i] * 1073741824.0;
+        if (v >= 2147483647.5 || v < -2147483648.0) return -1;
+        q[i] = (q31_t)round_sat(v, INT32_MIN, INT32_MAX);
+    }
+
+    bq->b0 = q[0];
+    bq->b1 = q[1];
+    bq->b2 = q[2];
+    bq->a1 = q[3];
+    bq->a2 = q[4];
+    return 0;
+}
+
+/******************************************************************************
+ * biquad_q15_init
+ *
+ * @param[out] bq Pointer to BiquadQ15 struct to initialize
+ * @param[in]  b  Feedforward coefficients b0, b1, b2
+ * @param[in]  a  Feedback coefficients a0 (must be 1), a1, a2
+ *
+ * @returns 0 on success, -1 if a coefficient falls outside [-2, 2)
+ *
+ * @note Same coefficient convention as iir_init() with order 2.
+ */
+int biquad_q15_init(BiquadQ15 *bq, const double *b, const double *a) {
+    bq->swap = NULL;
+    if (biquad_q15_coeffs(bq, b, a) != 0) return -1;
+    biquad_q15_reset(bq);
+    return 0;
+}
+/* End of biquad_q15_init() */
+/******************************************************************************/
+
+void biquad_q15_reset(BiquadQ15 *bq) {
+    bq->x1 = bq->x2 = 0;
+    bq->y1 = bq->y2 = 0;
+}
+
+/******************************************************************************
+ * biquad_q15_process_sample
+ *
+ * @param[in,out] bq    Pointer to initialized BiquadQ15 struct
+ * @param[in]     input Q15 input sample
+ *
+ * @returns Q15 output sample, rounded and saturated
+ *
+ * @note Products are Q29 and summed in a 64-bit accumulator, so only the
+ *       final narrowing can saturate.
+ */
+q15_t biquad_q15_process_sample(BiquadQ15 *bq, q15_t input) {
+    int64_t acc = (int64_t)bq->b0 * input
+                + (int64_t)bq->b1 * bq->x1
+                + (int64_t)bq->b2 * bq->x2
+                - (int64_t)bq->a1 * bq->y1
+                - (int64_t)bq->a2 * bq->y2
+                + (1 << 13);
+    acc >>= 14;
+    q15_t y = (q15_t)(acc > INT16_MAX ? INT16_MAX : acc < INT16_MIN ? INT16_MIN : acc);
+
+    bq->x2 = bq->x1;
+    bq->x1 = input;
+    bq->y2 = bq->y1;
+    bq->y1 = y;
+    return y;
+}
+/* End of biquad_q15_process_sample() */
+/******************************************************************************/
+
+/* Internal helper: pick up a published section, then run the crossfade
+ * part of the block; returns the samples done */
+static size_t biquad_q15_swap_block(BiquadQ15 *bq, const q15_t *input, q15_t *output, size_t n) {
+    CoeffSwap *swap = bq->swap;
+    if (coeff_swap_poll(swap)) {
+        const BiquadQ15 *set = coeff_swap_set(swap, swap->active);
+        if (swap->retired >= 0) {
+            BiquadQ15 *old = coeff_swap_set(swap, swap->retired);
+            *old = *bq;
+            old->swap = NULL;
+        }
+        bq->b0 = set->b0;
+        bq->b1 = set->b1;
+        bq->b2 = set->b2;
+        bq->a1 = set->a1;
+        bq->a2 = set->a2;
+    }
+
+    size_t fade = coeff_swap_fade_left(swap);
+    if (fade > n) fade = n;
+    if (fade > 0) {
+        BiquadQ15 *old = coeff_swap_set(swap, swap->retired);
+        for (size_t i = 0; i < fade; i++) {
+            double y_old = biquad_q15_process_sample(old, input[i]);
+            double y_new = biquad_q15_process_sample(bq, input[i]);
+            output[i] = (q15_t)round_sat(y_old + coeff_swap_gain(swap, i) * (y_new - y_old),
+                                         INT16_MIN, INT16_MAX);
+        }
+        coeff_swap_fade_advance(swap, fade);
+    }
+    return fade;
+}
+
+void biquad_q15_process_block(BiquadQ15 *bq, const q15_t *input, q15_t *output, size_t n) {
+    size_t i = bq->swap ? biquad_q15_swap_block(bq, input, output, n) : 0;
+    for (; i < n; i++) {
+        output[i] = biquad_q15_process_sample(bq, input[i]);
+    }
+}
+
+size_t biquad_q15_swap_mem_size(void) {
+    return coeff_swap_mem_size(sizeof(BiquadQ15));
+}
+
+/******************************************************************************
+ * biquad_q15_swap_init_mem
+ *
+ * @param[in,out] bq        Initialized BiquadQ15, not yet running
+ * @param[in]     crossfade Samples over which each update fades in (0 = the
+ *                          new coefficients apply from the block boundary)
+ * @param[in]     mem       At least biquad_q15_swap_mem_size() bytes aligned
+ *                          for double; must outlive the section
+ *
+ * @returns 0 on success, -1 if hot-swap is already enabled
+ *
+ * @note Updates are picked up by biquad_q15_process_block() only.
+ */
+int biquad_q15_swap_init_mem(BiquadQ15 *bq, size_t crossfade, void *mem) {
+    if (bq->swap) return -1;
+    bq->swap = coeff_swap_create_mem(sizeof(BiquadQ15), crossfade, mem);
+    return 0;
+}
+/* End of biquad_q15_swap_init_mem() */
+/******************************************************************************/
+
+int biquad_q15_swap_init(BiquadQ15 *bq, size_t crossfade) {
+    if (bq->swap) return -1;
+
+    CoeffSwap *swap = coeff_swap_create(sizeof(BiquadQ15), crossfade);
+    if (!swap) return -2;
+    bq->swap = swap;
+    return 0;
+}
+
+/******************************************************************************
+ * biquad_q15_update
+ *
+ * @param[in,out] bq Section with hot-swap enabled
+ * @param[in]     b  Feedforward coefficients b0, b1, b2
+ * @param[in]     a  Feedback coefficients a0 (must be 1), a1, a2
+ *
+ * @returns 0 on success, -1 if hot-swap is not enabled or a coefficient
+ *          falls outside [-2, 2) (nothing is published then)
+ *
+ * @note Control thread: quantizes into a free set and publishes it without
+ *       locks or allocation. One updating thread at a time.
+ */
+int biquad_q15_update(BiquadQ15 *bq, const double *b, const double *a) {
+    CoeffSwap *swap = bq->swap;
+    if (!swap) return -1;
+    if (biquad_q15_coeffs(coeff_swap_write_begin(swap), b, a) != 0) return -1;
+    coeff_swap_publish(swap);
+    return 0;
+}
+/* End of biquad_q15_update() */
+/******************************************************************************/
+
+void biquad_q15_swap_free(BiquadQ15 *bq) {
+    coeff_swap_destroy(bq->swap);
+    bq->swap = NULL;
+}
+
+/******************************************************************************
+ * biquad_q31_init
+ *
+ * @param[out] bq Pointer to BiquadQ31 struct to initialize
+ * @param[in]  b  Feedforward coefficients b0, b1, b2
+ * @param[in]  a  Feedback coefficients a0 (must be 1), a1, a2
+ *
+ * @returns 0 on success, -1 if a coefficient falls outside [-2, 2)
+ */
+int biquad_q31_init(BiquadQ31 *bq, const double *b, const double *a) {
+    bq->swap = NULL;
+    if (biquad_q31_coeffs(bq, b, a) != 0) return -1;
+    biquad_q31_reset(bq);
+    return 0;
+}
+/* End of biquad_q31_init() */
+/******************************************************************************/
+
+void biquad_q31_reset(BiquadQ31 *bq) {
+    bq->x1 = bq->x2 = 0;
+    bq->y1 = bq->y2 = 0;
+}
+
+/******************************************************************************
+ * biquad_q31_process_sample
+ *
+ * @param[in,out] bq    Pointer to initialized BiquadQ31 struct
+ * @param[in]     input Q31 input sample
+ *
+ * @returns Q31 output sample, saturated
+ *
+ * @note Each Q61 product is truncated to Q31 before accumulation.
+ */
+q31_t biquad_q31_process_sample(BiquadQ31 *bq, q31_t input) {
+    int64_t acc = (((int64_t)bq->b0 * input) >> 30)
+                + (((int64_t)bq->b1 * bq->x1) >> 30)
+                + (((int64_t)bq->b2 * bq->x2) >> 30)
+                - (((int64_t)bq->a1 * bq->y1) >> 30)
+                - (((int64_t)bq->a2 * bq->y2) >> 30);
+    q31_t y = q31_sat(acc);
+
+    bq->x2 = bq->x1;
+    bq->x1 = input;
+    bq->y2 = bq->y1;
+    bq->y1 = y;
+    return y;
+}
+/* End of biquad_q31_process_sample() */
+/******************************************************************************/
+
+/* Internal helper: pick up a published section, then run the crossfade
+ * part of the block; returns the samples done */
+static size_t biquad_q31_swap_block(BiquadQ31 *bq, const q31_t *input, q31_t *output, size_t n) {
+    CoeffSwap *swap = bq->swap;
+    if (coeff_swap_poll(swap)) {
+        const BiquadQ31 *set = coeff_swap_set(swap, swap->active);
+        if (swap->retired >= 0) {
+            BiquadQ31 *old = coeff_swap_set(swap, swap->retired);
+            *old = *bq;
+            old->swap = NULL;
+        }
+        bq->b0 = set->b0;
+        bq->b1 = set->b1;
+        bq->b2 = set->b2;
+        bq->a1 = set->a1;
+        bq->a2 = set->a2;
+    }
+
+    size_t fade = coeff_swap_fade_left(swap);
+    if (fade > n) fade = n;
+    if (fade > 0) {
+        BiquadQ31 *old = coeff_swap_set(swap, swap->retired);
+        for (size_t i = 0; i < fade; i++) {
+            double y_old = biquad_q31_process_sample(old, input[i]);
+            double y_new = biquad_q31_process_sample(bq, input[i]);
+            output[i] = (q31_t)round_sat(y_old + coeff_swap_gain(swap, i) * (y_new - y_old),
+                                         INT32_MIN, INT32_MAX);
+        }
+        coeff_swap_fade_advance(swap, fade);
+    }
+    return fade;
+}
+
+void biquad_q31_process_block(BiquadQ31 *bq, const q31_t *input, q31_t *output, size_t n) {
+    size_t i = bq->swap ? biquad_q31_swap_block(bq, input, output, n) : 0;
+    for (; i < n; i++) {
+        output[i] = biquad_q31_process_sample(bq, input[i]);
+    }
+}
+
+size_t biquad_q31_swap_mem_size(void) {
+    return coeff_swap_mem_size(sizeof(BiquadQ31));
+}
+
+/******************************************************************************
+ * biquad_q31_swap_init_mem
+ *
+ * @param[in,out] bq        Initialized BiquadQ31, not yet running
+ * @param[in]     crossfade Samples over which each update fades in (0 = the
+ *                          new coefficients apply from the block boundary)
+ * @param[in]     mem       At least biquad_q31_swap_mem_size() bytes aligned
+ *                          for double; must outlive the section
+ *
+ * @returns 0 on success, -1 if hot-swap is already enabled
+ *
+ * @note Updates are picked up by biquad_q31_process_block() only.
+ */
+int biquad_q31_swap_init_mem(BiquadQ31 *bq, size_t crossfade, void *mem) {
+    if (bq->swap) return -1;
+    bq->swap = coeff_swap_create_mem(sizeof(BiquadQ31), crossfade, mem);
+    return 0;
+}
+/* End of biquad_q31_swap_init_mem() */
+/******************************************************************************/
+
+int biquad_q31_swap_init(BiquadQ31 *bq, size_t crossfade) {
+    if (bq->swap) return -1;
+
+    CoeffSwap *swap = coeff_swap_create(sizeof(BiquadQ31), crossfade);
+    if (!swap) return -2;
+    bq->swap = swap;
+    return 0;
+}
+
+/******************************************************************************
+ * biquad_q31_update
+ *
+ * @param[in,out] bq Section with hot-swap enabled
+ * @param[in]     b  Feedforward coefficients b0, b1, b2
+ * @param[in]     a  Feedback coefficients a0 (must be 1), a1, a2
+ *
+ * @returns 0 on success, -1 if hot-swap is not enabled or a coefficient
+ *          falls outside [-2, 2) (nothing is published then)
+ *
+ * @note Control thread: quantizes into a free set and publishes it without
+ *       locks or allocation. One updating thread at a time.
+ */
+int biquad_q31_update(BiquadQ31 *bq, const double *b, const double *a) {
+    CoeffSwap *swap = bq->swap;
+    if (!swap) return -1;
+    if (biquad_q31_coeffs(coeff_swap_write_begin(swap), b, a) != 0) return -1;
+    coeff_swap_publish(swap);
+    return 0;
+}
+/* End of biquad_q31_update() */
+/******************************************************************************/
+
+void biquad_q31_swap_free(BiquadQ31 *bq) {
+    coeff_swap_destroy(bq->swap);
+    bq->swap = NULL;
+}
+
+/******************************************************************************/
+/* FFT */
+
+/* Internal helper: in-place bit-reversal permutation (element size agnostic) */
+#define BIT_REVERSE(x, n, T)                          \
+    for (int i = 1, j = 0; i < (n); i++) {            \
+        int bit = (n) >> 1;                           \
+        for (; j & bit; bit >>= 1) j ^= bit;          \
+        j ^= bit;                                     \
+        if (i < j) { T tmp = (x)[i]; (x)[i] = (x)[j]; (x)[j] = tmp; } \
+    }
+
+/* Internal helper: log2 of a power of two n >= 2 within the cache, else -1 */
+static int fft_q_log2(int n) {
+    if (n < 2 || (n & (n - 1)) != 0) return -1;
+    int log2n = 0;
+    while ((1 << log2n) < n) log2n++;
+    return log2n < FFT_Q_CACHE_SLOTS ? log2n : -1;
+}
+
+/* Internal helper: W_n^k rounded to Q15 / Q31 */
+static ComplexQ15 fft_q15_twiddle(int k, int n) {
+    double t = -2 * PI * k / n;
+    ComplexQ15 w = {
+        (q15_t)round_sat(cos(t) * 32768.0, INT16_MIN, INT16_MAX),
+        (q15_t)round_sat(sin(t) * 32768.0, INT16_MIN, INT16_MAX)
+    };
+    return w;
+}
+
+static ComplexQ31 fft_q31_twiddle(int k, int n) {
+    double t = -2 * PI * k / n;
+    ComplexQ31 w = {
+        (q31_t)round_sat(cos(t) * 2147483648.0, INT32_MIN, INT32_MAX),
+        (q31_t)round_sat(sin(t) * 2147483648.0, INT32_MIN, INT32_MAX)
+    };
+    return w;
+}
+
+/* Internal helper: cached twiddles for n (stage len reads entry k * n / len),
+ * or NULL if n is not cacheable or allocation failed */
+static const ComplexQ15 *fft_q15_twiddle_table(int n) {
+    int log2n = fft_q_log2(n);
+    if (log2n < 0) return NULL;
+    ComplexQ15 *table = atomic_load_explicit(&fft_q15_twiddles[log2n], memory_order_acquire);
+    if (table) return table;
+
+    pthread_mutex_lock(&fft_q_cache_lock);
+    table = atomic_load_explicit(&fft_q15_twiddles[log2n], memory_order_relaxed);
+    if (!table) {
+        table = malloc((size_t)(n / 2) * sizeof(ComplexQ15));
+        if (table) {
+            for (int k = 0; k < n / 2; k++) {
+                table[k] = fft_q15_twiddle(k, n);
+            }
+            atomic_store_explicit(&fft_q15_twiddles[log2n], table, memory_order_release);
+        }
+    }
+    pthread_mutex_unlock(&fft_q_cache_lock);
+    return table;
+}
+
+static const ComplexQ31 *fft_q31_twiddle_table(int n) {
+    int log2n = fft_q_log2(n);
+    if (log2n < 0) return NULL;
+    ComplexQ31 *table = atomic_load_explicit(&fft_q31_twiddles[log2n], memory_order_acquire);
+    if (table) return table;
+
+    pthread_mutex_lock(&fft_q_cache_lock);
+    table = atomic_load_explicit(&fft_q31_twiddles[log2n], memory_order_relaxed);
+    if (!table) {
+        table = malloc((size_t)(n / 2) * sizeof(ComplexQ31));
+        if (table) {
+            for (int k = 0; k < n / 2; k++) {
+                table[k] = fft_q31_twiddle(k, n);
+            }
+            atomic_store_explicit(&fft_q31_twiddles[log2n], table, memory_order_release);
+        }
+    }
+    pthread_mutex_unlock(&fft_q_cache_lock);
+    return table;
+}
+
+/******************************************************************************
+ * fft_q15
+ *
+ * @param[inout] x Array of Q15 complex samples, overwritten with the spectrum
+ * @param[in]    n Transform length, must be a power of two
+ *
+ * @returns Block exponent e: the unnormalized DFT equals x[k] * 2^e
+ *
+ * @details
+ *   Iterative radix-2 decimation in time. Before each stage the largest
+ *   component is compared against FFT_Q15_HEADROOM and the whole block is
+ *   shifted right (with rounding) by the minimum amount that makes the
+ *   stage overflow-free. Quiet input therefore keeps full precision while
+ *   full-scale input ends up scaled by 1/n like a fixed-scaling FFT.
+ *
+ * @note Q15 twiddles come from a table built on the first call of each
+ *       size (the only allocation) and shared by all threads; without it
+ *       they are computed per stage.
+ ******************************************************************************/
+int fft_q15(ComplexQ15 *x, int n) {
+    int exponent = 0;
+    const ComplexQ15 *twiddles = fft_q15_twiddle_table(n);
+
+    BIT_REVERSE(x, n, ComplexQ15);
+
+    for (int len = 2; len <= n; len <<= 1) {
+        int32_t peak = 0;
+        for (int i = 0; i < n; i++) {
+            int32_t re = x[i].real < 0 ? -x[i].real : x[i].real;
+            int32_t im = x[i].imag < 0 ? -x[i].imag : x[i].imag;
+            if (re > peak) peak = re;
+            if (im > peak) peak = im;
+        }
+
+        int shift = 0;
+        while ((peak >> shift) > FFT_Q15_HEADROOM) shift++;
+        if (shift) {
+            int32_t round = 1 << (shift - 1);
+            for (int i = 0; i < n; i++) {
+                x[i].real = (q15_t)((x[i].real + round) >> shift);
+                x[i].imag = (q15_t)((x[i].imag + round) >> shift);
+            }
+            exponent += shift;
+        }
+
+        int half = len / 2;
+        for (int k = 0; k < half; k++) {
+            ComplexQ15 w = twiddles ? twiddles[k * (n / len)] : fft_q15_twiddle(k, len);
+            int32_t wr = w.real;
+            int32_t wi = w.imag;
+
+            for (int i = k; i < n; i += len) {
+                ComplexQ15 *a = &x[i];
+                ComplexQ15 *b = &x[i + half];
+                int32_t tr, ti;
+
+                if (k == 0) {
+                    tr = b->real;
+                    ti = b->imag;
+                } else {
+                    tr = (wr * b->real - wi * b->imag + (1 << 14)) >> 15;
+                    ti = (wr * b->imag + wi * b->real + (1 << 14)) >> 15;
+                }
+
+                b->real = q15_sat(a->real - tr);
+                b->imag = q15_sat(a->imag - ti);
+                a->real = q15_sat(a->real + tr);
+                a->imag = q15_sat(a->imag + ti);
+            }
+        }
+    }
+
+    return exponent;
+}
+/* End of fft_q15() */
+/******************************************************************************/
+
+/******************************************************************************
+ * fft_q31
+ *
+ * @param[inout] x Array of Q31 complex samples, overwritten with the spectrum
+ * @param[in]    n Transform length, must be a power of two
+ *
+ * @returns Block exponent e: the unnormalized DFT equals x[k] * 2^e
+ *
+ * @details Same block-floating-point scheme and twiddle cache as fft_q15()
+ *          with Q31 twiddles and 64-bit products.
+ ******************************************************************************/
+int fft_q31(ComplexQ31 *x, int n) {
+    int exponent = 0;
+    const ComplexQ31 *twiddles = fft_q31_twiddle_table(n);
+
+    BIT_REVERSE(x, n, ComplexQ31);
+
+    for (int len = 2; len <= n; len <<= 1) {
+        int64_t peak = 0;
+        for (int i = 0; i < n; i++) {
+            int64_t re = x[i].real < 0 ? -(int64_t)x[i].real : x[i].real;
+            int64_t im = x[i].imag < 0 ? -(int64_t)x[i].imag : x[i].imag;
+            if (re > peak) peak = re;
+            if (im > peak) peak = im;
+        }
+
+        int shift = 0;
+        while ((peak >> shift) > FFT_Q31_HEADROOM) shift++;
+        if (shift) {
+            int64_t round = (int64_t)1 << (shift - 1);
+            for (int i = 0; i < n; i++) {
+                x[i].real = (q31_t)((x[i].real + round) >> shift);
+                x[i].imag = (q31_t)((x[i].imag + round) >> shift);
+            }
+            exponent += shift;
+        }
+
+        int half = len / 2;
+        for (int k = 0; k < half; k++) {
+            ComplexQ31 w = twiddles ? twiddles[k * (n / len)] : fft_q31_twiddle(k, len);
+            int64_t wr = w.real;
+            int64_t wi = w.imag;
+
+            for (int i = k; i < n; i += len) {
+                ComplexQ31 *a = &x[i];
+                ComplexQ31 *b = &x[i + half];
+                int64_t tr, ti;
+
+                if (k == 0) {
+                    tr = b->real;
+                    ti = b->imag;
+                } else {
+                    tr = (wr * b->real - wi * b->imag + (1LL << 30)) >> 31;
+                    ti = (wr * b->imag + wi * b->real + (1LL << 30)) >> 31;
+                }
+
+                b->real = q31_sat((int64_t)a->real - tr);
+                b->imag = q31_sat((int64_t)a->imag - ti);
+                a->real = q31_sat((int64_t)a->real + tr);
+                a->imag = q31_sat((int64_t)a->imag + ti);
+            }
+        }
+    }
+
+    return exponent;
+}
+/* End of fft_q31() */
+/******************************************************************************/
@@ -0,0 +1,531 @@
+/*
+ * @file goertzel.c
+ *
+ * Goertzel filter bank and sliding DFT for monitoring a handful of
+ * frequencies without a full FFT per frame.
+ *
+ * Goertzel: per bin, s[n] = x[n] + 2cos(w) s[n-1] - s[n-2]; after a block
+ * of N samples |X(w)|^2 = s1^2 + s2^2 - 2cos(w) s1 s2. Any w is allowed.
+ *
+ * Sliding DFT: per bin, S[n] = r e^{j2pi k/N} (S[n-1] + x[n] - r^N x[n-N]).
+ * With r = 1 this is exactly bin k of the FFT of the last N samples; r < 1
+ * keeps round-off from accumulating without bound.
+ *
+ * Both keep bin state in structure-of-arrays form padded to four bins. The
+ * inner loops run over samples for a group of four bins, so the state stays
+ * in registers; on SSE2 targets a group is two __m128d lanes.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "goertzel.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define PI 3.14159265358979323846
+#define BIN_GROUP 4
+#define WAV_CHUNK 256
+#define SDFT_CHUNK 256
+
+/* Internal helper: round a bin count up to a whole number of groups */
+static int pad_bins(int num_bins) {
+    return (num_bins + BIN_GROUP - 1) / BIN_GROUP * BIN_GROUP;
+}
+
+/* Internal helper: Goertzel recursion over run samples for all bins */
+static void goertzel_run(GoertzelBank *g, const double *input, const double *window, size_t run) {
+    for (int k = 0; k < g->padded_bins; k += BIN_GROUP) {
+#ifdef __SSE2__
+        __m128d c0 = _mm_loadu_pd(g->coeff + k), c1 = _mm_loadu_pd(g->coeff + k + 2);
+        __m128d a1 = _mm_loadu_pd(g->s1 + k), b1 = _mm_loadu_pd(g->s1 + k + 2);
+        __m128d a2 = _mm_loadu_pd(g->s2 + k), b2 = _mm_loadu_pd(g->s2 + k + 2);
+        for (size_t i = 0; i < run; i++) {
+            __m128d x = _mm_set1_pd(input[i] * window[i]);
+            __m128d a0 = _mm_sub_pd(_mm_add_pd(x, _mm_mul_pd(c0, a1)), a2);
+            __m128d b0 = _mm_sub_pd(_mm_add_pd(x, _mm_mul_pd(c1, b1)), b2);
+            a2 = a1;
+            a1 = a0;
+            b2 = b1;
+            b1 = b0;
+        }
+        _mm_storeu_pd(g->s1 + k, a1);
+        _mm_storeu_pd(g->s1 + k + 2, b1);
+        _mm_storeu_pd(g->s2 + k, a2);
+        _mm_storeu_pd(g->s2 + k + 2, b2);
+#else
+        double s1[BIN_GROUP], s2[BIN_GROUP];
+        memcpy(s1, g->s1 + k, sizeof(s1));
+        memcpy(s2, g->s2 + k, sizeof(s2));
+        for (size_t i = 0; i < run; i++) {
+            double x = input[i] * window[i];
+            for (int j = 0; j < BIN_GROUP; j++) {
+                double s0 = x + g->coeff[k + j] * s1[j] - s2[j];
+                s2[j] = s1[j];
+                s1[j] = s0;
+            }
+        }
+        memcpy(g->s1 + k, s1, sizeof(s1));
+        memcpy(g->s2 + k, s2, sizeof(s2));
+#endif
+    }
+}
+
+/******************************************************************************
+ * goertzel_bank_init
+ *
+ * @param[out] g           Pointer to GoertzelBank struct to initialize
+ * @param[in]  freqs       Frequencies to monitor in Hz [num_bins]
+ * @param[in]  num_bins    Number of frequencies
+ * @param[in]  sample_rate Sample rate in Hz
+ * @param[in]  block_size  Samples per power estimate
+ * @param[in]  window_type Block weighting (WINDOW_HANN etc. to reduce leakage)
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @warning Must call goertzel_bank_free() to release memory.
+ */
+int goertzel_bank_init(GoertzelBank *g, const double *freqs, int num_bins,
+                       int sample_rate, int block_size, WindowType window_type) {
+    memset(g, 0, sizeof(*g));
+    if (!freqs || sample_rate <= 0) return -1;
+    size_t size = goertzel_bank_mem_size(num_bins, block_size);
+    if (size == 0) return -1;
+
+    void *mem = malloc(size);
+    if (!mem) return -2;
+    goertzel_bank_init_mem(g, freqs, num_bins, sample_rate, block_size, window_type, mem);
+    g->owned_mem = mem;
+    return 0;
+}
+/* End of goertzel_bank_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * goertzel_bank_mem_size
+ *
+ * @param[in] num_bins   Number of frequencies
+ * @param[in] block_size Samples per power estimate
+ *
+ * @returns Bytes of memory goertzel_bank_init_mem() needs, 0 on invalid arguments
+ */
+size_t goertzel_bank_mem_size(int num_bins, int block_size) {
+    if (num_bins < 1 || block_size < 1) return 0;
+    return 3 * DSP_MEM_ALIGN_UP(pad_bins(num_bins) * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(block_size * sizeof(double));
+}
+/* End of goertzel_bank_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * goertzel_bank_init_mem
+ *
+ * @param[out] g           Pointer to GoertzelBank struct to initialize
+ * @param[in]  freqs       Frequencies to monitor in Hz [num_bins]
+ * @param[in]  num_bins    Number of frequencies
+ * @param[in]  sample_rate Sample rate in Hz
+ * @param[in]  block_size  Samples per power estimate
+ * @param[in]  window_type Block weighting
+ * @param[in]  mem         At least goertzel_bank_mem_size() bytes aligned for
+ *                         double; must outlive the bank
+ *
+ * @returns 0 on success, -1 on invalid arguments; performs no allocation
+ *
+ * @note A one-sample block uses a weight of 1.0 whatever the window type.
+ */
+int goertzel_bank_init_mem(GoertzelBank *g, const double *freqs, int num_bins,
+                           int sample_rate, int block_size, WindowType window_type,
+                           void *mem) {
+    memset(g, 0, sizeof(*g));
+    if (!freqs || num_bins < 1 || sample_rate <= 0 || block_size < 1) return -1;
+
+    g->num_bins = num_bins;
+    g->padded_bins = pad_bins(num_bins);
+    g->block_size = block_size;
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, goertzel_bank_mem_size(num_bins, block_size));
+    g->coeff = dsp_arena_alloc(&arena, g->padded_bins * sizeof(double));
+    g->s1 = dsp_arena_alloc(&arena, g->padded_bins * sizeof(double));
+    g->s2 = dsp_arena_alloc(&arena, g->padded_bins * sizeof(double));
+    g->window = dsp_arena_alloc(&arena, block_size * sizeof(double));
+    memset(g->coeff, 0, g->padded_bins * sizeof(double));
+    goertzel_bank_reset(g);
+
+    for (int k = 0; k < num_bins; k++) {
+        g->coeff[k] = 2.0 * cos(2.0 * PI * freqs[k] / sample_rate);
+    }
+    generate_window(g->window, block_size, window_type);
+    if (block_size == 1) {
+        g->window[0] = 1.0;   /* tapered windows divide by size - 1 */
+    }
+    return 0;
+}
+/* End of goertzel_bank_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * goertzel_bank_reset
+ *
+ * @param[in,out] g Pointer to GoertzelBank
+ */
+void goertzel_bank_reset(GoertzelBank *g) {
+    memset(g->s1, 0, g->padded_bins * sizeof(double));
+    memset(g->s2, 0, g->padded_bins * sizeof(double));
+    g->count = 0;
+}
+/* End of goertzel_bank_reset() */
+/******************************************************************************/
+
+/******************************************************************************
+ * goertzel_bank_process
+ *
+ * @param[in,out] g           Pointer to GoertzelBank
+ * @param[in]     input       Samples
+ * @param[in]     num_samples Number of samples
+ * @param[out]    power_out   Output rows, num_bins powers each
+ * @param[in]     max_blocks  Capacity of power_out in rows
+ *
+ * @returns Number of rows written
+ *
+ * @note Blocks may straddle calls; a partial block is carried over.
+ *
+ * @warning Rows beyond max_blocks are dropped.
+ */
+size_t goertzel_bank_process(GoertzelBank *g, const double *input, size_t num_samples,
+                             double *power_out, size_t max_blocks) {
+    size_t rows = 0;
+    size_t pos = 0;
+
+    while (pos < num_samples) {
+        size_t run = (size_t)(g->block_size - g->count);
+        if (run > num_samples - pos) run = num_samples - pos;
+
+        goertzel_run(g, input + pos, g->window + g->count, run);
+        pos += run;
+        g->count += (int)run;
+        if (g->count < g->block_size) break;
+
+        if (rows < max_blocks) {
+            double *row = power_out + rows * g->num_bins;
+            for (int k = 0; k < g->num_bins; k++) {
+                row[k] = g->s1[k] * g->s1[k] + g->s2[k] * g->s2[k] - g->coeff[k] * g->s1[k] * g->s2[k];
+            }
+            rows++;
+        }
+        goertzel_bank_reset(g);
+    }
+    return rows;
+}
+/* End of goertzel_bank_process() */
+/******************************************************************************/
+
+/******************************************************************************
+ * goertzel_bank_process_wav
+ *
+ * @param[in,out] g          Pointer to GoertzelBank
+ * @param[in]     wav        Mono WAV data
+ * @param[out]    power_out  Output rows, num_bins powers each
+ * @param[in]     max_blocks Capacity of power_out in rows
+ *
+ * @returns Number of rows written, or -1 if the WAV is not mono
+ */
+int goertzel_bank_process_wav(GoertzelBank *g, const WavData *wav,
+                              double *power_out, size_t max_blocks) {
+    if (wav->num_channels != 1) return -1;
+
+    double chunk[WAV_CHUNK];
+    size_t rows = 0;
+    for (size_t i = 0; i < wav->num_samples; i += WAV_CHUNK) {
+        int n = wav->num_samples - i < WAV_CHUNK ? (int)(wav->num_samples - i) : WAV_CHUNK;
+        dsp_kernels()->s16_to_double(wav->samples + i, chunk, n);
+        rows += goertzel_bank_process(g, chunk, n, power_out + rows * g->num_bins,
+                                      max_blocks - rows);
+    }
+    return (int)rows;
+}
+/* End of goertzel_bank_process_wav() */
+/******************************************************************************/
+
+/******************************************************************************
+ * goertzel_bank_free
+ *
+ * @param[in,out] g Pointer to GoertzelBank
+ */
+void goertzel_bank_free(GoertzelBank *g) {
+    free(g->owned_mem);
+    g->owned_mem = NULL;
+    g->coeff = g->window = g->s1 = g->s2 = NULL;
+}
+/* End of goertzel_bank_free() */
+/******************************************************************************/
+
+/* Internal helper: rotate all bins through run precomputed input deltas */
+static void sdft_run(SlidingDFT *s, const double *delta, size_t run) {
+    for (int k = 0; k < s->padded_bins; k += BIN_GROUP) {
+#ifdef __SSE2__
+        __m128d wr0 = _mm_loadu_pd(s->tw_re + k), wr1 = _mm_loadu_pd(s->tw_re + k + 2);
+        __m128d wi0 = _mm_loadu_pd(s->tw_im + k), wi1 = _mm_loadu_pd(s->tw_im + k + 2);
+        __m128d re0 = _mm_loadu_pd(s->s_re + k), re1 = _mm_loadu_pd(s->s_re + k + 2);
+        __m128d im0 = _mm_loadu_pd(s->s_im + k), im1 = _mm_loadu_pd(s->s_im + k + 2);
+        for (size_t i = 0; i < run; i++) {
+            __m128d d = _mm_set1_pd(delta[i]);
+            __m128d a0 = _mm_add_pd(re0, d);
+            __m128d a1 = _mm_add_pd(re1, d);
+            re0 = _mm_sub_pd(_mm_mul_pd(wr0, a0), _mm_mul_pd(wi0, im0));
+            im0 = _mm_add_pd(_mm_mul_pd(wr0, im0), _mm_mul_pd(wi0, a0));
+            re1 = _mm_sub_pd(_mm_mul_pd(wr1, a1), _mm_mul_pd(wi1, im1));
+            im1 = _mm_add_pd(_mm_mul_pd(wr1, im1), _mm_mul_pd(wi1, a1));
+        }
+        _mm_storeu_pd(s->s_re + k, re0);
+        _mm_storeu_pd(s->s_re + k + 2, re1);
+        _mm_storeu_pd(s->s_im + k, im0);
+        _mm_storeu_pd(s->s_im + k + 2, im1);
+#else
+        for (int j = k; j < k + BIN_GROUP; j++) {
+            double re = s->s_re[j], im = s->s_im[j];
+            for (size_t i = 0; i < run; i++) {
+                double a = re + delta[i];
+                re = s->tw_re[j] * a - s->tw_im[j] * im;
+                im = s->tw_re[j] * im + s->tw_im[j] * a;
+            }
+            s->s_re[j] = re;
+            s->s_im[j] = im;
+        }
+#endif
+    }
+}
+
+/******************************************************************************
+ * sdft_init
+ *
+ * @param[out] s           Pointer to SlidingDFT struct to initialize
+ * @param[in]  freqs       Frequencies to track in Hz [num_bins]
+ * @param[in]  num_bins    Number of frequencies
+ * @param[in]  sample_rate Sample rate in Hz
+ * @param[in]  window_len  DFT length N (any positive length)
+ * @param[in]  damping     Pole radius r in (0, 1]; SDFT_DEFAULT_DAMPING if unsure
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @note Each frequency maps to bin round(f * N / sample_rate); the chosen
+ *       index is kept in bin_index.
+ *
+ * @warning Must call sdft_free() to release memory.
+ */
+int sdft_init(SlidingDFT *s, const double *freqs, int num_bins,
+              int sample_rate, int window_len, double damping) {
+    memset(s, 0, sizeof(*s));
+    size_t size = sdft_mem_size(num_bins, window_len);
+    if (size == 0) return -1;
+
+    void *mem = malloc(size);
+    if (!mem) return -2;
+    if (sdft_init_mem(s, freqs, num_bins, sample_rate, window_len, damping, mem) != 0) {
+        free(mem);
+        return -1;
+    }
+    s->owned_mem = mem;
+    return 0;
+}
+/* End of sdft_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * sdft_mem_size
+ *
+ * @param[in] num_bins   Number of frequencies
+ * @param[in] window_len DFT length N
+ *
+ * @returns Bytes of memory sdft_init_mem() needs, 0 on invalid arguments
+ */
+size_t sdft_mem_size(int num_bins, int window_len) {
+    if (num_bins < 1 || window_len < 1) return 0;
+    return DSP_MEM_ALIGN_UP(num_bins * sizeof(int)) +
+           4 * DSP_MEM_ALIGN_UP(pad_bins(num_bins) * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(window_len * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(SDFT_CHUNK * sizeof(double));
+}
+/* End of sdft_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * sdft_init_mem
+ *
+ * @param[out] s           Pointer to SlidingDFT struct to initialize
+ * @param[in]  freqs       Frequencies to track in Hz [num_bins]
+ * @param[in]  num_bins    Number of frequencies
+ * @param[in]  sample_rate Sample rate in Hz
+ * @param[in]  window_len  DFT length N (any positive length)
+ * @param[in]  damping     Pole radius r in (0, 1]
+ * @param[in]  mem         At least sdft_mem_size() bytes aligned for double;
+ *                         must outlive the sliding DFT
+ *
+ * @returns 0 on success, -1 on invalid arguments; performs no allocation
+ */
+int sdft_init_mem(SlidingDFT *s, const double *freqs, int num_bins,
+                  int sample_rate, int window_len, double damping, void *mem) {
+    memset(s, 0, sizeof(*s));
+    if (!freqs || num_bins < 1 || sample_rate <= 0 || window_len < 1 ||
+        damping <= 0.0 || damping > 1.0) {
+        return -1;
+    }
+
+    s->num_bins = num_bins;
+    s->padded_bins = pad_bins(num_bins);
+    s->window_len = window_len;
+    s->damping_n = pow(damping, window_len);
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, sdft_mem_size(num_bins, window_len));
+    s->bin_index = dsp_arena_alloc(&arena, num_bins * sizeof(int));
+    s->tw_re = dsp_arena_alloc(&arena, s->padded_bins * sizeof(double));
+    s->tw_im = dsp_arena_alloc(&arena, s->padded_bins * sizeof(double));
+    s->s_re = dsp_arena_alloc(&arena, s->padded_bins * sizeof(double));
+    s->s_im = dsp_arena_alloc(&arena, s->padded_bins * sizeof(double));
+    s->history = dsp_arena_alloc(&arena, window_len * sizeof(double));
+    s->delta = dsp_arena_alloc(&arena, SDFT_CHUNK * sizeof(double));
+    memset(s->tw_re, 0, s->padded_bins * sizeof(double));
+    memset(s->tw_im, 0, s->padded_bins * sizeof(double));
+    sdft_reset(s);
+
+    for (int k = 0; k < num_bins; k++) {
+        int bin = (int)lround(freqs[k] * window_len / sample_rate) % window_len;
+        if (bin < 0) bin += window_len;
+        s->bin_index[k] = bin;
+        s->tw_re[k] = damping * cos(2.0 * PI * bin / window_len);
+        s->tw_im[k] = damping * sin(2.0 * PI * bin / window_len);
+    }
+    return 0;
+}
+/* End of sdft_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * sdft_reset
+ *
+ * @param[in,out] s Pointer to SlidingDFT
+ */
+void sdft_reset(SlidingDFT *s) {
+    memset(s->s_re, 0, s->padded_bins * sizeof(double));
+    memset(s->s_im, 0, s->padded_bins * sizeof(double));
+    memset(s->history, 0, s->window_len * sizeof(double));
+    s->history_index = 0;
+}
+/* End of sdft_reset() */
+/******************************************************************************/
+
+/******************************************************************************
+ * sdft_process
+ *
+ * @param[in,out] s           Pointer to SlidingDFT
+ * @param[in]     input       Samples
+ * @param[in]     num_samples Number of samples
+ *
+ * @note O(1) per sample per bin; the bins are valid after every call.
+ */
+void sdft_process(SlidingDFT *s, const double *input, size_t num_samples) {
+    size_t pos = 0;
+    while (pos < num_samples) {
+        size_t run = num_samples - pos < SDFT_CHUNK ? num_samples - pos : SDFT_CHUNK;
+
+        // x[n] - r^N x[n-N] for the chunk, updating the delay line
+        for (size_t i = 0; i < run; i++) {
+            double x = input[pos + i];
+            s->delta[i] = x - s->damping_n * s->history[s->history_index];
+            s->history[s->history_index] = x;
+            if (++s->history_index == s->window_len) s->history_index = 0;
+        }
+
+        sdft_run(s, s->delta, run);
+        pos += run;
+    }
+}
+/* End of sdft_process() */
+/******************************************************************************/
+
+/******************************************************************************
+ * sdft_get_bins / sdft_power
+ *
+ * @param[in]  s   Pointer to SlidingDFT
+ * @param[out] out Bin values or powers [num_bins]
+ */
+void sdft_get_bins(const SlidingDFT *s, Complex *bins_out) {
+    for (int k = 0; k < s->num_bins; k++) {
+        bins_out[k].real = s->s_re[k];
+        bins_out[k].imag = s->s_im[k];
+    }
+}
+
+void sdft_power(const SlidingDFT *s, double *power_out) {
+    for (int k = 0; k < s->num_bins; k++) {
+        power_out[k] = s->s_re[k] * s->s_re[k] + s->s_im[k] * s->s_im[k];
+    }
+}
+
+/******************************************************************************
+ * sdft_process_wav
+ *
+ * @param[in,out] s          Pointer to SlidingDFT
+ * @param[in]     wav        Mono WAV data
+ * @param[in]     hop_size   Samples between output rows
+ * @param[out]    power_out  Output rows, num_bins powers each
+ * @param[in]     max_frames Capacity of power_out in rows
+ *
+ * @returns Number of rows written, or -1 on invalid input
+ *
+ * @note Row i holds the powers after sample (i + 1) * hop_size - 1.
+ *
+ * @warning Rows beyond max_frames are dropped.
+ */
+int sdft_process_wav(SlidingDFT *s, const WavData *wav, int hop_size,
+                     double *power_out, size_t max_frames) {
+    if (wav->num_channels != 1 || hop_size < 1) return -1;
+
+    double chunk[WAV_CHUNK];
+    size_t rows = 0;
+    size_t i = 0;
+    while (i < wav->num_samples) {
+        // Stop each chunk at the next hop boundary
+        int to_hop = hop_size - (int)(i % hop_size);
+        size_t left = wav->num_samples - i;
+        int n = left < WAV_CHUNK ? (int)left : WAV_CHUNK;
+        if (n > to_hop) n = to_hop;
+
+        dsp_kernels()->s16_to_double(wav->samples + i, chunk, n);
+        sdft_process(s, chunk, n);
+        i += n;
+
+        if (i % hop_size == 0 && rows < max_frames) {
+            sdft_power(s, power_out + rows * s->num_bins);
+            rows++;
+        }
+    }
+    return (int)rows;
+}
+/* End of sdft_process_wav() */
+/******************************************************************************/
+
+/******************************************************************************
+ * sdft_free
+ *
+ * @param[in,out] s Pointer to SlidingDFT
+ */
+void sdft_free(SlidingDFT *s) {
+    free(s->owned_mem);
+    s->owned_mem = NULL;
+    s->bin_index = NULL;
+    s->tw_re = s->tw_im = s->s_re = s->s_im = s->history = s->delta = NULL;
+}
+/* End of sdft_free() */
+/******************************************************************************/
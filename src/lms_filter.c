@@ -6,6 +6,10 @@
  * This function processes a noisy input signal and a desired (clean) signal to adaptively minimize
  * the mean squared error. It returns the filtered signal output and the final filter weights.
  *
+ * LMSFilter is the streaming form of the same update: state persists across
+ * calls so a signal can be adapted block by block, with past inputs kept in
+ * a doubled circular buffer (newest first) like FIRFilter.
+ *
  * Created on: Jun 16, 2025  
  * Author: Omri Kebede
  */
@@ -15,6 +19,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include "lms_filter.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+#include "dsp_profile.h"
 
 /******************************************************************************/
 /**
@@ -35,9 +42,8 @@
  *  - The user must preallocate memory for `output_signal` and `final_weights`.
  *  - This implementation uses a direct form LMS update rule:
  *       w_j ← w_j + 2 * mu * error * x_j
- *
- * @warning
- *  - If memory allocation for internal weights fails, the function exits early without processing.
+ *  - The weights are adapted directly in `final_weights`, so no memory is allocated.
+ *  - Runs with flush-to-zero under DSP_DENORMALS_FLUSH, like the block calls.
  */
 void lms_filter(
     const double *noisy_signal,
@@ -48,17 +54,23 @@ void lms_filter(
     double *output_signal,
     double *final_weights
 ) {
-    double *weights = calloc(filter_order, sizeof(double));
-    if (!weights) return;  /* allocation failed */
+    DSP_PROFILE_BEGIN(DSP_PROF_LMS);
+    double *weights = final_weights;  /* adapted in place */
 
     int i, j;
 
+    for (j = 0; j < filter_order; j++) {
+        weights[j] = 0.0;
+    }
+
     /* Initialize output signal to zero */
     for (i = 0; i < num_samples; i++) {
         output_signal[i] = 0.0;
     }
 
     /* Main LMS loop: iterate over each sample starting from `filter_order` */
+    DspFpState fp;
+    dsp_fp_scope_begin(&fp);
     for (i = filter_order; i < num_samples; i++) {
         double y = 0.0;  /* predicted output for current sample */
 
@@ -76,13 +88,169 @@ void lms_filter(
 
         output_signal[i] = y;  /* store output */
     }
+    dsp_fp_scope_end(&fp);
+
+    DSP_PROFILE_END(DSP_PROF_LMS);
+}
+/* End of lms_filter() */
+/******************************************************************************/
+
+/**
+ * @brief Initializes a streaming LMS filter with zero weights.
+ *
+ * @param[out] filter Pointer to LMSFilter struct to initialize.
+ * @param[in]  order  Number of adaptive taps.
+ * @param[in]  mu     Learning rate (adaptation step size).
+ *
+ * @returns 0 on success, -1 on invalid order, -2 on allocation failure.
+ *
+ * @warning Must call lms_filter_free() to release memory.
+ */
+int lms_filter_init(LMSFilter *filter, int order, double mu) {
+    filter->weights = NULL;
+    filter->history = NULL;
+    filter->owned_mem = NULL;
+    if (order < 1) return -1;
+
+    void *mem = malloc(lms_filter_mem_size(order));
+    if (!mem) return -2;
+    DSP_PROFILE_ALLOC(DSP_PROF_LMS, lms_filter_mem_size(order));
+
+    lms_filter_init_mem(filter, order, mu, mem);
+    filter->owned_mem = mem;
+    return 0;
+}
+/* End of lms_filter_init() */
+/******************************************************************************/
+
+/**
+ * @brief Bytes of memory lms_filter_init_mem() needs.
+ *
+ * @param[in] order Number of adaptive taps.
+ */
+size_t lms_filter_mem_size(int order) {
+    return DSP_MEM_ALIGN_UP(order * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(2 * order * sizeof(double));
+}
+/* End of lms_filter_mem_size() */
+/******************************************************************************/
+
+/**
+ * @brief Initializes a streaming LMS filter inside caller memory.
+ *
+ * @param[out] filter Pointer to LMSFilter struct to initialize.
+ * @param[in]  order  Number of adaptive taps.
+ * @param[in]  mu     Learning rate (adaptation step size).
+ * @param[in]  mem    At least lms_filter_mem_size(order) bytes aligned for
+ *                    double; must outlive the filter.
+ *
+ * @returns 0 on success, -1 on invalid order. Performs no allocation.
+ */
+int lms_filter_init_mem(LMSFilter *filter, int order, double mu, void *mem) {
+    filter->owned_mem = NULL;
+    if (order < 1) return -1;
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, lms_filter_mem_size(order));
+    filter->order = order;
+    filter->mu = mu;
+    filter->weights = dsp_arena_alloc(&arena, order * sizeof(double));
+    filter->history = dsp_arena_alloc(&arena, 2 * order * sizeof(double));
+    lms_filter_reset(filter);
+    return 0;
+}
+/* End of lms_filter_init_mem() */
+/******************************************************************************/
+
+/**
+ * @brief Zeros the weights and the input history.
+ *
+ * @param[in,out] filter Pointer to LMSFilter.
+ */
+void lms_filter_reset(LMSFilter *filter) {
+    memset(filter->weights, 0, filter->order * sizeof(double));
+    memset(filter->history, 0, 2 * filter->order * sizeof(double));
+    filter->index = 0;
+}
+/* End of lms_filter_reset() */
+/******************************************************************************/
+
+/* Internal helper: one LMS step; same update rule as lms_filter() */
+static inline double lms_step(LMSFilter *filter, double input, double desired) {
+    int n = filter->order;
+    const double *x = filter->history + filter->index;  /* x[j] = input[i - j - 1] */
+    double *w = filter->weights;
+
+    double y = 0.0;
+    for (int j = 0; j < n; j++) {
+        y += w[j] * x[j];
+    }
 
-    /* Copy final weights to user-provided array */
-    for (i = 0; i < filter_order; i++) {
-        final_weights[i] = weights[i];
+    double step = 2 * filter->mu * (desired - y);
+    for (int j = 0; j < n; j++) {
+        w[j] += step * x[j];
     }
 
-    free(weights);  /* cleanup allocated memory */
+    filter->index = (filter->index == 0 ? n : filter->index) - 1;
+    filter->history[filter->index] = input;
+    filter->history[filter->index + n] = input;
+    return y;
 }
-/* End of lms_filter() */
+
+/**
+ * @brief Processes one sample pair.
+ *
+ * @param[in,out] filter  Pointer to LMSFilter.
+ * @param[in]     input   Current input (noisy) sample.
+ * @param[in]     desired Current desired (reference) sample.
+ *
+ * @returns The prediction from the previous `order` inputs.
+ *
+ * @note Matches lms_filter() once the history is full; unlike the batch form
+ *       it also adapts during the first `order` samples (against zeros).
+ */
+double lms_filter_process_sample(LMSFilter *filter, double input, double desired) {
+    DSP_PROFILE_BEGIN(DSP_PROF_LMS);
+    double y = lms_step(filter, input, desired);
+    DSP_PROFILE_END(DSP_PROF_LMS);
+    return y;
+}
+/* End of lms_filter_process_sample() */
+/******************************************************************************/
+
+/**
+ * @brief Processes a block of sample pairs.
+ *
+ * @param[in,out] filter      Pointer to LMSFilter.
+ * @param[in]     input       Input samples (length: num_samples).
+ * @param[in]     desired     Desired samples (length: num_samples).
+ * @param[out]    output      Predictions (length: num_samples); may alias input.
+ * @param[in]     num_samples Number of samples.
+ */
+void lms_filter_process_block(LMSFilter *filter, const double *input, const double *desired,
+                              double *output, size_t num_samples) {
+    DSP_PROFILE_BEGIN(DSP_PROF_LMS);
+    DspFpState fp;
+    dsp_fp_scope_begin(&fp);
+    for (size_t i = 0; i < num_samples; i++) {
+        output[i] = lms_step(filter, input[i], desired[i]);
+    }
+    dsp_fp_scope_end(&fp);
+    DSP_PROFILE_END(DSP_PROF_LMS);
+}
+/* End of lms_filter_process_block() */
+/******************************************************************************/
+
+/**
+ * @brief Frees memory owned by a streaming LMS filter.
+ *
+ * @param[in,out] filter Pointer to LMSFilter.
+ */
+void lms_filter_free(LMSFilter *filter) {
+    free(filter->owned_mem);
+    filter->owned_mem = NULL;
+    filter->weights = NULL;
+    filter->history = NULL;
+}
+/* End of lms_filter_free() */
 /******************************************************************************/
@@ -0,0 +1,522 @@
+/*
+ * @file mfcc.c
+ *
+ * Mel filterbank and MFCC feature extraction on top of the library FFT.
+ *
+ * Features:
+ *   - Triangular mel filters (HTK mel scale) precomputed as a sparse band
+ *     matrix: only the non-zero weights of each filter are stored, so
+ *     applying the bank costs about 2 * num_bins multiply-adds instead of
+ *     num_filters * num_bins for a dense matrix.
+ *   - Fused per-frame pipeline: window -> FFT -> power -> mel -> log -> DCT
+ *     with all scratch buffers owned by the extractor (no allocation per
+ *     frame).
+ *   - Streaming block API with the same frame/hop semantics as
+ *     compute_spectrogram(), so a corpus can be processed in one pass.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mfcc.h"
+#include "fft.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define PI 3.14159265358979323846
+#define MFCC_LOG_FLOOR 1e-10   /* mel energy floor before the log */
+
+/* Internal helpers: HTK mel scale */
+static double hz_to_mel(double hz) {
+    return 2595.0 * log10(1.0 + hz / 700.0);
+}
+
+static double mel_to_hz(double mel) {
+    return 700.0 * (pow(10.0, mel / 2595.0) - 1.0);
+}
+
+/* Internal helper: argument check shared by the filterbank entry points */
+static int mel_filterbank_valid(int sample_rate, int fft_size, int num_filters,
+                                double fmin, double fmax) {
+    return sample_rate > 0 && fft_size >= 2 && num_filters >= 1 &&
+           fmin >= 0 && fmax > fmin && fmax <= sample_rate / 2.0;
+}
+
+/******************************************************************************
+ * mel_filterbank_init
+ *
+ * @param[out] fb          Pointer to MelFilterbank struct to initialize
+ * @param[in]  sample_rate Sample rate in Hz
+ * @param[in]  fft_size    FFT length the spectrum comes from
+ * @param[in]  num_filters Number of triangular filters
+ * @param[in]  fmin        Lower edge of the first filter in Hz
+ * @param[in]  fmax        Upper edge of the last filter in Hz
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @warning
+ * - Must call mel_filterbank_free() to release allocated resources.
+ */
+int mel_filterbank_init(MelFilterbank *fb, int sample_rate, int fft_size,
+                        int num_filters, double fmin, double fmax) {
+    fb->owned_mem = NULL;
+    if (!mel_filterbank_valid(sample_rate, fft_size, num_filters, fmin, fmax)) return -1;
+
+    void *mem = malloc(mel_filterbank_mem_size(fft_size, num_filters));
+    if (!mem) return -2;
+    mel_filterbank_init_mem(fb, sample_rate, fft_size, num_filters, fmin, fmax, mem);
+    fb->owned_mem = mem;
+    return 0;
+}
+/* End of mel_filterbank_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * mel_filterbank_mem_size
+ *
+ * @param[in] fft_size    FFT length the spectrum comes from
+ * @param[in] num_filters Number of triangular filters
+ *
+ * @returns Bytes of memory mel_filterbank_init_mem() needs
+ */
+size_t mel_filterbank_mem_size(int fft_size, int num_filters) {
+    int num_bins = fft_size / 2 + 1;
+    // Adjacent triangles overlap by at most one band, so 2 * num_bins bounds the total
+    return 3 * DSP_MEM_ALIGN_UP(num_filters * sizeof(int)) +
+           DSP_MEM_ALIGN_UP(2 * num_bins * sizeof(double));
+}
+/* End of mel_filterbank_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * mel_filterbank_init_mem
+ *
+ * @param[out] fb          Pointer to MelFilterbank struct to initialize
+ * @param[in]  sample_rate Sample rate in Hz
+ * @param[in]  fft_size    FFT length the spectrum comes from
+ * @param[in]  num_filters Number of triangular filters
+ * @param[in]  fmin        Lower edge of the first filter in Hz
+ * @param[in]  fmax        Upper edge of the last filter in Hz
+ * @param[in]  mem         At least mel_filterbank_mem_size() bytes aligned for
+ *                         double; must outlive the filterbank
+ *
+ * @returns 0 on success, -1 on invalid arguments
+ *
+ * @note
+ * - Filter edges are equally spaced on the mel scale; weights are evaluated
+ *   at the exact bin centre frequencies (peak value 1 at the filter centre).
+ * - Each filter is stored as (start bin, weight count, packed weights).
+ * - Performs no allocation.
+ */
+int mel_filterbank_init_mem(MelFilterbank *fb, int sample_rate, int fft_size,
+                            int num_filters, double fmin, double fmax, void *mem) {
+    fb->owned_mem = NULL;
+    if (!mel_filterbank_valid(sample_rate, fft_size, num_filters, fmin, fmax)) return -1;
+
+    int num_bins = fft_size / 2 + 1;
+    double bin_hz = (double)sample_rate / fft_size;
+    double mel_lo = hz_to_mel(fmin);
+    double mel_step = (hz_to_mel(fmax) - mel_lo) / (num_filters + 1);
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, mel_filterbank_mem_size(fft_size, num_filters));
+    fb->num_filters = num_filters;
+    fb->num_bins = num_bins;
+    fb->start_bin = dsp_arena_alloc(&arena, num_filters * sizeof(int));
+    fb->num_weights = dsp_arena_alloc(&arena, num_filters * sizeof(int));
+    fb->offset = dsp_arena_alloc(&arena, num_filters * sizeof(int));
+    fb->weights = dsp_arena_alloc(&arena, 2 * num_bins * sizeof(double));
+
+    int total = 0;
+    for (int m = 0; m < num_filters; m++) {
+        double left = mel_to_hz(mel_lo + m * mel_step);
+        double centre = mel_to_hz(mel_lo + (m + 1) * mel_step);
+        double right = mel_to_hz(mel_lo + (m + 2) * mel_step);
+
+        fb->start_bin[m] = 0;
+        fb->num_weights[m] = 0;
+        fb->offset[m] = total;
+
+        for (int bin = (int)(left / bin_hz); bin < num_bins && bin * bin_hz < right; bin++) {
+            double f = bin * bin_hz;
+            double w = (f <= centre) ? (f - left) / (centre - left)
+                                     : (right - f) / (right - centre);
+            if (w <= 0.0) continue;
+
+            if (fb->num_weights[m] == 0) {
+                fb->start_bin[m] = bin;
+            }
+            fb->weights[total++] = w;
+            fb->num_weights[m]++;
+        }
+    }
+
+    return 0;
+}
+/* End of mel_filterbank_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * mel_filterbank_apply
+ *
+ * @param[in]  fb      Pointer to initialized MelFilterbank
+ * @param[in]  power   Power spectrum [num_bins]
+ * @param[out] mel_out Mel band energies [num_filters]
+ *
+ * @note Sparse band-matrix product; each filter touches only its own bins.
+ */
+void mel_filterbank_apply(const MelFilterbank *fb, const double *power, double *mel_out) {
+    for (int m = 0; m < fb->num_filters; m++) {
+        const double *w = fb->weights + fb->offset[m];
+        const double *p = power + fb->start_bin[m];
+        double acc = 0.0;
+
+        for (int k = 0; k < fb->num_weights[m]; k++) {
+            acc += w[k] * p[k];
+        }
+        mel_out[m] = acc;
+    }
+}
+/* End of mel_filterbank_apply() */
+/******************************************************************************/
+
+/******************************************************************************
+ * mel_filterbank_free
+ *
+ * @param[in,out] fb Pointer to MelFilterbank struct
+ *
+ * @note Caller memory from mel_filterbank_init_mem() is left alone.
+ */
+void mel_filterbank_free(MelFilterbank *fb) {
+    if (!fb) return;
+    free(fb->owned_mem);
+    fb->owned_mem = NULL;
+    fb->start_bin = NULL;
+    fb->num_weights = NULL;
+    fb->offset = NULL;
+    fb->weights = NULL;
+}
+/* End of mel_filterbank_free() */
+/******************************************************************************/
+
+/* Internal helper: configuration check shared by the extractor entry points */
+static int mfcc_config_valid(const MfccConfig *cfg) {
+    return cfg && cfg->hop_size >= 1 && cfg->num_ceps >= 1 &&
+           cfg->num_ceps <= cfg->num_filters && fft_plan_mem_size(cfg->fft_size) > 0 &&
+           mel_filterbank_valid(cfg->sample_rate, cfg->fft_size, cfg->num_filters,
+                                cfg->fmin, cfg->fmax);
+}
+
+/******************************************************************************
+ * mfcc_init
+ *
+ * @param[out] m   Pointer to Mfcc struct to initialize
+ * @param[in]  cfg Configuration (copied)
+ *
+ * @returns 0 on success, -1 on invalid configuration, -2 on allocation failure
+ *
+ * @note Allocates one block of mfcc_mem_size() bytes and builds the extractor
+ *       in it with mfcc_init_mem().
+ *
+ * @warning
+ * - Must call mfcc_free() to release allocated resources.
+ */
+int mfcc_init(Mfcc *m, const MfccConfig *cfg) {
+    memset(m, 0, sizeof(*m));
+    if (!mfcc_config_valid(cfg)) return -1;
+
+    void *mem = malloc(mfcc_mem_size(cfg));
+    if (!mem) return -2;
+    mfcc_init_mem(m, cfg, mem);
+    m->owned_mem = mem;
+    return 0;
+}
+/* End of mfcc_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * mfcc_mem_size
+ *
+ * @param[in] cfg Configuration
+ *
+ * @returns Bytes of memory mfcc_init_mem() needs, 0 on invalid configuration
+ */
+size_t mfcc_mem_size(const MfccConfig *cfg) {
+    if (!mfcc_config_valid(cfg)) return 0;
+
+    int n = cfg->fft_size;
+    return mel_filterbank_mem_size(n, cfg->num_filters) +
+           fft_plan_mem_size(n) +
+           DSP_MEM_ALIGN_UP(n * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(cfg->num_ceps * cfg->num_filters * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(n * sizeof(Complex)) +
+           DSP_MEM_ALIGN_UP((n / 2 + 1) * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(cfg->num_filters * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(n * sizeof(double));
+}
+/* End of mfcc_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * mfcc_init_mem
+ *
+ * @param[out] m   Pointer to Mfcc struct to initialize
+ * @param[in]  cfg Configuration (copied)
+ * @param[in]  mem At least mfcc_mem_size(cfg) bytes aligned for double; must
+ *                 outlive the extractor
+ *
+ * @returns 0 on success, -1 on invalid configuration
+ *
+ * @note Precomputes the window, the sparse mel bank, the FFT plan and an
+ *       orthonormal DCT-II matrix so per-frame work needs no trigonometry.
+ *       Performs no allocation.
+ */
+int mfcc_init_mem(Mfcc *m, const MfccConfig *cfg, void *mem) {
+    memset(m, 0, sizeof(*m));
+    if (!mfcc_config_valid(cfg)) return -1;
+    m->cfg = *cfg;
+
+    int n = cfg->fft_size;
+    size_t fb_size = mel_filterbank_mem_size(n, cfg->num_filters);
+    DspArena arena;
+    dsp_arena_init(&arena, mem, mfcc_mem_size(cfg));
+    mel_filterbank_init_mem(&m->fb, cfg->sample_rate, n, cfg->num_filters,
+                            cfg->fmin, cfg->fmax, dsp_arena_alloc(&arena, fb_size));
+    fft_plan_init_mem(&m->plan, n, dsp_arena_alloc(&arena, fft_plan_mem_size(n)));
+
+    m->window = dsp_arena_alloc(&arena, n * sizeof(double));
+    m->dct = dsp_arena_alloc(&arena, cfg->num_ceps * cfg->num_filters * sizeof(double));
+    m->fft_buffer = dsp_arena_alloc(&arena, n * sizeof(Complex));
+    m->power = dsp_arena_alloc(&arena, m->fb.num_bins * sizeof(double));
+    m->log_mel = dsp_arena_alloc(&arena, cfg->num_filters * sizeof(double));
+    m->pending = dsp_arena_alloc(&arena, n * sizeof(double));
+
+    generate_window(m->window, n, cfg->window_type);
+
+    int nf = cfg->num_filters;
+    for (int k = 0; k < cfg->num_ceps; k++) {
+        double scale = (k == 0) ? sqrt(1.0 / nf) : sqrt(2.0 / nf);
+        for (int j = 0; j < nf; j++) {
+            m->dct[k * nf + j] = scale * cos(PI * k * (j + 0.5) / nf);
+        }
+    }
+
+    m->pending_fill = 0;
+    return 0;
+}
+/* End of mfcc_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * mfcc_process_frame
+ *
+ * @param[in,out] m     Pointer to initialized Mfcc struct
+ * @param[in]     frame fft_size time-domain samples in [-1, 1)
+ * @param[out]    ceps  num_ceps cepstral coefficients
+ *
+ * @note Window, FFT, power, sparse mel, log and DCT run back to back over
+ *       scratch buffers that stay in cache; performs no allocation.
+ */
+void mfcc_process_frame(Mfcc *m, const double *frame, double *ceps) {
+    int n = m->cfg.fft_size;
+    int nf = m->cfg.num_filters;
+
+    for (int i = 0; i < n; i++) {
+        m->fft_buffer[i].real = frame[i] * m->window[i];
+        m->fft_buffer[i].imag = 0.0;
+    }
+
+    fft_execute(&m->plan, m->fft_buffer);
+
+    for (int bin = 0; bin < m->fb.num_bins; bin++) {
+        Complex c = m->fft_buffer[bin];
+        m->power[bin] = c.real * c.real + c.imag * c.imag;
+    }
+
+    // Sparse mel band energies straight into the log
+    for (int f = 0; f < nf; f++) {
+        const double *w = m->fb.weights + m->fb.offset[f];
+        const double *p = m->power + m->fb.start_bin[f];
+        double acc = 0.0;
+
+        for (int k = 0; k < m->fb.num_weights[f]; k++) {
+            acc += w[k] * p[k];
+        }
+        m->log_mel[f] = log(acc > MFCC_LOG_FLOOR ? acc : MFCC_LOG_FLOOR);
+    }
+
+    for (int k = 0; k < m->cfg.num_ceps; k++) {
+        const double *row = m->dct + k * nf;
+        double acc = 0.0;
+
+        for (int j = 0; j < nf; j++) {
+            acc += row[j] * m->log_mel[j];
+        }
+        ceps[k] = acc;
+    }
+}
+/* End of mfcc_process_frame() */
+/******************************************************************************/
+
+/******************************************************************************
+ * mfcc_process_block
+ *
+ * @param[in,out] m           Pointer to initialized Mfcc struct
+ * @param[in]     input       Block of samples in [-1, 1)
+ * @param[in]     num_samples Number of samples in the block
+ * @param[out]    ceps_out    Output rows, num_ceps values each
+ * @param[in]     max_frames  Capacity of ceps_out in rows
+ *
+ * @returns Number of rows written
+ *
+ * @note
+ * - Frames start every hop_size samples from the first sample ever pushed,
+ *   matching compute_spectrogram(); a frame is emitted as soon as its last
+ *   sample arrives.
+ * - A block of B samples yields at most B / hop_size + 1 rows.
+ *
+ * @warning
+ * - When hop_size > fft_size the samples between frames are skipped.
+ * - Rows beyond max_frames are dropped.
+ */
+size_t mfcc_process_block(Mfcc *m, const double *input, size_t num_samples,
+                          double *ceps_out, size_t max_frames) {
+    int n = m->cfg.fft_size;
+    int hop = m->cfg.hop_size;
+    size_t rows = 0;
+
+    for (size_t i = 0; i < num_samples; i++) {
+        // Negative fill counts samples still to skip when hop > fft_size
+        if (m->pending_fill < 0) {
+            m->pending_fill++;
+            continue;
+        }
+
+        m->pending[m->pending_fill++] = input[i];
+        if (m->pending_fill < n) continue;
+
+        if (rows < max_frames) {
+            mfcc_process_frame(m, m->pending, ceps_out + rows * m->cfg.num_ceps);
+            rows++;
+        }
+
+        if (hop < n) {
+            memmove(m->pending, m->pending + hop, (n - hop) * sizeof(double));
+            m->pending_fill = n - hop;
+        } else {
+            m->pending_fill = n - hop;
+        }
+    }
+
+    return rows;
+}
+/* End of mfcc_process_block() */
+/******************************************************************************/
+
+void mfcc_reset(Mfcc *m) {
+    m->pending_fill = 0;
+}
+
+/******************************************************************************
+ * mfcc_free
+ *
+ * @param[in,out] m Pointer to Mfcc struct
+ *
+ * @note Caller memory from mfcc_init_mem() is left alone.
+ */
+void mfcc_free(Mfcc *m) {
+    if (!m) return;
+    mel_filterbank_free(&m->fb);
+    free(m->owned_mem);
+    m->owned_mem = NULL;
+    m->window = NULL;
+    m->dct = NULL;
+    m->fft_buffer = NULL;
+    m->power = NULL;
+    m->log_mel = NULL;
+    m->pending = NULL;
+}
+/* End of mfcc_free() */
+/******************************************************************************/
+
+/******************************************************************************
+ * compute_mfcc
+ *
+ * @param[in]  wav            Pointer to WavData struct (must be mono)
+ * @param[in]  cfg            MFCC configuration
+ * @param[out] out_num_frames Number of rows returned
+ *
+ * @returns 2D array [num_frames][num_ceps], or NULL on error or when the
+ *          signal is shorter than one frame
+ *
+ * @note Same framing as compute_spectrogram(). Caller must free the result
+ *       with free_mfcc().
+ */
+double **compute_mfcc(const WavData *wav, const MfccConfig *cfg, int *out_num_frames) {
+    *out_num_frames = 0;
+    if (!wav || wav->num_channels != 1 || cfg->fft_size < 1 ||
+        wav->num_samples < (size_t)cfg->fft_size) return NULL;
+
+    Mfcc m;
+    if (mfcc_init(&m, cfg) != 0) return NULL;
+
+    int n = cfg->fft_size;
+    size_t num_frames_64 = 1 + (wav->num_samples - n) / cfg->hop_size;
+    if (num_frames_64 > INT_MAX) {
+        mfcc_free(&m);
+        return NULL;
+    }
+    int num_frames = (int)num_frames_64;
+
+    double **rows = malloc(num_frames * sizeof(double *));
+    if (!rows) {
+        mfcc_free(&m);
+        return NULL;
+    }
+    for (int f = 0; f < num_frames; f++) {
+        rows[f] = malloc(cfg->num_ceps * sizeof(double));
+        if (!rows[f]) {
+            free_mfcc(rows, f);
+            mfcc_free(&m);
+            return NULL;
+        }
+    }
+
+    for (int f = 0; f < num_frames; f++) {
+        const int16_t *src = wav->samples + (size_t)f * cfg->hop_size;
+        dsp_kernels()->s16_to_double(src, m.pending, n);
+        mfcc_process_frame(&m, m.pending, rows[f]);
+    }
+
+    mfcc_free(&m);
+    *out_num_frames = num_frames;
+    return rows;
+}
+/* End of compute_mfcc() */
+/******************************************************************************/
+
+/******************************************************************************
+ * free_mfcc
+ *
+ * @param[in,out] mfcc       Result of compute_mfcc()
+ * @param[in]     num_frames Number of rows
+ *
+ * @warning Safe to call with NULL pointer (no operation).
+ */
+void free_mfcc(double **mfcc, int num_frames) {
+    if (!mfcc) return;
+    for (int i = 0; i < num_frames; i++) {
+        free(mfcc[i]);
+    }
+    free(mfcc);
+}
+/* End of free_mfcc() */
+/******************************************************************************/
@@ -0,0 +1,459 @@
+/*
+ * @file resampler.c
+ *
+ * Implementation of a streaming polyphase sample-rate converter.
+ *
+ * Features:
+ *   - Windowed-sinc (Blackman) prototype split into a polyphase filter bank
+ *   - Exact rational conversion when the reduced output ratio fits the bank
+ *   - Arbitrary ratios via linear or cubic interpolation between branches
+ *   - Block processing that performs no allocation after resampler_init()
+ *
+ * Algorithm Details:
+ *   The ratio in_rate/out_rate is reduced to step/den. The position of the
+ *   next output sample is tracked as an integer accumulator in units of
+ *   1/den input samples, so the phase never drifts. For every output the
+ *   accumulator selects one branch (or interpolates between branches) and
+ *   a dot product is taken against a contiguous view of the delay line.
+ *   The low-pass cutoff follows the lower of the two Nyquist frequencies.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "resampler.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+#include "dsp_profile.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define PI 3.14159265358979323846
+#define RESAMPLER_ROLLOFF 0.94   /* passband edge relative to Nyquist */
+#define RESAMPLER_MAX_TAPS 4096   /* cap on the decimation-stretched filter length */
+
+/* Preset table indexed by ResamplerQuality */
+static const struct {
+    size_t num_taps;
+    size_t num_phases;
+    ResamplerInterp interp;
+} resampler_presets[] = {
+    {  8,  32, RESAMPLER_INTERP_LINEAR },
+    { 16, 128, RESAMPLER_INTERP_LINEAR },
+    { 32, 256, RESAMPLER_INTERP_CUBIC  }
+};
+
+/* Internal helper: greatest common divisor */
+static unsigned long long gcd_ull(unsigned long long a, unsigned long long b) {
+    while (b) {
+        unsigned long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Internal helper: windowed-sinc prototype evaluated at offset tau (input samples) */
+static double prototype(double tau, double cutoff, double half_len) {
+    if (fabs(tau) >= half_len) return 0.0;
+
+    double u = tau / half_len;
+    double window = 0.42 + 0.5 * cos(PI * u) + 0.08 * cos(2 * PI * u);
+    double x = 2 * cutoff * tau;
+    double sinc = (x == 0.0) ? 1.0 : sin(PI * x) / (PI * x);
+
+    return 2 * cutoff * sinc * window;
+}
+
+/* Internal helper: write one sample into the doubled delay line */
+static void resampler_push(Resampler *rs, double input) {
+    rs->history[rs->history_index] = input;
+    rs->history[rs->history_index + rs->num_taps] = input;
+    rs->history_index = (rs->history_index + 1) % rs->num_taps;
+}
+
+/* Internal helper: rates, ratio and bank shape for in_rate -> out_rate at
+ * the given quality; returns -1 on invalid arguments */
+static int resampler_layout(Resampler *rs, int in_rate, int out_rate, ResamplerQuality quality) {
+    if (in_rate <= 0 || out_rate <= 0 ||
+        quality < RESAMPLER_QUALITY_FAST || quality > RESAMPLER_QUALITY_HIGH) {
+        return -1;
+    }
+
+    unsigned long long g = gcd_ull((unsigned long long)in_rate, (unsigned long long)out_rate);
+
+    rs->in_rate = in_rate;
+    rs->out_rate = out_rate;
+    rs->step = (unsigned long long)in_rate / g;
+    rs->den = (unsigned long long)out_rate / g;
+    // The prototype spans num_taps input samples; when decimating, stretch it
+    // by the ratio so the transition band stays the same fraction of the
+    // output band (the preset length is multiplied, so it stays even)
+    size_t taps = resampler_presets[quality].num_taps;
+    if (in_rate > out_rate) {
+        size_t factor = (size_t)(((unsigned long long)in_rate + out_rate - 1) / out_rate);
+        if (factor > RESAMPLER_MAX_TAPS / taps) factor = RESAMPLER_MAX_TAPS / taps;
+        taps *= factor;
+    }
+    rs->num_taps = taps;
+
+    if (rs->den <= resampler_presets[quality].num_phases) {
+        rs->num_phases = (size_t)rs->den;
+        rs->interp = RESAMPLER_INTERP_NONE;
+    } else {
+        rs->num_phases = resampler_presets[quality].num_phases;
+        rs->interp = resampler_presets[quality].interp;
+    }
+    return 0;
+}
+
+/* Internal helper: bytes of the bank (with guard branches for interpolation:
+ * p = -1 below, p = num_phases and num_phases + 1 above) plus the delay line */
+static size_t resampler_layout_size(const Resampler *rs) {
+    return DSP_MEM_ALIGN_UP((rs->num_phases + 3) * rs->num_taps * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(2 * rs->num_taps * sizeof(double));
+}
+
+/******************************************************************************
+ * resampler_init
+ *
+ * @param[in,out] rs       Pointer to Resampler struct to initialize
+ * @param[in]     in_rate  Input sample rate in Hz (> 0)
+ * @param[in]     out_rate Output sample rate in Hz (> 0)
+ * @param[in]     quality  Quality preset (filter length and interpolation)
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @note Allocates one block of resampler_mem_size() bytes and builds the
+ *       resampler in it with resampler_init_mem().
+ *
+ * @warning
+ * - Must call resampler_free() to release allocated resources.
+ */
+int resampler_init(Resampler *rs, int in_rate, int out_rate, ResamplerQuality quality) {
+    size_t size = resampler_mem_size(in_rate, out_rate, quality);
+    if (size == 0) return -1;
+
+    void *mem = malloc(size);
+    if (!mem) {
+        rs->bank = NULL;
+        rs->history = NULL;
+        rs->owned_mem = NULL;
+        return -2;
+    }
+    resampler_init_mem(rs, in_rate, out_rate, quality, mem);
+    rs->owned_mem = mem;
+    return 0;
+}
+/* End of resampler_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * resampler_mem_size
+ *
+ * @param[in] in_rate  Input sample rate in Hz (> 0)
+ * @param[in] out_rate Output sample rate in Hz (> 0)
+ * @param[in] quality  Quality preset
+ *
+ * @returns Bytes of memory resampler_init_mem() needs, 0 on invalid arguments
+ */
+size_t resampler_mem_size(int in_rate, int out_rate, ResamplerQuality quality) {
+    Resampler layout;
+    if (resampler_layout(&layout, in_rate, out_rate, quality) != 0) return 0;
+    return resampler_layout_size(&layout);
+}
+/* End of resampler_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * resampler_init_mem
+ *
+ * @param[in,out] rs       Pointer to Resampler struct to initialize
+ * @param[in]     in_rate  Input sample rate in Hz (> 0)
+ * @param[in]     out_rate Output sample rate in Hz (> 0)
+ * @param[in]     quality  Quality preset (filter length and interpolation)
+ * @param[in]     mem      At least resampler_mem_size() bytes aligned for
+ *                         double; must outlive the resampler
+ *
+ * @returns 0 on success, -1 on invalid arguments
+ *
+ * @note
+ * - When the reduced output rate (out_rate / gcd) is not larger than the
+ *   preset's branch count, the bank is built with exactly that many branches
+ *   and no interpolation is needed (exact rational conversion, e.g.
+ *   48 kHz -> 96 kHz or 48 kHz -> 16 kHz).
+ * - Otherwise (e.g. 44.1 kHz -> 48 kHz at FAST quality) the preset bank is
+ *   used and branch coefficients are interpolated for every output.
+ * - When decimating, the preset filter length is multiplied by
+ *   ceil(in_rate / out_rate), up to RESAMPLER_MAX_TAPS taps, so the
+ *   transition band scales with the output rate; beyond that ratio the
+ *   band widens and alias rejection drops. The cost per input sample stays
+ *   roughly that of the preset.
+ * - Each branch is normalized to unit DC gain.
+ * - Performs no allocation; resampler_free() leaves mem alone.
+ */
+int resampler_init_mem(Resampler *rs, int in_rate, int out_rate, ResamplerQuality quality,
+                       void *mem) {
+    rs->owned_mem = NULL;
+    if (resampler_layout(rs, in_rate, out_rate, quality) != 0) return -1;
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, resampler_layout_size(rs));
+    rs->bank = dsp_arena_alloc(&arena, (rs->num_phases + 3) * rs->num_taps * sizeof(double));
+    rs->history = dsp_arena_alloc(&arena, 2 * rs->num_taps * sizeof(double));
+    memset(rs->history, 0, 2 * rs->num_taps * sizeof(double));
+    // Cutoff in cycles per input sample: the lower of the two Nyquist rates
+    double cutoff = 0.5 * RESAMPLER_ROLLOFF;
+    if (out_rate < in_rate) {
+        cutoff *= (double)out_rate / in_rate;
+    }
+    double half_len = rs->num_taps / 2.0;
+
+    // Branch p holds h(num_taps/2 - 1 - k + p/num_phases), oldest sample first
+    for (size_t r = 0; r < rs->num_phases + 3; r++) {
+        double frac = ((double)r - 1.0) / rs->num_phases;
+        double *branch = rs->bank + r * rs->num_taps;
+        double sum = 0.0;
+
+        for (size_t k = 0; k < rs->num_taps; k++) {
+            double tau = half_len - 1.0 - (double)k + frac;
+            branch[k] = prototype(tau, cutoff, half_len);
+            sum += branch[k];
+        }
+        for (size_t k = 0; k < rs->num_taps; k++) {
+            branch[k] /= sum;
+        }
+    }
+
+    rs->history_index = 0;
+    rs->acc = 0;
+    return 0;
+}
+/* End of resampler_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * resampler_reset
+ *
+ * @param[in,out] rs Pointer to initialized Resampler struct
+ *
+ * @returns None
+ *
+ * @note Zeroes the delay line and restarts the phase accumulator.
+ */
+void resampler_reset(Resampler *rs) {
+    if (rs->history) {
+        memset(rs->history, 0, 2 * rs->num_taps * sizeof(double));
+    }
+    rs->history_index = 0;
+    rs->acc = 0;
+}
+/* End of resampler_reset() */
+/******************************************************************************/
+
+/******************************************************************************
+ * resampler_max_output
+ *
+ * @param[in] rs     Pointer to initialized Resampler struct
+ * @param[in] num_in Number of input samples about to be processed
+ *
+ * @returns Maximum number of output samples resampler_process() can produce
+ *
+ * @note Use this to size the output buffer once, up front.
+ */
+size_t resampler_max_output(const Resampler *rs, size_t num_in) {
+    return (size_t)((unsigned long long)num_in * rs->den / rs->step) + 1;
+}
+/* End of resampler_max_output() */
+/******************************************************************************/
+
+/******************************************************************************
+ * resampler_process
+ *
+ * @param[in,out] rs      Pointer to initialized Resampler struct
+ * @param[in]     input   Block of input samples
+ * @param[in]     num_in  Number of input samples
+ * @param[out]    output  Output buffer
+ * @param[in]     max_out Capacity of output buffer
+ *
+ * @returns Number of output samples written
+ *
+ * @note
+ * - All input samples are always consumed; state carries over between
+ *   calls so arbitrary block sizes can be streamed.
+ * - The output lags the input by num_taps/2 input samples (filter delay).
+ * - Performs no memory allocation.
+ *
+ * @warning
+ * - max_out should be at least resampler_max_output(rs, num_in);
+ *   outputs beyond max_out are dropped.
+ */
+size_t resampler_process(Resampler *rs, const double *input, size_t num_in,
+                         double *output, size_t max_out) {
+    DSP_PROFILE_BEGIN(DSP_PROF_RESAMPLER);
+    DspFpState fp;
+    dsp_fp_scope_begin(&fp);
+    size_t num_out = 0;
+    size_t taps = rs->num_taps;
+    // Branch dot products with the contiguous delay line
+    double (*dot)(const double *, const double *, size_t) = dsp_kernels()->dot;
+
+    for (size_t i = 0; i < num_in; i++) {
+        resampler_push(rs, input[i]);
+        const double *window = rs->history + rs->history_index;
+
+        while (rs->acc < rs->den) {
+            double y;
+
+            if (rs->interp == RESAMPLER_INTERP_NONE) {
+                y = dot(rs->bank + (size_t)(rs->acc + 1) * taps, window, taps);
+            } else {
+                double pos = (double)rs->acc * rs->num_phases / rs->den;
+                size_t p = (size_t)pos;
+                double mu = pos - p;
+                const double *branch = rs->bank + (p + 1) * taps;
+
+                if (rs->interp == RESAMPLER_INTERP_LINEAR) {
+                    y = (1.0 - mu) * dot(branch, window, taps)
+                      + mu * dot(branch + taps, window, taps);
+                } else {
+                    // Catmull-Rom weights for branches p-1, p, p+1, p+2
+                    double mu2 = mu * mu, mu3 = mu2 * mu;
+                    double w0 = 0.5 * (-mu3 + 2 * mu2 - mu);
+                    double w1 = 0.5 * (3 * mu3 - 5 * mu2 + 2);
+                    double w2 = 0.5 * (-3 * mu3 + 4 * mu2 + mu);
+                    double w3 = 0.5 * (mu3 - mu2);
+
+                    y = w0 * dot(branch - taps, window, taps)
+                      + w1 * dot(branch, window, taps)
+                      + w2 * dot(branch + taps, window, taps)
+                      + w3 * dot(branch + 2 * taps, window, taps);
+                }
+            }
+
+            if (num_out < max_out) {
+                output[num_out++] = y;
+            }
+            rs->acc += rs->step;
+        }
+        rs->acc -= rs->den;
+    }
+
+    dsp_fp_scope_end(&fp);
+    DSP_PROFILE_END(DSP_PROF_RESAMPLER);
+    return num_out;
+}
+/* End of resampler_process() */
+/******************************************************************************/
+
+/******************************************************************************
+ * resample_wav
+ *
+ * @param[in]  in       Pointer to source WavData (16-bit, any channel count)
+ * @param[in]  out_rate Target sample rate in Hz
+ * @param[in]  quality  Quality preset
+ * @param[out] out      WavData receiving newly allocated resampled samples
+ *
+ * @returns 0 on success, negative error code on failure
+ *
+ * @note
+ * - Channels are resampled independently with one shared Resampler.
+ * - The filter delay is compensated, so output sample 0 is aligned with
+ *   input sample 0 and the output length is ceil(frames * out/in).
+ * - Output samples are rounded and saturated to int16.
+ *
+ * @warning
+ * - Caller must release the result with free_wav().
+ */
+int resample_wav(const WavData *in, int out_rate, ResamplerQuality quality, WavData *out) {
+    if (!in || !in->samples || in->num_channels <= 0) return -1;
+
+    Resampler rs;
+    if (resampler_init(&rs, in->sample_rate, out_rate, quality) != 0) return -2;
+
+    int channels = in->num_channels;
+    size_t in_frames = (size_t)in->num_samples / channels;
+    size_t delay = rs.num_taps / 2;
+    size_t out_frames = (size_t)(((unsigned long long)in_frames * rs.den + rs.step - 1) / rs.step);
+    size_t capacity = resampler_max_output(&rs, in_frames + delay);
+
+    double *mono_in = malloc((in_frames + delay) * sizeof(double));
+    double *mono_out = malloc(capacity * sizeof(double));
+    int16_t *samples = malloc((out_frames * channels + 1) * sizeof(int16_t));
+    if (!mono_in || !mono_out || !samples) {
+        free(mono_in);
+        free(mono_out);
+        free(samples);
+        resampler_free(&rs);
+        return -3;
+    }
+
+    for (int ch = 0; ch < channels; ch++) {
+        // Deinterleave and append delay zeros to flush the filter tail
+        for (size_t i = 0; i < in_frames; i++) {
+            mono_in[i] = in->samples[i * channels + ch] / 32768.0;
+        }
+        memset(mono_in + in_frames, 0, delay * sizeof(double));
+
+        // Prime the delay line so the first output is centred on input sample 0
+        resampler_reset(&rs);
+        size_t primed = delay < in_frames ? delay : in_frames;
+        for (size_t i = 0; i < primed; i++) {
+            resampler_push(&rs, mono_in[i]);
+        }
+
+        size_t produced = resampler_process(&rs, mono_in + primed,
+                                            in_frames + delay - primed,
+                                            mono_out, capacity);
+
+        for (size_t i = 0; i < out_frames; i++) {
+            double v = (i < produced) ? mono_out[i] * 32768.0 : 0.0;
+            v = v < 0 ? v - 0.5 : v + 0.5;
+            if (v > 32767.0) v = 32767.0;
+            if (v < -32768.0) v = -32768.0;
+            samples[i * channels + ch] = (int16_t)v;
+        }
+    }
+
+    free(mono_in);
+    free(mono_out);
+    resampler_free(&rs);
+
+    out->sample_rate = out_rate;
+    out->num_channels = channels;
+    out->bits_per_sample = 16;
+    out->num_samples = out_frames * channels;
+    out->samples = samples;
+
+    return 0;
+}
+/* End of resample_wav() */
+/******************************************************************************/
+
+/******************************************************************************
+ * resampler_free
+ *
+ * @param[in,out] rs Pointer to Resampler struct to free resources of
+ *
+ * @note
+ * - Frees the block allocated by resampler_init(); memory passed to
+ *   resampler_init_mem() is left alone.
+ * - Does not free the struct itself.
+ *
+ * @warning
+ * - Safe to call with NULL pointer (no operation).
+ */
+void resampler_free(Resampler *rs) {
+    if (!rs) return;
+    free(rs->owned_mem);
+    rs->owned_mem = NULL;
+    rs->bank = NULL;
+    rs->history = NULL;
+}
+/* End of resampler_free() */
+/******************************************************************************/
@@ -0,0 +1,328 @@
+/*
+ * @file ring_buffer.c
+ *
+ * Wait-free single-producer/single-consumer ring buffer.
+ *
+ * head and tail are free-running sample counters; the fill level is
+ * head - tail and the storage index is counter & mask, so full and empty
+ * are distinguishable without a spare slot. The producer publishes samples
+ * with a release store of head after writing them, and the consumer hands
+ * space back with a release store of tail after reading; each side loads
+ * the other's counter with acquire, and only when its cached copy says the
+ * ring is full (producer) or empty (consumer).
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stdlib.h>
+#include <string.h>
+#include "ring_buffer.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define RING_BUFFER_MIN_CAPACITY 16
+
+/* Internal helper: free space seen by the producer, refreshing its cached
+ * tail only when the cached value leaves less than want samples */
+static inline size_t producer_space(RingBuffer *rb, size_t head, size_t want) {
+    size_t space = rb->capacity - (head - rb->cached_tail);
+    if (space < want) {
+        rb->cached_tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+        space = rb->capacity - (head - rb->cached_tail);
+    }
+    return space;
+}
+
+/* Internal helper: samples seen by the consumer, refreshing its cached head
+ * only when the cached value holds less than want samples */
+static inline size_t consumer_fill(RingBuffer *rb, size_t tail, size_t want) {
+    size_t fill = rb->cached_head - tail;
+    if (fill < want) {
+        rb->cached_head = atomic_load_explicit(&rb->head, memory_order_acquire);
+        fill = rb->cached_head - tail;
+    }
+    return fill;
+}
+
+/* Internal helper: power-of-two capacity for min_capacity, 0 if invalid */
+static size_t ring_buffer_capacity(size_t min_capacity) {
+    if (min_capacity == 0 || min_capacity > ((size_t)-1 >> 1) / sizeof(double)) return 0;
+
+    size_t capacity = RING_BUFFER_MIN_CAPACITY;
+    while (capacity < min_capacity) capacity *= 2;
+    return capacity;
+}
+
+/******************************************************************************
+ * ring_buffer_init
+ *
+ * @param[out] rb           Pointer to RingBuffer struct to initialize
+ * @param[in]  min_capacity Minimum number of samples the ring must hold
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @note The capacity is rounded up to a power of two (at least 16).
+ *
+ * @warning Must call ring_buffer_free() to release memory.
+ */
+int ring_buffer_init(RingBuffer *rb, size_t min_capacity) {
+    memset(rb, 0, sizeof(*rb));
+    size_t size = ring_buffer_mem_size(min_capacity);
+    if (size == 0) return -1;
+
+    void *mem = malloc(size);
+    if (!mem) return -2;
+    ring_buffer_init_mem(rb, min_capacity, mem);
+    rb->owned_mem = mem;
+    return 0;
+}
+/* End of ring_buffer_init() */
+/******************************************************************************/
+
+size_t ring_buffer_mem_size(size_t min_capacity) {
+    return ring_buffer_capacity(min_capacity) * sizeof(double);
+}
+
+/******************************************************************************
+ * ring_buffer_init_mem
+ *
+ * @param[out] rb           Pointer to RingBuffer struct to initialize
+ * @param[in]  min_capacity Minimum number of samples the ring must hold
+ * @param[in]  mem          At least ring_buffer_mem_size() bytes aligned for
+ *                          double; must outlive the ring
+ *
+ * @returns 0 on success, -1 on invalid arguments
+ *
+ * @note Performs no allocation; the storage is zeroed.
+ */
+int ring_buffer_init_mem(RingBuffer *rb, size_t min_capacity, void *mem) {
+    memset(rb, 0, sizeof(*rb));
+    size_t capacity = ring_buffer_capacity(min_capacity);
+    if (capacity == 0 || !mem) return -1;
+
+    rb->data = mem;
+    memset(rb->data, 0, capacity * sizeof(double));
+    rb->capacity = capacity;
+    rb->mask = capacity - 1;
+    atomic_init(&rb->head, 0);
+    atomic_init(&rb->tail, 0);
+    return 0;
+}
+/* End of ring_buffer_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * ring_buffer_reset
+ *
+ * @param[in,out] rb Ring to empty
+ *
+ * @warning Not thread-safe: call only while no producer or consumer runs.
+ */
+void ring_buffer_reset(RingBuffer *rb) {
+    atomic_store(&rb->head, 0);
+    atomic_store(&rb->tail, 0);
+    rb->cached_head = rb->cached_tail = 0;
+}
+/* End of ring_buffer_reset() */
+/******************************************************************************/
+
+size_t ring_buffer_read_available(RingBuffer *rb) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    return head - atomic_load_explicit(&rb->tail, memory_order_acquire);
+}
+
+size_t ring_buffer_write_available(RingBuffer *rb) {
+    return rb->capacity - ring_buffer_read_available(rb);
+}
+
+/******************************************************************************
+ * ring_buffer_write_acquire
+ *
+ * @param[in,out] rb    Ring (producer side)
+ * @param[out]    count Length of the returned region
+ *
+ * @returns Start of the next writable region, which ends at the free space
+ *          or at the end of the storage, whichever comes first
+ *
+ * @note A second acquire after committing the first region returns the part
+ *       that wrapped to the start of the storage.
+ */
+double *ring_buffer_write_acquire(RingBuffer *rb, size_t *count) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    size_t offset = head & rb->mask;
+    size_t contiguous = rb->capacity - offset;
+    size_t space = producer_space(rb, head, contiguous);
+    *count = space < contiguous ? space : contiguous;
+    return rb->data + offset;
+}
+/* End of ring_buffer_write_acquire() */
+/******************************************************************************/
+
+/******************************************************************************
+ * ring_buffer_write_commit
+ *
+ * @param[in,out] rb Ring (producer side)
+ * @param[in]     n  Samples written (<= count from the last acquire)
+ */
+void ring_buffer_write_commit(RingBuffer *rb, size_t n) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    atomic_store_explicit(&rb->head, head + n, memory_order_release);
+}
+/* End of ring_buffer_write_commit() */
+/******************************************************************************/
+
+/******************************************************************************
+ * ring_buffer_read_acquire
+ *
+ * @param[in,out] rb    Ring (consumer side)
+ * @param[out]    count Length of the returned region
+ *
+ * @returns Start of the next readable region, which ends at the last
+ *          published sample or at the end of the storage
+ */
+const double *ring_buffer_read_acquire(RingBuffer *rb, size_t *count) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    size_t offset = tail & rb->mask;
+    size_t contiguous = rb->capacity - offset;
+    size_t fill = consumer_fill(rb, tail, contiguous);
+    *count = fill < contiguous ? fill : contiguous;
+    return rb->data + offset;
+}
+/* End of ring_buffer_read_acquire() */
+/******************************************************************************/
+
+/******************************************************************************
+ * ring_buffer_read_release
+ *
+ * @param[in,out] rb Ring (consumer side)
+ * @param[in]     n  Samples consumed (<= count from the last acquire)
+ */
+void ring_buffer_read_release(RingBuffer *rb, size_t n) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    atomic_store_explicit(&rb->tail, tail + n, memory_order_release);
+}
+/* End of ring_buffer_read_release() */
+/******************************************************************************/
+
+/******************************************************************************
+ * ring_buffer_write
+ *
+ * @param[in,out] rb      Ring (producer side)
+ * @param[in]     samples Samples to append [n]
+ * @param[in]     n       Number of samples offered
+ *
+ * @returns Samples written; less than n when the ring fills up
+ */
+size_t ring_buffer_write(RingBuffer *rb, const double *samples, size_t n) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    size_t space = producer_space(rb, head, n);
+    if (n > space) n = space;
+
+    size_t offset = head & rb->mask;
+    size_t first = rb->capacity - offset;
+    if (first > n) first = n;
+    memcpy(rb->data + offset, samples, first * sizeof(double));
+    memcpy(rb->data, samples + first, (n - first) * sizeof(double));
+
+    atomic_store_explicit(&rb->head, head + n, memory_order_release);
+    return n;
+}
+/* End of ring_buffer_write() */
+/******************************************************************************/
+
+/******************************************************************************
+ * ring_buffer_read
+ *
+ * @param[in,out] rb      Ring (consumer side)
+ * @param[out]    samples Destination [n]
+ * @param[in]     n       Number of samples wanted
+ *
+ * @returns Samples read; less than n when the ring runs empty
+ */
+size_t ring_buffer_read(RingBuffer *rb, double *samples, size_t n) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    size_t fill = consumer_fill(rb, tail, n);
+    if (n > fill) n = fill;
+
+    size_t offset = tail & rb->mask;
+    size_t first = rb->capacity - offset;
+    if (first > n) first = n;
+    memcpy(samples, rb->data + offset, first * sizeof(double));
+    memcpy(samples + first, rb->data, (n - first) * sizeof(double));
+
+    atomic_store_explicit(&rb->tail, tail + n, memory_order_release);
+    return n;
+}
+/* End of ring_buffer_read() */
+/******************************************************************************/
+
+/******************************************************************************
+ * ring_buffer_transfer
+ *
+ * @param[in,out] in    Source ring (caller is its consumer)
+ * @param[in,out] out   Destination ring (caller is its producer)
+ * @param[in]     max   Upper bound on samples to move
+ * @param[in]     fn    Block function applied on the way
+ * @param[in,out] state Passed to fn
+ *
+ * @returns Samples moved: the smallest of max, the samples available in in
+ *          and the free space in out
+ *
+ * @note fn reads directly from in's storage and writes directly into out's,
+ *       one call per contiguous span (at most three when both rings wrap).
+ */
+size_t ring_buffer_transfer(RingBuffer *in, RingBuffer *out, size_t max,
+                            RingBlockFn fn, void *state) {
+    size_t moved = 0;
+    while (moved < max) {
+        size_t readable, writable;
+        const double *src = ring_buffer_read_acquire(in, &readable);
+        double *dst = ring_buffer_write_acquire(out, &writable);
+
+        size_t n = max - moved;
+        if (n > readable) n = readable;
+        if (n > writable) n = writable;
+        if (n == 0) break;
+
+        fn(state, src, dst, n);
+        ring_buffer_write_commit(out, n);
+        ring_buffer_read_release(in, n);
+        moved += n;
+    }
+    return moved;
+}
+/* End of ring_buffer_transfer() */
+/******************************************************************************/
+
+static void fir_block(void *state, const double *input, double *output, size_t n) {
+    fir_filter_process_block(state, input, output, n);
+}
+
+static void iir_block(void *state, const double *input, double *output, size_t n) {
+    iir_process_block(state, input, output, n);
+}
+
+size_t ring_buffer_fir(RingBuffer *in, RingBuffer *out, FIRFilter *filter, size_t max) {
+    return ring_buffer_transfer(in, out, max, fir_block, filter);
+}
+
+size_t ring_buffer_iir(RingBuffer *in, RingBuffer *out, IIRFilter *filter, size_t max) {
+    return ring_buffer_transfer(in, out, max, iir_block, filter);
+}
+
+/******************************************************************************
+ * ring_buffer_free
+ *
+ * @param[in,out] rb Pointer to RingBuffer
+ */
+void ring_buffer_free(RingBuffer *rb) {
+    free(rb->owned_mem);
+    rb->owned_mem = NULL;
+    rb->data = NULL;
+    rb->capacity = rb->mask = 0;
+}
+/* End of ring_buffer_free() */
+/******************************************************************************/
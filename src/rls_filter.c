@@ -0,0 +1,501 @@
+/**
+ * @file rls_filter.c
+ *
+ * @brief Implements the RLS and fast transversal RLS adaptive filters.
+ *
+ * Both follow LMSFilter: past inputs sit in a doubled circular buffer
+ * (newest first), the prediction uses the previous `order` inputs and the
+ * current input is recorded after the update.
+ *
+ * RLSFilter keeps the inverse input correlation P in one preallocated block,
+ * row-major, with each row padded to a cache line. Per sample:
+ *     u = P x,  g = 1 / (lambda + x'u),  w += g e u,
+ *     P = (P - g u u') / lambda
+ * The rank-one term is formed as (u_i u_j) g, so P stays exactly symmetric.
+ *
+ * FTRLSFilter is the stabilized fast transversal filter (Slock & Kailath;
+ * Diniz, Adaptive Filtering, alg. 8.2). It needs order + 1 past inputs and
+ * O(order) work per sample. The backward prediction error is computed two
+ * ways and mixed with the constants FTRLS_K1/K2, which damps the error
+ * growth of the plain algorithm. If the conversion factor still leaves
+ * (0, 1], or an error energy stops being positive, the predictors restart.
+ * The joint-process weights are kept.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stdlib.h>
+#include <string.h>
+#include "rls_filter.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+#include "dsp_profile.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define RLS_ROW_DOUBLES (DSP_MEM_ALIGN / sizeof(double))
+
+/* Backward-error mixing constants of the stabilized FTRLS */
+#define FTRLS_K1 1.5
+#define FTRLS_K2 2.5
+
+/* Internal helper: P row length, order rounded up to a cache line */
+static int rls_stride(int order) {
+    return (int)((order + RLS_ROW_DOUBLES - 1) / RLS_ROW_DOUBLES * RLS_ROW_DOUBLES);
+}
+
+/******************************************************************************/
+/**
+ * @brief Initializes a streaming RLS filter.
+ *
+ * @param[out] filter Pointer to RLSFilter struct to initialize.
+ * @param[in]  order  Number of adaptive taps.
+ * @param[in]  lambda Forgetting factor in (0, 1], e.g. 0.999.
+ * @param[in]  delta  Initial input power estimate (> 0); P starts as I / delta.
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure.
+ *
+ * @warning Must call rls_filter_free() to release memory.
+ */
+int rls_filter_init(RLSFilter *filter, int order, double lambda, double delta) {
+    filter->weights = NULL;
+    filter->P = NULL;
+    filter->u = NULL;
+    filter->history = NULL;
+    filter->owned_mem = NULL;
+    if (order < 1 || !(lambda > 0.0 && lambda <= 1.0) || !(delta > 0.0)) return -1;
+
+    // Size is a multiple of DSP_MEM_ALIGN, so P rows land on cache lines
+    void *mem = aligned_alloc(DSP_MEM_ALIGN, rls_filter_mem_size(order));
+    if (!mem) return -2;
+    DSP_PROFILE_ALLOC(DSP_PROF_RLS, rls_filter_mem_size(order));
+
+    rls_filter_init_mem(filter, order, lambda, delta, mem);
+    filter->owned_mem = mem;
+    return 0;
+}
+/* End of rls_filter_init() */
+/******************************************************************************/
+
+/**
+ * @brief Bytes of memory rls_filter_init_mem() needs.
+ *
+ * @param[in] order Number of adaptive taps.
+ */
+size_t rls_filter_mem_size(int order) {
+    if (order < 1) return 0;
+    return DSP_MEM_ALIGN_UP((size_t)order * rls_stride(order) * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(order * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(order * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(2 * order * sizeof(double));
+}
+/* End of rls_filter_mem_size() */
+/******************************************************************************/
+
+/**
+ * @brief Initializes a streaming RLS filter inside caller memory.
+ *
+ * @param[out] filter Pointer to RLSFilter struct to initialize.
+ * @param[in]  order  Number of adaptive taps.
+ * @param[in]  lambda Forgetting factor in (0, 1].
+ * @param[in]  delta  Initial input power estimate (> 0).
+ * @param[in]  mem    At least rls_filter_mem_size(order) bytes aligned for
+ *                    double; must outlive the filter.
+ *
+ * @returns 0 on success, -1 on invalid arguments. Performs no allocation.
+ *
+ * @note P comes first in the block, so with mem aligned to DSP_MEM_ALIGN
+ *       every row starts on a cache line.
+ */
+int rls_filter_init_mem(RLSFilter *filter, int order, double lambda, double delta, void *mem) {
+    filter->owned_mem = NULL;
+    if (order < 1 || !(lambda > 0.0 && lambda <= 1.0) || !(delta > 0.0)) return -1;
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, rls_filter_mem_size(order));
+    filter->order = order;
+    filter->lambda = lambda;
+    filter->delta = delta;
+    filter->stride = rls_stride(order);
+    filter->P = dsp_arena_alloc(&arena, (size_t)order * filter->stride * sizeof(double));
+    filter->weights = dsp_arena_alloc(&arena, order * sizeof(double));
+    filter->u = dsp_arena_alloc(&arena, order * sizeof(double));
+    filter->history = dsp_arena_alloc(&arena, 2 * order * sizeof(double));
+    rls_filter_reset(filter);
+    return 0;
+}
+/* End of rls_filter_init_mem() */
+/******************************************************************************/
+
+/**
+ * @brief Zeros the weights and history and restores P = I / delta.
+ *
+ * @param[in,out] filter Pointer to RLSFilter.
+ */
+void rls_filter_reset(RLSFilter *filter) {
+    int n = filter->order;
+    memset(filter->P, 0, (size_t)n * filter->stride * sizeof(double));
+    for (int i = 0; i < n; i++) {
+        filter->P[(size_t)i * filter->stride + i] = 1.0 / filter->delta;
+    }
+    memset(filter->weights, 0, n * sizeof(double));
+    memset(filter->history, 0, 2 * n * sizeof(double));
+    filter->index = 0;
+}
+/* End of rls_filter_reset() */
+/******************************************************************************/
+
+/* Internal helper: one RLS step */
+static inline double rls_step(RLSFilter *filter, double input, double desired,
+                              const DspKernels *k) {
+    int n = filter->order;
+    size_t stride = filter->stride;
+    const double *x = filter->history + filter->index;  /* x[j] = input[i - j - 1] */
+    double *w = filter->weights;
+    double *P = filter->P;
+    double *u = filter->u;
+
+    // P is symmetric, so row i of P dotted with x is (P x)_i
+    for (int i = 0; i < n; i++) {
+        u[i] = k->dot(P + i * stride, x, n);
+    }
+    double denom = filter->lambda + k->dot(x, u, n);
+    double y = k->dot(w, x, n);
+
+    if (denom > 0.0) {
+        double g = 1.0 / denom;
+        double ge = g * (desired - y);
+        double inv_lambda = 1.0 / filter->lambda;
+        for (int i = 0; i < n; i++) {
+            w[i] += ge * u[i];
+            double *row = P + i * stride;
+            double ui = u[i];
+            for (int j = 0; j < n; j++) {
+                row[j] = (row[j] - ui * u[j] * g) * inv_lambda;
+            }
+        }
+    }
+
+    filter->index = (filter->index == 0 ? n : filter->index) - 1;
+    filter->history[filter->index] = input;
+    filter->history[filter->index + n] = input;
+    return y;
+}
+
+/**
+ * @brief Processes one sample pair.
+ *
+ * @param[in,out] filter  Pointer to RLSFilter.
+ * @param[in]     input   Current input sample.
+ * @param[in]     desired Current desired (reference) sample.
+ *
+ * @returns The prediction from the previous `order` inputs.
+ */
+double rls_filter_process_sample(RLSFilter *filter, double input, double desired) {
+    DSP_PROFILE_BEGIN(DSP_PROF_RLS);
+    double y = rls_step(filter, input, desired, dsp_kernels());
+    DSP_PROFILE_END(DSP_PROF_RLS);
+    return y;
+}
+/* End of rls_filter_process_sample() */
+/******************************************************************************/
+
+/**
+ * @brief Processes a block of sample pairs.
+ *
+ * @param[in,out] filter      Pointer to RLSFilter.
+ * @param[in]     input       Input samples (length: num_samples).
+ * @param[in]     desired     Desired samples (length: num_samples).
+ * @param[out]    output      Predictions (length: num_samples); may alias input.
+ * @param[in]     num_samples Number of samples.
+ */
+void rls_filter_process_block(RLSFilter *filter, const double *input, const double *desired,
+                              double *output, size_t num_samples) {
+    DSP_PROFILE_BEGIN(DSP_PROF_RLS);
+    DspFpState fp;
+    dsp_fp_scope_begin(&fp);
+    const DspKernels *k = dsp_kernels();
+    for (size_t i = 0; i < num_samples; i++) {
+        output[i] = rls_step(filter, input[i], desired[i], k);
+    }
+    dsp_fp_scope_end(&fp);
+    DSP_PROFILE_END(DSP_PROF_RLS);
+}
+/* End of rls_filter_process_block() */
+/******************************************************************************/
+
+/**
+ * @brief Frees memory owned by a streaming RLS filter.
+ *
+ * @param[in,out] filter Pointer to RLSFilter.
+ */
+void rls_filter_free(RLSFilter *filter) {
+    free(filter->owned_mem);
+    filter->owned_mem = NULL;
+    filter->weights = NULL;
+    filter->P = NULL;
+    filter->u = NULL;
+    filter->history = NULL;
+}
+/* End of rls_filter_free() */
+/******************************************************************************/
+
+/******************************************************************************/
+/**
+ * @brief Initializes a fast transversal RLS filter.
+ *
+ * @param[out] filter Pointer to FTRLSFilter struct to initialize.
+ * @param[in]  order  Number of adaptive taps.
+ * @param[in]  lambda Forgetting factor in (0, 1); 1 - 1/(4 order) or closer
+ *                    to 1 keeps the predictors well conditioned.
+ * @param[in]  delta  Initial prediction error energies (> 0), e.g. the input
+ *                    power.
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure.
+ *
+ * @warning Must call ftrls_filter_free() to release memory.
+ */
+int ftrls_filter_init(FTRLSFilter *filter, int order, double lambda, double delta) {
+    filter->weights = NULL;
+    filter->fwd = NULL;
+    filter->bwd = NULL;
+    filter->gain = NULL;
+    filter->history = NULL;
+    filter->pred_history = NULL;
+    filter->owned_mem = NULL;
+    if (order < 1 || !(lambda > 0.0 && lambda < 1.0) || !(delta > 0.0)) return -1;
+
+    void *mem = malloc(ftrls_filter_mem_size(order));
+    if (!mem) return -2;
+    DSP_PROFILE_ALLOC(DSP_PROF_RLS, ftrls_filter_mem_size(order));
+
+    ftrls_filter_init_mem(filter, order, lambda, delta, mem);
+    filter->owned_mem = mem;
+    return 0;
+}
+/* End of ftrls_filter_init() */
+/******************************************************************************/
+
+/**
+ * @brief Bytes of memory ftrls_filter_init_mem() needs.
+ *
+ * @param[in] order Number of adaptive taps.
+ */
+size_t ftrls_filter_mem_size(int order) {
+    if (order < 1) return 0;
+    return 3 * DSP_MEM_ALIGN_UP(order * sizeof(double)) +
+           DSP_MEM_ALIGN_UP((order + 1) * sizeof(double)) +
+           2 * DSP_MEM_ALIGN_UP(2 * (order + 1) * sizeof(double));
+}
+/* End of ftrls_filter_mem_size() */
+/******************************************************************************/
+
+/**
+ * @brief Initializes a fast transversal RLS filter inside caller memory.
+ *
+ * @param[out] filter Pointer to FTRLSFilter struct to initialize.
+ * @param[in]  order  Number of adaptive taps.
+ * @param[in]  lambda Forgetting factor in (0, 1).
+ * @param[in]  delta  Initial prediction error energies (> 0).
+ * @param[in]  mem    At least ftrls_filter_mem_size(order) bytes aligned for
+ *                    double; must outlive the filter.
+ *
+ * @returns 0 on success, -1 on invalid arguments. Performs no allocation.
+ */
+int ftrls_filter_init_mem(FTRLSFilter *filter, int order, double lambda, double delta, void *mem) {
+    filter->owned_mem = NULL;
+    if (order < 1 || !(lambda > 0.0 && lambda < 1.0) || !(delta > 0.0)) return -1;
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, ftrls_filter_mem_size(order));
+    filter->order = order;
+    filter->lambda = lambda;
+    filter->delta = delta;
+    filter->weights = dsp_arena_alloc(&arena, order * sizeof(double));
+    filter->fwd = dsp_arena_alloc(&arena, order * sizeof(double));
+    filter->bwd = dsp_arena_alloc(&arena, order * sizeof(double));
+    filter->gain = dsp_arena_alloc(&arena, (order + 1) * sizeof(double));
+    filter->history = dsp_arena_alloc(&arena, 2 * (order + 1) * sizeof(double));
+    filter->pred_history = dsp_arena_alloc(&arena, 2 * (order + 1) * sizeof(double));
+    ftrls_filter_reset(filter);
+    return 0;
+}
+/* End of ftrls_filter_init_mem() */
+/******************************************************************************/
+
+/* Internal helper: restart the predictors, keeping the weights. The
+ * recursions assume no input before the start, so the predictors get a zeroed
+ * history and the weights pause for order + 1 samples until it is full again.
+ * The error energies restart from delta or from the energy of the past inputs
+ * x[0 .. order] (NULL on reset), whichever is larger: a restart from a delta
+ * far below the signal power tends to diverge again at once. */
+static void ftrls_restart(FTRLSFilter *filter, const double *x) {
+    int n = filter->order;
+    memset(filter->fwd, 0, n * sizeof(double));
+    memset(filter->bwd, 0, n * sizeof(double));
+    memset(filter->gain, 0, (n + 1) * sizeof(double));
+    memset(filter->pred_history, 0, 2 * (n + 1) * sizeof(double));
+    double xi = filter->delta;
+    if (x) {
+        double energy = dsp_kernels()->dot(x, x, n + 1);
+        if (energy > xi) xi = energy;
+    }
+    filter->gamma = 1.0;
+    filter->xi_f = xi;
+    filter->xi_b = xi;
+    filter->warmup = x ? n + 1 : 0;
+}
+
+/**
+ * @brief Zeros the weights, predictors and history.
+ *
+ * @param[in,out] filter Pointer to FTRLSFilter.
+ */
+void ftrls_filter_reset(FTRLSFilter *filter) {
+    int n = filter->order;
+    ftrls_restart(filter, NULL);
+    memset(filter->weights, 0, n * sizeof(double));
+    memset(filter->history, 0, 2 * (n + 1) * sizeof(double));
+    filter->index = 0;
+    filter->rescues = 0;
+}
+/* End of ftrls_filter_reset() */
+/******************************************************************************/
+
+/* Internal helper: one stabilized FTRLS step */
+static inline double ftrls_step(FTRLSFilter *filter, double input, double desired,
+                                const DspKernels *k) {
+    int n = filter->order;
+    double lambda = filter->lambda;
+    const double *x = filter->history + filter->index;  /* x[j] = input[i - j - 1], j <= n */
+    const double *xp = filter->pred_history + filter->index;  /* x, or zeros after a restart */
+    double *w = filter->weights;
+    double *wf = filter->fwd;
+    double *wb = filter->bwd;
+    double *phi = filter->gain;
+
+    // Forward prediction of x[0] from x[1 .. n]
+    double ef = xp[0] - k->dot(wf, xp + 1, n);
+    double eps_f = ef * filter->gamma;
+    double c = ef / (lambda * filter->xi_f);
+    double gamma_inv = 1.0 / filter->gamma + c * ef;
+    filter->xi_f = lambda * filter->xi_f + ef * eps_f;
+
+    // Extended gain [0; phi] + c [1; -wf] (shifted up in place), forward update
+    for (int j = n - 1; j >= 0; j--) {
+        double g = phi[j];
+        phi[j + 1] = g - c * wf[j];
+        wf[j] += g * eps_f;
+    }
+    phi[0] = c;
+
+    // Backward prediction error, computed directly and from the gain
+    double last = phi[n];
+    double eb_direct = xp[n] - k->dot(wb, xp, n);
+    double eb_gain = lambda * filter->xi_b * last;
+    double eb1 = FTRLS_K1 * eb_direct + (1.0 - FTRLS_K1) * eb_gain;
+    double eb2 = FTRLS_K2 * eb_direct + (1.0 - FTRLS_K2) * eb_gain;
+    gamma_inv -= last * eb_direct;
+    double gamma = 1.0 / gamma_inv;
+
+    double y = k->dot(w, x, n);
+    if (!(gamma > 0.0 && gamma <= 1.0)) {
+        ftrls_restart(filter, x);
+        filter->rescues++;
+    } else {
+        filter->gamma = gamma;
+        filter->xi_b = lambda * filter->xi_b + eb2 * gamma * eb2;
+
+        // Drop the extension: phi = phi[0 .. n-1] + last * wb, backward update
+        double eps_b = eb1 * gamma;
+        for (int j = 0; j < n; j++) {
+            double g = phi[j] + last * wb[j];
+            phi[j] = g;
+            wb[j] += g * eps_b;
+        }
+
+        if (filter->warmup > 0) {
+            filter->warmup--;
+        } else {
+            double eps = (desired - y) * gamma;
+            for (int j = 0; j < n; j++) {
+                w[j] += phi[j] * eps;
+            }
+        }
+        if (!(filter->xi_f > 0.0 && filter->xi_b > 0.0)) {
+            ftrls_restart(filter, x);
+            filter->rescues++;
+        }
+    }
+
+    int len = n + 1;
+    filter->index = (filter->index == 0 ? len : filter->index) - 1;
+    filter->history[filter->index] = input;
+    filter->history[filter->index + len] = input;
+    filter->pred_history[filter->index] = input;
+    filter->pred_history[filter->index + len] = input;
+    return y;
+}
+
+/**
+ * @brief Processes one sample pair.
+ *
+ * @param[in,out] filter  Pointer to FTRLSFilter.
+ * @param[in]     input   Current input sample.
+ * @param[in]     desired Current desired (reference) sample.
+ *
+ * @returns The prediction from the previous `order` inputs.
+ */
+double ftrls_filter_process_sample(FTRLSFilter *filter, double input, double desired) {
+    DSP_PROFILE_BEGIN(DSP_PROF_RLS);
+    double y = ftrls_step(filter, input, desired, dsp_kernels());
+    DSP_PROFILE_END(DSP_PROF_RLS);
+    return y;
+}
+/* End of ftrls_filter_process_sample() */
+/******************************************************************************/
+
+/**
+ * @brief Processes a block of sample pairs.
+ *
+ * @param[in,out] filter      Pointer to FTRLSFilter.
+ * @param[in]     input       Input samples (length: num_samples).
+ * @param[in]     desired     Desired samples (length: num_samples).
+ * @param[out]    output      Predictions (length: num_samples); may alias input.
+ * @param[in]     num_samples Number of samples.
+ */
+void ftrls_filter_process_block(FTRLSFilter *filter, const double *input, const double *desired,
+                                double *output, size_t num_samples) {
+    DSP_PROFILE_BEGIN(DSP_PROF_RLS);
+    DspFpState fp;
+    dsp_fp_scope_begin(&fp);
+    const DspKernels *k = dsp_kernels();
+    for (size_t i = 0; i < num_samples; i++) {
+        output[i] = ftrls_step(filter, input[i], desired[i], k);
+    }
+    dsp_fp_scope_end(&fp);
+    DSP_PROFILE_END(DSP_PROF_RLS);
+}
+/* End of ftrls_filter_process_block() */
+/******************************************************************************/
+
+/**
+ * @brief Frees memory owned by a fast transversal RLS filter.
+ *
+ * @param[in,out] filter Pointer to FTRLSFilter.
+ */
+void ftrls_filter_free(FTRLSFilter *filter) {
+    free(filter->owned_mem);
+    filter->owned_mem = NULL;
+    filter->weights = NULL;
+    filter->fwd = NULL;
+    filter->bwd = NULL;
+    filter->gain = NULL;
+    filter->history = NULL;
+    filter->pred_history = NULL;
+}
+/* End of ftrls_filter_free() */
+/******************************************************************************/
@@ -4,17 +4,524 @@
  * Implementation of magnitude spectrogram computation for mono audio signals.
  * Provides functions to compute spectrogram with windowing and FFT, and to free memory.
  *
+ * Bins leave the FFT through spectrogram_convert_bins(), a single fused pass
+ * that produces magnitude, power or dB with optional clamping. Magnitude and
+ * power run on the runtime-dispatched kernels (dsp_cpu.h); dB uses a
+ * vectorized log2 (exponent split plus an atanh series on the mantissa)
+ * evaluated in float, four bins per iteration on SSE2 targets.
+ *
+ * Quantized output (float16, or uint8 dB codes) reuses the same pass: the
+ * uint8 path quantizes the float dB values in registers, and the float16
+ * path converts each 64-bin block while it is still in L1. Neither builds
+ * a double row of the whole frame.
+ *
  * Created on: Jun 16, 2025
  * Author: Omri Kebede
  */
 
 /******************************************************************************/
 /* include block */
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "spectrogram.h"
 #include "fft.h"
 #include "window.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+#include "dsp_profile.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define LOG_SQRT2 1.41421356f
+/* atanh series for log2(m) with t = (m - 1) / (m + 1): 2/ln2 * (t + t^3/3 + t^5/5 + t^7/7) */
+#define LOG2_C1 2.88539008f
+#define LOG2_C3 0.96179669f
+#define LOG2_C5 0.57707801f
+#define LOG2_C7 0.41219858f
+/* 10 * log10(2): dB per octave of power */
+#define DB_PER_LOG2 3.01029996f
+/* float bit patterns for the float16 conversion */
+#define HALF_MAX_BITS 0x477FE000        /* 65504.0f, largest finite float16 */
+#define HALF_MIN_NORMAL_BITS 0x38800000 /* 2^-14, smallest normal float16 */
+#define HALF_DENORM_MAGIC 0x3F000000    /* 0.5f: adding it aligns subnormal mantissas */
+#define HALF_REBIAS 0xC8000FFFu         /* (15 - 127) << 23, plus the rounding bias 0xFFF */
+/* Bins per block of the float16 output path */
+#define QUANT_BLOCK 64
+
+/* Internal helper: fast log2 for positive normal floats. Truncation error of
+ * the series is below 5e-8 for |t| <= 0.1716 (mantissa folded into
+ * [sqrt(1/2), sqrt(2))); with float rounding the result stays within 2e-5 of
+ * log2(x) for x in [1e-20, 1e38], i.e. 6e-5 dB after scaling. */
+static inline float fast_log2f(float x) {
+    union { float f; uint32_t u; } v = { x };
+    float e = (float)((int)(v.u >> 23) - 127);
+    v.u = (v.u & 0x007FFFFF) | 0x3F800000;
+    float m = v.f;
+    if (m > LOG_SQRT2) {
+        m = m - m * 0.5f;
+        e = e + 1.0f;
+    }
+    float t = (m - 1.0f) / (m + 1.0f);
+    float t2 = t * t;
+    return e + t * (LOG2_C1 + t2 * (LOG2_C3 + t2 * (LOG2_C5 + t2 * LOG2_C7)));
+}
+
+/* Internal helper: float16 bits of x, rounded to nearest even; saturates at
+ * +-65504 (infinities and NaN included) and keeps float16 subnormals */
+static inline uint16_t float_to_half(float x) {
+    union { float f; uint32_t u; } v = { x };
+    uint32_t sign = v.u & 0x80000000u;
+    v.u ^= sign;
+    if (v.u > HALF_MAX_BITS) v.u = HALF_MAX_BITS;
+
+    uint32_t h;
+    if (v.u < HALF_MIN_NORMAL_BITS) {
+        union { uint32_t u; float f; } magic = { HALF_DENORM_MAGIC };
+        v.f += magic.f;
+        h = v.u - HALF_DENORM_MAGIC;
+    } else {
+        uint32_t mant_odd = (v.u >> 13) & 1;
+        h = (v.u + HALF_REBIAS + mant_odd) >> 13;
+    }
+    return (uint16_t)(h | (sign >> 16));
+}
+
+/* Internal helper: float value of float16 bits h (exact) */
+static inline float half_to_float(uint16_t h) {
+    union { uint32_t u; float f; } v = { (uint32_t)(h & 0x7FFF) << 13 };
+    union { uint32_t u; float f; } magic = { 113u << 23 };
+    uint32_t exp = v.u & (0x7C00u << 13);
+    v.u += (uint32_t)(127 - 15) << 23;
+    if (exp == 0x7C00u << 13) {
+        v.u += (uint32_t)(128 - 16) << 23; // Inf / NaN
+    } else if (exp == 0) {
+        v.u += 1u << 23; // Subnormal: renormalize
+        v.f -= magic.f;
+    }
+    v.u |= (uint32_t)(h & 0x8000) << 16;
+    return v.f;
+}
+
+/* Internal helper: uint8 code of a dB value, clamped to 0 .. 255 */
+static inline uint8_t db_to_code(float db, float offset, float inv_scale) {
+    float q = (db - offset) * inv_scale;
+    q = q > 0.0f ? q : 0.0f;
+    q = q < 255.0f ? q : 255.0f;
+    return (uint8_t)(int)(q + 0.5f);
+}
+
+/* Internal helper: dB of one bin as computed by the dB output mode */
+static inline float bin_db(const Complex *b) {
+    double v = b->real * b->real + b->imag * b->imag;
+    float f = (float)(v > SPECTROGRAM_DB_MIN_POWER ? v : SPECTROGRAM_DB_MIN_POWER);
+    return fast_log2f(f) * DB_PER_LOG2;
+}
+
+#ifdef __SSE2__
+/* Internal helper: four-lane fast_log2f(), same operations lane by lane */
+static inline __m128 fast_log2_ps(__m128 x) {
+    __m128i xi = _mm_castps_si128(x);
+    __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(xi, 23), _mm_set1_epi32(127)));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(xi, _mm_set1_epi32(0x007FFFFF)),
+                                             _mm_set1_epi32(0x3F800000)));
+    __m128 big = _mm_cmpgt_ps(m, _mm_set1_ps(LOG_SQRT2));
+    m = _mm_sub_ps(m, _mm_and_ps(big, _mm_mul_ps(m, _mm_set1_ps(0.5f))));
+    e = _mm_add_ps(e, _mm_and_ps(big, _mm_set1_ps(1.0f)));
+
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 t = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+    __m128 t2 = _mm_mul_ps(t, t);
+    __m128 poly = _mm_add_ps(_mm_set1_ps(LOG2_C5), _mm_mul_ps(t2, _mm_set1_ps(LOG2_C7)));
+    poly = _mm_add_ps(_mm_set1_ps(LOG2_C3), _mm_mul_ps(t2, poly));
+    poly = _mm_add_ps(_mm_set1_ps(LOG2_C1), _mm_mul_ps(t2, poly));
+    return _mm_add_ps(e, _mm_mul_ps(t, poly));
+}
+
+/* Internal helper: |X|^2 of two adjacent bins */
+static inline __m128d power_pd(const double *p) {
+    __m128d a = _mm_loadu_pd(p);
+    __m128d b = _mm_loadu_pd(p + 2);
+    a = _mm_mul_pd(a, a);
+    b = _mm_mul_pd(b, b);
+    return _mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b));
+}
+
+/* Internal helper: bin_db() of four bins starting at p (interleaved re/im) */
+static inline __m128 db_ps(const double *p) {
+    __m128d vmin_power = _mm_set1_pd(SPECTROGRAM_DB_MIN_POWER);
+    __m128 f = _mm_movelh_ps(_mm_cvtpd_ps(_mm_max_pd(power_pd(p), vmin_power)),
+                             _mm_cvtpd_ps(_mm_max_pd(power_pd(p + 4), vmin_power)));
+    return _mm_mul_ps(fast_log2_ps(f), _mm_set1_ps(DB_PER_LOG2));
+}
+
+/* Internal helper: four-lane float_to_half(), in the low 16 bits of each
+ * 32-bit lane (sign-extended, ready for _mm_packs_epi32) */
+static inline __m128i half_epi32(__m128 x) {
+    __m128i u = _mm_castps_si128(x);
+    __m128i sign = _mm_and_si128(u, _mm_set1_epi32((int)0x80000000u));
+    u = _mm_xor_si128(u, sign);
+    __m128i max = _mm_set1_epi32(HALF_MAX_BITS);
+    __m128i over = _mm_cmpgt_epi32(u, max);
+    u = _mm_or_si128(_mm_and_si128(over, max), _mm_andnot_si128(over, u));
+
+    __m128i magic = _mm_set1_epi32(HALF_DENORM_MAGIC);
+    __m128i denorm = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(u),
+                                                               _mm_castsi128_ps(magic))), magic);
+    __m128i mant_odd = _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(1));
+    __m128i norm = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(u, _mm_set1_epi32((int)HALF_REBIAS)),
+                                                mant_odd), 13);
+    __m128i small = _mm_cmplt_epi32(u, _mm_set1_epi32(HALF_MIN_NORMAL_BITS));
+    __m128i h = _mm_or_si128(_mm_and_si128(small, denorm), _mm_andnot_si128(small, norm));
+    return _mm_or_si128(h, _mm_srai_epi32(sign, 16));
+}
+
+/* Internal helper: four-lane db_to_code() as 32-bit lanes */
+static inline __m128i code_epi32(__m128 db, __m128 offset, __m128 inv_scale) {
+    __m128 q = _mm_mul_ps(_mm_sub_ps(db, offset), inv_scale);
+    q = _mm_min_ps(_mm_max_ps(q, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+    return _mm_cvttps_epi32(_mm_add_ps(q, _mm_set1_ps(0.5f)));
+}
+#endif
+
+/******************************************************************************
+ * spectrogram_options_init
+ *
+ * @param[out] options Options to fill
+ * @param[in]  mode    Output representation
+ *
+ * @note Clamping is disabled; set floor/ceiling afterwards as needed.
+ */
+void spectrogram_options_init(SpectrogramOptions *options, SpectrogramMode mode) {
+    options->mode = mode;
+    options->floor = -HUGE_VAL;
+    options->ceiling = HUGE_VAL;
+}
+/* End of spectrogram_options_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_convert_bins
+ *
+ * @param[in]  bins     FFT output
+ * @param[out] out      Converted values [num_bins]
+ * @param[in]  num_bins Number of bins to convert
+ * @param[in]  options  Mode and clamp range, or NULL for plain magnitude
+ *
+ * @note
+ * - Magnitude and power are exact (bit-identical to complex_mag() and its square).
+ * - dB is 10*log10(max(|X|^2, SPECTROGRAM_DB_MIN_POWER)) with absolute error
+ *   below 1e-4 dB for powers up to 1e38.
+ * - Clamping to [floor, ceiling] happens in output units, in the same pass.
+ */
+void spectrogram_convert_bins(const Complex *bins, double *out, int num_bins,
+                              const SpectrogramOptions *options) {
+    SpectrogramMode mode = options ? options->mode : SPEC_MODE_MAGNITUDE;
+    double lo = options ? options->floor : -HUGE_VAL;
+    double hi = options ? options->ceiling : HUGE_VAL;
+    int k = 0;
+
+    if (mode == SPEC_MODE_MAGNITUDE) {
+        dsp_kernels()->magnitude(bins, out, num_bins, lo, hi);
+        return;
+    }
+    if (mode == SPEC_MODE_POWER) {
+        dsp_kernels()->power(bins, out, num_bins, lo, hi);
+        return;
+    }
+
+#ifdef __SSE2__
+    __m128d vlo = _mm_set1_pd(lo);
+    __m128d vhi = _mm_set1_pd(hi);
+
+    for (; k + 4 <= num_bins; k += 4) {
+        __m128 f = db_ps(&bins[k].real);
+        __m128d v01 = _mm_cvtps_pd(f);
+        __m128d v23 = _mm_cvtps_pd(_mm_movehl_ps(f, f));
+
+        _mm_storeu_pd(out + k, _mm_min_pd(_mm_max_pd(v01, vlo), vhi));
+        _mm_storeu_pd(out + k + 2, _mm_min_pd(_mm_max_pd(v23, vlo), vhi));
+    }
+#endif
+
+    for (; k < num_bins; k++) {
+        double v = bin_db(&bins[k]);
+        if (v < lo) v = lo;
+        if (v > hi) v = hi;
+        out[k] = v;
+    }
+}
+/* End of spectrogram_convert_bins() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_u8_db_range
+ *
+ * @param[in]  options Clamp range [floor, ceiling] in dB
+ * @param[out] scale   dB per code step, (ceiling - floor) / 255
+ * @param[out] offset  dB of code 0 (floor)
+ *
+ * @returns 0 on success, -1 unless floor < ceiling are both finite
+ */
+int spectrogram_u8_db_range(const SpectrogramOptions *options, float *scale, float *offset) {
+    if (!options || !isfinite(options->floor) || !isfinite(options->ceiling) ||
+        !(options->floor < options->ceiling)) return -1;
+    *scale = (float)((options->ceiling - options->floor) / 255.0);
+    *offset = (float)options->floor;
+    return 0;
+}
+/* End of spectrogram_u8_db_range() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_convert_bins_f16
+ *
+ * @param[in]  bins     FFT output
+ * @param[out] out      float16 bit patterns [num_bins]
+ * @param[in]  num_bins Number of bins to convert
+ * @param[in]  options  Mode and clamp range, or NULL for plain magnitude
+ *
+ * @note
+ * - Each value is spectrogram_convert_bins() rounded to float16 (through
+ *   float, nearest even): relative error at most 2^-11 (4.9e-4) for
+ *   magnitudes in [6.1e-5, 65504], absolute error at most 2^-25 (3e-8)
+ *   below that. Values beyond +-65504 saturate, so power of loud bins at
+ *   large FFT sizes clips; magnitude or dB keep the full range.
+ * - Converts QUANT_BLOCK bins at a time through a stack buffer.
+ */
+void spectrogram_convert_bins_f16(const Complex *bins, uint16_t *out, int num_bins,
+                                  const SpectrogramOptions *options) {
+    double block[QUANT_BLOCK];
+    for (int k = 0; k < num_bins; k += QUANT_BLOCK) {
+        int n = num_bins - k < QUANT_BLOCK ? num_bins - k : QUANT_BLOCK;
+        spectrogram_convert_bins(bins + k, block, n, options);
+        spectrogram_double_to_f16(block, out + k, n);
+    }
+}
+/* End of spectrogram_convert_bins_f16() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_convert_bins_u8_db
+ *
+ * @param[in]  bins     FFT output
+ * @param[out] out      Codes [num_bins]; dB = offset + scale * code
+ * @param[in]  num_bins Number of bins to convert
+ * @param[in]  scale    dB per code step (see spectrogram_u8_db_range())
+ * @param[in]  offset   dB of code 0
+ *
+ * @note
+ * - dB is computed as in SPEC_MODE_DB and quantized in the same pass,
+ *   eight bins per iteration on SSE2 targets. Codes equal
+ *   spectrogram_db_to_u8() applied to that mode's output.
+ * - Inside [offset, offset + 255 * scale] the decoded value is within
+ *   scale / 2 + 1e-4 dB of the exact level; outside it clamps to code 0
+ *   or 255.
+ */
+void spectrogram_convert_bins_u8_db(const Complex *bins, uint8_t *out, int num_bins,
+                                    float scale, float offset) {
+    float inv_scale = 1.0f / scale;
+    int k = 0;
+
+#ifdef __SSE2__
+    __m128 voffset = _mm_set1_ps(offset);
+    __m128 vinv = _mm_set1_ps(inv_scale);
+    for (; k + 8 <= num_bins; k += 8) {
+        __m128i lo = code_epi32(db_ps(&bins[k].real), voffset, vinv);
+        __m128i hi = code_epi32(db_ps(&bins[k + 4].real), voffset, vinv);
+        __m128i c16 = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64((__m128i *)(out + k), _mm_packus_epi16(c16, c16));
+    }
+#endif
+
+    for (; k < num_bins; k++) {
+        out[k] = db_to_code(bin_db(&bins[k]), offset, inv_scale);
+    }
+}
+/* End of spectrogram_convert_bins_u8_db() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_double_to_f16 / spectrogram_f16_to_double
+ *
+ * @param[in]  in  Values
+ * @param[out] out Converted values
+ * @param[in]  n   Number of values
+ *
+ * @note Encoding rounds through float to nearest-even float16 and saturates
+ *       at +-65504 (see spectrogram_convert_bins_f16()); decoding is exact.
+ */
+void spectrogram_double_to_f16(const double *in, uint16_t *out, size_t n) {
+    size_t i = 0;
+
+#ifdef __SSE2__
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(in + i)),
+                                 _mm_cvtpd_ps(_mm_loadu_pd(in + i + 2)));
+        __m128 b = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(in + i + 4)),
+                                 _mm_cvtpd_ps(_mm_loadu_pd(in + i + 6)));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(half_epi32(a), half_epi32(b)));
+    }
+#endif
+
+    for (; i < n; i++) {
+        out[i] = float_to_half((float)in[i]);
+    }
+}
+
+void spectrogram_f16_to_double(const uint16_t *in, double *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = half_to_float(in[i]);
+    }
+}
+/* End of spectrogram_double_to_f16() / spectrogram_f16_to_double() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_db_to_u8 / spectrogram_u8_to_db
+ *
+ * @param[in]  in     dB values (encode) or codes (decode)
+ * @param[out] out    Codes (encode) or dB values (decode)
+ * @param[in]  n      Number of values
+ * @param[in]  scale  dB per code step
+ * @param[in]  offset dB of code 0
+ *
+ * @note Encoding rounds (in - offset) / scale to the nearest code, in float,
+ *       and clamps it to 0 .. 255; decoding returns offset + scale * code.
+ */
+void spectrogram_db_to_u8(const double *in, uint8_t *out, size_t n, float scale, float offset) {
+    float inv_scale = 1.0f / scale;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    __m128 voffset = _mm_set1_ps(offset);
+    __m128 vinv = _mm_set1_ps(inv_scale);
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(in + i)),
+                                 _mm_cvtpd_ps(_mm_loadu_pd(in + i + 2)));
+        __m128 b = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(in + i + 4)),
+                                 _mm_cvtpd_ps(_mm_loadu_pd(in + i + 6)));
+        __m128i c16 = _mm_packs_epi32(code_epi32(a, voffset, vinv), code_epi32(b, voffset, vinv));
+        _mm_storel_epi64((__m128i *)(out + i), _mm_packus_epi16(c16, c16));
+    }
+#endif
+
+    for (; i < n; i++) {
+        out[i] = db_to_code((float)in[i], offset, inv_scale);
+    }
+}
+
+void spectrogram_u8_to_db(const uint8_t *in, double *out, size_t n, float scale, float offset) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = offset + (double)scale * in[i];
+    }
+}
+/* End of spectrogram_db_to_u8() / spectrogram_u8_to_db() */
+/******************************************************************************/
+
+/* Internal helper: window the fft_size samples at offset (zero-padded past
+ * the end of wav) into the workspace FFT buffer and transform them */
+static void spectrogram_frame_fft(SpectrogramWorkspace *ws, const WavData *wav, size_t offset,
+                                  const DspKernels *kernels) {
+    int fft_size = ws->fft_size;
+    Complex *fft_buffer = ws->fft_buffer;
+
+    // Apply window and copy samples to FFT buffer, zero-padding past the end
+    DSP_PROFILE_BEGIN(DSP_PROF_SPEC_WINDOW);
+    size_t left = wav->num_samples > offset ? wav->num_samples - offset : 0;
+    int avail = left < (size_t)fft_size ? (int)left : fft_size;
+    kernels->window_s16(wav->samples + offset, ws->window, fft_buffer, avail);
+    memset(fft_buffer + avail, 0, (fft_size - avail) * sizeof(Complex));
+    DSP_PROFILE_END(DSP_PROF_SPEC_WINDOW);
+
+    // Perform FFT
+    DSP_PROFILE_BEGIN(DSP_PROF_SPEC_FFT);
+    fft_execute(&ws->plan, fft_buffer);
+    DSP_PROFILE_END(DSP_PROF_SPEC_FFT);
+}
+
+/* Internal helper: frame loop shared by every spectrogram entry point.
+ * Frame f goes to rows[f] when rows is given, to flat + f * num_bins when
+ * flat is given, otherwise to the workspace row handed to fn. Returns the
+ * number of frames processed; performs no allocation. */
+static int spectrogram_frames(SpectrogramWorkspace *ws,
+                              const WavData *wav,
+                              int hop_size,
+                              const SpectrogramOptions *options,
+                              int num_frames,
+                              double **rows,
+                              double *flat,
+                              SpectrogramFrameFn fn,
+                              void *user) {
+    int num_bins = ws->num_bins;
+    const DspKernels *kernels = dsp_kernels();
+
+    int frame;
+    for (frame = 0; frame < num_frames; frame++) {
+        double *out = rows ? rows[frame] : flat ? flat + (size_t)frame * num_bins : ws->row;
+        spectrogram_frame_fft(ws, wav, (size_t)frame * hop_size, kernels);
+
+        // Convert every bin to the requested representation in one pass
+        DSP_PROFILE_BEGIN(DSP_PROF_SPEC_MAGNITUDE);
+        spectrogram_convert_bins(ws->fft_buffer, out, num_bins, options);
+        DSP_PROFILE_END(DSP_PROF_SPEC_MAGNITUDE);
+
+        if (fn && fn(frame, out, num_bins, user) != 0) {
+            frame++;
+            break;
+        }
+    }
+    return frame;
+}
+
+/* Internal helper: frame loop of the quantized outputs; frame f goes to
+ * out + f * num_bins elements of the type's size */
+static void spectrogram_frames_quantized(SpectrogramWorkspace *ws, const WavData *wav,
+                                         int hop_size, const SpectrogramOptions *options,
+                                         SpectrogramQuantType type, float scale, float offset,
+                                         int num_frames, void *out) {
+    int num_bins = ws->num_bins;
+    const DspKernels *kernels = dsp_kernels();
+
+    for (int frame = 0; frame < num_frames; frame++) {
+        spectrogram_frame_fft(ws, wav, (size_t)frame * hop_size, kernels);
+
+        // Convert and quantize every bin in one pass
+        DSP_PROFILE_BEGIN(DSP_PROF_SPEC_MAGNITUDE);
+        size_t row = (size_t)frame * num_bins;
+        if (type == SPEC_QUANT_F16) {
+            spectrogram_convert_bins_f16(ws->fft_buffer, (uint16_t *)out + row, num_bins, options);
+        } else {
+            spectrogram_convert_bins_u8_db(ws->fft_buffer, (uint8_t *)out + row, num_bins,
+                                           scale, offset);
+        }
+        DSP_PROFILE_END(DSP_PROF_SPEC_MAGNITUDE);
+    }
+}
+
+/* Internal helper: bytes per element of a quantized type, 0 if unknown */
+static size_t quant_elem_size(SpectrogramQuantType type) {
+    switch (type) {
+        case SPEC_QUANT_F16: return sizeof(uint16_t);
+        case SPEC_QUANT_U8_DB: return sizeof(uint8_t);
+        default: return 0;
+    }
+}
+
+/* Internal helper: scale/offset for type (0 for float16); returns 0 or -1 */
+static int quant_params(SpectrogramQuantType type, const SpectrogramOptions *options,
+                        float *scale, float *offset) {
+    *scale = 0.0f;
+    *offset = 0.0f;
+    if (quant_elem_size(type) == 0) return -1;
+    if (type == SPEC_QUANT_U8_DB) return spectrogram_u8_db_range(options, scale, offset);
+    return 0;
+}
 
 /******************************************************************************
  * compute_spectrogram
@@ -43,54 +550,382 @@ double **compute_spectrogram(const WavData *wav,
                              WindowType window_type,
                              int *out_num_frames,
                              int *out_num_bins) {
+    return compute_spectrogram_ex(wav, fft_size, hop_size, window_type, NULL,
+                                  out_num_frames, out_num_bins);
+}
+/* End of compute_spectrogram() */
+/******************************************************************************/
+
+/******************************************************************************
+ * compute_spectrogram_ex
+ *
+ * @param[in]  wav            Pointer to WavData struct (must be mono)
+ * @param[in]  fft_size       FFT window size (power of two)
+ * @param[in]  hop_size       Hop size between frames
+ * @param[in]  window_type    Type of window to apply
+ * @param[in]  options        Output mode and clamp range, or NULL for magnitude
+ * @param[out] out_num_frames Pointer to store number of time frames
+ * @param[out] out_num_bins   Pointer to store number of frequency bins
+ *
+ * @returns 2D array [num_frames][num_bins] in the requested representation,
+ *          or NULL on error; free with free_spectrogram()
+ *
+ * @note Power and dB skip the square root; dB replaces a separate 20*log10
+ *       pass over the magnitudes (see spectrogram_convert_bins()).
+ */
+double **compute_spectrogram_ex(const WavData *wav,
+                                int fft_size,
+                                int hop_size,
+                                WindowType window_type,
+                                const SpectrogramOptions *options,
+                                int *out_num_frames,
+                                int *out_num_bins) {
     if (wav->num_channels != 1) return NULL;
+    DSP_PROFILE_BEGIN(DSP_PROF_SPECTROGRAM);
 
-    int num_samples = wav->num_samples;
-    int num_frames = 1 + (num_samples - fft_size) / hop_size;
+    int num_frames = spectrogram_frame_count(wav, fft_size, hop_size);
     int num_bins = fft_size / 2 + 1;
 
+    SpectrogramWorkspace ws;
+    if (spectrogram_workspace_init(&ws, fft_size, window_type) != 0) {
+        DSP_PROFILE_END(DSP_PROF_SPECTROGRAM);
+        return NULL;
+    }
+
     // Allocate spectrogram 2D array [num_frames][num_bins]
     double **spectrogram = malloc(num_frames * sizeof(double *));
     for (int i = 0; i < num_frames; i++) {
         spectrogram[i] = calloc(num_bins, sizeof(double));
     }
+    DSP_PROFILE_ALLOC(DSP_PROF_SPECTROGRAM,
+                      num_frames * (sizeof(double *) + num_bins * sizeof(double)) +
+                      spectrogram_workspace_mem_size(fft_size));
 
-    // Allocate and generate window coefficients
-    double *window = malloc(sizeof(double) * fft_size);
-    generate_window(window, fft_size, window_type);
+    spectrogram_frames(&ws, wav, hop_size, options, num_frames, spectrogram, NULL, NULL, NULL);
+    spectrogram_workspace_free(&ws);
 
-    // Allocate FFT buffer
-    Complex *fft_buffer = malloc(sizeof(Complex) * fft_size);
+    *out_num_frames = num_frames;
+    *out_num_bins = num_bins;
 
-    for (int frame = 0; frame < num_frames; frame++) {
-        int offset = frame * hop_size;
-
-        // Apply window and copy samples to FFT buffer
-        for (int i = 0; i < fft_size; i++) {
-            int idx = offset + i;
-            double sample = (idx < num_samples) ? wav->samples[idx] / 32768.0 : 0.0;
-            fft_buffer[i].real = sample * window[i];
-            fft_buffer[i].imag = 0.0;
-        }
+    DSP_PROFILE_END(DSP_PROF_SPECTROGRAM);
+    return spectrogram;
+}
+/* End of compute_spectrogram_ex() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_for_each_frame
+ *
+ * @param[in] wav         Pointer to WavData struct (must be mono)
+ * @param[in] fft_size    FFT window size (power of two)
+ * @param[in] hop_size    Hop size between frames
+ * @param[in] window_type Type of window to apply
+ * @param[in] options     Output mode and clamp range, or NULL for magnitude
+ * @param[in] fn          Called once per frame with num_bins values
+ * @param[in] user        Opaque pointer passed to fn
+ *
+ * @returns Number of frames delivered, or -1 on error
+ *
+ * @note
+ * - Same framing and values as compute_spectrogram(), but only one row is
+ *   held in memory; the row pointer is only valid during the callback.
+ * - A non-zero return from fn stops the analysis after that frame.
+ * - Allocates a temporary workspace; see
+ *   spectrogram_workspace_for_each_frame() for the allocation-free form.
+ */
+int spectrogram_for_each_frame(const WavData *wav,
+                               int fft_size,
+                               int hop_size,
+                               WindowType window_type,
+                               const SpectrogramOptions *options,
+                               SpectrogramFrameFn fn,
+                               void *user) {
+    SpectrogramWorkspace ws;
+    if (spectrogram_workspace_init(&ws, fft_size, window_type) != 0) return -1;
+    DSP_PROFILE_ALLOC(DSP_PROF_SPECTROGRAM, spectrogram_workspace_mem_size(fft_size));
 
-        // Perform FFT
-        fft(fft_buffer, fft_size);
+    int ret = spectrogram_workspace_for_each_frame(&ws, wav, hop_size, options, fn, user);
+    spectrogram_workspace_free(&ws);
+    return ret;
+}
+/* End of spectrogram_for_each_frame() */
+/******************************************************************************/
 
-        // Calculate magnitude spectrum for each bin
-        for (int bin = 0; bin < num_bins; bin++) {
-            spectrogram[frame][bin] = complex_mag(fft_buffer[bin]);
-        }
+/******************************************************************************
+ * spectrogram_frame_count
+ *
+ * @param[in] wav      Pointer to WavData struct
+ * @param[in] fft_size FFT window size
+ * @param[in] hop_size Hop size between frames
+ *
+ * @returns Number of complete frames, 0 when wav is shorter than one frame,
+ *          saturated at INT_MAX for very long captures
+ */
+int spectrogram_frame_count(const WavData *wav, int fft_size, int hop_size) {
+    if (fft_size < 1 || hop_size < 1 || wav->num_samples < (size_t)fft_size) return 0;
+    size_t frames = 1 + (wav->num_samples - fft_size) / hop_size;
+    return frames > INT_MAX ? INT_MAX : (int)frames;
+}
+/* End of spectrogram_frame_count() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_workspace_init
+ *
+ * @param[out] ws          Pointer to SpectrogramWorkspace to initialize
+ * @param[in]  fft_size    FFT window size (power of two)
+ * @param[in]  window_type Type of window to apply
+ *
+ * @returns 0 on success, -1 on invalid size, -2 on allocation failure
+ *
+ * @warning Must call spectrogram_workspace_free() to release memory.
+ */
+int spectrogram_workspace_init(SpectrogramWorkspace *ws, int fft_size, WindowType window_type) {
+    ws->owned_mem = NULL;
+    size_t size = spectrogram_workspace_mem_size(fft_size);
+    if (size == 0) return -1;
+
+    void *mem = malloc(size);
+    if (!mem) return -2;
+    spectrogram_workspace_init_mem(ws, fft_size, window_type, mem);
+    ws->owned_mem = mem;
+    return 0;
+}
+/* End of spectrogram_workspace_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_workspace_mem_size
+ *
+ * @param[in] fft_size FFT window size (power of two)
+ *
+ * @returns Bytes of memory spectrogram_workspace_init_mem() needs, 0 when
+ *          fft_size is not a power of two
+ */
+size_t spectrogram_workspace_mem_size(int fft_size) {
+    size_t plan_size = fft_plan_mem_size(fft_size);
+    if (plan_size == 0) return 0;
+    return plan_size +
+           DSP_MEM_ALIGN_UP(fft_size * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(fft_size * sizeof(Complex)) +
+           DSP_MEM_ALIGN_UP((fft_size / 2 + 1) * sizeof(double));
+}
+/* End of spectrogram_workspace_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_workspace_init_mem
+ *
+ * @param[out] ws          Pointer to SpectrogramWorkspace to initialize
+ * @param[in]  fft_size    FFT window size (power of two)
+ * @param[in]  window_type Type of window to apply
+ * @param[in]  mem         At least spectrogram_workspace_mem_size(fft_size)
+ *                         bytes aligned for double; must outlive ws
+ *
+ * @returns 0 on success, -1 on invalid size
+ *
+ * @note Builds the FFT plan and the window inside mem; performs no allocation.
+ */
+int spectrogram_workspace_init_mem(SpectrogramWorkspace *ws, int fft_size,
+                                   WindowType window_type, void *mem) {
+    ws->owned_mem = NULL;
+    size_t size = spectrogram_workspace_mem_size(fft_size);
+    if (size == 0) return -1;
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, size);
+    size_t plan_size = fft_plan_mem_size(fft_size);
+    fft_plan_init_mem(&ws->plan, fft_size, dsp_arena_alloc(&arena, plan_size));
+
+    ws->fft_size = fft_size;
+    ws->num_bins = fft_size / 2 + 1;
+    ws->window_type = window_type;
+    ws->window = dsp_arena_alloc(&arena, fft_size * sizeof(double));
+    ws->fft_buffer = dsp_arena_alloc(&arena, fft_size * sizeof(Complex));
+    ws->row = dsp_arena_alloc(&arena, ws->num_bins * sizeof(double));
+    generate_window(ws->window, fft_size, window_type);
+    return 0;
+}
+/* End of spectrogram_workspace_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_compute_into
+ *
+ * @param[in,out] ws         Workspace (fixes the FFT size and window)
+ * @param[in]     wav        Pointer to WavData struct (must be mono)
+ * @param[in]     hop_size   Hop size between frames
+ * @param[in]     options    Output mode and clamp range, or NULL for magnitude
+ * @param[out]    out        Row-major output [max_frames][num_bins]
+ * @param[in]     max_frames Rows available in out
+ *
+ * @returns Frames written (at most max_frames, see spectrogram_frame_count()),
+ *          or -1 on invalid arguments
+ *
+ * @note Same values as compute_spectrogram_ex(); performs no allocation.
+ */
+int spectrogram_compute_into(SpectrogramWorkspace *ws, const WavData *wav, int hop_size,
+                             const SpectrogramOptions *options, double *out, int max_frames) {
+    if (wav->num_channels != 1 || hop_size < 1 || max_frames < 0) return -1;
+    DSP_PROFILE_BEGIN(DSP_PROF_SPECTROGRAM);
+
+    int num_frames = spectrogram_frame_count(wav, ws->fft_size, hop_size);
+    if (num_frames > max_frames) num_frames = max_frames;
+    int ret = spectrogram_frames(ws, wav, hop_size, options, num_frames, NULL, out, NULL, NULL);
+
+    DSP_PROFILE_END(DSP_PROF_SPECTROGRAM);
+    return ret;
+}
+/* End of spectrogram_compute_into() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_workspace_for_each_frame
+ *
+ * @param[in,out] ws       Workspace (fixes the FFT size and window)
+ * @param[in]     wav      Pointer to WavData struct (must be mono)
+ * @param[in]     hop_size Hop size between frames
+ * @param[in]     options  Output mode and clamp range, or NULL for magnitude
+ * @param[in]     fn       Called once per frame with num_bins values
+ * @param[in]     user     Opaque pointer passed to fn
+ *
+ * @returns Number of frames delivered, or -1 on error
+ *
+ * @note Same contract as spectrogram_for_each_frame(); performs no allocation.
+ */
+int spectrogram_workspace_for_each_frame(SpectrogramWorkspace *ws, const WavData *wav,
+                                         int hop_size, const SpectrogramOptions *options,
+                                         SpectrogramFrameFn fn, void *user) {
+    if (wav->num_channels != 1 || !fn || hop_size < 1) return -1;
+    DSP_PROFILE_BEGIN(DSP_PROF_SPECTROGRAM);
+
+    int num_frames = spectrogram_frame_count(wav, ws->fft_size, hop_size);
+    int ret = spectrogram_frames(ws, wav, hop_size, options, num_frames, NULL, NULL, fn, user);
+
+    DSP_PROFILE_END(DSP_PROF_SPECTROGRAM);
+    return ret;
+}
+/* End of spectrogram_workspace_for_each_frame() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_workspace_free
+ *
+ * @param[in,out] ws Workspace; caller memory from spectrogram_workspace_init_mem()
+ *                   is left alone
+ */
+void spectrogram_workspace_free(SpectrogramWorkspace *ws) {
+    free(ws->owned_mem);
+    ws->owned_mem = NULL;
+    ws->window = NULL;
+    ws->fft_buffer = NULL;
+    ws->row = NULL;
+}
+/* End of spectrogram_workspace_free() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spectrogram_compute_into_quantized
+ *
+ * @param[in,out] ws         Workspace (fixes the FFT size and window)
+ * @param[in]     wav        Pointer to WavData struct (must be mono)
+ * @param[in]     hop_size   Hop size between frames
+ * @param[in]     options    Float16: mode and clamp range (NULL for magnitude).
+ *                           uint8 dB: the code range [floor, ceiling]
+ * @param[in]     type       SPEC_QUANT_F16 or SPEC_QUANT_U8_DB
+ * @param[out]    out        Row-major uint16_t or uint8_t [max_frames][num_bins]
+ * @param[in]     max_frames Rows available in out
+ *
+ * @returns Frames written (at most max_frames), or -1 on invalid arguments
+ *
+ * @note Performs no allocation. uint8 codes decode with the scale and offset
+ *       of spectrogram_u8_db_range().
+ */
+int spectrogram_compute_into_quantized(SpectrogramWorkspace *ws, const WavData *wav,
+                                       int hop_size, const SpectrogramOptions *options,
+                                       SpectrogramQuantType type, void *out, int max_frames) {
+    float scale, offset;
+    if (wav->num_channels != 1 || hop_size < 1 || max_frames < 0 ||
+        quant_params(type, options, &scale, &offset) != 0) return -1;
+    DSP_PROFILE_BEGIN(DSP_PROF_SPECTROGRAM);
+
+    int num_frames = spectrogram_frame_count(wav, ws->fft_size, hop_size);
+    if (num_frames > max_frames) num_frames = max_frames;
+    spectrogram_frames_quantized(ws, wav, hop_size, options, type, scale, offset, num_frames, out);
+
+    DSP_PROFILE_END(DSP_PROF_SPECTROGRAM);
+    return num_frames;
+}
+/* End of spectrogram_compute_into_quantized() */
+/******************************************************************************/
+
+/******************************************************************************
+ * compute_spectrogram_quantized
+ *
+ * @param[in]  wav         Pointer to WavData struct (must be mono)
+ * @param[in]  fft_size    FFT window size (power of two)
+ * @param[in]  hop_size    Hop size between frames
+ * @param[in]  window_type Type of window to apply
+ * @param[in]  options     As for spectrogram_compute_into_quantized()
+ * @param[in]  type        SPEC_QUANT_F16 or SPEC_QUANT_U8_DB
+ * @param[out] out         Quantized spectrogram in one block
+ *
+ * @returns 0 on success, -1 on invalid arguments or a signal shorter than
+ *          one frame, -2 on allocation failure
+ *
+ * @note Storage is 2 (float16) or 1 (uint8) bytes per bin, against 8 for
+ *       compute_spectrogram(). Free with free_quantized_spectrogram().
+ */
+int compute_spectrogram_quantized(const WavData *wav, int fft_size, int hop_size,
+                                  WindowType window_type, const SpectrogramOptions *options,
+                                  SpectrogramQuantType type, QuantizedSpectrogram *out) {
+    memset(out, 0, sizeof(*out));
+    float scale, offset;
+    if (wav->num_channels != 1 || hop_size < 1 ||
+        quant_params(type, options, &scale, &offset) != 0) return -1;
+    int num_frames = spectrogram_frame_count(wav, fft_size, hop_size);
+    if (num_frames < 1) return -1;
+    DSP_PROFILE_BEGIN(DSP_PROF_SPECTROGRAM);
+
+    SpectrogramWorkspace ws;
+    int num_bins = fft_size / 2 + 1;
+    size_t bytes = (size_t)num_frames * num_bins * quant_elem_size(type);
+    int ret = spectrogram_workspace_init(&ws, fft_size, window_type);
+    void *data = ret == 0 ? malloc(bytes) : NULL;
+    if (!data) {
+        if (ret == 0) spectrogram_workspace_free(&ws);
+        DSP_PROFILE_END(DSP_PROF_SPECTROGRAM);
+        return ret != 0 ? ret : -2;
     }
+    DSP_PROFILE_ALLOC(DSP_PROF_SPECTROGRAM, bytes + spectrogram_workspace_mem_size(fft_size));
 
-    free(window);
-    free(fft_buffer);
+    spectrogram_frames_quantized(&ws, wav, hop_size, options, type, scale, offset, num_frames, data);
+    spectrogram_workspace_free(&ws);
 
-    *out_num_frames = num_frames;
-    *out_num_bins = num_bins;
+    out->type = type;
+    out->num_frames = num_frames;
+    out->num_bins = num_bins;
+    out->scale = scale;
+    out->offset = offset;
+    out->data = data;
 
-    return spectrogram;
+    DSP_PROFILE_END(DSP_PROF_SPECTROGRAM);
+    return 0;
 }
-/* End of compute_spectrogram() */
+/* End of compute_spectrogram_quantized() */
+/******************************************************************************/
+
+/******************************************************************************
+ * free_quantized_spectrogram
+ *
+ * @param[in,out] q Spectrogram from compute_spectrogram_quantized()
+ */
+void free_quantized_spectrogram(QuantizedSpectrogram *q) {
+    free(q->data);
+    q->data = NULL;
+    q->num_frames = 0;
+}
+/* End of free_quantized_spectrogram() */
 /******************************************************************************/
 
 /******************************************************************************
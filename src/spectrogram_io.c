@@ -0,0 +1,384 @@
+/*
+ * @file spectrogram_io.c
+ *
+ * Writer and memory-mapped reader for the binary spectrogram container
+ * described in spectrogram_io.h.
+ *
+ * The writer emits the header up front with num_frames = 0, appends frames
+ * as they arrive and patches the count on close, so it can sit directly
+ * behind spectrogram_for_each_frame() without buffering the spectrogram.
+ * The reader maps the file read-only (POSIX mmap) and hands out pointers
+ * into the mapping; nothing is parsed or copied per frame.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "spectrogram_io.h"
+#include "spectrogram.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define SPEC_PAYLOAD_ALIGN 64
+
+/* Internal helpers: little-endian field encoding */
+static void put_u16(unsigned char *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+}
+
+static void put_u32(unsigned char *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+static void put_u64(unsigned char *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+static uint16_t get_u16(const unsigned char *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_u64(const unsigned char *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static void put_f32(unsigned char *p, float f) {
+    union { float f; uint32_t u; } v = { f };
+    put_u32(p, v.u);
+}
+
+static float get_f32(const unsigned char *p) {
+    union { uint32_t u; float f; } v = { get_u32(p) };
+    return v.f;
+}
+
+/* Internal helper: bytes per payload element, 0 for an unknown dtype */
+static size_t dtype_size(SpecDtype dtype) {
+    switch (dtype) {
+        case SPEC_DTYPE_F32: return sizeof(float);
+        case SPEC_DTYPE_F64: return sizeof(double);
+        case SPEC_DTYPE_F16: return sizeof(uint16_t);
+        case SPEC_DTYPE_U8_DB: return sizeof(uint8_t);
+        default: return 0;
+    }
+}
+
+/* Internal helper: serialize the header */
+static void encode_header(unsigned char *h, const SpecFileInfo *info) {
+    memset(h, 0, SPEC_FILE_HEADER_SIZE);
+    memcpy(h, "DSPS", 4);
+    put_u16(h + 4, SPEC_FILE_VERSION);
+    put_u16(h + 6, (uint16_t)info->dtype);
+    put_u32(h + 8, (uint32_t)info->sample_rate);
+    put_u32(h + 12, (uint32_t)info->fft_size);
+    put_u32(h + 16, (uint32_t)info->hop_size);
+    put_u32(h + 20, (uint32_t)info->window_type);
+    put_u32(h + 24, (uint32_t)info->num_bins);
+    put_u64(h + 32, info->num_frames);
+    put_u64(h + 40, SPEC_FILE_HEADER_SIZE);
+    put_f32(h + 48, info->scale);
+    put_f32(h + 52, info->offset);
+}
+
+/******************************************************************************
+ * spec_writer_open
+ *
+ * @param[out] w    Pointer to SpecWriter struct to initialize
+ * @param[in]  path Output file path
+ * @param[in]  info Metadata; num_frames is ignored (counted while writing)
+ *
+ * @returns 0 on success, -1 on invalid metadata (including a uint8 dB file
+ *          without a positive scale), -2 if the file cannot be created or
+ *          its header cannot be written (the file is then removed),
+ *          -3 on allocation failure
+ *
+ * @warning Must call spec_writer_close() or the frame count stays 0.
+ */
+int spec_writer_open(SpecWriter *w, const char *path, const SpecFileInfo *info) {
+    if (!info || info->num_bins < 1 || dtype_size(info->dtype) == 0) return -1;
+    if (info->dtype == SPEC_DTYPE_U8_DB && !(info->scale > 0.0f)) return -1;
+
+    w->info = *info;
+    w->info.num_frames = 0;
+    if (info->dtype != SPEC_DTYPE_U8_DB) {
+        w->info.scale = 0.0f;
+        w->info.offset = 0.0f;
+    }
+    w->row = NULL;
+
+    if (info->dtype != SPEC_DTYPE_F64) {
+        w->row = malloc(info->num_bins * dtype_size(info->dtype));
+        if (!w->row) return -3;
+    }
+
+    w->f = fopen(path, "wb");
+    if (!w->f) {
+        free(w->row);
+        w->row = NULL;
+        return -2;
+    }
+
+    unsigned char header[SPEC_FILE_HEADER_SIZE];
+    encode_header(header, &w->info);
+    if (fwrite(header, 1, SPEC_FILE_HEADER_SIZE, w->f) != SPEC_FILE_HEADER_SIZE ||
+        fflush(w->f) != 0) {
+        fclose(w->f);
+        unlink(path);
+        free(w->row);
+        w->row = NULL;
+        w->f = NULL;
+        return -2;
+    }
+    return 0;
+}
+/* End of spec_writer_open() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spec_writer_write_frame
+ *
+ * @param[in,out] w    Pointer to open SpecWriter
+ * @param[in]     bins num_bins values
+ *
+ * @returns 0 on success, -1 on write failure
+ *
+ * @note float32 files round each value to nearest float, float16 files use
+ *       spectrogram_double_to_f16() and uint8 dB files spectrogram_db_to_u8()
+ *       with the header scale and offset (bins must then be in dB).
+ */
+int spec_writer_write_frame(SpecWriter *w, const double *bins) {
+    size_t n = (size_t)w->info.num_bins;
+
+    switch (w->info.dtype) {
+        case SPEC_DTYPE_F32: {
+            float *row = w->row;
+            for (size_t i = 0; i < n; i++) {
+                row[i] = (float)bins[i];
+            }
+            break;
+        }
+        case SPEC_DTYPE_F16:
+            spectrogram_double_to_f16(bins, w->row, n);
+            break;
+        case SPEC_DTYPE_U8_DB:
+            spectrogram_db_to_u8(bins, w->row, n, w->info.scale, w->info.offset);
+            break;
+        default:
+            return spec_writer_write_raw(w, bins);
+    }
+    return spec_writer_write_raw(w, w->row);
+}
+/* End of spec_writer_write_frame() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spec_writer_write_raw
+ *
+ * @param[in,out] w   Pointer to open SpecWriter
+ * @param[in]     row num_bins values in the file dtype
+ *
+ * @returns 0 on success, -1 on write failure
+ */
+int spec_writer_write_raw(SpecWriter *w, const void *row) {
+    size_t n = (size_t)w->info.num_bins;
+    if (fwrite(row, dtype_size(w->info.dtype), n, w->f) != n) return -1;
+    w->info.num_frames++;
+    return 0;
+}
+/* End of spec_writer_write_raw() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spec_writer_close
+ *
+ * @param[in,out] w Pointer to open SpecWriter
+ *
+ * @returns 0 on success, -1 if the header could not be updated
+ */
+int spec_writer_close(SpecWriter *w) {
+    if (!w->f) return -1;
+
+    unsigned char header[SPEC_FILE_HEADER_SIZE];
+    encode_header(header, &w->info);
+
+    int ret = 0;
+    if (fseek(w->f, 0, SEEK_SET) != 0 ||
+        fwrite(header, 1, SPEC_FILE_HEADER_SIZE, w->f) != SPEC_FILE_HEADER_SIZE) {
+        ret = -1;
+    }
+    if (fclose(w->f) != 0) ret = -1;
+
+    free(w->row);
+    w->row = NULL;
+    w->f = NULL;
+    return ret;
+}
+/* End of spec_writer_close() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spec_reader_open
+ *
+ * @param[out] r    Pointer to SpecReader struct to initialize
+ * @param[in]  path File path
+ *
+ * @returns 0 on success, -1 if the file cannot be opened or mapped,
+ *          -2 on a bad header, -3 if the file is truncated
+ *
+ * @warning Must call spec_reader_close() to unmap the file.
+ */
+int spec_reader_open(SpecReader *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < SPEC_FILE_HEADER_SIZE) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    const unsigned char *h = map;
+    SpecFileInfo info;
+    info.dtype = (SpecDtype)get_u16(h + 6);
+    info.sample_rate = (int)get_u32(h + 8);
+    info.fft_size = (int)get_u32(h + 12);
+    info.hop_size = (int)get_u32(h + 16);
+    info.window_type = (WindowType)get_u32(h + 20);
+    info.num_bins = (int)get_u32(h + 24);
+    info.num_frames = get_u64(h + 32);
+    uint64_t payload_offset = get_u64(h + 40);
+    info.scale = get_f32(h + 48);
+    info.offset = get_f32(h + 52);
+
+    if (memcmp(h, "DSPS", 4) != 0 || get_u16(h + 4) != SPEC_FILE_VERSION ||
+        dtype_size(info.dtype) == 0 || info.num_bins < 1 ||
+        payload_offset % SPEC_PAYLOAD_ALIGN != 0) {
+        munmap(map, (size_t)st.st_size);
+        return -2;
+    }
+
+    size_t row_bytes = (size_t)info.num_bins * dtype_size(info.dtype);
+    // Compared by division so crafted sizes cannot wrap around
+    uint64_t file_size = (uint64_t)st.st_size;
+    if (payload_offset > file_size ||
+        info.num_frames > (file_size - payload_offset) / row_bytes) {
+        munmap(map, (size_t)st.st_size);
+        return -3;
+    }
+
+    r->info = info;
+    r->map = map;
+    r->map_size = (size_t)st.st_size;
+    r->payload = (const unsigned char *)map + payload_offset;
+    r->row_bytes = row_bytes;
+    return 0;
+}
+/* End of spec_reader_open() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spec_reader_frame_f32 / spec_reader_frame_f64 / spec_reader_frame_f16 /
+ * spec_reader_frame_u8
+ *
+ * @param[in] r     Pointer to open SpecReader
+ * @param[in] frame Frame index
+ *
+ * @returns Pointer into the mapping, or NULL on dtype mismatch or when the
+ *          frame is out of range
+ */
+const float *spec_reader_frame_f32(const SpecReader *r, uint64_t frame) {
+    if (r->info.dtype != SPEC_DTYPE_F32 || frame >= r->info.num_frames) return NULL;
+    return (const float *)(r->payload + frame * r->row_bytes);
+}
+
+const double *spec_reader_frame_f64(const SpecReader *r, uint64_t frame) {
+    if (r->info.dtype != SPEC_DTYPE_F64 || frame >= r->info.num_frames) return NULL;
+    return (const double *)(r->payload + frame * r->row_bytes);
+}
+
+const uint16_t *spec_reader_frame_f16(const SpecReader *r, uint64_t frame) {
+    if (r->info.dtype != SPEC_DTYPE_F16 || frame >= r->info.num_frames) return NULL;
+    return (const uint16_t *)(r->payload + frame * r->row_bytes);
+}
+
+const uint8_t *spec_reader_frame_u8(const SpecReader *r, uint64_t frame) {
+    if (r->info.dtype != SPEC_DTYPE_U8_DB || frame >= r->info.num_frames) return NULL;
+    return r->payload + frame * r->row_bytes;
+}
+
+/******************************************************************************
+ * spec_reader_read_frame
+ *
+ * @param[in]  r     Pointer to open SpecReader
+ * @param[in]  frame Frame index
+ * @param[out] out   num_bins values
+ *
+ * @returns 0 on success, -1 if the frame is out of range
+ *
+ * @note uint8 dB frames decode to offset + scale * code.
+ */
+int spec_reader_read_frame(const SpecReader *r, uint64_t frame, double *out) {
+    if (frame >= r->info.num_frames) return -1;
+    size_t n = (size_t)r->info.num_bins;
+
+    switch (r->info.dtype) {
+        case SPEC_DTYPE_F32: {
+            const float *row = spec_reader_frame_f32(r, frame);
+            for (size_t i = 0; i < n; i++) {
+                out[i] = row[i];
+            }
+            break;
+        }
+        case SPEC_DTYPE_F16:
+            spectrogram_f16_to_double(spec_reader_frame_f16(r, frame), out, n);
+            break;
+        case SPEC_DTYPE_U8_DB:
+            spectrogram_u8_to_db(spec_reader_frame_u8(r, frame), out, n,
+                                 r->info.scale, r->info.offset);
+            break;
+        default:
+            memcpy(out, spec_reader_frame_f64(r, frame), r->row_bytes);
+            break;
+    }
+    return 0;
+}
+/* End of spec_reader_read_frame() */
+/******************************************************************************/
+
+/******************************************************************************
+ * spec_reader_close
+ *
+ * @param[in,out] r Pointer to SpecReader
+ *
+ * @note Pointers obtained from the reader become invalid.
+ */
+void spec_reader_close(SpecReader *r) {
+    if (r->map) {
+        munmap(r->map, r->map_size);
+    }
+    r->map = NULL;
+    r->payload = NULL;
+}
+/* End of spec_reader_close() */
+/******************************************************************************/
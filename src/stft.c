@@ -0,0 +1,487 @@
+/*
+ * @file stft.c
+ *
+ * Complex STFT and inverse STFT built on fft()/ifft().
+ *
+ * Features:
+ *   - compute_stft(): complex counterpart of compute_spectrogram() keeping
+ *     the phase, with identical framing and sample scaling.
+ *   - istft()/istft_to_wav(): weighted overlap-add resynthesis. Each frame
+ *     is inverse transformed, multiplied by the synthesis window and added;
+ *     the sum is divided by the accumulated squared window, which removes
+ *     the window modulation for any overlap (COLA normalization).
+ *   - StftStream: the same analysis/synthesis pair one hop at a time with
+ *     preallocated buffers, so spectral processing (e.g. noise suppression)
+ *     runs end to end without materializing all frames.
+ *
+ * Only bins 0 .. fft_size/2 are stored; the negative-frequency half is
+ * rebuilt by Hermitian symmetry before the inverse transform.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stft.h"
+#include "fft.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define STFT_NORM_EPS 1e-8   /* window energy below this is treated as zero */
+
+/* Internal helper: rebuild a full Hermitian spectrum [n] from bins 0..n/2 */
+static void mirror_bins(const Complex *bins, Complex *buffer, int n) {
+    int half = n / 2;
+
+    for (int k = 0; k <= half; k++) {
+        buffer[k] = bins[k];
+    }
+    for (int k = half + 1; k < n; k++) {
+        buffer[k].real = bins[n - k].real;
+        buffer[k].imag = -bins[n - k].imag;
+    }
+}
+
+/******************************************************************************
+ * compute_stft
+ *
+ * @param[in]  wav            Pointer to WavData struct (must be mono)
+ * @param[in]  fft_size       FFT window size (power of two)
+ * @param[in]  hop_size       Hop size between frames
+ * @param[in]  window_type    Analysis window
+ * @param[out] out_num_frames Pointer to store number of time frames
+ * @param[out] out_num_bins   Pointer to store number of frequency bins
+ *
+ * @returns 2D array [num_frames][num_bins] of complex bins, or NULL on error
+ *
+ * @note Same framing and 1/32768 sample scaling as compute_spectrogram().
+ *       Caller must free the result with free_stft().
+ */
+Complex **compute_stft(const WavData *wav,
+                       int fft_size,
+                       int hop_size,
+                       WindowType window_type,
+                       int *out_num_frames,
+                       int *out_num_bins) {
+    if (wav->num_channels != 1 || fft_size < 1 || wav->num_samples < (size_t)fft_size ||
+        hop_size < 1) return NULL;
+
+    size_t num_frames_64 = 1 + (wav->num_samples - fft_size) / hop_size;
+    if (num_frames_64 > INT_MAX) return NULL;
+    int num_frames = (int)num_frames_64;
+    int num_bins = fft_size / 2 + 1;
+
+    Complex **stft = malloc(num_frames * sizeof(Complex *));
+    double *window = malloc(fft_size * sizeof(double));
+    Complex *fft_buffer = malloc(fft_size * sizeof(Complex));
+    if (!stft || !window || !fft_buffer) {
+        free(stft);
+        free(window);
+        free(fft_buffer);
+        return NULL;
+    }
+
+    for (int f = 0; f < num_frames; f++) {
+        stft[f] = malloc(num_bins * sizeof(Complex));
+        if (!stft[f]) {
+            free_stft(stft, f);
+            free(window);
+            free(fft_buffer);
+            return NULL;
+        }
+    }
+
+    generate_window(window, fft_size, window_type);
+
+    const DspKernels *kernels = dsp_kernels();
+    for (int f = 0; f < num_frames; f++) {
+        kernels->window_s16(wav->samples + (size_t)f * hop_size, window, fft_buffer, fft_size);
+
+        fft(fft_buffer, fft_size);
+        memcpy(stft[f], fft_buffer, num_bins * sizeof(Complex));
+    }
+
+    free(window);
+    free(fft_buffer);
+
+    *out_num_frames = num_frames;
+    *out_num_bins = num_bins;
+    return stft;
+}
+/* End of compute_stft() */
+/******************************************************************************/
+
+/******************************************************************************
+ * free_stft
+ *
+ * @param[in,out] stft       Result of compute_stft()
+ * @param[in]     num_frames Number of frames
+ *
+ * @warning Safe to call with NULL pointer (no operation).
+ */
+void free_stft(Complex **stft, int num_frames) {
+    if (!stft) return;
+    for (int i = 0; i < num_frames; i++) {
+        free(stft[i]);
+    }
+    free(stft);
+}
+/* End of free_stft() */
+/******************************************************************************/
+
+/******************************************************************************
+ * istft
+ *
+ * @param[in]  stft        Frames [num_frames][fft_size/2 + 1]
+ * @param[in]  num_frames  Number of frames
+ * @param[in]  fft_size    FFT size used for analysis
+ * @param[in]  hop_size    Hop size used for analysis
+ * @param[in]  window_type Window used for analysis (also used for synthesis)
+ * @param[out] output      Time-domain samples in [-1, 1) scale
+ * @param[in]  output_len  Length of output; samples past the last frame are zeroed
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @note
+ * - Weighted overlap-add normalized by the accumulated squared window, so
+ *   an unmodified compute_stft() result reconstructs its input exactly
+ *   wherever the window energy is non-zero.
+ * - Samples whose accumulated window energy is below 1e-8 (the first and
+ *   last one or two samples under a symmetric Hann window) are output as 0
+ *   rather than amplified.
+ */
+int istft(Complex *const *stft, int num_frames, int fft_size, int hop_size,
+          WindowType window_type, double *output, size_t output_len) {
+    if (!stft || !output || num_frames < 0 || fft_size < 2 || hop_size < 1) return -1;
+
+    double *window = malloc(fft_size * sizeof(double));
+    double *energy = calloc(output_len, sizeof(double));
+    Complex *buffer = malloc(fft_size * sizeof(Complex));
+    if (!window || !energy || !buffer) {
+        free(window);
+        free(energy);
+        free(buffer);
+        return -2;
+    }
+
+    generate_window(window, fft_size, window_type);
+    memset(output, 0, output_len * sizeof(double));
+
+    for (int f = 0; f < num_frames; f++) {
+        size_t offset = (size_t)f * hop_size;
+        if (offset >= output_len) break;
+
+        mirror_bins(stft[f], buffer, fft_size);
+        ifft(buffer, fft_size);
+
+        size_t count = output_len - offset < (size_t)fft_size ? output_len - offset : (size_t)fft_size;
+        for (size_t i = 0; i < count; i++) {
+            output[offset + i] += buffer[i].real * window[i];
+            energy[offset + i] += window[i] * window[i];
+        }
+    }
+
+    for (size_t i = 0; i < output_len; i++) {
+        output[i] = energy[i] > STFT_NORM_EPS ? output[i] / energy[i] : 0.0;
+    }
+
+    free(window);
+    free(energy);
+    free(buffer);
+    return 0;
+}
+/* End of istft() */
+/******************************************************************************/
+
+/******************************************************************************
+ * istft_to_wav
+ *
+ * @param[in]  stft        Frames [num_frames][fft_size/2 + 1]
+ * @param[in]  num_frames  Number of frames
+ * @param[in]  fft_size    FFT size used for analysis
+ * @param[in]  hop_size    Hop size used for analysis
+ * @param[in]  window_type Window used for analysis
+ * @param[in]  sample_rate Sample rate stored in the result
+ * @param[out] out         Mono 16-bit WavData with newly allocated samples
+ *
+ * @returns 0 on success, negative error code on failure
+ *
+ * @note Output length is (num_frames - 1) * hop_size + fft_size samples,
+ *       rounded and saturated to int16. Release with free_wav().
+ */
+int istft_to_wav(Complex *const *stft, int num_frames, int fft_size, int hop_size,
+                 WindowType window_type, int sample_rate, WavData *out) {
+    if (num_frames < 1) return -1;
+
+    size_t len = (size_t)(num_frames - 1) * hop_size + fft_size;
+    double *buffer = malloc(len * sizeof(double));
+    int16_t *samples = malloc(len * sizeof(int16_t));
+    if (!buffer || !samples) {
+        free(buffer);
+        free(samples);
+        return -2;
+    }
+
+    int ret = istft(stft, num_frames, fft_size, hop_size, window_type, buffer, len);
+    if (ret != 0) {
+        free(buffer);
+        free(samples);
+        return ret;
+    }
+
+    dsp_kernels()->double_to_s16(buffer, samples, len);
+    free(buffer);
+
+    out->sample_rate = sample_rate;
+    out->num_channels = 1;
+    out->bits_per_sample = 16;
+    out->num_samples = len;
+    out->samples = samples;
+    return 0;
+}
+/* End of istft_to_wav() */
+/******************************************************************************/
+
+/******************************************************************************
+ * stft_stream_init
+ *
+ * @param[out] s           Pointer to StftStream struct to initialize
+ * @param[in]  fft_size    Frame length (power of two)
+ * @param[in]  hop_size    Frame advance, 1 .. fft_size
+ * @param[in]  window_type Analysis/synthesis window
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @note Allocates one block of stft_stream_mem_size() bytes and builds the
+ *       stream in it with stft_stream_init_mem().
+ *
+ * @warning Must call stft_stream_free() to release allocated resources.
+ */
+int stft_stream_init(StftStream *s, int fft_size, int hop_size, WindowType window_type) {
+    memset(s, 0, sizeof(*s));
+    size_t size = stft_stream_mem_size(fft_size, hop_size);
+    if (size == 0) return -1;
+
+    void *mem = malloc(size);
+    if (!mem) return -2;
+    stft_stream_init_mem(s, fft_size, hop_size, window_type, mem);
+    s->owned_mem = mem;
+    return 0;
+}
+/* End of stft_stream_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * stft_stream_mem_size
+ *
+ * @param[in] fft_size Frame length (power of two)
+ * @param[in] hop_size Frame advance, 1 .. fft_size
+ *
+ * @returns Bytes of memory stft_stream_init_mem() needs, 0 on invalid arguments
+ */
+size_t stft_stream_mem_size(int fft_size, int hop_size) {
+    if (fft_size < 2 || hop_size < 1 || hop_size > fft_size) return 0;
+    size_t plan_size = fft_plan_mem_size(fft_size);
+    if (plan_size == 0) return 0;
+
+    return plan_size +
+           DSP_MEM_ALIGN_UP(fft_size * sizeof(double)) * 3 +
+           DSP_MEM_ALIGN_UP(fft_size * sizeof(Complex)) +
+           DSP_MEM_ALIGN_UP((fft_size / 2 + 1) * sizeof(Complex)) +
+           DSP_MEM_ALIGN_UP(hop_size * sizeof(double)) * 3;
+}
+/* End of stft_stream_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * stft_stream_init_mem
+ *
+ * @param[out] s           Pointer to StftStream struct to initialize
+ * @param[in]  fft_size    Frame length (power of two)
+ * @param[in]  hop_size    Frame advance, 1 .. fft_size
+ * @param[in]  window_type Analysis/synthesis window
+ * @param[in]  mem         At least stft_stream_mem_size() bytes aligned for
+ *                         double; must outlive the stream
+ *
+ * @returns 0 on success, -1 on invalid arguments
+ *
+ * @note Precomputes the steady-state overlap-add normalization per hop
+ *       position. Because the stream starts from a zero history, every
+ *       emitted sample is covered by the full set of frames and the
+ *       reconstruction is exact after the fft_size-sample latency.
+ *       The FFT plan lives in mem too; performs no allocation.
+ */
+int stft_stream_init_mem(StftStream *s, int fft_size, int hop_size, WindowType window_type,
+                         void *mem) {
+    memset(s, 0, sizeof(*s));
+    size_t size = stft_stream_mem_size(fft_size, hop_size);
+    if (size == 0) return -1;
+
+    s->fft_size = fft_size;
+    s->hop_size = hop_size;
+    s->num_bins = fft_size / 2 + 1;
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, size);
+    fft_plan_init_mem(&s->plan, fft_size, dsp_arena_alloc(&arena, fft_plan_mem_size(fft_size)));
+    s->window = dsp_arena_alloc(&arena, fft_size * sizeof(double));
+    s->inv_norm = dsp_arena_alloc(&arena, hop_size * sizeof(double));
+    s->frame = dsp_arena_alloc(&arena, fft_size * sizeof(double));
+    s->overlap = dsp_arena_alloc(&arena, fft_size * sizeof(double));
+    s->fft_buffer = dsp_arena_alloc(&arena, fft_size * sizeof(Complex));
+    s->spectrum = dsp_arena_alloc(&arena, s->num_bins * sizeof(Complex));
+    s->in_hop = dsp_arena_alloc(&arena, hop_size * sizeof(double));
+    s->out_hop = dsp_arena_alloc(&arena, hop_size * sizeof(double));
+
+    generate_window(s->window, fft_size, window_type);
+    for (int i = 0; i < hop_size; i++) {
+        double energy = 0.0;
+        for (int k = i; k < fft_size; k += hop_size) {
+            energy += s->window[k] * s->window[k];
+        }
+        s->inv_norm[i] = energy > STFT_NORM_EPS ? 1.0 / energy : 0.0;
+    }
+
+    stft_stream_reset(s);
+    return 0;
+}
+/* End of stft_stream_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * stft_stream_reset
+ *
+ * @param[in,out] s Pointer to initialized StftStream struct
+ */
+void stft_stream_reset(StftStream *s) {
+    memset(s->frame, 0, s->fft_size * sizeof(double));
+    memset(s->overlap, 0, s->fft_size * sizeof(double));
+    memset(s->out_hop, 0, s->hop_size * sizeof(double));
+    s->fill = 0;
+}
+/* End of stft_stream_reset() */
+/******************************************************************************/
+
+/******************************************************************************
+ * stft_analyze
+ *
+ * @param[in,out] s        Pointer to initialized StftStream struct
+ * @param[in]     hop_in   hop_size new samples
+ * @param[out]    bins_out Spectrum of the newest fft_size samples [num_bins]
+ *
+ * @note Performs no allocation.
+ */
+void stft_analyze(StftStream *s, const double *hop_in, Complex *bins_out) {
+    int n = s->fft_size;
+    int hop = s->hop_size;
+
+    memmove(s->frame, s->frame + hop, (n - hop) * sizeof(double));
+    memcpy(s->frame + n - hop, hop_in, hop * sizeof(double));
+
+    for (int i = 0; i < n; i++) {
+        s->fft_buffer[i].real = s->frame[i] * s->window[i];
+        s->fft_buffer[i].imag = 0.0;
+    }
+
+    fft_execute(&s->plan, s->fft_buffer);
+    memcpy(bins_out, s->fft_buffer, s->num_bins * sizeof(Complex));
+}
+/* End of stft_analyze() */
+/******************************************************************************/
+
+/******************************************************************************
+ * stft_synthesize
+ *
+ * @param[in,out] s       Pointer to initialized StftStream struct
+ * @param[in]     bins    Spectrum to resynthesize [num_bins]
+ * @param[out]    hop_out hop_size finished, normalized samples
+ *
+ * @note The emitted samples are the oldest hop of the overlap-add
+ *       accumulator, i.e. the start of the frame that began fft_size
+ *       samples before the end of the current analysis frame.
+ */
+void stft_synthesize(StftStream *s, const Complex *bins, double *hop_out) {
+    int n = s->fft_size;
+    int hop = s->hop_size;
+
+    mirror_bins(bins, s->fft_buffer, n);
+    ifft_execute(&s->plan, s->fft_buffer);
+
+    for (int i = 0; i < n; i++) {
+        s->overlap[i] += s->fft_buffer[i].real * s->window[i];
+    }
+
+    for (int i = 0; i < hop; i++) {
+        hop_out[i] = s->overlap[i] * s->inv_norm[i];
+    }
+
+    memmove(s->overlap, s->overlap + hop, (n - hop) * sizeof(double));
+    memset(s->overlap + n - hop, 0, hop * sizeof(double));
+}
+/* End of stft_synthesize() */
+/******************************************************************************/
+
+/******************************************************************************
+ * stft_stream_process
+ *
+ * @param[in,out] s           Pointer to initialized StftStream struct
+ * @param[in]     input       Input samples
+ * @param[out]    output      Output samples (same count; may alias input)
+ * @param[in]     num_samples Number of samples
+ * @param[in]     fn          Optional spectral callback (NULL = identity)
+ * @param[in]     user        Opaque pointer passed to fn
+ *
+ * @note
+ * - Accepts any block size; frames are formed every hop_size samples.
+ * - output[t] reconstructs input[t - fft_size] (zeros before the start).
+ * - Performs no allocation.
+ */
+void stft_stream_process(StftStream *s, const double *input, double *output,
+                         size_t num_samples, StftFrameFn fn, void *user) {
+    int hop = s->hop_size;
+
+    for (size_t i = 0; i < num_samples; i++) {
+        output[i] = s->out_hop[s->fill];
+        s->in_hop[s->fill++] = input[i];
+
+        if (s->fill == hop) {
+            stft_analyze(s, s->in_hop, s->spectrum);
+            if (fn) {
+                fn(s->spectrum, s->num_bins, user);
+            }
+            stft_synthesize(s, s->spectrum, s->out_hop);
+            s->fill = 0;
+        }
+    }
+}
+/* End of stft_stream_process() */
+/******************************************************************************/
+
+/******************************************************************************
+ * stft_stream_free
+ *
+ * @param[in,out] s Pointer to StftStream struct
+ *
+ * @note Caller memory from stft_stream_init_mem() is left alone.
+ */
+void stft_stream_free(StftStream *s) {
+    if (!s) return;
+    free(s->owned_mem);
+    s->owned_mem = NULL;
+    s->window = NULL;
+    s->inv_norm = NULL;
+    s->frame = NULL;
+    s->overlap = NULL;
+    s->fft_buffer = NULL;
+    s->spectrum = NULL;
+    s->in_hop = NULL;
+    s->out_hop = NULL;
+}
+/* End of stft_stream_free() */
+/******************************************************************************/
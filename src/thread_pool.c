@@ -0,0 +1,256 @@
+/*
+ * @file thread_pool.c
+ *
+ * Work-stealing thread pool.
+ *
+ * Each worker's range is one 64-bit atomic holding begin (low half) and
+ * end (high half). The owner advances begin by compare-and-swap, a thief
+ * lowers end by the same means and installs the stolen half in its own,
+ * empty, slot. A task index leaves the ranges exactly once, so a packed
+ * value never recurs within a run and the CAS loops are ABA free. A worker
+ * finishes when its own range is empty and a scan finds nothing to steal;
+ * ranges still held by others are drained by their owners.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "thread_pool.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define RANGE(begin, end) (((uint64_t)(end) << 32) | (uint32_t)(begin))
+#define RANGE_BEGIN(r) ((uint32_t)(r))
+#define RANGE_END(r) ((uint32_t)((r) >> 32))
+
+struct ThreadPoolSlot {
+    _Alignas(64) _Atomic uint64_t range;  /* [begin, end) still to run */
+    size_t steals;                        /* ranges stolen by this worker this run */
+};
+
+/* Internal helper: next task of the worker's own range, or -1 when empty */
+static int64_t take_own(ThreadPoolSlot *slot) {
+    uint64_t r = atomic_load_explicit(&slot->range, memory_order_relaxed);
+    while (RANGE_BEGIN(r) < RANGE_END(r)) {
+        if (atomic_compare_exchange_weak_explicit(&slot->range, &r,
+                                                  RANGE(RANGE_BEGIN(r) + 1, RANGE_END(r)),
+                                                  memory_order_acq_rel, memory_order_relaxed)) {
+            return RANGE_BEGIN(r);
+        }
+    }
+    return -1;
+}
+
+/* Internal helper: move the back half of a victim's range into the thief's slot */
+static int steal(ThreadPoolSlot *victim, ThreadPoolSlot *thief) {
+    uint64_t r = atomic_load_explicit(&victim->range, memory_order_relaxed);
+    while (RANGE_BEGIN(r) < RANGE_END(r)) {
+        uint32_t count = RANGE_END(r) - RANGE_BEGIN(r);
+        uint32_t split = RANGE_END(r) - (count + 1) / 2;
+        if (atomic_compare_exchange_weak_explicit(&victim->range, &r,
+                                                  RANGE(RANGE_BEGIN(r), split),
+                                                  memory_order_acq_rel, memory_order_relaxed)) {
+            atomic_store_explicit(&thief->range, RANGE(split, RANGE_END(r)), memory_order_release);
+            thief->steals++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Internal helper: one worker's share of a run */
+static void work(ThreadPool *pool, int worker) {
+    ThreadPoolSlot *own = &pool->slots[worker];
+    for (;;) {
+        int64_t task;
+        while ((task = take_own(own)) >= 0) {
+            pool->fn(pool->ctx, (size_t)task, worker);
+        }
+
+        // Scan the other workers once, starting after ourselves
+        int stolen = 0;
+        for (int i = 1; i < pool->num_threads && !stolen; i++) {
+            stolen = steal(&pool->slots[(worker + i) % pool->num_threads], own);
+        }
+        if (!stolen) return;
+    }
+}
+
+/* Internal helper: helper thread main loop */
+typedef struct {
+    ThreadPool *pool;
+    int worker;
+} HelperArg;
+
+static void *helper_main(void *arg) {
+    HelperArg a = *(HelperArg *)arg;
+    free(arg);
+    ThreadPool *pool = a.pool;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stop) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        work(pool, a.worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->active == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int thread_pool_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+/******************************************************************************
+ * thread_pool_init
+ *
+ * @param[out] pool        Pointer to ThreadPool struct to initialize
+ * @param[in]  num_threads Workers including the calling thread; 0 for the
+ *                         number of online CPUs
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 if memory or a thread
+ *          could not be obtained
+ *
+ * @warning Must call thread_pool_free() to stop the workers.
+ */
+int thread_pool_init(ThreadPool *pool, int num_threads) {
+    memset(pool, 0, sizeof(*pool));
+    if (num_threads < 0) return -1;
+    if (num_threads == 0) num_threads = thread_pool_cpu_count();
+
+    pool->slots = aligned_alloc(_Alignof(ThreadPoolSlot), num_threads * sizeof(ThreadPoolSlot));
+    pool->threads = malloc(num_threads * sizeof(pthread_t));
+    if (!pool->slots || !pool->threads) {
+        free(pool->slots);
+        free(pool->threads);
+        return -2;
+    }
+    for (int i = 0; i < num_threads; i++) {
+        atomic_init(&pool->slots[i].range, 0);
+        pool->slots[i].steals = 0;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->num_threads = 1;
+
+    // Helpers are workers 1 .. num_threads-1; the caller is worker 0
+    for (int i = 1; i < num_threads; i++) {
+        HelperArg *arg = malloc(sizeof(*arg));
+        if (!arg) {
+            thread_pool_free(pool);
+            return -2;
+        }
+        arg->pool = pool;
+        arg->worker = i;
+        if (pthread_create(&pool->threads[i - 1], NULL, helper_main, arg) != 0) {
+            free(arg);
+            thread_pool_free(pool);
+            return -2;
+        }
+        pool->num_threads++;
+    }
+    return 0;
+}
+/* End of thread_pool_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * thread_pool_run
+ *
+ * @param[in,out] pool      Initialized pool
+ * @param[in]     num_tasks Number of tasks (<= THREAD_POOL_MAX_TASKS)
+ * @param[in]     fn        Task body, called once per task from any worker
+ * @param[in]     ctx       Passed to fn
+ *
+ * @returns 0 once every task has run, -1 on invalid arguments
+ *
+ * @note Tasks start in index order within each worker's range; there is no
+ *       ordering between workers. fn must not call thread_pool_run() on the
+ *       same pool.
+ */
+int thread_pool_run(ThreadPool *pool, size_t num_tasks, ThreadPoolFn fn, void *ctx) {
+    if (!pool->slots || !fn || num_tasks > THREAD_POOL_MAX_TASKS) return -1;
+    if (num_tasks == 0) return 0;
+
+    int n = pool->num_threads;
+    for (int i = 0; i < n; i++) {
+        uint64_t begin = num_tasks * i / n;
+        uint64_t end = num_tasks * (i + 1) / n;
+        atomic_store_explicit(&pool->slots[i].range, RANGE(begin, end), memory_order_relaxed);
+        pool->slots[i].steals = 0;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->active = n - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+/* End of thread_pool_run() */
+/******************************************************************************/
+
+size_t thread_pool_steals(const ThreadPool *pool) {
+    size_t steals = 0;
+    for (int i = 0; i < pool->num_threads; i++) {
+        steals += pool->slots[i].steals;
+    }
+    return steals;
+}
+
+/******************************************************************************
+ * thread_pool_free
+ *
+ * @param[in,out] pool Pool to stop
+ *
+ * @note Must not be called while thread_pool_run() is in progress.
+ */
+void thread_pool_free(ThreadPool *pool) {
+    if (!pool->slots) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->num_threads - 1; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->slots);
+    free(pool->threads);
+    memset(pool, 0, sizeof(*pool));
+}
+/* End of thread_pool_free() */
+/******************************************************************************/
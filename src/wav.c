@@ -3,7 +3,14 @@
  *
  * WAV file loader and saver for 16-bit PCM WAV audio files.
  * Supports reading WAV files into memory, validating mono 16-bit format,
- * freeing allocated memory, and saving WAV data to disk.
+ * freeing allocated memory, and saving WAV data to disk. WavReader and
+ * WavWriter stream the same format in blocks with constant memory.
+ *
+ * Files whose RIFF size would not fit in 32 bits use RF64 (EBU Tech 3306,
+ * also BW64 of ITU-R BS.2088): the RIFF and data sizes are set to
+ * 0xFFFFFFFF and the real 64-bit sizes live in a "ds64" chunk placed right
+ * after "WAVE". WavWriter reserves that space with a "JUNK" chunk of the
+ * same size, so a stream can be promoted to RF64 when it is closed.
  *
  * Created on: Jun 16, 2025
  * Author: Omri Kebede
@@ -14,12 +21,20 @@
 #include <string.h>
 #include <stdint.h>
 #include "wav.h"
+#include "dsp_profile.h"
 
 /* Internal helper: read 4 bytes as little-endian uint32 from file */
 static uint32_t read_uint32_le(FILE *f) {
     uint8_t b[4];
     if (fread(b, 1, 4, f) != 4) return 0;
-    return b[0] | (b[1]<<8) | (b[2]<<16) | (b[3]<<24);
+    return b[0] | (b[1]<<8) | (b[2]<<16) | ((uint32_t)b[3]<<24);
+}
+
+/* Internal helper: read 8 bytes as little-endian uint64 from file */
+static uint64_t read_uint64_le(FILE *f) {
+    uint64_t lo = read_uint32_le(f);
+    uint64_t hi = read_uint32_le(f);
+    return lo | (hi << 32);
 }
 
 /* Internal helper: read 2 bytes as little-endian uint16 from file */
@@ -29,18 +44,15 @@ static uint16_t read_uint16_le(FILE *f) {
     return b[0] | (b[1]<<8);
 }
 
-/**
- * Loads a 16-bit PCM WAV file from disk into a WavData struct.
- * Supports mono or stereo.
- * Returns 0 on success, negative error codes on failure.
- */
-int load_wav(const char *filename, WavData *out) {
-    FILE *f = fopen(filename, "rb");
-    if (!f) return -1;
-
+/* Internal helper: parse the RIFF/WAVE (or RF64/BW64) header up to the
+ * start of the "data" payload. Returns 0 on success or the load_wav() error
+ * code (-2 .. -6) */
+static int read_wav_header(FILE *f, uint32_t *sample_rate, uint16_t *num_channels,
+                           uint16_t *bits_per_sample, uint64_t *data_bytes) {
     char riff[4];
-    if (fread(riff, 1, 4, f) != 4 || strncmp(riff, "RIFF", 4) != 0) {
-        fclose(f);
+    if (fread(riff, 1, 4, f) != 4) return -2;
+    int rf64 = strncmp(riff, "RF64", 4) == 0 || strncmp(riff, "BW64", 4) == 0;
+    if (!rf64 && strncmp(riff, "RIFF", 4) != 0) {
         return -2;  // Not a RIFF file
     }
 
@@ -48,44 +60,77 @@ int load_wav(const char *filename, WavData *out) {
 
     char wave[4];
     if (fread(wave, 1, 4, f) != 4 || strncmp(wave, "WAVE", 4) != 0) {
-        fclose(f);
         return -3;  // Not a WAVE format
     }
 
     char chunk_id[4];
     uint32_t chunk_size;
+    uint64_t ds64_data_size = 0;
+    int have_ds64 = 0;
 
-    // Find "fmt " chunk
+    // Find "fmt " chunk, picking up the 64-bit sizes of an RF64 file on the way
     while (1) {
-        if (fread(chunk_id, 1, 4, f) != 4) { fclose(f); return -4; }
+        if (fread(chunk_id, 1, 4, f) != 4) return -4;
         chunk_size = read_uint32_le(f);
         if (strncmp(chunk_id, "fmt ", 4) == 0) break;
+        if (rf64 && strncmp(chunk_id, "ds64", 4) == 0 && chunk_size >= 24) {
+            read_uint64_le(f); // RIFF size
+            ds64_data_size = read_uint64_le(f);
+            have_ds64 = 1;
+            fseek(f, chunk_size - 16, SEEK_CUR); // Sample count and size table
+            continue;
+        }
         fseek(f, chunk_size, SEEK_CUR);
     }
 
     uint16_t audio_format = read_uint16_le(f);
-    uint16_t num_channels = read_uint16_le(f);
-    uint32_t sample_rate = read_uint32_le(f);
+    *num_channels = read_uint16_le(f);
+    *sample_rate = read_uint32_le(f);
     fseek(f, 6, SEEK_CUR); // Skip byte rate + block align
-    uint16_t bits_per_sample = read_uint16_le(f);
+    *bits_per_sample = read_uint16_le(f);
     fseek(f, chunk_size - 16, SEEK_CUR); // Skip any extra fmt bytes
 
-    if (audio_format != 1 || bits_per_sample != 16) {
-        fclose(f);
+    if (audio_format != 1 || *bits_per_sample != 16) {
         return -5; // Unsupported format (only PCM 16-bit supported)
     }
 
     // Find "data" chunk
     while (1) {
-        if (fread(chunk_id, 1, 4, f) != 4) { fclose(f); return -6; }
+        if (fread(chunk_id, 1, 4, f) != 4) return -6;
         chunk_size = read_uint32_le(f);
         if (strncmp(chunk_id, "data", 4) == 0) break;
         fseek(f, chunk_size, SEEK_CUR);
     }
 
-    int num_samples = chunk_size / 2; // 2 bytes per sample (16-bit)
+    if (rf64 && chunk_size == 0xFFFFFFFFu) {
+        if (!have_ds64) return -6; // RF64 data size without a ds64 chunk
+        *data_bytes = ds64_data_size;
+    } else {
+        *data_bytes = chunk_size;
+    }
+    return 0;
+}
+
+/* Internal helper: body of load_wav(), kept separate so the public entry
+ * point can be profiled around its many early returns */
+static int load_wav_file(const char *filename, WavData *out) {
+    FILE *f = fopen(filename, "rb");
+    if (!f) return -1;
+
+    uint32_t sample_rate;
+    uint64_t chunk_size;
+    uint16_t num_channels, bits_per_sample;
+    int ret = read_wav_header(f, &sample_rate, &num_channels, &bits_per_sample, &chunk_size);
+    if (ret != 0) {
+        fclose(f);
+        return ret;
+    }
+    if (chunk_size > SIZE_MAX) { fclose(f); return -7; }
+
+    size_t num_samples = chunk_size / 2; // 2 bytes per sample (16-bit)
     int16_t *data = malloc(chunk_size);
     if (!data) { fclose(f); return -7; }
+    DSP_PROFILE_ALLOC(DSP_PROF_LOAD_WAV, chunk_size);
 
     if (fread(data, 1, chunk_size, f) != chunk_size) {
         free(data);
@@ -105,6 +150,18 @@ int load_wav(const char *filename, WavData *out) {
     return 0;
 }
 
+/**
+ * Loads a 16-bit PCM WAV file from disk into a WavData struct.
+ * Supports mono or stereo, and RF64/BW64 files larger than 4 GB.
+ * Returns 0 on success, negative error codes on failure.
+ */
+int load_wav(const char *filename, WavData *out) {
+    DSP_PROFILE_BEGIN(DSP_PROF_LOAD_WAV);
+    int ret = load_wav_file(filename, out);
+    DSP_PROFILE_END(DSP_PROF_LOAD_WAV);
+    return ret;
+}
+
 /**
  * Validates that a WavData struct contains mono 16-bit data.
  * Returns 0 if valid, negative error codes otherwise.
@@ -147,24 +204,47 @@ static void write_uint16_le(FILE *f, uint16_t val) {
     fwrite(b, 1, 2, f);
 }
 
-/**
- * Saves WAV data as a 16-bit PCM file to disk.
- * Returns 0 on success, negative error codes on failure.
- */
-int save_wav(const char *filename, const WavData *wav) {
+/* Internal helper: write an 8-byte little-endian uint64 to file */
+static void write_uint64_le(FILE *f, uint64_t val) {
+    write_uint32_le(f, (uint32_t)val);
+    write_uint32_le(f, (uint32_t)(val >> 32));
+}
+
+/* Internal helper: write the body of a ds64 chunk (28 bytes, empty size table) */
+static void write_ds64(FILE *f, uint64_t riff_size, uint64_t data_size, uint64_t frames) {
+    write_uint64_le(f, riff_size);
+    write_uint64_le(f, data_size);
+    write_uint64_le(f, frames);
+    write_uint32_le(f, 0);
+}
+
+/* Bytes of a ds64 (or placeholder JUNK) chunk body */
+#define WAV_DS64_SIZE 28
+
+/* Internal helper: body of save_wav() */
+static int save_wav_file(const char *filename, const WavData *wav) {
     if (!wav || !wav->samples) return -1;
 
     FILE *f = fopen(filename, "wb");
     if (!f) return -2;
 
-    uint32_t data_chunk_size = wav->num_samples * wav->num_channels * (wav->bits_per_sample / 8);
+    // num_samples already counts every channel
+    uint64_t data_chunk_size = (uint64_t)wav->num_samples * (wav->bits_per_sample / 8);
     uint32_t fmt_chunk_size = 16;
-    uint32_t riff_chunk_size = 4 + (8 + fmt_chunk_size) + (8 + data_chunk_size);
+    uint64_t riff_chunk_size = 4 + (8 + fmt_chunk_size) + (8 + data_chunk_size);
+    int rf64 = riff_chunk_size > WAV_RIFF_MAX_SIZE;
+    if (rf64) riff_chunk_size += 8 + WAV_DS64_SIZE;
 
-    // Write RIFF header
-    fwrite("RIFF", 1, 4, f);
-    write_uint32_le(f, riff_chunk_size);
+    // Write RIFF (or RF64 + ds64) header
+    fwrite(rf64 ? "RF64" : "RIFF", 1, 4, f);
+    write_uint32_le(f, rf64 ? 0xFFFFFFFFu : (uint32_t)riff_chunk_size);
     fwrite("WAVE", 1, 4, f);
+    if (rf64) {
+        fwrite("ds64", 1, 4, f);
+        write_uint32_le(f, WAV_DS64_SIZE);
+        write_ds64(f, riff_chunk_size, data_chunk_size,
+                   wav->num_channels > 0 ? wav->num_samples / wav->num_channels : 0);
+    }
 
     // Write fmt chunk
     fwrite("fmt ", 1, 4, f);
@@ -180,9 +260,167 @@ int save_wav(const char *filename, const WavData *wav) {
 
     // Write data chunk
     fwrite("data", 1, 4, f);
-    write_uint32_le(f, data_chunk_size);
-    fwrite(wav->samples, 1, data_chunk_size, f);
+    write_uint32_le(f, rf64 ? 0xFFFFFFFFu : (uint32_t)data_chunk_size);
+    size_t written = fwrite(wav->samples, 1, data_chunk_size, f);
 
-    fclose(f);
+    if (fclose(f) != 0 || written != data_chunk_size) return -3;
     return 0;
 }
+
+/**
+ * Saves WAV data as a 16-bit PCM file to disk, as RF64 when the RIFF size
+ * would not fit in 32 bits.
+ * Returns 0 on success, negative error codes on failure.
+ */
+int save_wav(const char *filename, const WavData *wav) {
+    DSP_PROFILE_BEGIN(DSP_PROF_SAVE_WAV);
+    int ret = save_wav_file(filename, wav);
+    DSP_PROFILE_END(DSP_PROF_SAVE_WAV);
+    return ret;
+}
+
+/**
+ * Opens a 16-bit PCM WAV file for block-wise reading.
+ * Returns 0 on success or the same negative codes as load_wav().
+ */
+int wav_reader_open(WavReader *r, const char *filename) {
+    memset(r, 0, sizeof(*r));
+    r->f = fopen(filename, "rb");
+    if (!r->f) return -1;
+
+    uint32_t sample_rate;
+    uint64_t data_bytes;
+    uint16_t num_channels, bits_per_sample;
+    int ret = read_wav_header(r->f, &sample_rate, &num_channels, &bits_per_sample, &data_bytes);
+    if (ret != 0 || num_channels == 0) {
+        fclose(r->f);
+        r->f = NULL;
+        return ret != 0 ? ret : -5;
+    }
+
+    r->sample_rate = sample_rate;
+    r->num_channels = num_channels;
+    r->bits_per_sample = bits_per_sample;
+    r->frames_left = data_bytes / (2u * num_channels);
+    return 0;
+}
+
+/**
+ * Reads up to max_frames interleaved frames into samples.
+ * Returns the number of frames read (0 at end of data or on error).
+ */
+size_t wav_reader_read(WavReader *r, int16_t *samples, size_t max_frames) {
+    if (!r->f) return 0;
+    if (max_frames > r->frames_left) max_frames = r->frames_left;
+
+    size_t frames = fread(samples, 2u * r->num_channels, max_frames, r->f);
+    r->frames_left = frames < max_frames ? 0 : r->frames_left - frames;
+    return frames;
+}
+
+/**
+ * Closes a WavReader.
+ */
+void wav_reader_close(WavReader *r) {
+    if (r->f) fclose(r->f);
+    r->f = NULL;
+}
+
+/* Byte offsets of the streamed header: RIFF size, the JUNK/ds64 chunk and
+ * the data chunk size */
+#define WAV_WRITER_RIFF_SIZE_OFFSET 4
+#define WAV_WRITER_DS64_OFFSET 12
+#define WAV_WRITER_DATA_SIZE_OFFSET 76
+#define WAV_WRITER_HEADER_SIZE 80
+
+/**
+ * Creates a 16-bit PCM WAV file for block-wise writing. The header sizes
+ * are patched by wav_writer_close(), which turns the reserved JUNK chunk
+ * into ds64 when the data outgrows a RIFF file.
+ * Returns 0 on success, negative error codes on failure.
+ */
+int wav_writer_open(WavWriter *w, const char *filename, int sample_rate, int num_channels) {
+    memset(w, 0, sizeof(*w));
+    if (sample_rate <= 0 || num_channels <= 0) return -1;
+
+    w->f = fopen(filename, "wb");
+    if (!w->f) return -2;
+    w->sample_rate = sample_rate;
+    w->num_channels = num_channels;
+
+    // Header with zero sizes, patched on close
+    fwrite("RIFF", 1, 4, w->f);
+    write_uint32_le(w->f, 0);
+    fwrite("WAVE", 1, 4, w->f);
+    fwrite("JUNK", 1, 4, w->f);
+    write_uint32_le(w->f, WAV_DS64_SIZE);
+    write_ds64(w->f, 0, 0, 0);
+    fwrite("fmt ", 1, 4, w->f);
+    write_uint32_le(w->f, 16);
+    write_uint16_le(w->f, 1); // PCM format
+    write_uint16_le(w->f, num_channels);
+    write_uint32_le(w->f, sample_rate);
+    write_uint32_le(w->f, sample_rate * num_channels * 2);
+    write_uint16_le(w->f, num_channels * 2);
+    write_uint16_le(w->f, 16);
+    fwrite("data", 1, 4, w->f);
+    write_uint32_le(w->f, 0);
+    return 0;
+}
+
+/**
+ * Appends num_frames interleaved frames.
+ * Returns 0 on success, -1 on write failure.
+ */
+int wav_writer_write(WavWriter *w, const int16_t *samples, size_t num_frames) {
+    if (!w->f) return -1;
+    size_t written = fwrite(samples, 2u * w->num_channels, num_frames, w->f);
+    w->data_bytes += written * 2u * w->num_channels;
+    return written == num_frames ? 0 : -1;
+}
+
+/**
+ * Patches the RIFF and data chunk sizes and closes the file. Streams too
+ * long for 32-bit sizes are rewritten as RF64 with a ds64 chunk.
+ * Returns 0 on success, -1 on failure.
+ */
+int wav_writer_close(WavWriter *w) {
+    if (!w->f) return -1;
+
+    int ret = 0;
+    uint64_t riff_size = WAV_WRITER_HEADER_SIZE - 8 + w->data_bytes;
+    if (riff_size <= WAV_RIFF_MAX_SIZE) {
+        if (fseek(w->f, WAV_WRITER_RIFF_SIZE_OFFSET, SEEK_SET) == 0) {
+            write_uint32_le(w->f, (uint32_t)riff_size);
+        } else {
+            ret = -1;
+        }
+        if (fseek(w->f, WAV_WRITER_DATA_SIZE_OFFSET, SEEK_SET) == 0) {
+            write_uint32_le(w->f, (uint32_t)w->data_bytes);
+        } else {
+            ret = -1;
+        }
+    } else {
+        if (fseek(w->f, 0, SEEK_SET) == 0) {
+            fwrite("RF64", 1, 4, w->f);
+            write_uint32_le(w->f, 0xFFFFFFFFu);
+        } else {
+            ret = -1;
+        }
+        if (fseek(w->f, WAV_WRITER_DS64_OFFSET, SEEK_SET) == 0) {
+            fwrite("ds64", 1, 4, w->f);
+            write_uint32_le(w->f, WAV_DS64_SIZE);
+            write_ds64(w->f, riff_size, w->data_bytes, w->data_bytes / (2u * w->num_channels));
+        } else {
+            ret = -1;
+        }
+        if (fseek(w->f, WAV_WRITER_DATA_SIZE_OFFSET, SEEK_SET) == 0) {
+            write_uint32_le(w->f, 0xFFFFFFFFu);
+        } else {
+            ret = -1;
+        }
+    }
+    if (fclose(w->f) != 0) ret = -1;
+    w->f = NULL;
+    return ret;
+}
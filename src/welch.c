@@ -0,0 +1,437 @@
+/*
+ * @file welch.c
+ *
+ * Welch power spectral density estimate with in-place accumulation.
+ *
+ * Every frame goes through the spectrogram workspace (window_s16 kernel,
+ * planned FFT, spectrogram_convert_bins()) and is folded into the estimator
+ * right away: added to a per-bin sum (mean), blended into a per-bin running
+ * average (exponential), or counted in a per-bin dB histogram (median). The
+ * mean and median states of two estimators add, which gives the per-thread
+ * reduction of welch_compute(). Exponential averaging depends on frame order,
+ * so welch_compute() gives frame f of N its final weight alpha (1-alpha)^(N-1-f)
+ * up front and sums like the mean.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "welch.h"
+#include "dsp_alloc.h"
+#include "dsp_cpu.h"
+#include "dsp_profile.h"
+
+/******************************************************************************/
+/** local definitions **/
+
+/* Shared state of one welch_compute() run */
+typedef struct {
+    const WavData *wav;
+    WelchPSD *states;      /* one per worker */
+    int hop_size;
+    long num_frames;
+    int exponential;       /* weight frames by their final exponential weight */
+    double alpha;
+} WelchJob;
+
+/* Internal helper: window, transform and accumulate the frame at samples */
+static void welch_frame(WelchPSD *w, const int16_t *samples, double weight) {
+    SpectrogramWorkspace *ws = &w->ws;
+    int num_bins = w->num_bins;
+    double *row = ws->row;
+
+    dsp_kernels()->window_s16(samples, ws->window, ws->fft_buffer, w->fft_size);
+    fft_execute(&ws->plan, ws->fft_buffer);
+
+    SpectrogramOptions options;
+    if (w->averaging == WELCH_AVERAGE_MEDIAN) {
+        spectrogram_options_init(&options, SPEC_MODE_DB);
+        spectrogram_convert_bins(ws->fft_buffer, row, num_bins, &options);
+        uint32_t *hist = w->hist;
+        for (int b = 0; b < num_bins; b++, hist += WELCH_MEDIAN_CELLS) {
+            int cell = (int)((row[b] - WELCH_MEDIAN_DB_MIN) * (1.0 / WELCH_MEDIAN_DB_STEP));
+            if (cell < 0) cell = 0;
+            if (cell >= WELCH_MEDIAN_CELLS) cell = WELCH_MEDIAN_CELLS - 1;
+            hist[cell]++;
+        }
+    } else {
+        spectrogram_options_init(&options, SPEC_MODE_POWER);
+        spectrogram_convert_bins(ws->fft_buffer, row, num_bins, &options);
+        double *accum = w->accum;
+        if (w->averaging == WELCH_AVERAGE_EXPONENTIAL) {
+            double alpha = w->num_frames == 0 ? 1.0 : w->alpha;
+            for (int b = 0; b < num_bins; b++) {
+                accum[b] += alpha * (row[b] - accum[b]);
+            }
+        } else {
+            for (int b = 0; b < num_bins; b++) {
+                accum[b] += weight * row[b];
+            }
+        }
+    }
+    w->num_frames++;
+}
+
+/* Internal helper: add src's sums or histograms into dst */
+static void welch_add(WelchPSD *dst, const WelchPSD *src) {
+    if (dst->averaging == WELCH_AVERAGE_MEDIAN) {
+        size_t cells = (size_t)dst->num_bins * WELCH_MEDIAN_CELLS;
+        for (size_t i = 0; i < cells; i++) {
+            dst->hist[i] += src->hist[i];
+        }
+    } else {
+        for (int b = 0; b < dst->num_bins; b++) {
+            dst->accum[b] += src->accum[b];
+        }
+    }
+    dst->num_frames += src->num_frames;
+}
+
+/* Internal helper: median of bin b's histogram as power, interpolated within the cell */
+static double welch_hist_median(const WelchPSD *w, int b) {
+    const uint32_t *hist = w->hist + (size_t)b * WELCH_MEDIAN_CELLS;
+    double target = 0.5 * w->num_frames;
+    double below = 0.0;
+    int cell;
+    for (cell = 0; cell < WELCH_MEDIAN_CELLS - 1; cell++) {
+        if (hist[cell] > 0 && below + hist[cell] >= target) break;
+        below += hist[cell];
+    }
+    double frac = hist[cell] > 0 ? (target - below) / hist[cell] : 0.5;
+    double db = WELCH_MEDIAN_DB_MIN + WELCH_MEDIAN_DB_STEP * (cell + frac);
+    return pow(10.0, db / 10.0);
+}
+
+/* Internal helper: ratio of the median to the mean of n chi-squared (2 dof)
+ * periodogram values; tends to ln 2 */
+static double welch_median_bias(long n) {
+    double bias = 1.0;
+    for (long i = 2; i <= n - 1; i += 2) {
+        bias += 1.0 / (i + 1) - 1.0 / i;
+    }
+    return bias;
+}
+
+/* Internal helper: thread pool task, one frame */
+static void welch_task(void *ctx, size_t task, int worker) {
+    WelchJob *job = ctx;
+    long f = (long)task;
+    double weight = 1.0;
+    if (job->exponential) {
+        double decay = pow(1.0 - job->alpha, (double)(job->num_frames - 1 - f));
+        weight = f == 0 ? decay : job->alpha * decay;
+    }
+    welch_frame(&job->states[worker], job->wav->samples + (size_t)f * job->hop_size, weight);
+}
+
+/******************************************************************************
+ * welch_init
+ *
+ * @param[out] w           Pointer to WelchPSD to initialize
+ * @param[in]  fft_size    Frame length (power of two)
+ * @param[in]  hop_size    Frame advance, 1 .. fft_size (fft_size / 2 is usual)
+ * @param[in]  window_type Analysis window
+ * @param[in]  averaging   Combination rule
+ * @param[in]  alpha       Weight of the newest frame, 0 < alpha <= 1 (exponential only)
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @warning Must call welch_free() to release memory.
+ */
+int welch_init(WelchPSD *w, int fft_size, int hop_size, WindowType window_type,
+               WelchAveraging averaging, double alpha) {
+    w->owned_mem = NULL;
+    size_t size = welch_mem_size(fft_size, averaging);
+    if (size == 0) return -1;
+
+    void *mem = malloc(size);
+    if (!mem) return -2;
+    if (welch_init_mem(w, fft_size, hop_size, window_type, averaging, alpha, mem) != 0) {
+        free(mem);
+        return -1;
+    }
+    w->owned_mem = mem;
+    return 0;
+}
+/* End of welch_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * welch_mem_size
+ *
+ * @param[in] fft_size  Frame length (power of two)
+ * @param[in] averaging Combination rule; the median adds
+ *                      num_bins * WELCH_MEDIAN_CELLS counters
+ *
+ * @returns Bytes of memory welch_init_mem() needs, 0 on invalid arguments
+ */
+size_t welch_mem_size(int fft_size, WelchAveraging averaging) {
+    size_t ws_size = spectrogram_workspace_mem_size(fft_size);
+    if (ws_size == 0) return 0;
+    if (averaging != WELCH_AVERAGE_MEAN && averaging != WELCH_AVERAGE_EXPONENTIAL &&
+        averaging != WELCH_AVERAGE_MEDIAN) return 0;
+
+    size_t num_bins = fft_size / 2 + 1;
+    size_t size = ws_size +
+                  DSP_MEM_ALIGN_UP(num_bins * sizeof(double)) +
+                  DSP_MEM_ALIGN_UP(fft_size * sizeof(int16_t));
+    if (averaging == WELCH_AVERAGE_MEDIAN) {
+        size += DSP_MEM_ALIGN_UP(num_bins * WELCH_MEDIAN_CELLS * sizeof(uint32_t));
+    }
+    return size;
+}
+/* End of welch_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * welch_init_mem
+ *
+ * @param[out] w           Pointer to WelchPSD to initialize
+ * @param[in]  fft_size    Frame length (power of two)
+ * @param[in]  hop_size    Frame advance, 1 .. fft_size
+ * @param[in]  window_type Analysis window
+ * @param[in]  averaging   Combination rule
+ * @param[in]  alpha       Weight of the newest frame (exponential only)
+ * @param[in]  mem         At least welch_mem_size(fft_size, averaging) bytes
+ *                         aligned for double; must outlive w
+ *
+ * @returns 0 on success, -1 on invalid arguments
+ *
+ * @note Performs no allocation.
+ */
+int welch_init_mem(WelchPSD *w, int fft_size, int hop_size, WindowType window_type,
+                   WelchAveraging averaging, double alpha, void *mem) {
+    w->owned_mem = NULL;
+    size_t size = welch_mem_size(fft_size, averaging);
+    if (size == 0 || hop_size < 1 || hop_size > fft_size) return -1;
+    if (averaging == WELCH_AVERAGE_EXPONENTIAL && !(alpha > 0.0 && alpha <= 1.0)) return -1;
+
+    DspArena arena;
+    dsp_arena_init(&arena, mem, size);
+    size_t ws_size = spectrogram_workspace_mem_size(fft_size);
+    spectrogram_workspace_init_mem(&w->ws, fft_size, window_type,
+                                   dsp_arena_alloc(&arena, ws_size));
+
+    w->fft_size = fft_size;
+    w->hop_size = hop_size;
+    w->num_bins = fft_size / 2 + 1;
+    w->averaging = averaging;
+    w->alpha = alpha;
+    w->accum = dsp_arena_alloc(&arena, w->num_bins * sizeof(double));
+    w->pending = dsp_arena_alloc(&arena, fft_size * sizeof(int16_t));
+    w->hist = averaging == WELCH_AVERAGE_MEDIAN
+            ? dsp_arena_alloc(&arena, (size_t)w->num_bins * WELCH_MEDIAN_CELLS * sizeof(uint32_t))
+            : NULL;
+    welch_reset(w);
+    return 0;
+}
+/* End of welch_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * welch_reset
+ *
+ * @param[in,out] w Estimator; keeps its configuration
+ */
+void welch_reset(WelchPSD *w) {
+    memset(w->accum, 0, w->num_bins * sizeof(double));
+    if (w->hist) {
+        memset(w->hist, 0, (size_t)w->num_bins * WELCH_MEDIAN_CELLS * sizeof(uint32_t));
+    }
+    w->fill = 0;
+    w->num_frames = 0;
+}
+/* End of welch_reset() */
+/******************************************************************************/
+
+/******************************************************************************
+ * welch_push
+ *
+ * @param[in,out] w           Estimator
+ * @param[in]     samples     Mono 16-bit samples
+ * @param[in]     num_samples Number of samples; any block size
+ *
+ * @note Frames start every hop_size samples from the first sample pushed
+ *       since the last reset, exactly as in compute_spectrogram(), and only
+ *       complete frames count. Performs no allocation.
+ */
+void welch_push(WelchPSD *w, const int16_t *samples, size_t num_samples) {
+    DSP_PROFILE_BEGIN(DSP_PROF_WELCH);
+    int fft_size = w->fft_size;
+    while (num_samples > 0) {
+        size_t take = (size_t)(fft_size - w->fill);
+        if (take > num_samples) take = num_samples;
+        memcpy(w->pending + w->fill, samples, take * sizeof(int16_t));
+        w->fill += (int)take;
+        samples += take;
+        num_samples -= take;
+
+        if (w->fill == fft_size) {
+            welch_frame(w, w->pending, 1.0);
+            w->fill = fft_size - w->hop_size;
+            memmove(w->pending, w->pending + w->hop_size, w->fill * sizeof(int16_t));
+        }
+    }
+    DSP_PROFILE_END(DSP_PROF_WELCH);
+}
+/* End of welch_push() */
+/******************************************************************************/
+
+/******************************************************************************
+ * welch_merge
+ *
+ * @param[in,out] dst Estimator receiving the frames
+ * @param[in]     src Estimator over another part of the signal
+ *
+ * @returns 0 on success, -1 when the two do not match (fft size, window,
+ *          averaging) or use exponential averaging, which depends on order
+ *
+ * @note Lets callers run their own threads, one estimator each, and reduce
+ *       at the end. src is left unchanged; buffered samples are not merged.
+ */
+int welch_merge(WelchPSD *dst, const WelchPSD *src) {
+    if (dst->fft_size != src->fft_size || dst->averaging != src->averaging ||
+        dst->ws.window_type != src->ws.window_type ||
+        dst->averaging == WELCH_AVERAGE_EXPONENTIAL) return -1;
+    welch_add(dst, src);
+    return 0;
+}
+/* End of welch_merge() */
+/******************************************************************************/
+
+/******************************************************************************
+ * welch_estimate
+ *
+ * @param[in]  w           Estimator
+ * @param[in]  sample_rate Sample rate in Hz, or <= 0 for density per unit
+ *                         normalized frequency (cycles/sample)
+ * @param[out] psd         One-sided density [num_bins], full scale = 1.0
+ *
+ * @returns 0 on success, -1 if no frame has completed yet
+ *
+ * @note Density scaling 1 / (fs * sum(window^2)); every bin except DC and
+ *       Nyquist is doubled, so the sum over bins times fs / fft_size is the
+ *       signal power. The median is divided by its bias for the frame count
+ *       (about ln 2), so all three modes estimate the same quantity.
+ */
+int welch_estimate(const WelchPSD *w, int sample_rate, double *psd) {
+    if (w->num_frames == 0) return -1;
+
+    double sum_w2 = 0.0;
+    for (int i = 0; i < w->fft_size; i++) {
+        sum_w2 += w->ws.window[i] * w->ws.window[i];
+    }
+    double scale = 1.0 / ((sample_rate > 0 ? sample_rate : 1.0) * sum_w2);
+    if (w->averaging == WELCH_AVERAGE_MEAN) {
+        scale /= w->num_frames;
+    } else if (w->averaging == WELCH_AVERAGE_MEDIAN) {
+        scale /= welch_median_bias(w->num_frames);
+    }
+
+    for (int b = 0; b < w->num_bins; b++) {
+        double p = w->averaging == WELCH_AVERAGE_MEDIAN ? welch_hist_median(w, b) : w->accum[b];
+        if (b != 0 && b != w->num_bins - 1) p *= 2.0;
+        psd[b] = p * scale;
+    }
+    return 0;
+}
+/* End of welch_estimate() */
+/******************************************************************************/
+
+/******************************************************************************
+ * welch_compute
+ *
+ * @param[in]  wav         Mono WAV
+ * @param[in]  fft_size    Frame length (power of two)
+ * @param[in]  hop_size    Frame advance, 1 .. fft_size
+ * @param[in]  window_type Analysis window
+ * @param[in]  averaging   Combination rule
+ * @param[in]  alpha       Weight of the newest frame (exponential only)
+ * @param[in]  pool        Thread pool, or NULL to run on the calling thread
+ * @param[out] psd         One-sided density [fft_size / 2 + 1], as welch_estimate()
+ *                         with wav->sample_rate
+ *
+ * @returns Number of frames averaged, -1 on invalid arguments or a WAV
+ *          shorter than one frame, -2 on allocation failure
+ *
+ * @note Frames are the pool's tasks. Each worker accumulates into its own
+ *       estimator and the estimators are summed at the end, so the memory
+ *       is one estimator per worker. The median result does not depend on
+ *       the thread count; mean and exponential results vary only by
+ *       summation rounding.
+ */
+long welch_compute(const WavData *wav, int fft_size, int hop_size, WindowType window_type,
+                   WelchAveraging averaging, double alpha, ThreadPool *pool, double *psd) {
+    if (!wav || !psd || wav->num_channels != 1 || hop_size < 1 || hop_size > fft_size) return -1;
+    if (averaging == WELCH_AVERAGE_EXPONENTIAL && !(alpha > 0.0 && alpha <= 1.0)) return -1;
+    long num_frames = spectrogram_frame_count(wav, fft_size, hop_size);
+    if (num_frames == 0 || welch_mem_size(fft_size, averaging) == 0) return -1;
+    DSP_PROFILE_BEGIN(DSP_PROF_WELCH);
+
+    // Exponential weights are applied per frame, so the workers just sum
+    WelchAveraging worker_averaging =
+        averaging == WELCH_AVERAGE_MEDIAN ? WELCH_AVERAGE_MEDIAN : WELCH_AVERAGE_MEAN;
+    int num_workers = pool ? pool->num_threads : 1;
+    WelchPSD *states = calloc(num_workers, sizeof(WelchPSD));
+    if (!states) {
+        DSP_PROFILE_END(DSP_PROF_WELCH);
+        return -2;
+    }
+    long ret = num_frames;
+    int ready;
+    for (ready = 0; ready < num_workers; ready++) {
+        if (welch_init(&states[ready], fft_size, hop_size, window_type,
+                       worker_averaging, alpha) != 0) {
+            ret = -2;
+            break;
+        }
+    }
+
+    if (ret > 0) {
+        WelchJob job = { wav, states, hop_size, num_frames,
+                         averaging == WELCH_AVERAGE_EXPONENTIAL, alpha };
+        if (pool) {
+            thread_pool_run(pool, (size_t)num_frames, welch_task, &job);
+        } else {
+            for (long f = 0; f < num_frames; f++) {
+                welch_task(&job, (size_t)f, 0);
+            }
+        }
+
+        for (int i = 1; i < num_workers; i++) {
+            welch_add(&states[0], &states[i]);
+        }
+        // The weighted sum already is the exponential average
+        states[0].averaging = averaging;
+        welch_estimate(&states[0], wav->sample_rate, psd);
+    }
+
+    for (int i = 0; i < ready; i++) {
+        welch_free(&states[i]);
+    }
+    free(states);
+    DSP_PROFILE_END(DSP_PROF_WELCH);
+    return ret;
+}
+/* End of welch_compute() */
+/******************************************************************************/
+
+/******************************************************************************
+ * welch_free
+ *
+ * @param[in,out] w Estimator; caller memory from welch_init_mem() is left alone
+ */
+void welch_free(WelchPSD *w) {
+    free(w->owned_mem);
+    w->owned_mem = NULL;
+    w->accum = NULL;
+    w->hist = NULL;
+    w->pending = NULL;
+}
+/* End of welch_free() */
+/******************************************************************************/
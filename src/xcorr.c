@@ -0,0 +1,323 @@
+/*
+ * @file xcorr.c
+ *
+ * FFT-based cross-correlation and GCC-PHAT time-delay estimation.
+ *
+ * Both signals are zero-padded to fft_size >= 2 * max_len, so the circular
+ * correlation from the inverse transform equals the linear one for every
+ * lag |tau| < len. Positive lags sit at corr[tau], negative lags wrap to
+ * corr[fft_size + tau].
+ *
+ * GCC-PHAT divides each cross-spectrum bin by its magnitude, which whitens
+ * the correlation and sharpens the peak under reverberation.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xcorr.h"
+#include "dsp_alloc.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define PHAT_EPSILON 1e-30
+
+/* Internal helper: real FFT of samples [len] zero-padded to fft_size */
+static void padded_spectrum(XCorr *xc, const double *samples, int len, Complex *out) {
+    memcpy(xc->frame, samples, len * sizeof(double));
+    memset(xc->frame + len, 0, (xc->fft_size - len) * sizeof(double));
+    rfft_execute(&xc->plan, xc->frame, out);
+}
+
+/* Internal helper: weighted cross-spectrum X conj(Y), inverse transform, and
+ * extraction of lags -max_lag..max_lag into out */
+static void correlate_spectra(XCorr *xc, const Complex *x, const Complex *y,
+                              XcorrWeighting weighting, int max_lag, double *out) {
+    for (int k = 0; k < xc->num_bins; k++) {
+        Complex g = {
+            x[k].real * y[k].real + x[k].imag * y[k].imag,
+            x[k].imag * y[k].real - x[k].real * y[k].imag
+        };
+        if (weighting == XCORR_PHAT) {
+            double mag = complex_mag(g);
+            if (mag > PHAT_EPSILON) {
+                g.real /= mag;
+                g.imag /= mag;
+            } else {
+                g.real = g.imag = 0.0;
+            }
+        }
+        xc->cross[k] = g;
+    }
+
+    irfft_execute(&xc->plan, xc->cross, xc->corr);
+
+    for (int tau = -max_lag; tau <= max_lag; tau++) {
+        out[max_lag + tau] = xc->corr[tau >= 0 ? tau : xc->fft_size + tau];
+    }
+}
+
+/* Internal helper: transform length for signals up to max_len samples */
+static int xcorr_fft_size(int max_len) {
+    int fft_size = 4;
+    while (fft_size < 2 * max_len) fft_size *= 2;
+    return fft_size;
+}
+
+/******************************************************************************
+ * xcorr_init
+ *
+ * @param[out] xc           Pointer to XCorr struct to initialize
+ * @param[in]  max_len      Longest signal that will be correlated
+ * @param[in]  max_channels Most channels passed to xcorr_wav_pairs() (0 if unused)
+ *
+ * @returns 0 on success, -1 on invalid arguments, -2 on allocation failure
+ *
+ * @warning Must call xcorr_free() to release memory.
+ */
+int xcorr_init(XCorr *xc, int max_len, int max_channels) {
+    memset(xc, 0, sizeof(*xc));
+    size_t size = xcorr_mem_size(max_len, max_channels);
+    if (size == 0) return -1;
+
+    void *mem = malloc(size);
+    if (!mem) return -2;
+    xcorr_init_mem(xc, max_len, max_channels, mem);
+    xc->owned_mem = mem;
+    return 0;
+}
+/* End of xcorr_init() */
+/******************************************************************************/
+
+/******************************************************************************
+ * xcorr_mem_size
+ *
+ * @param[in] max_len      Longest signal that will be correlated
+ * @param[in] max_channels Most channels passed to xcorr_wav_pairs() (0 if unused)
+ *
+ * @returns Bytes of memory xcorr_init_mem() needs, 0 on invalid arguments
+ */
+size_t xcorr_mem_size(int max_len, int max_channels) {
+    if (max_len < 2 || max_channels < 0) return 0;
+
+    int fft_size = xcorr_fft_size(max_len);
+    int num_bins = fft_size / 2 + 1;
+    // At least two spectra for xcorr_process()
+    int num_spectra = max_channels > 2 ? max_channels : 2;
+    return rfft_plan_mem_size(fft_size) +
+           2 * DSP_MEM_ALIGN_UP(fft_size * sizeof(double)) +
+           DSP_MEM_ALIGN_UP(num_bins * sizeof(Complex)) +
+           DSP_MEM_ALIGN_UP((size_t)num_spectra * num_bins * sizeof(Complex));
+}
+/* End of xcorr_mem_size() */
+/******************************************************************************/
+
+/******************************************************************************
+ * xcorr_init_mem
+ *
+ * @param[out] xc           Pointer to XCorr struct to initialize
+ * @param[in]  max_len      Longest signal that will be correlated
+ * @param[in]  max_channels Most channels passed to xcorr_wav_pairs() (0 if unused)
+ * @param[in]  mem          At least xcorr_mem_size() bytes aligned for double;
+ *                          must outlive the workspace
+ *
+ * @returns 0 on success, -1 on invalid arguments
+ *
+ * @note Performs no allocation.
+ */
+int xcorr_init_mem(XCorr *xc, int max_len, int max_channels, void *mem) {
+    memset(xc, 0, sizeof(*xc));
+    size_t size = xcorr_mem_size(max_len, max_channels);
+    if (size == 0 || !mem) return -1;
+
+    int fft_size = xcorr_fft_size(max_len);
+    xc->max_len = max_len;
+    xc->max_channels = max_channels;
+    xc->fft_size = fft_size;
+    xc->num_bins = fft_size / 2 + 1;
+
+    int num_spectra = max_channels > 2 ? max_channels : 2;
+    DspArena arena;
+    dsp_arena_init(&arena, mem, size);
+    rfft_plan_init_mem(&xc->plan, fft_size,
+                       dsp_arena_alloc(&arena, rfft_plan_mem_size(fft_size)));
+    xc->frame = dsp_arena_alloc(&arena, fft_size * sizeof(double));
+    xc->corr = dsp_arena_alloc(&arena, fft_size * sizeof(double));
+    xc->cross = dsp_arena_alloc(&arena, xc->num_bins * sizeof(Complex));
+    xc->spectra = dsp_arena_alloc(&arena, (size_t)num_spectra * xc->num_bins * sizeof(Complex));
+    return 0;
+}
+/* End of xcorr_init_mem() */
+/******************************************************************************/
+
+/******************************************************************************
+ * xcorr_process
+ *
+ * @param[in,out] xc        Workspace
+ * @param[in]     x         First signal [len]
+ * @param[in]     y         Second signal [len]
+ * @param[in]     len       Signal length (<= max_len)
+ * @param[in]     weighting XCORR_PLAIN or XCORR_PHAT
+ * @param[in]     max_lag   Largest lag of interest (< len)
+ * @param[out]    out       Correlation at lags -max_lag..max_lag [2 * max_lag + 1]
+ *
+ * @returns 0 on success, -1 on invalid arguments
+ */
+int xcorr_process(XCorr *xc, const double *x, const double *y, int len,
+                  XcorrWeighting weighting, int max_lag, double *out) {
+    if (len < 1 || len > xc->max_len || max_lag < 0 || max_lag >= len) return -1;
+
+    Complex *spec_x = xc->spectra;
+    Complex *spec_y = xc->spectra + xc->num_bins;
+    padded_spectrum(xc, x, len, spec_x);
+    padded_spectrum(xc, y, len, spec_y);
+    correlate_spectra(xc, spec_x, spec_y, weighting, max_lag, out);
+    return 0;
+}
+/* End of xcorr_process() */
+/******************************************************************************/
+
+/******************************************************************************
+ * xcorr_peak_lag
+ *
+ * @param[in]  corr    Correlation at lags -max_lag..max_lag [2 * max_lag + 1]
+ * @param[in]  max_lag Largest lag
+ * @param[out] peak    Interpolated peak value (may be NULL)
+ *
+ * @returns Lag of the maximum, refined by fitting a parabola through the
+ *          peak and its two neighbours
+ *
+ * @note A peak at either end of the range is returned without refinement.
+ */
+double xcorr_peak_lag(const double *corr, int max_lag, double *peak) {
+    int count = 2 * max_lag + 1;
+    int best = 0;
+    for (int i = 1; i < count; i++) {
+        if (corr[i] > corr[best]) best = i;
+    }
+
+    double offset = 0.0;
+    double value = corr[best];
+    if (best > 0 && best < count - 1) {
+        double l = corr[best - 1], c = corr[best], r = corr[best + 1];
+        double denom = l - 2.0 * c + r;
+        if (denom < 0.0) {
+            offset = 0.5 * (l - r) / denom;
+            value = c - 0.25 * (l - r) * offset;
+        }
+    }
+
+    if (peak) *peak = value;
+    return best - max_lag + offset;
+}
+/* End of xcorr_peak_lag() */
+/******************************************************************************/
+
+/******************************************************************************
+ * xcorr_delay
+ *
+ * @param[in,out] xc        Workspace
+ * @param[in]     x         First signal [len]
+ * @param[in]     y         Second signal [len]
+ * @param[in]     len       Signal length (<= max_len)
+ * @param[in]     weighting XCORR_PLAIN or XCORR_PHAT
+ * @param[in]     max_lag   Search range in samples (< len)
+ * @param[out]    peak      Correlation peak value (may be NULL)
+ *
+ * @returns Delay of x relative to y in samples
+ */
+double xcorr_delay(XCorr *xc, const double *x, const double *y, int len,
+                   XcorrWeighting weighting, int max_lag, double *peak) {
+    // corr holds the full circular result; the lag window goes to frame
+    if (xcorr_process(xc, x, y, len, weighting, max_lag, xc->frame) != 0) {
+        if (peak) *peak = 0.0;
+        return 0.0;
+    }
+    return xcorr_peak_lag(xc->frame, max_lag, peak);
+}
+/* End of xcorr_delay() */
+/******************************************************************************/
+
+/******************************************************************************
+ * xcorr_wav_pairs
+ *
+ * @param[in,out] xc         Workspace with max_channels >= wav->num_channels
+ * @param[in]     wav        Interleaved multichannel WAV data
+ * @param[in]     start      First frame of the segment
+ * @param[in]     len        Segment length in frames (<= max_len)
+ * @param[in]     pairs      Channel pairs, or NULL for all pairs a < b
+ * @param[in]     num_pairs  Number of entries in pairs (ignored when NULL)
+ * @param[in]     weighting  XCORR_PLAIN or XCORR_PHAT
+ * @param[in]     max_lag    Search range in samples (< len)
+ * @param[out]    delays_out Delay of channel a relative to b per pair
+ * @param[out]    peaks_out  Peak value per pair (may be NULL)
+ *
+ * @returns Number of pairs processed, or -1 on invalid arguments
+ *
+ * @note Each channel is transformed once, so C channels and P pairs cost
+ *       C forward and P inverse FFTs.
+ */
+int xcorr_wav_pairs(XCorr *xc, const WavData *wav, size_t start, int len,
+                    const XcorrPair *pairs, int num_pairs, XcorrWeighting weighting,
+                    int max_lag, double *delays_out, double *peaks_out) {
+    int channels = wav->num_channels;
+    size_t frames = (size_t)wav->num_samples / channels;
+    if (channels < 2 || channels > xc->max_channels || len < 1 || len > xc->max_len ||
+        start + len > frames || max_lag < 0 || max_lag >= len) {
+        return -1;
+    }
+
+    // One forward transform per channel
+    for (int ch = 0; ch < channels; ch++) {
+        const int16_t *src = wav->samples + start * channels + ch;
+        for (int i = 0; i < len; i++) {
+            xc->frame[i] = src[(size_t)i * channels] / 32768.0;
+        }
+        memset(xc->frame + len, 0, (xc->fft_size - len) * sizeof(double));
+        rfft_execute(&xc->plan, xc->frame, xc->spectra + (size_t)ch * xc->num_bins);
+    }
+
+    if (!pairs) num_pairs = channels * (channels - 1) / 2;
+
+    int a = 0, b = 1;
+    for (int p = 0; p < num_pairs; p++) {
+        if (pairs) {
+            a = pairs[p].a;
+            b = pairs[p].b;
+            if (a < 0 || a >= channels || b < 0 || b >= channels) return -1;
+        }
+
+        correlate_spectra(xc, xc->spectra + (size_t)a * xc->num_bins,
+                          xc->spectra + (size_t)b * xc->num_bins, weighting, max_lag, xc->frame);
+        double peak;
+        delays_out[p] = xcorr_peak_lag(xc->frame, max_lag, &peak);
+        if (peaks_out) peaks_out[p] = peak;
+
+        if (!pairs && ++b == channels) {
+            a++;
+            b = a + 1;
+        }
+    }
+    return num_pairs;
+}
+/* End of xcorr_wav_pairs() */
+/******************************************************************************/
+
+/******************************************************************************
+ * xcorr_free
+ *
+ * @param[in,out] xc Pointer to XCorr
+ */
+void xcorr_free(XCorr *xc) {
+    free(xc->owned_mem);
+    xc->owned_mem = NULL;
+    xc->frame = xc->corr = NULL;
+    xc->cross = xc->spectra = NULL;
+}
+/* End of xcorr_free() */
+/******************************************************************************/
@@ -0,0 +1,674 @@
+/*
+ * @file dsp_batch.c
+ *
+ * Batch processor for directories or lists of WAV files.
+ *
+ * Usage:
+ *   dsp_batch -o OUTDIR [-s SPEC] [-j N] [-l LIST] [-q] [FILE | DIR]...
+ *
+ *   -o OUTDIR  directory for the outputs (must exist)
+ *   -s SPEC    processing spec, default "spectrogram":
+ *                spectrogram[:fft=1024,hop=256,window=hann|hamming,
+ *                            mode=mag|power|db,dtype=f32|f64|f16|u8,
+ *                            floor=X,ceil=X]
+ *                    dtype=u8 stores dB as 8-bit codes over [floor, ceil]
+ *                    (default -120 .. 60 dB)
+ *                    -> OUTDIR/<name>.dsps (see spectrogram_io.h)
+ *                fir:taps=101,cutoff=HZ   windowed-sinc lowpass, or
+ *                fir:coeffs=FILE          whitespace-separated taps
+ *                    -> OUTDIR/<name>.wav
+ *   -j N       worker threads (default: online CPUs)
+ *   -l LIST    read input paths from LIST, one per line ("-" for stdin)
+ *   -q         print only the summary
+ *   DIR        every *.wav directly inside DIR, in name order
+ *
+ * Files run on a work-stealing thread pool. Each worker builds its FFT plan,
+ * window, FIR filter and sample buffers once and reuses them for every file
+ * it processes, growing the sample buffer only when a longer file arrives.
+ * Per-file lines (status, milliseconds, samples, path) follow the input
+ * order, then a summary gives files/s, samples/s and the realtime factor.
+ * Inputs must be mono 16-bit PCM. The exit status is 1 if any file failed,
+ * 2 on bad arguments, including two inputs that map to the same output.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <ctype.h>
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "dsp_cpu.h"
+#include "fir_filter.h"
+#include "spectrogram.h"
+#include "spectrogram_io.h"
+#include "thread_pool.h"
+#include "wav.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define PI 3.14159265358979323846
+#define BATCH_BLOCK 4096        /* frames per FIR streaming block */
+#define BATCH_MAX_TAPS 8192
+#define BATCH_U8_DB_FLOOR (-120.0)   /* default dtype=u8 range in dB */
+#define BATCH_U8_DB_CEILING 60.0
+
+typedef enum {
+    BATCH_SPECTROGRAM,
+    BATCH_FIR
+} BatchKind;
+
+/* Parsed processing spec */
+typedef struct {
+    BatchKind kind;
+    int fft_size;
+    int hop_size;
+    WindowType window_type;
+    SpectrogramOptions options;
+    SpecDtype dtype;
+    float scale;              /* uint8 dB code step */
+    float offset;             /* uint8 dB of code 0 */
+    int num_taps;
+    double cutoff_hz;         /* lowpass design cutoff, 0 when coeffs are given */
+    double *coeffs;           /* taps read from a file, NULL for the lowpass design */
+} BatchSpec;
+
+/* Per-worker reusable state */
+typedef struct {
+    int16_t *samples;         /* whole-file buffer (spectrogram) [capacity] */
+    size_t capacity;
+    SpectrogramWorkspace ws;  /* plan, window and FFT buffer */
+    int has_ws;
+    void *fir_mem;            /* fir_filter_mem_size(num_taps) bytes */
+    FIRFilter fir;
+    double *taps;             /* designed taps [num_taps] */
+    int fir_rate;             /* sample rate the taps were designed for, 0 if none */
+    double in[BATCH_BLOCK];
+    double out[BATCH_BLOCK];
+    int16_t pcm[BATCH_BLOCK];
+} BatchWorker;
+
+/* Outcome of one file */
+typedef struct {
+    const char *error;        /* NULL on success */
+    size_t samples;
+    int sample_rate;
+    double ms;
+} BatchResult;
+
+typedef struct {
+    const BatchSpec *spec;
+    const char *out_dir;
+    char **paths;
+    BatchResult *results;
+    BatchWorker *workers;
+} BatchJob;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+/* Internal helper: OUTDIR/<basename without extension><ext> */
+static void output_path(char *buf, size_t size, const char *out_dir, const char *in, const char *ext) {
+    const char *base = strrchr(in, '/');
+    base = base ? base + 1 : in;
+    const char *dot = strrchr(base, '.');
+    int len = dot && dot != base ? (int)(dot - base) : (int)strlen(base);
+    snprintf(buf, size, "%s/%.*s%s", out_dir, len, base, ext);
+}
+
+/* Internal helper: unit-DC-gain Hamming-windowed sinc lowpass */
+static void design_lowpass(double *h, int num_taps, double cutoff_hz, int sample_rate) {
+    double fc = cutoff_hz / sample_rate;
+    double mid = (num_taps - 1) / 2.0;
+    double sum = 0.0;
+    for (int i = 0; i < num_taps; i++) {
+        double t = i - mid;
+        double sinc = t == 0.0 ? 2 * fc : sin(2 * PI * fc * t) / (PI * t);
+        double w = num_taps > 1 ? 0.54 - 0.46 * cos(2 * PI * i / (num_taps - 1)) : 1.0;
+        h[i] = sinc * w;
+        sum += h[i];
+    }
+    for (int i = 0; i < num_taps; i++) {
+        h[i] /= sum;
+    }
+}
+
+/******************************************************************************/
+/* per-file processing */
+
+static int write_frame(int frame, const double *bins, int num_bins, void *user) {
+    (void)frame;
+    (void)num_bins;
+    return spec_writer_write_frame((SpecWriter *)user, bins);
+}
+
+/* Internal helper: spectrogram of one file into OUTDIR/<name>.dsps */
+static const char *run_spectrogram(const BatchJob *job, BatchWorker *w, const char *path,
+                                   BatchResult *res) {
+    const BatchSpec *spec = job->spec;
+    WavReader reader;
+    if (wav_reader_open(&reader, path) != 0) return "cannot read WAV";
+    if (reader.num_channels != 1) {
+        wav_reader_close(&reader);
+        return "not mono";
+    }
+
+    if (reader.frames_left > SIZE_MAX / sizeof(int16_t)) {
+        wav_reader_close(&reader);
+        return "too long";
+    }
+    size_t frames = reader.frames_left;
+    if (frames > w->capacity) {
+        int16_t *grown = realloc(w->samples, frames * sizeof(int16_t));
+        if (!grown) {
+            wav_reader_close(&reader);
+            return "out of memory";
+        }
+        w->samples = grown;
+        w->capacity = frames;
+    }
+    size_t got = wav_reader_read(&reader, w->samples, frames);
+    wav_reader_close(&reader);
+
+    WavData wav = { reader.sample_rate, 1, 16, got, w->samples };
+    res->samples = got;
+    res->sample_rate = wav.sample_rate;
+
+    SpecFileInfo info = {
+        .sample_rate = wav.sample_rate,
+        .fft_size = spec->fft_size,
+        .hop_size = spec->hop_size,
+        .window_type = spec->window_type,
+        .num_bins = spec->fft_size / 2 + 1,
+        .dtype = spec->dtype,
+        .scale = spec->scale,
+        .offset = spec->offset,
+    };
+    char out[4096];
+    output_path(out, sizeof(out), job->out_dir, path, ".dsps");
+
+    SpecWriter writer;
+    if (spec_writer_open(&writer, out, &info) != 0) return "cannot create output";
+    int n = spectrogram_workspace_for_each_frame(&w->ws, &wav, spec->hop_size, &spec->options,
+                                                 write_frame, &writer);
+    if (spec_writer_close(&writer) != 0 || n < 0) return "write failed";
+    return NULL;
+}
+
+/* Internal helper: stream one file through the FIR into OUTDIR/<name>.wav */
+static const char *run_fir(const BatchJob *job, BatchWorker *w, const char *path,
+                           BatchResult *res) {
+    const BatchSpec *spec = job->spec;
+    WavReader reader;
+    if (wav_reader_open(&reader, path) != 0) return "cannot read WAV";
+    if (reader.num_channels != 1) {
+        wav_reader_close(&reader);
+        return "not mono";
+    }
+    res->sample_rate = reader.sample_rate;
+
+    // Designed taps depend on the rate; rebuild in place when it changes
+    if (!spec->coeffs && w->fir_rate != reader.sample_rate) {
+        if (spec->cutoff_hz >= reader.sample_rate / 2.0) {
+            wav_reader_close(&reader);
+            return "cutoff above Nyquist";
+        }
+        design_lowpass(w->taps, spec->num_taps, spec->cutoff_hz, reader.sample_rate);
+        fir_filter_init_mem(&w->fir, w->taps, spec->num_taps, w->fir_mem);
+        w->fir_rate = reader.sample_rate;
+    }
+    fir_filter_reset(&w->fir);
+
+    char out[4096];
+    output_path(out, sizeof(out), job->out_dir, path, ".wav");
+    if (strcmp(out, path) == 0) {
+        wav_reader_close(&reader);
+        return "output would overwrite input";
+    }
+    WavWriter writer;
+    if (wav_writer_open(&writer, out, reader.sample_rate, 1) != 0) {
+        wav_reader_close(&reader);
+        return "cannot create output";
+    }
+
+    const DspKernels *kernels = dsp_kernels();
+    const char *error = NULL;
+    size_t n;
+    while ((n = wav_reader_read(&reader, w->pcm, BATCH_BLOCK)) > 0) {
+        kernels->s16_to_double(w->pcm, w->in, n);
+        fir_filter_process_block(&w->fir, w->in, w->out, n);
+        kernels->double_to_s16(w->out, w->pcm, n);
+        if (wav_writer_write(&writer, w->pcm, n) != 0) {
+            error = "write failed";
+            break;
+        }
+        res->samples += n;
+    }
+    wav_reader_close(&reader);
+    if (wav_writer_close(&writer) != 0 && !error) error = "write failed";
+    return error;
+}
+
+/* Thread pool task: one file */
+static void batch_task(void *ctx, size_t task, int worker) {
+    BatchJob *job = ctx;
+    BatchResult *res = &job->results[task];
+    double t0 = now_ms();
+    if (job->spec->kind == BATCH_SPECTROGRAM) {
+        res->error = run_spectrogram(job, &job->workers[worker], job->paths[task], res);
+    } else {
+        res->error = run_fir(job, &job->workers[worker], job->paths[task], res);
+    }
+    res->ms = now_ms() - t0;
+}
+
+/******************************************************************************/
+/* setup */
+
+/* Internal helper: read whitespace-separated taps; returns count or -1 */
+static int read_coeffs(const char *path, double **out) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int n = 0, cap = 0;
+    double *c = NULL, v;
+    while (fscanf(f, "%lf", &v) == 1) {
+        if (n == cap) {
+            cap = cap ? 2 * cap : 64;
+            double *grown = realloc(c, cap * sizeof(double));
+            if (!grown) {
+                free(c);
+                fclose(f);
+                return -1;
+            }
+            c = grown;
+        }
+        c[n++] = v;
+    }
+    int bad = !feof(f);
+    fclose(f);
+    if (bad || n == 0 || n > BATCH_MAX_TAPS) {
+        free(c);
+        return -1;
+    }
+    *out = c;
+    return n;
+}
+
+/******************************************************************************
+ * parse_spec
+ *
+ * @param[in]  text Spec string, e.g. "spectrogram:fft=512,mode=db"
+ * @param[out] spec Parsed spec with defaults filled in
+ *
+ * @returns 0 on success, -1 with a message on stderr otherwise
+ */
+static int parse_spec(const char *text, BatchSpec *spec) {
+    memset(spec, 0, sizeof(*spec));
+    spec->fft_size = 1024;
+    spec->window_type = WINDOW_HANN;
+    spectrogram_options_init(&spec->options, SPEC_MODE_MAGNITUDE);
+    spec->dtype = SPEC_DTYPE_F32;
+    spec->num_taps = 101;
+
+    char buf[1024];
+    snprintf(buf, sizeof(buf), "%s", text);
+    char *params = strchr(buf, ':');
+    if (params) *params++ = '\0';
+
+    if (strcmp(buf, "spectrogram") == 0) {
+        spec->kind = BATCH_SPECTROGRAM;
+    } else if (strcmp(buf, "fir") == 0) {
+        spec->kind = BATCH_FIR;
+    } else {
+        fprintf(stderr, "unknown spec '%s' (spectrogram or fir)\n", buf);
+        return -1;
+    }
+
+    const char *coeffs_path = NULL;
+    for (char *kv = params ? strtok(params, ",") : NULL; kv; kv = strtok(NULL, ",")) {
+        char *val = strchr(kv, '=');
+        if (!val) {
+            fprintf(stderr, "spec parameter '%s' needs a value\n", kv);
+            return -1;
+        }
+        *val++ = '\0';
+        if (strcmp(kv, "fft") == 0) {
+            spec->fft_size = atoi(val);
+        } else if (strcmp(kv, "hop") == 0) {
+            spec->hop_size = atoi(val);
+        } else if (strcmp(kv, "window") == 0 && strcmp(val, "hann") == 0) {
+            spec->window_type = WINDOW_HANN;
+        } else if (strcmp(kv, "window") == 0 && strcmp(val, "hamming") == 0) {
+            spec->window_type = WINDOW_HAMMING;
+        } else if (strcmp(kv, "mode") == 0 && strcmp(val, "mag") == 0) {
+            spec->options.mode = SPEC_MODE_MAGNITUDE;
+        } else if (strcmp(kv, "mode") == 0 && strcmp(val, "power") == 0) {
+            spec->options.mode = SPEC_MODE_POWER;
+        } else if (strcmp(kv, "mode") == 0 && strcmp(val, "db") == 0) {
+            spec->options.mode = SPEC_MODE_DB;
+        } else if (strcmp(kv, "dtype") == 0 && strcmp(val, "f32") == 0) {
+            spec->dtype = SPEC_DTYPE_F32;
+        } else if (strcmp(kv, "dtype") == 0 && strcmp(val, "f64") == 0) {
+            spec->dtype = SPEC_DTYPE_F64;
+        } else if (strcmp(kv, "dtype") == 0 && strcmp(val, "f16") == 0) {
+            spec->dtype = SPEC_DTYPE_F16;
+        } else if (strcmp(kv, "dtype") == 0 && strcmp(val, "u8") == 0) {
+            spec->dtype = SPEC_DTYPE_U8_DB;
+        } else if (strcmp(kv, "floor") == 0) {
+            spec->options.floor = atof(val);
+        } else if (strcmp(kv, "ceil") == 0) {
+            spec->options.ceiling = atof(val);
+        } else if (strcmp(kv, "taps") == 0) {
+            spec->num_taps = atoi(val);
+        } else if (strcmp(kv, "cutoff") == 0) {
+            spec->cutoff_hz = atof(val);
+        } else if (strcmp(kv, "coeffs") == 0) {
+            coeffs_path = val;
+        } else {
+            fprintf(stderr, "bad spec parameter '%s=%s'\n", kv, val);
+            return -1;
+        }
+    }
+
+    if (spec->kind == BATCH_SPECTROGRAM) {
+        if (spectrogram_workspace_mem_size(spec->fft_size) == 0) {
+            fprintf(stderr, "fft must be a power of two\n");
+            return -1;
+        }
+        if (spec->dtype == SPEC_DTYPE_U8_DB) {
+            // uint8 codes are dB over a finite range
+            spec->options.mode = SPEC_MODE_DB;
+            if (isinf(spec->options.floor)) spec->options.floor = BATCH_U8_DB_FLOOR;
+            if (isinf(spec->options.ceiling)) spec->options.ceiling = BATCH_U8_DB_CEILING;
+            if (spectrogram_u8_db_range(&spec->options, &spec->scale, &spec->offset) != 0) {
+                fprintf(stderr, "dtype=u8 needs floor < ceil\n");
+                return -1;
+            }
+        }
+        if (spec->hop_size == 0) spec->hop_size = spec->fft_size / 4;
+        if (spec->hop_size < 1) {
+            fprintf(stderr, "hop must be positive\n");
+            return -1;
+        }
+    } else if (coeffs_path) {
+        spec->num_taps = read_coeffs(coeffs_path, &spec->coeffs);
+        if (spec->num_taps < 0) {
+            fprintf(stderr, "cannot read taps from %s\n", coeffs_path);
+            return -1;
+        }
+    } else if (spec->num_taps < 1 || spec->num_taps > BATCH_MAX_TAPS || spec->cutoff_hz <= 0) {
+        fprintf(stderr, "fir needs cutoff=HZ and 1..%d taps, or coeffs=FILE\n", BATCH_MAX_TAPS);
+        return -1;
+    }
+    return 0;
+}
+/* End of parse_spec() */
+/******************************************************************************/
+
+/* Internal helper: append a copy of path to the list */
+static int add_path(char ***paths, size_t *count, size_t *cap, const char *path) {
+    if (*count == *cap) {
+        size_t grown_cap = *cap ? 2 * *cap : 256;
+        char **grown = realloc(*paths, grown_cap * sizeof(char *));
+        if (!grown) return -1;
+        *paths = grown;
+        *cap = grown_cap;
+    }
+    char *copy = strdup(path);
+    if (!copy) return -1;
+    (*paths)[(*count)++] = copy;
+    return 0;
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/* Internal helper: add every *.wav directly inside dir, sorted by name */
+static int add_dir(char ***paths, size_t *count, size_t *cap, const char *dir) {
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+    size_t first = *count;
+    struct dirent *e;
+    char buf[4096];
+    while ((e = readdir(d)) != NULL) {
+        size_t len = strlen(e->d_name);
+        if (len < 5 || strcasecmp(e->d_name + len - 4, ".wav") != 0) continue;
+        snprintf(buf, sizeof(buf), "%s/%s", dir, e->d_name);
+        if (add_path(paths, count, cap, buf) != 0) {
+            closedir(d);
+            return -1;
+        }
+    }
+    closedir(d);
+    qsort(*paths + first, *count - first, sizeof(char *), compare_paths);
+    return 0;
+}
+
+/* Internal helper: add the non-empty lines of a list file */
+static int add_list(char ***paths, size_t *count, size_t *cap, const char *list) {
+    FILE *f = strcmp(list, "-") == 0 ? stdin : fopen(list, "r");
+    if (!f) return -1;
+    char line[4096];
+    int ret = 0;
+    while (ret == 0 && fgets(line, sizeof(line), f)) {
+        size_t len = strlen(line);
+        while (len > 0 && isspace((unsigned char)line[len - 1])) line[--len] = '\0';
+        if (len > 0) ret = add_path(paths, count, cap, line);
+    }
+    if (f != stdin) fclose(f);
+    return ret;
+}
+
+/* Internal helper: output path per input */
+typedef struct {
+    char *out;
+    size_t input;
+} BatchOutput;
+
+static int compare_outputs(const void *a, const void *b) {
+    const BatchOutput *x = a, *y = b;
+    int c = strcmp(x->out, y->out);
+    return c ? c : (x->input > y->input) - (x->input < y->input);
+}
+
+/* Internal helper: outputs are OUTDIR/<basename>, so inputs with the same
+ * name in different directories would overwrite each other (from two
+ * workers at once). Reports every clash on stderr; returns 0 if none,
+ * 1 on a clash, -1 on allocation failure. */
+static int check_outputs(char **paths, size_t count, const char *out_dir, const char *ext) {
+    BatchOutput *outputs = calloc(count, sizeof(BatchOutput));
+    if (!outputs) return -1;
+
+    int ret = 0;
+    char buf[4096];
+    for (size_t i = 0; i < count && ret == 0; i++) {
+        output_path(buf, sizeof(buf), out_dir, paths[i], ext);
+        outputs[i].out = strdup(buf);
+        outputs[i].input = i;
+        if (!outputs[i].out) ret = -1;
+    }
+    if (ret == 0) {
+        qsort(outputs, count, sizeof(BatchOutput), compare_outputs);
+        for (size_t i = 1; i < count; i++) {
+            if (strcmp(outputs[i].out, outputs[i - 1].out) == 0) {
+                fprintf(stderr, "%s and %s would both write %s\n",
+                        paths[outputs[i - 1].input], paths[outputs[i].input], outputs[i].out);
+                ret = 1;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        free(outputs[i].out);
+    }
+    free(outputs);
+    return ret;
+}
+
+/* Internal helper: build the per-worker state */
+static int worker_init(BatchWorker *w, const BatchSpec *spec) {
+    memset(w, 0, sizeof(*w));
+    if (spec->kind == BATCH_SPECTROGRAM) {
+        if (spectrogram_workspace_init(&w->ws, spec->fft_size, spec->window_type) != 0) return -1;
+        w->has_ws = 1;
+        return 0;
+    }
+
+    w->fir_mem = malloc(fir_filter_mem_size(spec->num_taps));
+    w->taps = malloc(spec->num_taps * sizeof(double));
+    if (!w->fir_mem || !w->taps) return -1;
+    if (spec->coeffs) {
+        fir_filter_init_mem(&w->fir, spec->coeffs, spec->num_taps, w->fir_mem);
+    }
+    return 0;
+}
+
+static void worker_free(BatchWorker *w) {
+    if (w->has_ws) spectrogram_workspace_free(&w->ws);
+    free(w->samples);
+    free(w->fir_mem);
+    free(w->taps);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s -o OUTDIR [-s SPEC] [-j N] [-l LIST] [-q] [FILE | DIR]...\n"
+            "  SPEC: spectrogram[:fft=N,hop=N,window=hann|hamming,mode=mag|power|db,\n"
+            "                    dtype=f32|f64|f16|u8,floor=X,ceil=X]\n"
+            "        fir:taps=N,cutoff=HZ | fir:coeffs=FILE\n",
+            prog);
+}
+
+/******************************************************************************
+ * main
+ *
+ * @param[in] argc number of command-line arguments
+ * @param[in] argv command-line arguments (see file header)
+ *
+ * @returns 0 if every file succeeded, 1 if any failed, 2 on bad arguments
+ */
+int main(int argc, char *argv[]) {
+    const char *out_dir = NULL;
+    const char *spec_text = "spectrogram";
+    const char *list = NULL;
+    int threads = 0, quiet = 0, opt;
+
+    while ((opt = getopt(argc, argv, "o:s:j:l:qh")) != -1) {
+        switch (opt) {
+            case 'o': out_dir = optarg; break;
+            case 's': spec_text = optarg; break;
+            case 'j': threads = atoi(optarg); break;
+            case 'l': list = optarg; break;
+            case 'q': quiet = 1; break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    BatchSpec spec;
+    if (!out_dir || threads < 0 || parse_spec(spec_text, &spec) != 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    char **paths = NULL;
+    size_t count = 0, cap = 0;
+    if (list && add_list(&paths, &count, &cap, list) != 0) {
+        fprintf(stderr, "cannot read list %s\n", list);
+        return 2;
+    }
+    for (int i = optind; i < argc; i++) {
+        struct stat st;
+        int ret = stat(argv[i], &st) == 0 && S_ISDIR(st.st_mode)
+                ? add_dir(&paths, &count, &cap, argv[i])
+                : add_path(&paths, &count, &cap, argv[i]);
+        if (ret != 0) {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (count == 0) {
+        fprintf(stderr, "no input files\n");
+        return 2;
+    }
+    int clash = check_outputs(paths, count, out_dir, spec.kind == BATCH_SPECTROGRAM ? ".dsps" : ".wav");
+    if (clash != 0) {
+        fprintf(stderr, clash < 0 ? "out of memory\n" : "output names must be unique\n");
+        return 2;
+    }
+
+    ThreadPool pool;
+    if (thread_pool_init(&pool, threads) != 0) {
+        fprintf(stderr, "cannot start threads\n");
+        return 2;
+    }
+    BatchJob job = {
+        .spec = &spec,
+        .out_dir = out_dir,
+        .paths = paths,
+        .results = calloc(count, sizeof(BatchResult)),
+        .workers = calloc(pool.num_threads, sizeof(BatchWorker)),
+    };
+    int ok = job.results && job.workers;
+    for (int i = 0; ok && i < pool.num_threads; i++) {
+        ok = worker_init(&job.workers[i], &spec) == 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+
+    double t0 = now_ms();
+    thread_pool_run(&pool, count, batch_task, &job);
+    double wall_ms = now_ms() - t0;
+
+    size_t failed = 0, samples = 0;
+    double audio_s = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        const BatchResult *r = &job.results[i];
+        if (r->error) {
+            failed++;
+        } else {
+            samples += r->samples;
+            audio_s += (double)r->samples / r->sample_rate;
+        }
+        if (!quiet) {
+            printf("%-4s %10.3f ms %10zu samples  %s%s%s\n", r->error ? "FAIL" : "ok",
+                   r->ms, r->samples, paths[i], r->error ? ": " : "", r->error ? r->error : "");
+        }
+    }
+
+    double wall_s = wall_ms / 1e3;
+    printf("files: %zu ok, %zu failed; %d threads (%s kernels), %zu steals\n",
+           count - failed, failed, pool.num_threads, dsp_cpu_level_name(dsp_cpu_level()),
+           thread_pool_steals(&pool));
+    printf("wall %.3f s: %.1f files/s, %.2f Msamples/s, %.1fx realtime (%.1f s of audio)\n",
+           wall_s, count / wall_s, samples / wall_s / 1e6, audio_s / wall_s, audio_s);
+
+    for (int i = 0; i < pool.num_threads; i++) {
+        worker_free(&job.workers[i]);
+    }
+    thread_pool_free(&pool);
+    for (size_t i = 0; i < count; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+    free(job.results);
+    free(job.workers);
+    free(spec.coeffs);
+    return failed ? 1 : 0;
+}
+/* End of main() */
+/******************************************************************************/
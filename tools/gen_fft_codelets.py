@@ -0,0 +1,191 @@
+"""Generate src/fft_codelets.c: straight-line FFTs for sizes 2 .. 128.
+
+Each size gets two codelets:
+  fft_codelet_<n>_br  input in bit-reversed order, output in natural order
+                      (the radix-2 DIT stages only; leaf kernel for the
+                      iterative plan, which has already permuted the data)
+  fft_codelet_<n>     natural order in and out (unrolled swaps, then _br)
+
+The data are loaded into locals once, every butterfly is written out with
+its twiddle as a literal, and multiplications by 1, -i and (+-1 - i)/sqrt(2)
+are folded away. Run from the repository root:
+
+    python3 tools/gen_fft_codelets.py
+"""
+
+import math
+
+MAX_N = 128
+REG_N = 32      # largest size kept entirely in locals; above it the codelet
+                # runs two half-size codelets and an unrolled combine stage
+OUT = "src/fft_codelets.c"
+
+HEADER = """\
+/*
+ * @file fft_codelets.c
+ *
+ * GENERATED by tools/gen_fft_codelets.py -- do not edit by hand.
+ *
+ * Fully unrolled radix-2 FFTs for n = 2 .. %d with constant twiddles.
+ * Twiddles equal to 1, -i or (+-1 - i)/sqrt(2) are folded into adds and
+ * one shared multiply; the rest appear as literals. The _br codelets take
+ * their input in bit-reversed order (leaf kernels of fft_execute()); the
+ * plain ones take natural order.
+ *
+ * Created on: Oct 18, 2026
+ * Author: Omri Kebede
+ */
+
+/******************************************************************************/
+/* include block */
+#include <stddef.h>
+#include "fft_codelets.h"
+
+/******************************************************************************/
+/** local definitions **/
+#define SQRT1_2 0.70710678118654752440
+
+#define SWAP(a, b) do { Complex t_ = x[a]; x[a] = x[b]; x[b] = t_; } while (0)
+""" % MAX_N
+
+
+def lit(v):
+    return repr(float(v))
+
+
+def bitrev(i, bits):
+    r = 0
+    for b in range(bits):
+        r |= ((i >> b) & 1) << (bits - 1 - b)
+    return r
+
+
+def twiddle(k, length, re, im):
+    """Statements setting tr, ti to (re + i*im) * exp(-2*pi*i*k/length)."""
+    if k == 0:
+        return "tr = %s; ti = %s;" % (re, im)
+    if 4 * k == length:
+        return "tr = %s; ti = -%s;" % (im, re)
+    if 8 * k == length:
+        return "tr = SQRT1_2 * (%s + %s); ti = SQRT1_2 * (%s - %s);" % (re, im, im, re)
+    if 8 * k == 3 * length:
+        return "tr = SQRT1_2 * (%s - %s); ti = -SQRT1_2 * (%s + %s);" % (im, re, re, im)
+    t = -2 * math.pi * k / length
+    wr, wi = lit(math.cos(t)), lit(math.sin(t))
+    return "tr = %s * %s - %s * %s; ti = %s * %s + %s * %s;" % (wr, re, wi, im, wr, im, wi, re)
+
+
+def codelet_split_br(n):
+    half = n // 2
+    lines = ["static void fft_codelet_%d_br(Complex *x) {" % n]
+    lines.append("    fft_codelet_%d_br(x);" % half)
+    lines.append("    fft_codelet_%d_br(x + %d);" % (half, half))
+    lines.append("    double ar, ai, tr, ti;")
+    lines.append("")
+    lines.append("    // stage: span %d" % n)
+    for k in range(half):
+        b = k + half
+        lines.append("    ar = x[%d].real; ai = x[%d].imag; %s" % (
+            k, k, twiddle(k, n, "x[%d].real" % b, "x[%d].imag" % b)))
+        lines.append("    x[%d].real = ar - tr; x[%d].imag = ai - ti; x[%d].real = ar + tr; x[%d].imag = ai + ti;" % (
+            b, b, k, k))
+    lines.append("}")
+    return lines
+
+
+def codelet_br(n):
+    if n > REG_N:
+        return codelet_split_br(n)
+    lines = ["static void fft_codelet_%d_br(Complex *x) {" % n]
+    for i in range(n):
+        lines.append("    double r%d = x[%d].real, i%d = x[%d].imag;" % (i, i, i, i))
+    lines.append("    double tr, ti;")
+    lines.append("")
+
+    length = 2
+    while length <= n:
+        half = length // 2
+        lines.append("    // stage: span %d" % length)
+        for start in range(0, n, length):
+            for k in range(half):
+                a, b = start + k, start + k + half
+                lines.append("    " + twiddle(k, length, "r%d" % b, "i%d" % b))
+                lines.append("    r%d = r%d - tr; i%d = i%d - ti; r%d += tr; i%d += ti;" % (
+                    b, a, b, a, a, a))
+        length *= 2
+
+    lines.append("")
+    for i in range(n):
+        lines.append("    x[%d].real = r%d; x[%d].imag = i%d;" % (i, i, i, i))
+    lines.append("}")
+    return lines
+
+
+def codelet_natural(n):
+    bits = n.bit_length() - 1
+    lines = ["static void fft_codelet_%d(Complex *x) {" % n]
+    swaps = ["SWAP(%d, %d);" % (i, bitrev(i, bits)) for i in range(n) if bitrev(i, bits) > i]
+    for j in range(0, len(swaps), 4):
+        lines.append("    " + " ".join(swaps[j:j + 4]))
+    lines.append("    fft_codelet_%d_br(x);" % n)
+    lines.append("}")
+    return lines
+
+
+def table(name, suffix, sizes):
+    lines = ["static const FFTCodelet %s[] = {" % name]
+    lines.append("    NULL,")
+    for n in sizes:
+        lines.append("    fft_codelet_%d%s," % (n, suffix))
+    lines.append("};")
+    return lines
+
+
+def lookup(func, name, doc):
+    return [
+        "/" + "*" * 78,
+        " * %s" % func,
+        " *",
+        " * @param[in] n Transform length",
+        " *",
+        " * @returns %s, NULL unless n is a power" % doc,
+        " *          of two in 2 .. FFT_CODELET_MAX",
+        " " + "*" * 78 + "/",
+        "FFTCodelet %s(int n) {" % func,
+        "    if (n < 2 || n > FFT_CODELET_MAX || (n & (n - 1)) != 0) return NULL;",
+        "    int log2n = 0;",
+        "    while ((1 << log2n) < n) log2n++;",
+        "    return %s[log2n];" % name,
+        "}",
+        "/* End of %s() */" % func,
+        "/" + "*" * 78 + "/",
+    ]
+
+
+def main():
+    sizes = [1 << b for b in range(1, MAX_N.bit_length())]
+    out = [HEADER]
+    for n in sizes:
+        out.append("/" + "*" * 78 + "/")
+        out.append("/* n = %d */" % n)
+        out.append("")
+        out.extend(codelet_br(n))
+        out.append("")
+        out.extend(codelet_natural(n))
+        out.append("")
+    out.append("/" + "*" * 78 + "/")
+    out.append("/* lookup, indexed by log2(n) */")
+    out.append("")
+    out.extend(table("codelets", "", sizes))
+    out.append("")
+    out.extend(table("codelets_br", "_br", sizes))
+    out.append("")
+    out.extend(lookup("fft_codelet", "codelets", "Natural-order codelet for n"))
+    out.append("")
+    out.extend(lookup("fft_codelet_bitrev", "codelets_br", "Bit-reversed-input codelet for n"))
+    with open(OUT, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()